@@ -147,15 +147,18 @@ if [[ "X$ENABLE_GE_UT" = "Xon" || "X$ENABLE_GE_COV" = "Xon" ]]; then
     cp ${BUILD_PATH}/graphengine/tests/ut/ge/ut_libge_distinct_load_utest ${OUTPUT_PATH}
     cp ${BUILD_PATH}/graphengine/tests/ut/ge/ut_libge_others_utest ${OUTPUT_PATH}
     cp ${BUILD_PATH}/graphengine/tests/ut/ge/ut_libge_kernel_utest ${OUTPUT_PATH}
+    cp ${BUILD_PATH}/graphengine/tests/ut/ge/ge_mem_assigner_benchmark ${OUTPUT_PATH}
 
     if [[ "X${ENABLE_GE_UT_ONLY_COMPILE}" != "Xon" ]]; then
         export LD_LIBRARY_PATH=${D_LINK_PATH}/x86_64/:${BUILD_PATH}/graphengine/:/usr/local/HiAI/driver/lib64:/usr/local/HiAI/runtime/lib64:${LD_LIBRARY_PATH}
         echo ${LD_LIBRARY_PATH}
+        # the memory assigner benchmark checks the planned sizes here, GE_MEM_ASSIGNER_BENCHMARK_TIMING=1 adds the timing
         ${OUTPUT_PATH}/ut_libgraph &&
         ${OUTPUT_PATH}/ut_libge_multiparts_utest &&
         ${OUTPUT_PATH}/ut_libge_distinct_load_utest &&
         ${OUTPUT_PATH}/ut_libge_others_utest &&
-        ${OUTPUT_PATH}/ut_libge_kernel_utest
+        ${OUTPUT_PATH}/ut_libge_kernel_utest &&
+        ${OUTPUT_PATH}/ge_mem_assigner_benchmark
         if [[ "$?" -ne 0 ]]; then
             echo "!!! UT FAILED, PLEASE CHECK YOUR CHANGES !!!"
             exit 1;
@@ -57,7 +57,8 @@ class OpsKernelInfoStore {
   // get all opsKernelInfo
   virtual void GetAllOpsKernelInfo(map<string, OpInfo> &infos) const = 0;
 
-  // check whether opsKernelInfoStore is supported based on the operator attribute
+  // check whether opsKernelInfoStore is supported based on the operator attribute,
+  // called concurrently for different ops when ge.parallelEnginePlace is "1"
   virtual bool CheckSupported(const OpDescPtr &opDescPtr, std::string &un_supported_reason) const = 0;
 
   virtual bool CheckAccuracySupported(const OpDescPtr &opDescPtr, std::string &un_supported_reason,
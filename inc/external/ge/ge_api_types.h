@@ -38,6 +38,20 @@ const char *const GE_AICPU_FLAG = "ge.aicpuFlag";
 const char *const OPTION_EXEC_EXTERN_PLUGIN_PATH = "ge.soLoadPath";
 const char *const OPTION_EXEC_ENABLE_DUMP = "ge.exec.enableDump";
 const char *const OPTION_EXEC_DUMP_PATH = "ge.exec.dumpPath";
+// Dump filters, only ops matching all of the configured ones are dumped
+// regex searched in op name, such as "conv1|fc"
+const char *const OPTION_EXEC_DUMP_OP_NAME = "ge.exec.dumpOpName";
+// op types split by ",", such as "Conv2D,MatMul"
+const char *const OPTION_EXEC_DUMP_OP_TYPE = "ge.exec.dumpOpType";
+// input or output indexes split by ",", such as "0,2"
+const char *const OPTION_EXEC_DUMP_INPUT_INDEX = "ge.exec.dumpInputIndex";
+const char *const OPTION_EXEC_DUMP_OUTPUT_INDEX = "ge.exec.dumpOutputIndex";
+// iteration range, such as "10-20" or "10"
+const char *const OPTION_EXEC_DUMP_STEP = "ge.exec.dumpStep";
+// dump every N iterations of the range
+const char *const OPTION_EXEC_DUMP_INTERVAL = "ge.exec.dumpInterval";
+// max bytes dumped by a model in all iterations, 0 means no limit
+const char *const OPTION_EXEC_DUMP_MAX_BYTES = "ge.exec.dumpMaxBytes";
 // Hccl flag, if ge.exec.hcclFlag =1, it means load plugin for opskernel, else:ge.exec.hcclFlag =0
 const char *const OPTION_EXEC_HCCL_FLAG = "ge.exec.hcclFlag";
 const char *const OPTION_EXEC_ATOMIC_FLAG = "ge.exec.enable_atomic";
@@ -152,6 +166,19 @@ const std::string AUTO_TUNE_MODE = "ge.autoTuneMode";
 // Configure core type "VectorEngine", default value is "AICoreEngine"
 const std::string CORE_TYPE = "ge.engineType";
 
+// Configure whether to check the op support of different op signatures on parallel threads when placing engines,
+// the ops kernel info stores must allow concurrent CheckSupported, its value should be "0" or "1", default value is "0"
+const std::string PARALLEL_ENGINE_PLACE = "ge.parallelEnginePlace";
+
+// Configure whether to copy the batch branches of the dynamic batch/imagesize graph on parallel threads,
+// its value should be "0" or "1", default value is "0"
+const std::string MULTI_BATCH_PARALLEL_COPY = "ge.multiBatchParallelCopy";
+
+// Configure whether the batch branches of the dynamic batch/imagesize graph share the Const/Variable nodes which the
+// branches write to, rather than each branch getting its own copy, and plan the feature map of the branches on the same
+// memory, its value should be "0" or "1", default value is "0"
+const std::string MULTI_BATCH_SHARE_WEIGHTS = "ge.multiBatchShareWeights";
+
 // Configure soc version , example: "Ascend310"
 const std::string SOC_VERSION = "ge.socVersion";
 
@@ -161,6 +188,10 @@ const std::string SAVE_ORIGINAL_MODEL = "ge.saveOriginalModel";
 // Save original model file name
 const std::string ORIGINAL_MODEL_FILE = "ge.originalModelFile";
 
+// Configure graphs whose models are never unloaded when device memory is insufficient,
+// its value should be graph ids split by ",", such as "1,3", default value is ""
+const std::string NEVER_EVICT_GRAPHS = "ge.neverEvictGraphs";
+
 const char *const OPTION_GE_MAX_DUMP_FILE_NUM = "ge.maxDumpFileNum";
 const char *const OPTION_GE_MAX_DUMP_FILE_SIZE = "ge.maxDumpFileSize";
 const char *const OPTION_GE_MAX_DUMP_OP_NUM = "ge.maxDumpOpNum";
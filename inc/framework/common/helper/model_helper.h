@@ -35,6 +35,9 @@ class ModelHelper {
   Status SaveToOmModel(const GeModelPtr &ge_model, const SaveParam &save_param, const std::string &output_file);
   Status SaveOriginalGraphToOmModel(const ge::Graph &graph, const std::string &output_file);
   Status LoadModel(const ge::ModelData &model_data);
+  // weights and tbe kernels are viewed in the model data and the task def is parsed on first use,
+  // data_owner keeps the model data valid as long as the loaded model
+  Status LoadModelLazily(const ge::ModelData &model_data, const std::shared_ptr<void> &data_owner);
 
   ModelFileHeader *GetFileHeader() { return file_header_; }
 
@@ -50,6 +53,7 @@ class ModelHelper {
   uint8_t *model_addr_tmp_ = nullptr;
   uint32_t model_len_tmp_ = 0;
   GeModelPtr model_;
+  std::shared_ptr<void> data_owner_;
 
   ModelHelper(const ModelHelper &);
   ModelHelper &operator=(const ModelHelper &);
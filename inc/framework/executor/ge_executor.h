@@ -24,6 +24,7 @@
 #include "common/ge_inner_error_codes.h"
 #include "common/ge_types.h"
 #include "common/types.h"
+#include "graph/ge_tensor.h"
 #include "graph/tensor.h"
 #include "runtime/base.h"
 
@@ -31,6 +32,7 @@ namespace ge {
 class ModelListenerAdapter;
 
 class SingleOp;
+class DynamicSingleOp;
 
 struct RunModelData {
   uint32_t index;                 // Data index
@@ -153,6 +155,13 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GeExecutor {
   static ge::Status ExecuteAsync(SingleOp *executor, const std::vector<DataBuffer> &inputs,
                                  std::vector<DataBuffer> &outputs);
 
+  static ge::Status LoadDynamicSingleOp(const std::string &model_name, const ge::ModelData &model_data, void *stream,
+                                        DynamicSingleOp **single_op);
+
+  static ge::Status ExecuteAsync(DynamicSingleOp *executor, const std::vector<GeTensorDesc> &input_desc,
+                                 const std::vector<DataBuffer> &inputs, std::vector<GeTensorDesc> &output_desc,
+                                 std::vector<DataBuffer> &outputs);
+
   static ge::Status ReleaseSingleOpResource(void *stream);
 
  private:
@@ -106,6 +106,9 @@ class ComputeGraph : public std::enable_shared_from_this<ComputeGraph>, public A
   graphStatus InferShape();
   graphStatus InferOriginFormat();
   graphStatus InferShapeInNeed();
+  /// Infer seeds and nodes with dirty descs, then their consumers in topological order. Propagation stops at
+  /// consumers whose input descs come out unchanged, so only the changed region is inferred again
+  graphStatus InferShapeIncremental(const std::vector<NodePtr> &seeds);
   graphStatus InsertEventNodes();
   bool operator==(const ComputeGraph &r_compute_graph) const;
 
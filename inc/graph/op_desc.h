@@ -225,6 +225,12 @@ class OpDesc : public std::enable_shared_from_this<OpDesc>, public AttrHolder {
 
   std::string GetOpEngineName() const;
 
+  /// Set when an input or output desc is updated with another shape, data type or format,
+  /// cleared once the node is inferred. See ComputeGraph::InferShapeIncremental
+  bool IsInferDirty() const;
+
+  void SetInferDirty(bool infer_dirty);
+
  protected:
   ProtoAttrMapHelper MutableAttrMap() override;
   ConstProtoAttrMapHelper GetAttrMap() const override;
@@ -246,6 +252,7 @@ class OpDesc : public std::enable_shared_from_this<OpDesc>, public AttrHolder {
   std::function<graphStatus(Operator &)> verifier_func_ = nullptr;
   string op_kernel_lib_name_;
   string engine_name_;
+  bool infer_dirty_ = false;
   friend class OpDescUtils;
   friend class ModelSerializeImp;
   friend class AttrUtils;
@@ -17,6 +17,9 @@
 #ifndef INC_GRAPH_SHAPE_REFINER_H_
 #define INC_GRAPH_SHAPE_REFINER_H_
 
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
 
 #include "external/graph/inference_context.h"
@@ -24,12 +27,35 @@
 #include "graph/node.h"
 
 namespace ge {
+// IR names and funcs of an op type, taken from the operator created by the factory
+struct OpTypeFuncs {
+  std::map<std::string, uint32_t> input_name_idx;
+  std::map<std::string, uint32_t> output_name_idx;
+  std::function<graphStatus(Operator &)> infer_func;
+  std::function<graphStatus(Operator &)> verify_func;
+  std::function<graphStatus(Operator &)> infer_format_func;
+};
+using OpTypeFuncsPtr = std::shared_ptr<const OpTypeFuncs>;
+
 // ShapeRefiner performs shape inference for compute graphs
 class ShapeRefiner {
  public:
   static graphStatus InferShapeAndType(const ConstNodePtr &node, Operator &op);
   static graphStatus InferShapeAndType(const NodePtr &node);
 
+  ///
+  /// @brief Get IR names and funcs of op type. The operator of each type is created by the factory only once,
+  ///        the result is kept in a thread safe table shared by all graphs.
+  /// @param [in] op_type
+  /// @return nullptr if no operator is registered for op_type
+  ///
+  static OpTypeFuncsPtr GetOpTypeFuncs(const std::string &op_type);
+
+  ///
+  /// @brief Drop all cached op types, operators registered afterwards are created again.
+  ///
+  static void ClearOpTypeFuncs();
+
  private:
   static void PrintInOutTensorShape(const ge::NodePtr &node, const std::string &phase);
 };
@@ -159,6 +159,11 @@ class GraphUtils {
 
   static void DumpGEGraphToOnnx(const ge::ComputeGraph &compute_graph, const std::string &suffix);
 
+  ///
+  /// The graphs are written by a background thread, wait until all the dumped graphs are in their files.
+  ///
+  static void FlushDumpGraph();
+
   static bool LoadGEGraphFromOnnx(const char *file, ge::ComputeGraph &compute_graph);
 
   static bool ReadProtoFromTextFile(const char *file, google::protobuf::Message *message);
@@ -881,6 +881,46 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus ComputeGraph::InferSh
   return GRAPH_SUCCESS;
 }
 
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus
+ComputeGraph::InferShapeIncremental(const std::vector<NodePtr> &seeds) {
+  GE_CHK_BOOL_RET_STATUS(TopologicalSorting() == GRAPH_SUCCESS, GRAPH_FAILED, "Topological sorting failed.");
+  // keyed by topological id, a node is always inferred after its dirty inputs
+  std::map<int64_t, NodePtr> dirty_nodes;
+  for (const auto &seed : seeds) {
+    GE_CHECK_NOTNULL(seed);
+    GE_CHECK_NOTNULL(seed->GetOpDesc());
+    if (seed->GetOwnerComputeGraph().get() != this) {
+      GELOGE(GRAPH_PARAM_INVALID, "Node %s is not a direct node of graph %s.", seed->GetName().c_str(), name_.c_str());
+      return GRAPH_PARAM_INVALID;
+    }
+    dirty_nodes[seed->GetOpDesc()->GetId()] = seed;
+  }
+  for (const auto &node : nodes_) {
+    if (node->GetOpDesc()->IsInferDirty()) {
+      dirty_nodes[node->GetOpDesc()->GetId()] = node;
+    }
+  }
+
+  size_t infer_count = 0;
+  while (!dirty_nodes.empty()) {
+    NodePtr node = dirty_nodes.begin()->second;
+    (void)dirty_nodes.erase(dirty_nodes.begin());
+    GE_CHK_BOOL_RET_STATUS(ShapeRefiner::InferShapeAndType(node) == GRAPH_SUCCESS, GRAPH_FAILED,
+                           "Inferring %s failed.", node->GetName().c_str());
+    infer_count++;
+    // updating an input desc with the same shape does not make the consumer dirty
+    for (const auto &out_node : node->GetOutDataNodes()) {
+      GE_CHECK_NOTNULL(out_node->GetOpDesc());
+      if (out_node->GetOpDesc()->IsInferDirty()) {
+        dirty_nodes[out_node->GetOpDesc()->GetId()] = out_node;
+      }
+    }
+  }
+  GELOGI("Incremental infer shape of graph %s inferred %zu of %zu nodes.", name_.c_str(), infer_count,
+         nodes_.size());
+  return GRAPH_SUCCESS;
+}
+
 ProtoAttrMapHelper ComputeGraph::MutableAttrMap() { return attrs_; }
 
 ConstProtoAttrMapHelper ComputeGraph::GetAttrMap() const {
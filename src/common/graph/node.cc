@@ -744,22 +744,23 @@ graphStatus Node::Verify() const {
 
   string frameworkop_type = "FrameworkOp";
   if (op_->GetType() != frameworkop_type) {
-    auto node_op = ge::OperatorFactoryImpl::CreateOperator("node_op", op_->GetType());
-    if (node_op.IsEmpty()) {
+    auto op_type_funcs = ShapeRefiner::GetOpTypeFuncs(op_->GetType());
+    if (op_type_funcs == nullptr) {
       GELOGW("get op from OperatorFactory fail. opType: %s", op_->GetType().c_str());
     } else {
       GELOGD("get op from OperatorFactory success. opType: %s", op_->GetType().c_str());
-      auto temp_op_desc = ge::OpDescUtils::GetOpDescFromOperator(node_op);
-      if (temp_op_desc == nullptr) {
-        GELOGE(GRAPH_FAILED, "temp op desc is null");
-        return GRAPH_FAILED;
-      }
-      if (!op_->UpdateInputName(temp_op_desc->GetAllInputName())) {
+      if (!op_->UpdateInputName(op_type_funcs->input_name_idx)) {
         GELOGW("Verify UpdateInputName failed");
       }
-      if (!op_->UpdateOutputName(temp_op_desc->GetAllOutputName())) {
+      if (!op_->UpdateOutputName(op_type_funcs->output_name_idx)) {
         GELOGW("Verify UpdateOutputName failed");
       }
+      if ((op_->GetVerifyFunc() == nullptr) && (op_type_funcs->verify_func != nullptr)) {
+        op_->AddVerifierFunc(op_type_funcs->verify_func);
+      }
+      if ((op_->GetInferFormatFunc() == nullptr) && (op_type_funcs->infer_format_func != nullptr)) {
+        op_->AddInferFormatFunc(op_type_funcs->infer_format_func);
+      }
     }
   }
 
@@ -275,10 +275,24 @@ graphStatus OpDesc::AddOptionalInputDesc(const string &name, const ge::GeTensorD
   return GRAPH_SUCCESS;
 }
 
+namespace {
+// infer shape only reads shape, data type and format of the descs
+bool IsInferDescChanged(const GeTensorDescPtr &old_desc, const GeTensorDesc &new_desc) {
+  if (old_desc == nullptr) {
+    return true;
+  }
+  return (old_desc->GetDataType() != new_desc.GetDataType()) || (old_desc->GetFormat() != new_desc.GetFormat()) ||
+         (old_desc->GetShape().GetDims() != new_desc.GetShape().GetDims());
+}
+}  // namespace
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus
 OpDesc::UpdateInputDesc(uint32_t index, const ge::GeTensorDesc &tensor_Desc) {
   GE_CHK_BOOL_RET_STATUS((index < inputs_desc_.size()), GRAPH_FAILED, "The index is invalid. index[%u]", index);
 
+  if (IsInferDescChanged(inputs_desc_[index], tensor_Desc)) {
+    infer_dirty_ = true;
+  }
   inputs_desc_[index] = ComGraphMakeShared<GeTensorDesc>(tensor_Desc);
   if (inputs_desc_[index] == nullptr) {
     GELOGE(GRAPH_FAILED, "UpdateInputDesc failed, malloc shared_ptr failed.");
@@ -379,6 +393,9 @@ graphStatus OpDesc::UpdateInputDesc(const string &name, const ge::GeTensorDesc &
   }
   GE_IF_BOOL_EXEC(it->second >= inputs_desc_.size(), GELOGE(GRAPH_FAILED, "it->second is invalid.");
                   return GRAPH_FAILED);
+  if (IsInferDescChanged(inputs_desc_[it->second], tensor_Desc)) {
+    infer_dirty_ = true;
+  }
   inputs_desc_[it->second] = ComGraphMakeShared<GeTensorDesc>(tensor_Desc);
   if (inputs_desc_[it->second] == nullptr) {
     GELOGE(GRAPH_FAILED, "UpdateInputDesc failed, malloc shared_ptr failed.");
@@ -439,6 +456,12 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void OpDesc::SetOpEngineName(cons
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY std::string OpDesc::GetOpEngineName() const { return engine_name_; }
 
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool OpDesc::IsInferDirty() const { return infer_dirty_; }
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void OpDesc::SetInferDirty(bool infer_dirty) {
+  infer_dirty_ = infer_dirty;
+}
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GeTensorDescPtr OpDesc::MutableInputDesc(uint32_t index) const {
   GE_CHK_BOOL_RET_STATUS(index < inputs_desc_.size(), nullptr, "Can't find the input desc %u", index);
   if (inputs_desc_[index] == nullptr) {
@@ -509,6 +532,9 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus
 OpDesc::UpdateOutputDesc(uint32_t index, const ge::GeTensorDesc &tensor_Desc) {
   GE_CHK_BOOL_RET_STATUS((index < outputs_desc_.size()), GRAPH_FAILED, "The index is invalid. index[%u]", index);
 
+  if (IsInferDescChanged(outputs_desc_[index], tensor_Desc)) {
+    infer_dirty_ = true;
+  }
   outputs_desc_[index] = ComGraphMakeShared<GeTensorDesc>(tensor_Desc);
   if (outputs_desc_[index] == nullptr) {
     GELOGE(GRAPH_FAILED, "UpdateOutputDesc failed, malloc shared_ptr failed.");
@@ -525,6 +551,9 @@ graphStatus OpDesc::UpdateOutputDesc(const string &name, const ge::GeTensorDesc
   }
   GE_IF_BOOL_EXEC(it->second >= outputs_desc_.size(), GELOGE(GRAPH_FAILED, "it->second is invalid.");
                   return GRAPH_FAILED);
+  if (IsInferDescChanged(outputs_desc_[it->second], tensor_Desc)) {
+    infer_dirty_ = true;
+  }
   outputs_desc_[it->second] = ComGraphMakeShared<GeTensorDesc>(tensor_Desc);
   if (outputs_desc_[it->second] == nullptr) {
     GELOGE(GRAPH_FAILED, "UpdateOutputDesc failed, malloc shared_ptr failed.");
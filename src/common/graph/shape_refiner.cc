@@ -17,6 +17,7 @@
 #include "graph/shape_refiner.h"
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -28,12 +29,64 @@
 #include "external/graph/operator_factory.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/compute_graph.h"
+#include "graph/operator_factory_impl.h"
 #include "utils/node_utils.h"
 #include "utils/op_desc_utils.h"
 #include "utils/tensor_utils.h"
 #include "utils/type_utils.h"
 
 namespace ge {
+namespace {
+std::mutex op_type_funcs_mutex;
+std::unordered_map<std::string, OpTypeFuncsPtr> op_type_funcs;
+}  // namespace
+
+OpTypeFuncsPtr ShapeRefiner::GetOpTypeFuncs(const std::string &op_type) {
+  {
+    std::lock_guard<std::mutex> lock(op_type_funcs_mutex);
+    auto iter = op_type_funcs.find(op_type);
+    if (iter != op_type_funcs.end()) {
+      return iter->second;
+    }
+  }
+
+  // Types without operator are not kept, their op proto may be registered later
+  auto node_op = OperatorFactoryImpl::CreateOperator("node_op", op_type);
+  if (node_op.IsEmpty()) {
+    return nullptr;
+  }
+  auto temp_op_desc = OpDescUtils::GetOpDescFromOperator(node_op);
+  if (temp_op_desc == nullptr) {
+    GELOGE(GRAPH_FAILED, "temp op desc of %s is null", op_type.c_str());
+    return nullptr;
+  }
+  auto funcs = std::shared_ptr<OpTypeFuncs>(new (std::nothrow) OpTypeFuncs());
+  if (funcs == nullptr) {
+    GELOGE(GRAPH_FAILED, "Failed to alloc OpTypeFuncs of %s", op_type.c_str());
+    return nullptr;
+  }
+  funcs->input_name_idx = temp_op_desc->GetAllInputName();
+  funcs->output_name_idx = temp_op_desc->GetAllOutputName();
+  funcs->infer_func = temp_op_desc->GetInferFunc();
+  funcs->verify_func = temp_op_desc->GetVerifyFunc();
+  if (funcs->verify_func == nullptr) {
+    funcs->verify_func = OperatorFactoryImpl::GetVerifyFunc(op_type);
+  }
+  funcs->infer_format_func = temp_op_desc->GetInferFormatFunc();
+  if (funcs->infer_format_func == nullptr) {
+    funcs->infer_format_func = OperatorFactoryImpl::GetInferFormatFunc(op_type);
+  }
+
+  // Another thread may have created the same type meanwhile, the first one is kept
+  std::lock_guard<std::mutex> lock(op_type_funcs_mutex);
+  return op_type_funcs.emplace(op_type, funcs).first->second;
+}
+
+void ShapeRefiner::ClearOpTypeFuncs() {
+  std::lock_guard<std::mutex> lock(op_type_funcs_mutex);
+  op_type_funcs.clear();
+}
+
 void ShapeRefiner::PrintInOutTensorShape(const ge::NodePtr &node, const std::string &phase) {
   if (node == nullptr) {
     GELOGE(GRAPH_FAILED, "node is null");
@@ -85,19 +138,14 @@ graphStatus ShapeRefiner::InferShapeAndType(const ConstNodePtr &node, Operator &
   graphStatus ret = op_desc->CallInferFunc(op);
   if (ret == GRAPH_PARAM_INVALID) {
     // Op ir no infer func, try to get infer func from operator factory
-    auto node_op = ge::OperatorFactory::CreateOperator("node_op", op_desc->GetType());
-    if (node_op.IsEmpty()) {
+    auto op_type_funcs = GetOpTypeFuncs(op_type);
+    if (op_type_funcs == nullptr) {
       GELOGW("get op from OperatorFactory fail. opType: %s", op_type.c_str());
       return ret;
     }
 
     GELOGD("get op from OperatorFactory success. opType: %s", op_type.c_str());
-    auto temp_op_desc = ge::OpDescUtils::GetOpDescFromOperator(node_op);
-    if (temp_op_desc == nullptr) {
-      GELOGE(GRAPH_FAILED, "temp op desc is null");
-      return GRAPH_FAILED;
-    }
-    if (!op_desc->UpdateInputName(temp_op_desc->GetAllInputName())) {
+    if (!op_desc->UpdateInputName(op_type_funcs->input_name_idx)) {
       GELOGW("InferShapeAndType UpdateInputName failed");
       for (const auto &out_desc : op_desc->GetAllOutputsDescPtr()) {
         if (out_desc != nullptr && out_desc->GetShape().GetDims().empty()) {
@@ -106,10 +154,10 @@ graphStatus ShapeRefiner::InferShapeAndType(const ConstNodePtr &node, Operator &
         return GRAPH_SUCCESS;
       }
     }
-    if (!op_desc->UpdateOutputName(temp_op_desc->GetAllOutputName())) {
+    if (!op_desc->UpdateOutputName(op_type_funcs->output_name_idx)) {
       GELOGW("InferShapeAndType UpdateOutputName failed");
     }
-    op_desc->AddInferFunc(temp_op_desc->GetInferFunc());
+    op_desc->AddInferFunc(op_type_funcs->infer_func);
     ret = op_desc->CallInferFunc(op);
     GELOGI("op CallInferFunc second. ret: %u", ret);
   }
@@ -202,6 +250,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus ShapeRefiner::InferSh
   graphStatus status = InferShapeAndType(node, op);
   if (status == GRAPH_PARAM_INVALID || status == GRAPH_SUCCESS) {
     (void)ge::NodeUtils::UpdatePeerNodeInputDesc(node);
+    node->GetOpDesc()->SetInferDirty(false);
   } else {
     GELOGE(GRAPH_FAILED, "%s call infer function failed.", node->GetName().c_str());
     return GRAPH_FAILED;
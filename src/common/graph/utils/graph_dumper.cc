@@ -0,0 +1,203 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/graph_dumper.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/text_format.h>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+
+#include "./ge_context.h"
+#include "debug/ge_util.h"
+#include "framework/common/debug/ge_log.h"
+#include "graph/ge_error_codes.h"
+
+namespace ge {
+namespace {
+const char *const kDumpGraphMode = "DUMP_GRAPH_MODE";
+const char *const kDumpModeSync = "sync";
+const char *const kDumpGraphFormat = "DUMP_GRAPH_FORMAT";
+const char *const kDumpFormatBinary = "binary";
+const char *const kBinaryExt = ".pb";
+const int kFileAuthority = 0600;
+const int kBaseOfIntegerValue = 10;
+// the snapshots of the large graphs take much memory, only a few of them wait for the writer
+const size_t kMaxDumpQueueSize = 8;
+// the dump is for debugging, the writer yields the cpu to the compile threads
+const int kWriterNiceValue = 10;
+
+bool IsEnvEqual(const char *env_name, const char *value) {
+  const char *env_value = std::getenv(env_name);
+  return env_value != nullptr && strcmp(env_value, value) == 0;
+}
+}  // namespace
+
+GraphDumper &GraphDumper::Instance() {
+  // destructed at exit, which flushes the graphs still in the queue
+  static GraphDumper instance;
+  return instance;
+}
+
+GraphDumper::~GraphDumper() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+}
+
+void GraphDumper::Dump(std::unique_ptr<google::protobuf::Message> proto, std::string &&snapshot,
+                       const std::string &file_name, const std::string &text_ext) {
+  if (proto == nullptr) {
+    GELOGE(GRAPH_FAILED, "The message of graph %s is nullptr.", file_name.c_str());
+    return;
+  }
+  DumpTask task;
+  task.is_binary = IsEnvEqual(kDumpGraphFormat, kDumpFormatBinary);
+  task.file_path = file_name + (task.is_binary ? kBinaryExt : text_ext);
+  if (task.file_path.length() >= PATH_MAX) {
+    GELOGE(GRAPH_FAILED, "File path %s is too long!", task.file_path.c_str());
+    return;
+  }
+  std::string opt = "0";
+  (void)GetContext().GetOption("ge.maxDumpFileSize", opt);
+  task.max_file_size = std::strtol(opt.c_str(), nullptr, kBaseOfIntegerValue);
+  task.proto = std::move(proto);
+  task.snapshot = std::move(snapshot);
+
+  if (IsEnvEqual(kDumpGraphMode, kDumpModeSync)) {
+    Write(task);
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!writer_.joinable()) {
+    try {
+      writer_ = std::thread(&GraphDumper::Run, this);
+    } catch (const std::system_error &e) {
+      GELOGW("Start graph dump thread failed: %s, write %s synchronously.", e.what(), task.file_path.c_str());
+      lock.unlock();
+      Write(task);
+      return;
+    }
+  }
+  cond_.wait(lock, [this] { return tasks_.size() < kMaxDumpQueueSize; });
+  GELOGD("Queue graph dump %s, %zu graphs waiting.", task.file_path.c_str(), tasks_.size());
+  tasks_.emplace_back(std::move(task));
+  cond_.notify_all();
+}
+
+void GraphDumper::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] { return tasks_.empty() && !writing_; });
+}
+
+void GraphDumper::Run() {
+  if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), kWriterNiceValue) != 0) {
+    GELOGW("Lower the priority of graph dump thread failed.");
+  }
+  while (true) {
+    DumpTask task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      // the queue is drained before stopping
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+      writing_ = true;
+    }
+    cond_.notify_all();
+
+    Write(task);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      writing_ = false;
+    }
+    cond_.notify_all();
+  }
+}
+
+bool GraphDumper::WriteFile(const DumpTask &task, google::protobuf::io::ZeroCopyOutputStream *output) {
+  if (!task.is_binary) {
+    return google::protobuf::TextFormat::Print(*task.proto, output);
+  }
+  if (task.snapshot.empty()) {
+    return task.proto->SerializeToZeroCopyStream(output);
+  }
+  // the snapshot is the serialized message already
+  google::protobuf::io::CodedOutputStream coded_output(output);
+  coded_output.WriteRaw(task.snapshot.data(), static_cast<int>(task.snapshot.size()));
+  return !coded_output.HadError();
+}
+
+void GraphDumper::Write(DumpTask &task) {
+  // the binary snapshot is written as it is, the text is printed from the parsed message
+  if (!task.is_binary && !task.snapshot.empty()) {
+    if (!task.proto->ParseFromString(task.snapshot)) {
+      GELOGE(GRAPH_FAILED, "Parse the snapshot of %s failed.", task.file_path.c_str());
+      return;
+    }
+    std::string().swap(task.snapshot);
+  }
+
+  char real_path[PATH_MAX] = {0x00};
+  const char *file_path = task.file_path.c_str();
+  if (realpath(file_path, real_path) != nullptr) {
+    file_path = real_path;
+  } else {
+    GELOGD("File %s does not exist, it will be created.", file_path);
+  }
+  int fd = open(file_path, O_WRONLY | O_CREAT | O_TRUNC, kFileAuthority);
+  if (fd < 0) {
+    GELOGE(GRAPH_FAILED, "Fail to open the file: %s", file_path);
+    return;
+  }
+  google::protobuf::io::FileOutputStream output(fd);
+  bool ret = WriteFile(task, &output);
+  // close flushes the buffered output
+  if (!output.Close() || !ret) {
+    GELOGE(GRAPH_FAILED, "Fail to write the file: %s", file_path);
+    return;
+  }
+
+  struct stat file_stat;
+  if (task.max_file_size != 0 && stat(file_path, &file_stat) == 0 && file_stat.st_size > task.max_file_size) {
+    GELOGW("dump graph file size > maxDumpFileSize, maxDumpFileSize=%ld.", task.max_file_size);
+    GE_IF_BOOL_EXEC(std::remove(file_path) != 0, GELOGW("remove %s failed", file_path));
+    return;
+  }
+  GELOGD("Dump graph to %s success.", file_path);
+}
+}  // namespace ge
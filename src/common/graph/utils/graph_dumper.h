@@ -0,0 +1,87 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_GRAPH_UTILS_GRAPH_DUMPER_H_
+#define COMMON_GRAPH_UTILS_GRAPH_DUMPER_H_
+
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/message.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ge {
+///
+/// Writes the dumped graphs on a background thread.
+/// The caller only takes a serialized snapshot of the graph, the text printing and the file writing,
+/// which take most of the dumping time, are moved off the compile thread.
+/// The queue is bounded, the caller waits when the writer lags behind, so no graph is dropped.
+/// DUMP_GRAPH_MODE=sync writes the graphs on the caller thread as before,
+/// DUMP_GRAPH_FORMAT=binary writes the compact serialized message instead of the text.
+///
+class GraphDumper {
+ public:
+  static GraphDumper &Instance();
+
+  ~GraphDumper();
+
+  GraphDumper(const GraphDumper &) = delete;
+  GraphDumper &operator=(const GraphDumper &) = delete;
+
+  ///
+  /// Write a graph to file_name with the extension text_ext, or with .pb in the binary format.
+  /// @param [in] proto: the message to write, the snapshot is parsed into it on the writer thread if not empty
+  /// @param [in] snapshot: the serialized message
+  ///
+  void Dump(std::unique_ptr<google::protobuf::Message> proto, std::string &&snapshot, const std::string &file_name,
+            const std::string &text_ext);
+
+  // wait until all the queued graphs are written
+  void Flush();
+
+ private:
+  struct DumpTask {
+    std::unique_ptr<google::protobuf::Message> proto;
+    std::string snapshot;
+    std::string file_path;
+    bool is_binary = false;
+    // the options are thread local, they are read on the caller thread
+    int64_t max_file_size = 0;
+  };
+
+  GraphDumper() = default;
+
+  void Run();
+
+  static void Write(DumpTask &task);
+
+  static bool WriteFile(const DumpTask &task, google::protobuf::io::ZeroCopyOutputStream *output);
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<DumpTask> tasks_;
+  std::thread writer_;
+  bool writing_ = false;
+  bool stop_ = false;
+};
+}  // namespace ge
+
+#endif  // COMMON_GRAPH_UTILS_GRAPH_DUMPER_H_
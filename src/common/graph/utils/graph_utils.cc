@@ -35,6 +35,7 @@
 #include "proto/ge_ir.pb.h"
 #include "utils/attr_utils.h"
 #include "utils/ge_ir_utils.h"
+#include "utils/graph_dumper.h"
 #include "utils/node_utils.h"
 
 using google::protobuf::io::FileOutputStream;
@@ -446,12 +447,10 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraph(cons
   file_idx++;
   GELOGD("Start to dump om txt: %d", file_idx);
 
-  static int max_dumpfile_num = 0;
-  if (max_dumpfile_num == 0) {
-    string opt = "0";
-    (void)GetContext().GetOption("ge.maxDumpFileNum", opt);
-    max_dumpfile_num = std::strtol(opt.c_str(), nullptr, kBaseOfIntegerValue);
-  }
+  // read on each dump, the options are those of the session dumping the graph
+  string opt = "0";
+  (void)GetContext().GetOption("ge.maxDumpFileNum", opt);
+  int max_dumpfile_num = std::strtol(opt.c_str(), nullptr, kBaseOfIntegerValue);
   if (max_dumpfile_num != 0 && file_idx > max_dumpfile_num) {
     GELOGW("dump graph file cnt > maxDumpFileNum, maxDumpFileCnt=%d.", max_dumpfile_num);
     return;
@@ -459,30 +458,21 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraph(cons
 
   std::stringstream stream_file_name;
   stream_file_name << "ge_proto_" << std::setw(dump_graph_index_width) << std::setfill('0') << file_idx;
-  stream_file_name << "_" << suffix << ".txt";
-  std::string proto_file = stream_file_name.str();
+  stream_file_name << "_" << suffix;
 
-  // Create buffer
+  // Take a serialized snapshot, it is printed and written by the dumper
   ge::Model model("", "");
   model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(graph)));
   Buffer buffer;
   model.Save(buffer);
-
-  // Write file
-  ge::proto::ModelDef ge_proto;
-  if (buffer.GetData() != nullptr) {
-    std::string str(reinterpret_cast<const char *>(buffer.GetData()), buffer.GetSize());
-    if (!ge_proto.ParseFromString(str)) {
-      GELOGE(GRAPH_FAILED, "parse from string failed.");
-      return;
-    }
-    char real_path[PATH_MAX] = {0x00};
-    GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(strlen(proto_file.c_str()) >= PATH_MAX, return, "file path is too longer!");
-    GE_IF_BOOL_EXEC(realpath(proto_file.c_str(), real_path) == nullptr,
-                    GELOGI("file %s does not exist, it will be created.", proto_file.c_str()));
-
-    GraphUtils::WriteProtoToTextFile(ge_proto, real_path);
+  if (buffer.GetData() == nullptr) {
+    GELOGE(GRAPH_FAILED, "Serialize graph %s failed.", stream_file_name.str().c_str());
+    return;
   }
+  std::unique_ptr<google::protobuf::Message> ge_proto(new (std::nothrow) ge::proto::ModelDef());
+  GE_CHK_BOOL_EXEC(ge_proto != nullptr, return, "New ModelDef failed.");
+  std::string snapshot(reinterpret_cast<const char *>(buffer.GetData()), buffer.GetSize());
+  GraphDumper::Instance().Dump(std::move(ge_proto), std::move(snapshot), stream_file_name.str(), ".txt");
 #else
   GELOGW("need to define FMK_SUPPORT_DUMP for dump graph.");
 #endif
@@ -602,8 +592,9 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraphToOnn
   ge::Model model("GE", "");
   std::shared_ptr<ge::ComputeGraph> compute_graph_ptr = ComGraphMakeShared<ge::ComputeGraph>(compute_graph);
   model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(compute_graph_ptr)));
-  onnx::ModelProto model_proto;
-  if (!OnnxUtils::ConvertGeModelToModelProto(model, model_proto)) {
+  std::unique_ptr<onnx::ModelProto> model_proto(new (std::nothrow) onnx::ModelProto());
+  GE_CHK_BOOL_EXEC(model_proto != nullptr, return, "New ModelProto failed.");
+  if (!OnnxUtils::ConvertGeModelToModelProto(model, *model_proto)) {
     GELOGE(GRAPH_FAILED, "DumpGEGraphToOnnx failed.");
     return;
   }
@@ -613,12 +604,10 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraphToOnn
   file_index++;
   GELOGD("Start to dump ge onnx file: %d", file_index);
 
-  static int max_dumpfile_num = 0;
-  if (max_dumpfile_num == 0) {
-    string opt = "0";
-    (void)GetContext().GetOption("ge.maxDumpFileNum", opt);
-    max_dumpfile_num = std::strtol(opt.c_str(), nullptr, kBaseOfIntegerValue);
-  }
+  // read on each dump, the options are those of the session dumping the graph
+  string opt = "0";
+  (void)GetContext().GetOption("ge.maxDumpFileNum", opt);
+  int max_dumpfile_num = std::strtol(opt.c_str(), nullptr, kBaseOfIntegerValue);
   if (max_dumpfile_num != 0 && file_index > max_dumpfile_num) {
     GELOGW("dump graph file cnt > maxDumpFileNum, maxDumpFileNum=%d.", max_dumpfile_num);
     return;
@@ -628,37 +617,21 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraphToOnn
   /// setw(5) is for formatted sort
   std::stringstream stream_file_name;
   stream_file_name << "ge_onnx_" << std::setw(5) << std::setfill('0') << file_index;
-  stream_file_name << "_" << suffix << ".pbtxt";
-  std::string proto_file = stream_file_name.str();
-  if ((proto_file.length()) >= NAME_MAX) {
+  stream_file_name << "_" << suffix;
+  if ((stream_file_name.str().length() + strlen(".pbtxt")) >= NAME_MAX) {
     GELOGE(GRAPH_FAILED, "File name is too longer!");
     return;
   }
-  std::unique_ptr<char> real_path(new (std::nothrow) char[PATH_MAX]{0});
-  if (real_path == nullptr) {
-    GELOGE(GRAPH_FAILED, "New real_path failed.");
-    return;
-  }
-  /// Returning nullptr means 3 case as follows:
-  /// a.path is PATH_MAX chars or more
-  /// b.the file does not exist
-  /// c.the path has no permissions
-  /// Distinguish between last the two cases in the function WriteProtoToTextFile call open()
-  if (realpath(proto_file.c_str(), real_path.get()) == nullptr) {
-    // For case a
-    if (errno == ENAMETOOLONG) {
-      GELOGE(GRAPH_FAILED, "Call realpath failed: path is PATH_MAX chars or more.");
-      return;
-    }
-  }
 
-  // 3. Serialize to file in current path
-  GraphUtils::WriteProtoToTextFile(model_proto, real_path.get());
+  // 3. Hand the converted message over to the dumper, it is serialized to file in current path
+  GraphDumper::Instance().Dump(std::move(model_proto), "", stream_file_name.str(), ".pbtxt");
 #else
   GELOGW("need to define FMK_SUPPORT_DUMP for dump graph.");
 #endif
 }
 
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::FlushDumpGraph() { GraphDumper::Instance().Flush(); }
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool GraphUtils::LoadGEGraphFromOnnx(const char *file,
                                                                                     ge::ComputeGraph &compute_graph) {
   if (file == nullptr) {
@@ -273,6 +273,18 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status ModelHelper::LoadModel(c
   return SUCCESS;
 }
 
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status
+ModelHelper::LoadModelLazily(const ge::ModelData &model_data, const std::shared_ptr<void> &data_owner) {
+  if (data_owner == nullptr) {
+    GELOGE(FAILED, "The owner of model data is nullptr");
+    return FAILED;
+  }
+  data_owner_ = data_owner;
+  Status ret = LoadModel(model_data);
+  data_owner_ = nullptr;
+  return ret;
+}
+
 Status ModelHelper::GenerateGeModel(OmFileLoadHelper &om_load_helper) {
   model_ = ge::MakeShared<ge::GeModel>();
   GE_CHECK_NOTNULL(model_);
@@ -326,8 +338,13 @@ Status ModelHelper::LoadWeights(OmFileLoadHelper &om_load_helper) {
     GELOGE(FAILED, "Get weight model partition failed.");
     return FAILED;
   }
-  ge::Buffer weight = ge::Buffer::CopyFrom(partition.data, partition.size);
-  model_->SetWeight(weight);
+  if (data_owner_ != nullptr) {
+    model_->SetDataOwner(data_owner_);
+    model_->SetWeightView(partition.data, partition.size);
+  } else {
+    ge::Buffer weight = ge::Buffer::CopyFrom(partition.data, partition.size);
+    model_->SetWeight(weight);
+  }
 
   GELOGI("GetWeight size:%u", partition.size);
   return SUCCESS;
@@ -339,6 +356,11 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status ModelHelper::LoadTask(Om
     GELOGE(FAILED, "Get task model partition failed.");
     return FAILED;
   }
+  if (data_owner_ != nullptr) {
+    model_->SetModelTaskDefData(task_partition.data, task_partition.size);
+    GELOGI("TASK_INFO size is %u, parsed on first use", task_partition.size);
+    return SUCCESS;
+  }
   std::shared_ptr<ModelTaskDef> task = ge::MakeShared<ModelTaskDef>();
   GE_CHECK_NOTNULL(task);
   if (task_partition.size != 0) {
@@ -356,6 +378,12 @@ Status ModelHelper::LoadTBEKernelStore(OmFileLoadHelper &om_load_helper) {
   // Load tbe kernels
   ModelPartition partition_kernel_def;
   TBEKernelStore kernel_store;
+  if (data_owner_ != nullptr) {
+    if (om_load_helper.GetModelPartition(ModelPartitionType::TBE_KERNELS, partition_kernel_def) == SUCCESS) {
+      model_->SetTBEKernelData(partition_kernel_def.data, partition_kernel_def.size);
+    }
+    return SUCCESS;
+  }
   if (om_load_helper.GetModelPartition(ModelPartitionType::TBE_KERNELS, partition_kernel_def) == SUCCESS) {
     GELOGI("Kernels partition size:%u", partition_kernel_def.size);
     if (kernel_store.Load(partition_kernel_def.data, partition_kernel_def.size)) {
@@ -462,6 +490,7 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status ModelHelper::TransGeMode
     return FAILED;
   }
   // Copy task info
+  GE_CHK_STATUS_RET(ge_model->LoadModelTaskDef(), "Load model task def failed!");
   std::shared_ptr<ModelTaskDef> model_task = ge_model->GetModelTaskDefPtr();
 
   if (model_task != nullptr) {
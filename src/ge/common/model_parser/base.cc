@@ -16,8 +16,12 @@
 
 #include "common/model_parser/base.h"
 
+#include <fcntl.h>
 #include <securec.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/sysinfo.h>
+#include <unistd.h>
 #include <fstream>
 #include <memory>
 #include <string>
@@ -107,4 +111,54 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status ModelParserBase::ParseMo
 
   return res;
 }
+
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY MappedModelFile::~MappedModelFile() { Unmap(); }
+
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status MappedModelFile::Map(const char *model_path,
+                                                                             int32_t priority) {
+  GE_CHECK_NOTNULL(model_path);
+  std::string real_path = RealPath(model_path);
+  if (real_path.empty()) {
+    GELOGE(PARAM_INVALID, "Model file path '%s' is invalid", model_path);
+    return PARAM_INVALID;
+  }
+
+  int fd = open(real_path.c_str(), O_RDONLY);
+  GE_CHK_BOOL_RET_STATUS(fd >= 0, FAILED, "Open file failed! path:%s", model_path);
+  struct stat file_stat;
+  if ((fstat(fd, &file_stat) != 0) || (file_stat.st_size < 1) ||
+      (static_cast<uint64_t>(file_stat.st_size) > UINT32_MAX)) {
+    GELOGE(FAILED, "File size not valid, path:%s", model_path);
+    (void)close(fd);
+    return FAILED;
+  }
+
+  // private and writable, the pages stay the ones of the file until they are written
+  size_t len = static_cast<size_t>(file_stat.st_size);
+  void *addr = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  // the mapping keeps the file, no need to keep the fd
+  (void)close(fd);
+  if (addr == MAP_FAILED) {
+    GELOGE(MEMALLOC_FAILED, "Map model file failed, path:%s, size:%zu", model_path, len);
+    return MEMALLOC_FAILED;
+  }
+
+  Unmap();
+  mapped_len_ = len;
+  model_data_.model_data = addr;
+  model_data_.model_len = static_cast<uint32_t>(len);
+  model_data_.priority = priority;
+  model_data_.key = "";
+  GELOGI("Map model file %s, size:%zu", model_path, len);
+  return SUCCESS;
+}
+
+void MappedModelFile::Unmap() {
+  if (model_data_.model_data != nullptr) {
+    (void)munmap(model_data_.model_data, mapped_len_);
+    model_data_.model_data = nullptr;
+    model_data_.model_len = 0;
+    mapped_len_ = 0;
+  }
+}
 }  // namespace ge
@@ -18,6 +18,7 @@
 #define GE_COMMON_MODEL_PARSER_BASE_H_
 
 #include <memory>
+#include <string>
 
 #include "framework/common/debug/log.h"
 #include "framework/common/ge_types.h"
@@ -63,5 +64,37 @@ class ModelParserBase {
   ///
   static Status ParseModelContent(const ge::ModelData &model, uint8_t *&model_data, uint32_t &model_len);
 };
+
+///
+/// @ingroup domi_ome
+/// @brief Model file mapped into memory instead of read, the pages are only loaded when they are touched.
+/// The model data is valid as long as the object lives, it must not be deleted by the user.
+/// The file must not be truncated or rewritten meanwhile, reading a page cut from the file raises SIGBUS.
+///
+class MappedModelFile {
+ public:
+  MappedModelFile() = default;
+  ~MappedModelFile();
+
+  MappedModelFile(const MappedModelFile &) = delete;
+  MappedModelFile &operator=(const MappedModelFile &) = delete;
+
+  ///
+  /// @ingroup domi_ome
+  /// @brief Map a model file
+  /// @param [in] model_file  model path
+  /// @param [in] priority    model priority
+  /// @return Status  result
+  ///
+  Status Map(const char *model_file, int32_t priority);
+
+  const ge::ModelData &GetModelData() const { return model_data_; }
+
+ private:
+  void Unmap();
+
+  ge::ModelData model_data_;
+  size_t mapped_len_ = 0;
+};
 }  //  namespace ge
 #endif  // GE_COMMON_MODEL_PARSER_BASE_H_
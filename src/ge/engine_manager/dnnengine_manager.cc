@@ -19,13 +19,16 @@
 #include <unistd.h>
 #include <cstdio>
 #include <fstream>
+#include <future>
 #include <map>
 #include <utility>
 
 #include "common/debug/log.h"
 #include "common/ge/ge_util.h"
+#include "common/thread_pool.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/ge_context.h"
+#include "graph/ge_local_context.h"
 #include "init/gelib.h"
 
 namespace {
@@ -40,6 +43,25 @@ const char *const kAttch = "attach";
 const char *const kVectorEngine = "VectorEngine";
 const char *const kAIcoreEngine = "AIcoreEngine";
 const char *const kCustomOpFlag = "_custom_op_flag";
+// with PARALLEL_ENGINE_PLACE, ops of signatures not placed yet are checked on a worker pool when there are at least
+// so many of them
+const size_t kMinParallelPlaceNum = 8;
+const uint32_t kMaxPlaceThreadNum = 16;
+
+std::string GetCoreTypeOption() {
+  std::string ge_core_type;
+  ge::Status ret = ge::GetContext().GetOption(ge::CORE_TYPE, ge_core_type);
+  if (ret != ge::SUCCESS) {
+    GELOGD("get the option CORE_TYPE fail, set it to default value VECTOR_ENGINE");
+  }
+  return ge_core_type;
+}
+
+bool GetParallelPlaceOption() {
+  std::string parallel_place;
+  return (ge::GetContext().GetOption(ge::PARALLEL_ENGINE_PLACE, parallel_place) == ge::SUCCESS) &&
+         (parallel_place == "1");
+}
 }  // namespace
 
 namespace ge {
@@ -47,6 +69,7 @@ DNNEngineManager::DNNEngineManager() : init_flag_(false) {}
 DNNEngineManager::~DNNEngineManager() {
   engines_attrs_map_.clear();
   schedulers_.clear();
+  ClearPlacementCache();
 }
 
 Status DNNEngineManager::Initialize(const std::map<std::string, std::string> &options) {
@@ -55,6 +78,7 @@ Status DNNEngineManager::Initialize(const std::map<std::string, std::string> &op
     GELOGW("DNNEngineManager has been initialized.");
     return SUCCESS;
   }
+  ClearPlacementCache();
 
   // Load engine so
   std::string so_path = "plugin/nnengine/";
@@ -138,6 +162,9 @@ Status DNNEngineManager::Finalize() {
   }
   init_flag_ = false;
   engines_map_.clear();
+  ClearPlacementCache();
+  std::lock_guard<std::mutex> lock(place_pool_mutex_);
+  place_pool_.reset();
   return SUCCESS;
 }
 
@@ -171,18 +198,151 @@ std::string DNNEngineManager::GetDNNEngineName(const OpDescPtr &op_desc) const {
     GELOGE(GE_CLI_GE_NOT_INITIALIZED, "GetDNNEngineName failed.");
     return "";
   }
-  OpsKernelManager &ops_kernel_manager = instance_ptr->OpsKernelManagerObj();
-  std::vector<OpInfo> op_infos = ops_kernel_manager.GetOpsKernelInfo(op_desc->GetType());
+  return GetDNNEngineName(op_desc, GetCoreTypeOption(), instance_ptr->OpsKernelManagerObj());
+}
+
+Status DNNEngineManager::GetDNNEngineNames(const std::vector<OpDescPtr> &op_descs,
+                                           std::vector<std::string> &engine_names) const {
+  std::shared_ptr<GELib> instance_ptr = ge::GELib::GetInstance();
+  if ((instance_ptr == nullptr) || (!instance_ptr->InitFlag())) {
+    GELOGE(GE_CLI_GE_NOT_INITIALIZED, "GetDNNEngineNames failed.");
+    return GE_CLI_GE_NOT_INITIALIZED;
+  }
+  // options are thread local, they are read on the calling thread
+  return GetDNNEngineNames(op_descs, GetCoreTypeOption(), GetParallelPlaceOption(),
+                           instance_ptr->OpsKernelManagerObj(), engine_names);
+}
+
+void DNNEngineManager::ClearPlacementCache() const {
+  std::lock_guard<std::mutex> lock(placement_mutex_);
+  placement_cache_.clear();
+}
+
+std::string DNNEngineManager::GetPlacementKey(const OpDescPtr &op_desc, const std::string &core_type) {
+  std::string key = core_type + ":" + op_desc->GetType();
+  auto append_tensors = [&key](const OpDesc::Vistor<GeTensorDescPtr> &tensor_descs) {
+    key += "|";
+    for (const auto &tensor_desc : tensor_descs) {
+      if (tensor_desc == nullptr) {
+        key += "-;";
+        continue;
+      }
+      key += std::to_string(static_cast<int>(tensor_desc->GetDataType())) + "," +
+             std::to_string(static_cast<int>(tensor_desc->GetFormat())) + "," +
+             std::to_string(tensor_desc->MutableShape().GetDimNum()) + ";";
+    }
+  };
+  append_tensors(op_desc->GetAllInputsDescPtr());
+  append_tensors(op_desc->GetAllOutputsDescPtr());
+  return key;
+}
+
+std::string DNNEngineManager::GetDNNEngineName(const OpDescPtr &op_desc, const std::string &core_type,
+                                               OpsKernelManager &ops_kernel_manager) const {
+  if (op_desc == nullptr) {
+    GELOGE(GE_CLI_GE_NOT_INITIALIZED, "DNNEngineManager: op_desc is nullptr");
+    return "";
+  }
+  return PlaceOp(op_desc, GetPlacementKey(op_desc, core_type), core_type, ops_kernel_manager);
+}
+
+std::string DNNEngineManager::PlaceOp(const OpDescPtr &op_desc, const std::string &key, const std::string &core_type,
+                                      OpsKernelManager &ops_kernel_manager) const {
+  {
+    std::lock_guard<std::mutex> lock(placement_mutex_);
+    auto iter = placement_cache_.find(key);
+    if (iter != placement_cache_.end()) {
+      op_desc->SetOpEngineName(iter->second.engine_name);
+      op_desc->SetOpKernelLibName(iter->second.kernel_lib_name);
+      GELOGD("DNNEngineManager:Set cached OpKernelLibName %s and engine name %s into op_desc %s",
+             iter->second.kernel_lib_name.c_str(), iter->second.engine_name.c_str(), op_desc->GetName().c_str());
+      return iter->second.engine_name;
+    }
+  }
+
+  std::string engine_name = CheckSupportedEngine(op_desc, core_type, ops_kernel_manager);
+  if (!engine_name.empty()) {
+    std::lock_guard<std::mutex> lock(placement_mutex_);
+    placement_cache_.emplace(key, OpPlacement{engine_name, op_desc->GetOpKernelLibName()});
+  }
+  return engine_name;
+}
+
+Status DNNEngineManager::GetDNNEngineNames(const std::vector<OpDescPtr> &op_descs, const std::string &core_type,
+                                           bool parallel, OpsKernelManager &ops_kernel_manager,
+                                           std::vector<std::string> &engine_names) const {
+  engine_names.assign(op_descs.size(), "");
+  // the first op of each signature not placed yet is checked, the others of it hit the cache afterwards
+  std::vector<size_t> first_ops;
+  std::vector<std::string> keys(op_descs.size());
+  std::unordered_map<std::string, size_t> signatures;
+  {
+    std::lock_guard<std::mutex> lock(placement_mutex_);
+    for (size_t i = 0; i < op_descs.size(); ++i) {
+      GE_CHECK_NOTNULL(op_descs[i]);
+      keys[i] = GetPlacementKey(op_descs[i], core_type);
+      if ((placement_cache_.count(keys[i]) == 0) && signatures.emplace(keys[i], i).second) {
+        first_ops.emplace_back(i);
+      }
+    }
+  }
+  GELOGD("Place %zu ops, %zu of them by check support.", op_descs.size(), first_ops.size());
+
+  ThreadPool *executor = (parallel && (first_ops.size() >= kMinParallelPlaceNum)) ? GetPlacePool() : nullptr;
+  if (executor != nullptr) {
+    // the stores may read the options in CheckSupported, the workers take the context of the calling thread
+    const GEThreadLocalContext &context = GetThreadLocalContext();
+    std::vector<std::future<std::string>> futures;
+    for (size_t index : first_ops) {
+      futures.emplace_back(executor->commit(
+          [this, &core_type, &ops_kernel_manager, &context](const OpDescPtr &op_desc,
+                                                            const std::string &key) -> std::string {
+            GetThreadLocalContext() = context;
+            return PlaceOp(op_desc, key, core_type, ops_kernel_manager);
+          },
+          op_descs[index], keys[index]));
+    }
+    for (size_t i = 0; i < futures.size(); ++i) {
+      engine_names[first_ops[i]] = futures[i].get();
+    }
+  } else {
+    for (size_t index : first_ops) {
+      engine_names[index] = PlaceOp(op_descs[index], keys[index], core_type, ops_kernel_manager);
+    }
+  }
+
+  for (size_t i = 0; i < op_descs.size(); ++i) {
+    auto iter = signatures.find(keys[i]);
+    if ((iter == signatures.end()) || (iter->second != i)) {
+      engine_names[i] = PlaceOp(op_descs[i], keys[i], core_type, ops_kernel_manager);
+    }
+  }
+  return SUCCESS;
+}
+
+ThreadPool *DNNEngineManager::GetPlacePool() const {
+  std::lock_guard<std::mutex> lock(place_pool_mutex_);
+  if (place_pool_ == nullptr) {
+    place_pool_.reset(new (std::nothrow) ThreadPool(kMaxPlaceThreadNum));
+    if (place_pool_ == nullptr) {
+      GELOGW("Create thread pool for placement failed, place ops serially.");
+    }
+  }
+  return place_pool_.get();
+}
+
+std::string DNNEngineManager::CheckSupportedEngine(const OpDescPtr &op_desc, const std::string &core_type,
+                                                   OpsKernelManager &ops_kernel_manager) const {
+  std::vector<OpInfo> op_infos;
+  {
+    std::lock_guard<std::mutex> lock(ops_kernel_info_mutex_);
+    op_infos = ops_kernel_manager.GetOpsKernelInfo(op_desc->GetType());
+  }
   if (op_infos.empty()) {
     GELOGI("DNNEngineManager: Can not get op info by op type %s", op_desc->GetType().c_str());
     return "";
   }
-  string ge_core_type;
-  Status ret = ge::GetContext().GetOption(ge::CORE_TYPE, ge_core_type);
-  if (ret != SUCCESS) {
-    GELOGD("get the option CORE_TYPE fail, set it to default value VECTOR_ENGINE");
-  }
-  string exclude_core_Type = (ge_core_type == kVectorEngine) ? kAIcoreEngine : kVectorEngine;
+  string exclude_core_Type = (core_type == kVectorEngine) ? kAIcoreEngine : kVectorEngine;
   GELOGD("engine type will exclude: %s", exclude_core_Type.c_str());
   std::map<std::string, std::string> unsupported_reasons;
   for (const auto &it : op_infos) {
@@ -19,7 +19,9 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "nlohmann/json.hpp"
@@ -55,6 +57,9 @@ struct SchedulerConf {
 
 using DNNEnginePtr = std::shared_ptr<DNNEngine>;
 
+class OpsKernelManager;
+class ThreadPool;
+
 class DNNEngineManager {
  public:
   friend class GELib;
@@ -62,9 +67,28 @@ class DNNEngineManager {
   bool IsEngineRegistered(const std::string &name) const;
   // If can't find appropriate engine name, return "", report error
   string GetDNNEngineName(const OpDescPtr &op_desc) const;
+  // Place a batch of ops, engine_names[i] is the engine of op_descs[i] or "" if it can't be placed
+  Status GetDNNEngineNames(const vector<OpDescPtr> &op_descs, vector<string> &engine_names) const;
+  // Forget the placements, they are cached by op type and input/output signature
+  void ClearPlacementCache() const;
   const map<string, SchedulerConf> &GetSchedulers() const;
 
  private:
+  struct OpPlacement {
+    string engine_name;
+    string kernel_lib_name;
+  };
+
+  string GetDNNEngineName(const OpDescPtr &op_desc, const string &core_type,
+                          OpsKernelManager &ops_kernel_manager) const;
+  string PlaceOp(const OpDescPtr &op_desc, const string &key, const string &core_type,
+                 OpsKernelManager &ops_kernel_manager) const;
+  Status GetDNNEngineNames(const vector<OpDescPtr> &op_descs, const string &core_type, bool parallel,
+                           OpsKernelManager &ops_kernel_manager, vector<string> &engine_names) const;
+  ThreadPool *GetPlacePool() const;
+  string CheckSupportedEngine(const OpDescPtr &op_desc, const string &core_type,
+                              OpsKernelManager &ops_kernel_manager) const;
+  static string GetPlacementKey(const OpDescPtr &op_desc, const string &core_type);
   DNNEngineManager();
   ~DNNEngineManager();
   Status Initialize(const std::map<std::string, std::string> &options);
@@ -79,6 +103,14 @@ class DNNEngineManager {
   std::map<std::string, ge::DNNEngineAttribute> engines_attrs_map_;
   std::map<string, SchedulerConf> schedulers_;
   bool init_flag_;
+  // placement of op type and signature under a core type, only successful ones are kept
+  mutable std::mutex placement_mutex_;
+  mutable std::unordered_map<string, OpPlacement> placement_cache_;
+  // ops kernel info of an unknown type is rebuilt by OpsKernelManager, which is not thread safe
+  mutable std::mutex ops_kernel_info_mutex_;
+  // workers of the parallel placement, created on first use and kept until finalized
+  mutable std::mutex place_pool_mutex_;
+  mutable std::unique_ptr<ThreadPool> place_pool_;
 };
 }  // namespace ge
 
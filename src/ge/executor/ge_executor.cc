@@ -480,6 +480,24 @@ Status GeExecutor::ExecuteAsync(SingleOp *executor, const std::vector<DataBuffer
   return executor->ExecuteAsync(inputs, outputs);
 }
 
+Status GeExecutor::LoadDynamicSingleOp(const std::string &model_name,
+                                       const ge::ModelData &model_data,
+                                       void *stream,
+                                       DynamicSingleOp **single_op) {
+  return SingleOpManager::GetInstance().GetDynamicOpFromModel(model_name, model_data, stream, single_op);
+}
+
+Status GeExecutor::ExecuteAsync(DynamicSingleOp *executor, const std::vector<GeTensorDesc> &input_desc,
+                                const std::vector<DataBuffer> &inputs, std::vector<GeTensorDesc> &output_desc,
+                                std::vector<DataBuffer> &outputs) {
+  if (executor == nullptr) {
+    GELOGE(PARAM_INVALID, "param is NULL");
+    return PARAM_INVALID;
+  }
+
+  return executor->ExecuteAsync(input_desc, inputs, output_desc, outputs);
+}
+
 Status GeExecutor::ReleaseSingleOpResource(void *stream) {
   return SingleOpManager::GetInstance().ReleaseResource(stream);
 }
@@ -16,6 +16,7 @@
 
 #include "ge_runtime/runtime_model.h"
 
+#include <algorithm>
 #include <set>
 
 #include "./model_context.h"
@@ -31,12 +32,22 @@
 
 namespace ge {
 namespace model_runner {
+namespace {
+const uint32_t kStagingSlotNum = 4;
+const uint32_t kStagingSlotSize = 2 * 1024 * 1024;
+}  // namespace
+
 RuntimeModel::~RuntimeModel() {
   GELOGI("RuntimeModel destructor start");
 
   // Release task first, hccl task hold stream
   task_list_.clear();
 
+  // Wait for the input copies in flight before their stream and buffers are released
+  staging_ring_.Release();
+  trans_staging_.Release();
+  DestroyChunkTensorDesc();
+
   // Unbind rtModel from all task related streams
   RtModelUnbindStream();
 
@@ -395,6 +406,12 @@ bool RuntimeModel::CopyInputData(const InputData &input_data) {
     return false;
   }
 
+  // The slots are allocated by the first run and reused by the later ones
+  if (!staging_ring_.Init(kStagingSlotNum, kStagingSlotSize)) {
+    GELOGE(FAILED, "Init staging ring failed, model id: %u", input_data.model_id);
+    return false;
+  }
+
   for (const auto &data_info : data_info_list_) {
     if (data_info == nullptr) {
       GELOGE(PARAM_INVALID, "data info is null.");
@@ -455,7 +472,7 @@ bool RuntimeModel::CopyInputDataToModel(const std::vector<DataBuffer> &data, con
   }
 }
 
-bool RuntimeModel::CopyHostData(const std::vector<DataBuffer> &data, const std::shared_ptr<OpInfo> &data_info) const {
+bool RuntimeModel::CopyHostData(const std::vector<DataBuffer> &data, const std::shared_ptr<OpInfo> &data_info) {
   GELOGI("Start CopyHostData.");
   if (data.empty()) {
     GELOGE(PARAM_INVALID, "data buffer is empty.");
@@ -467,7 +484,7 @@ bool RuntimeModel::CopyHostData(const std::vector<DataBuffer> &data, const std::
     return false;
   }
 
-  void *host_data_addr = data[data_info->index].data;
+  const uint8_t *host_data_addr = reinterpret_cast<const uint8_t *>(data[data_info->index].data);
   uint32_t copy_size = data[data_info->index].length;
   GELOGD("data output tensor is aipp tensor,copy data only.");
 
@@ -477,13 +494,24 @@ bool RuntimeModel::CopyHostData(const std::vector<DataBuffer> &data, const std::
     return false;
   }
 
-  // Copy input data to data nodes
-  void *data_out_addr = reinterpret_cast<void *>(outputs[0]);
-
-  rtError_t rt_ret = rtMemcpy(data_out_addr, copy_size, host_data_addr, copy_size, RT_MEMCPY_HOST_TO_DEVICE);
-  if (rt_ret != RT_ERROR_NONE) {
-    GELOGE(RT_FAILED, "Call rt api failed, ret: 0x%X", rt_ret);
-    return false;
+  // Copy input data to data nodes through the pinned slots, the caller may free its buffer once this returns
+  uint8_t *data_out_addr = reinterpret_cast<uint8_t *>(outputs[0]);
+  uint32_t slot_size = staging_ring_.GetSlotSize();
+  for (uint32_t offset = 0; offset < copy_size; offset += slot_size) {
+    uint32_t chunk_size = std::min(slot_size, copy_size - offset);
+    void *staging_addr = nullptr;
+    if (!staging_ring_.Acquire(staging_addr)) {
+      GELOGE(FAILED, "Acquire staging buffer failed, data info: %s.", data_info->name.c_str());
+      return false;
+    }
+    if (memcpy_s(staging_addr, slot_size, host_data_addr + offset, chunk_size) != EOK) {
+      GELOGE(FAILED, "Copy input data to staging buffer failed, size: %u.", chunk_size);
+      return false;
+    }
+    if (!staging_ring_.Submit(data_out_addr + offset, copy_size - offset, chunk_size, rt_model_stream_)) {
+      GELOGE(FAILED, "Copy staging buffer to data node failed, data info: %s.", data_info->name.c_str());
+      return false;
+    }
   }
 
   return true;
@@ -512,13 +540,32 @@ bool RuntimeModel::CopyTransData(const std::vector<DataBuffer> &data, const std:
     return false;
   }
 
-  void *fp16_data_addr = nullptr;
-  uint32_t copy_size = data_info->output_tensors[0].size;
-  GE_MAKE_GUARD_RTMEM(fp16_data_addr);
+  // A cast keeping the format and dims converts each element alone, so that it could be done by chunk
+  const TensorInfo &input_tensor = data_info->input_tensors[0];
+  const TensorInfo &output_tensor = data_info->output_tensors[0];
+  int64_t element_num = output_tensor.GetShapeSize();
+  int input_type_size = GetSizeByDataType(static_cast<DataType>(input_tensor.datatype));
+  int output_type_size = GetSizeByDataType(static_cast<DataType>(output_tensor.datatype));
+  bool by_chunk = (input_tensor.format == output_tensor.format) && (input_tensor.dims == output_tensor.dims) &&
+                  (input_type_size > 0) && (output_type_size > 0) && (element_num > 0) &&
+                  (element_num * input_type_size <= static_cast<int64_t>(data[data_info->index].length)) &&
+                  (element_num * output_type_size <= static_cast<int64_t>(output_tensor.size)) &&
+                  (static_cast<uint32_t>(output_type_size) <= staging_ring_.GetSlotSize());
+  if (by_chunk) {
+    return CopyTransDataByChunk(data[data_info->index], data_info, static_cast<uint32_t>(element_num));
+  }
 
-  rtError_t rt_ret = rtMallocHost(&fp16_data_addr, copy_size);
-  if (rt_ret != RT_ERROR_NONE) {
-    GELOGE(RT_FAILED, "Call rt api failed, ret: 0x%X", rt_ret);
+  uint32_t copy_size = output_tensor.size;
+  if (!trans_staging_.IsInited() || trans_staging_.GetSlotSize() < copy_size) {
+    trans_staging_.Release();
+    if (!trans_staging_.Init(1, copy_size)) {
+      GELOGE(FAILED, "Init trans staging buffer failed, size: %u.", copy_size);
+      return false;
+    }
+  }
+  void *fp16_data_addr = nullptr;
+  if (!trans_staging_.Acquire(fp16_data_addr)) {
+    GELOGE(FAILED, "Acquire trans staging buffer failed.");
     return false;
   }
 
@@ -528,21 +575,98 @@ bool RuntimeModel::CopyTransData(const std::vector<DataBuffer> &data, const std:
     GELOGE(CCE_FAILED, "Call cce api failed, ret: 0x%X", cc_ret);
     return false;
   }
-  void *host_data_addr = fp16_data_addr;
 
   GELOGI("data output tensor is not aipp tensor,call cce trans tensor.");
   GELOGI("output[0]=%ld, copy_size=%u", outputs[0], copy_size);
 
-  rt_ret = rtMemcpy(reinterpret_cast<void *>(outputs[0]), copy_size, host_data_addr, copy_size,
-                    RT_MEMCPY_HOST_TO_DEVICE);
-  if (rt_ret != RT_ERROR_NONE) {
-    GELOGE(RT_FAILED, "Call rt api failed, ret: 0x%X", rt_ret);
+  if (!trans_staging_.Submit(reinterpret_cast<void *>(outputs[0]), copy_size, copy_size, rt_model_stream_)) {
+    GELOGE(FAILED, "Copy trans staging buffer to data node failed, data info: %s.", data_info->name.c_str());
     return false;
   }
 
   return true;
 }
 
+bool RuntimeModel::CopyTransDataByChunk(const DataBuffer &data, const std::shared_ptr<OpInfo> &data_info,
+                                        uint32_t element_num) {
+  auto input_type_size = static_cast<uint32_t>(GetSizeByDataType(
+      static_cast<DataType>(data_info->input_tensors[0].datatype)));
+  auto output_type_size = static_cast<uint32_t>(GetSizeByDataType(
+      static_cast<DataType>(data_info->output_tensors[0].datatype)));
+  uint32_t chunk_element_num = staging_ring_.GetSlotSize() / output_type_size;
+  const uint8_t *src_addr = reinterpret_cast<const uint8_t *>(data.data);
+  uint8_t *dst_addr = reinterpret_cast<uint8_t *>(data_info->output_addrs[0]);
+  uint64_t dst_size = static_cast<uint64_t>(element_num) * output_type_size;
+  GELOGI("Trans data %s by chunk, element num: %u, chunk element num: %u.", data_info->name.c_str(), element_num,
+         chunk_element_num);
+
+  // The chunk converted on the host overlaps the copy of the previous chunk in flight on the model stream
+  for (uint32_t offset = 0; offset < element_num; offset += chunk_element_num) {
+    uint32_t num = std::min(chunk_element_num, element_num - offset);
+    cce::ccTensorDescriptor_t input_desc = nullptr;
+    cce::ccTensorDescriptor_t output_desc = nullptr;
+    if (!GetChunkTensorDesc(data_info, num, input_desc, output_desc)) {
+      return false;
+    }
+    void *staging_addr = nullptr;
+    if (!staging_ring_.Acquire(staging_addr)) {
+      GELOGE(FAILED, "Acquire staging buffer failed, data info: %s.", data_info->name.c_str());
+      return false;
+    }
+    uint64_t chunk_size = static_cast<uint64_t>(num) * output_type_size;
+    cce::ccStatus_t cc_ret = cce::ccTransTensor(input_desc, src_addr + static_cast<uint64_t>(offset) * input_type_size,
+                                                output_desc, staging_addr, static_cast<uint32_t>(chunk_size));
+    if (cc_ret != cce::CC_STATUS_SUCCESS) {
+      GELOGE(CCE_FAILED, "Call cce api failed, ret: 0x%X", cc_ret);
+      return false;
+    }
+    uint64_t dst_offset = static_cast<uint64_t>(offset) * output_type_size;
+    if (!staging_ring_.Submit(dst_addr + dst_offset, dst_size - dst_offset, chunk_size, rt_model_stream_)) {
+      GELOGE(FAILED, "Copy staging buffer to data node failed, data info: %s.", data_info->name.c_str());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool RuntimeModel::GetChunkTensorDesc(const std::shared_ptr<OpInfo> &data_info, uint32_t element_num,
+                                      cce::ccTensorDescriptor_t &input_desc, cce::ccTensorDescriptor_t &output_desc) {
+  auto &chunk_descs = chunk_tensor_desc_list_[data_info->name];
+  auto iter = chunk_descs.find(element_num);
+  if (iter != chunk_descs.end()) {
+    input_desc = iter->second.first;
+    output_desc = iter->second.second;
+    return true;
+  }
+
+  std::vector<int64_t> dims = {static_cast<int64_t>(element_num)};
+  const uint32_t format = static_cast<uint32_t>(cce::CC_TENSOR_ND);
+  if (!OpInfoUtils::InitTensorDescriptor(format, data_info->input_tensors[0].datatype, dims, input_desc)) {
+    GELOGE(FAILED, "Init chunk input tensor descriptor failed, element num: %u.", element_num);
+    OpInfoUtils::DestroyTensorDescriptor(input_desc);
+    return false;
+  }
+  if (!OpInfoUtils::InitTensorDescriptor(format, data_info->output_tensors[0].datatype, dims, output_desc)) {
+    GELOGE(FAILED, "Init chunk output tensor descriptor failed, element num: %u.", element_num);
+    OpInfoUtils::DestroyTensorDescriptor(input_desc);
+    OpInfoUtils::DestroyTensorDescriptor(output_desc);
+    return false;
+  }
+  chunk_descs[element_num] = std::make_pair(input_desc, output_desc);
+  return true;
+}
+
+void RuntimeModel::DestroyChunkTensorDesc() noexcept {
+  for (auto &name_to_descs : chunk_tensor_desc_list_) {
+    for (auto &num_to_desc : name_to_descs.second) {
+      OpInfoUtils::DestroyTensorDescriptor(num_to_desc.second.first);
+      OpInfoUtils::DestroyTensorDescriptor(num_to_desc.second.second);
+    }
+  }
+  chunk_tensor_desc_list_.clear();
+}
+
 bool RuntimeModel::InitConstantInfo(std::shared_ptr<DavinciModel> &davinci_model) {
   // Const no input, only 1 output, and this output has no data
   // weight data copy to output mem
@@ -24,6 +24,7 @@
 
 #include "cce/dnn_base_def.hpp"
 #include "ge_runtime/davinci_model.h"
+#include "ge_runtime/staging_ring.h"
 #include "common/ge_types.h"
 #include "runtime/base.h"
 #include "runtime/rt_model.h"
@@ -63,8 +64,12 @@ class RuntimeModel {
   void RtLabelDestroy() noexcept;
   void RtEventDestroy() noexcept;
   bool CopyInputDataToModel(const std::vector<DataBuffer> &data, const std::shared_ptr<OpInfo> &data_info);
-  bool CopyHostData(const std::vector<DataBuffer> &data, const std::shared_ptr<OpInfo> &data_info) const;
+  bool CopyHostData(const std::vector<DataBuffer> &data, const std::shared_ptr<OpInfo> &data_info);
   bool CopyTransData(const std::vector<DataBuffer> &data, const std::shared_ptr<OpInfo> &data_info);
+  bool CopyTransDataByChunk(const DataBuffer &data, const std::shared_ptr<OpInfo> &data_info, uint32_t element_num);
+  bool GetChunkTensorDesc(const std::shared_ptr<OpInfo> &data_info, uint32_t element_num,
+                          cce::ccTensorDescriptor_t &input_desc, cce::ccTensorDescriptor_t &output_desc);
+  void DestroyChunkTensorDesc() noexcept;
   bool GetInputDescInfo(std::vector<InputOutputDescInfo> *input_desc, std::vector<uint32_t> *formats);
   bool GetOutputDescInfo(std::vector<InputOutputDescInfo> *output_desc, std::vector<uint32_t> *formats);
   void CreateOutput(uint32_t index, const OpInfo &op_info, InputOutputDescInfo *output, uint32_t *format);
@@ -82,6 +87,13 @@ class RuntimeModel {
   std::vector<std::shared_ptr<OpInfo>> constant_info_list_{};
   std::map<std::string, cce::ccTensorDescriptor_t> input_tensor_desc_list_{};
   std::map<std::string, cce::ccTensorDescriptor_t> output_tensor_desc_list_{};
+  // 1-D descs of the chunks of the inputs cast by chunk, by data op name and element number of the chunk
+  std::map<std::string, std::map<uint32_t, std::pair<cce::ccTensorDescriptor_t, cce::ccTensorDescriptor_t>>>
+      chunk_tensor_desc_list_{};
+
+  // pinned slots staging the inputs by chunk, and one slot of the largest input converted as a whole
+  StagingRing staging_ring_;
+  StagingRing trans_staging_;
 
   std::vector<uint32_t> task_id_list_{};
 };
@@ -0,0 +1,132 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ge_runtime/staging_ring.h"
+
+#include "common/ge_inner_error_codes.h"
+#include "framework/common/debug/ge_log.h"
+#include "runtime/event.h"
+#include "runtime/mem.h"
+#include "runtime/stream.h"
+
+namespace ge {
+namespace model_runner {
+StagingRing::~StagingRing() { Release(); }
+
+bool StagingRing::Init(uint32_t slot_num, uint32_t slot_size) {
+  if (IsInited()) {
+    return true;
+  }
+  if (slot_num == 0 || slot_size == 0) {
+    GELOGE(PARAM_INVALID, "Invalid staging ring, slot num %u, slot size %u.", slot_num, slot_size);
+    return false;
+  }
+
+  slot_size_ = slot_size;
+  for (uint32_t i = 0; i < slot_num; ++i) {
+    Slot slot;
+    rtError_t rt_ret = rtMallocHost(&slot.buffer, slot_size);
+    if (rt_ret != RT_ERROR_NONE) {
+      GELOGE(RT_FAILED, "Call rt api rtMallocHost failed, size: %u, ret: 0x%X", slot_size, rt_ret);
+      Release();
+      return false;
+    }
+    rt_ret = rtEventCreate(&slot.event);
+    if (rt_ret != RT_ERROR_NONE) {
+      GELOGE(RT_FAILED, "Call rt api rtEventCreate failed, ret: 0x%X", rt_ret);
+      (void)rtFreeHost(slot.buffer);
+      Release();
+      return false;
+    }
+    slots_.emplace_back(slot);
+  }
+  GELOGI("Staging ring inited, slot num: %u, slot size: %u.", slot_num, slot_size);
+  return true;
+}
+
+bool StagingRing::WaitSlot(Slot &slot) {
+  if (!slot.in_flight) {
+    return true;
+  }
+  rtError_t rt_ret = rtEventSynchronize(slot.event);
+  if (rt_ret != RT_ERROR_NONE) {
+    GELOGE(RT_FAILED, "Call rt api rtEventSynchronize failed, ret: 0x%X", rt_ret);
+    return false;
+  }
+  slot.in_flight = false;
+  return true;
+}
+
+bool StagingRing::Acquire(void *&buffer) {
+  if (!IsInited()) {
+    GELOGE(FAILED, "Staging ring is not inited.");
+    return false;
+  }
+  Slot &slot = slots_[next_slot_];
+  if (!WaitSlot(slot)) {
+    return false;
+  }
+  buffer = slot.buffer;
+  return true;
+}
+
+bool StagingRing::Submit(void *dst, uint64_t dst_max, uint64_t size, rtStream_t stream) {
+  if (!IsInited() || size > slot_size_) {
+    GELOGE(PARAM_INVALID, "Invalid staging copy, size: %lu, slot size: %u.", size, slot_size_);
+    return false;
+  }
+  Slot &slot = slots_[next_slot_];
+  rtError_t rt_ret = rtMemcpyAsync(dst, dst_max, slot.buffer, size, RT_MEMCPY_HOST_TO_DEVICE, stream);
+  if (rt_ret != RT_ERROR_NONE) {
+    GELOGE(RT_FAILED, "Call rt api rtMemcpyAsync failed, size: %lu, ret: 0x%X", size, rt_ret);
+    return false;
+  }
+  rt_ret = rtEventRecord(slot.event, stream);
+  if (rt_ret != RT_ERROR_NONE) {
+    // the copy could not be tracked, wait for it right here
+    GELOGE(RT_FAILED, "Call rt api rtEventRecord failed, ret: 0x%X", rt_ret);
+    (void)rtStreamSynchronize(stream);
+    return false;
+  }
+  slot.in_flight = true;
+  next_slot_ = (next_slot_ + 1) % slots_.size();
+  return true;
+}
+
+bool StagingRing::Synchronize() {
+  bool ret = true;
+  for (auto &slot : slots_) {
+    ret = WaitSlot(slot) && ret;
+  }
+  return ret;
+}
+
+void StagingRing::Release() noexcept {
+  (void)Synchronize();
+  for (auto &slot : slots_) {
+    if (slot.event != nullptr && rtEventDestroy(slot.event) != RT_ERROR_NONE) {
+      GELOGW("Destroy staging event failed.");
+    }
+    if (slot.buffer != nullptr && rtFreeHost(slot.buffer) != RT_ERROR_NONE) {
+      GELOGW("Free staging buffer failed.");
+    }
+  }
+  slots_.clear();
+  next_slot_ = 0;
+  slot_size_ = 0;
+}
+}  // namespace model_runner
+}  // namespace ge
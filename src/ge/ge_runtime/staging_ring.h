@@ -0,0 +1,79 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GE_RUNTIME_STAGING_RING_H_
+#define GE_GE_RUNTIME_STAGING_RING_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "runtime/base.h"
+
+namespace ge {
+namespace model_runner {
+///
+/// A ring of pinned host buffers staging the input data of a model for asynchronous copies to the device.
+/// Each slot records an event after its copy, and is handed out again only once that copy has completed,
+/// so that the host fills the next slot while the copy of the previous one is in flight on the stream.
+/// The buffers are allocated once, the copies of the later runs allocate no host memory.
+///
+class StagingRing {
+ public:
+  StagingRing() = default;
+  ~StagingRing();
+
+  StagingRing(const StagingRing &) = delete;
+  StagingRing &operator=(const StagingRing &) = delete;
+
+  bool Init(uint32_t slot_num, uint32_t slot_size);
+
+  ///
+  /// Wait for the copy from the next slot to complete and return its buffer.
+  /// @param [out] buffer: the pinned buffer of slot_size bytes
+  ///
+  bool Acquire(void *&buffer);
+
+  ///
+  /// Copy the first size bytes of the acquired slot to the device asynchronously, and move to the next slot.
+  ///
+  bool Submit(void *dst, uint64_t dst_max, uint64_t size, rtStream_t stream);
+
+  // wait for all the copies in flight, the buffers of the caller could be reused after it
+  bool Synchronize();
+
+  void Release() noexcept;
+
+  uint32_t GetSlotSize() const { return slot_size_; }
+
+  bool IsInited() const { return !slots_.empty(); }
+
+ private:
+  struct Slot {
+    void *buffer = nullptr;
+    rtEvent_t event = nullptr;
+    bool in_flight = false;
+  };
+
+  bool WaitSlot(Slot &slot);
+
+  std::vector<Slot> slots_;
+  size_t next_slot_ = 0;
+  uint32_t slot_size_ = 0;
+};
+}  // namespace model_runner
+}  // namespace ge
+
+#endif  // GE_GE_RUNTIME_STAGING_RING_H_
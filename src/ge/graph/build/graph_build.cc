@@ -22,6 +22,7 @@
 #include "graph/build/optimize_stream_graph.h"
 #include "graph/build/run_context.h"
 #include "graph/manager/graph_var_manager.h"
+#include "graph/passes/pass_profiler.h"
 #include "graph/utils/node_utils.h"
 #include "graph/utils/type_utils.h"
 #include "init/gelib.h"
@@ -110,14 +111,14 @@ Status GraphBuilder::Build(ComputeGraphPtr &comp_graph, std::vector<SubGraphInfo
 
   GE_TIMESTAMP_START(PreBuildModel);
   GE_CHK_STATUS_RET(builder.PreBuildModel(), "Builder PreBuildModel() return fail.");
-  GE_TIMESTAMP_END(PreBuildModel, "GraphBuilder::PreBuildModel");
+  GE_TIMESTAMP_PROFILED_END(PreBuildModel, "GraphBuilder::PreBuildModel");
 
   GraphUtils::DumpGEGraph(comp_graph, "AfterPrebuildmodel");
   GraphUtils::DumpGEGraphToOnnx(*comp_graph, "AfterPrebuildmodel");
 
   GE_TIMESTAMP_START(CalcOpParam);
   GE_CHK_STATUS_RET(CalcOpParam(comp_graph), "Builder CalcOpParam() return fail.");
-  GE_TIMESTAMP_END(CalcOpParam, "GraphBuilder::CalcOpParam");
+  GE_TIMESTAMP_PROFILED_END(CalcOpParam, "GraphBuilder::CalcOpParam");
   GraphUtils::DumpGEGraph(comp_graph, "AfterCalcOpParam");
   GraphUtils::DumpGEGraphToOnnx(*comp_graph, "AfterCalcOpParam");
 
@@ -127,14 +128,14 @@ Status GraphBuilder::Build(ComputeGraphPtr &comp_graph, std::vector<SubGraphInfo
   }
   GE_TIMESTAMP_START(BuildModelForGetTask);
   GE_CHK_STATUS_RET(builder.BuildModelForGetTask(*model_ptr), "Builder BuildModelForGetTask() return fail.");
-  GE_TIMESTAMP_END(BuildModelForGetTask, "GraphBuilder::BuildModelForGetTask");
+  GE_TIMESTAMP_PROFILED_END(BuildModelForGetTask, "GraphBuilder::BuildModelForGetTask");
 
   GraphUtils::DumpGEGraph(comp_graph, "AfterBuildModel");
   GraphUtils::DumpGEGraphToOnnx(*comp_graph, "AfterBuildModel");
 
   GE_TIMESTAMP_START(GetTaskInfo);
   ret = GetTaskInfo(builder, model_ptr, comp_graph, subgraph_ptr_list, session_id);
-  GE_TIMESTAMP_END(GetTaskInfo, "GraphBuilder::GetTaskInfo");
+  GE_TIMESTAMP_PROFILED_END(GetTaskInfo, "GraphBuilder::GetTaskInfo");
 
   GraphUtils::DumpGEGraph(comp_graph, "AfterGetTask");
   GraphUtils::DumpGEGraphToOnnx(*comp_graph, "AfterGetTask");
@@ -249,7 +250,7 @@ Status GraphBuilder::SecondPartition(ge::ComputeGraphPtr &comp_graph,
   GE_TIMESTAMP_START(GraphPartition2);
   Status ret = graph_partitioner_.Partition(comp_graph, subgraph_ptr_list, GraphPartitioner::kSecondPartitioning);
   GE_CHK_STATUS_RET(ret, "Graph partition Failed.");
-  GE_TIMESTAMP_END(GraphPartition2, "GraphPartitioner::Partition2");
+  GE_TIMESTAMP_PROFILED_END(GraphPartition2, "GraphPartitioner::Partition2");
   return ret;
 }
 }  // namespace ge
@@ -38,6 +38,7 @@ namespace {
 const char *const kAttrNameWorkspaceReuseFlag = "workspace_reuse_flag";
 const char *const kL2FusionDynamicConvergeOp = "l2fusion_dynamic_converge_op";
 const char *const kDisableReuseMemory = "ge.exec.disableReuseMemory";
+const char *const kMultiBatchShareWeights = "ge.multiBatchShareWeights";
 const int kReuseMaxCount = 10;
 }  // namespace
 
@@ -240,6 +241,20 @@ bool CanReuseByStream(const std::unordered_set<int64_t> &reuse_stream, MemoryBlo
   return can_reuse;
 }
 
+// the outputs of a batch branch which shares the weights stay alive until the merges out of the branches, so the
+// blocks are kept to one batch label, to be overlaid by MergeDynamicBatchBlocks instead of piling up across the gears
+bool CanReuseByBatchLabel(const MemoryBlock &reusable_block, const string &batch_label) {
+  for (const auto &node_type : reusable_block.NodeTypeIndexList()) {
+    GE_IF_BOOL_EXEC(node_type.node_ == nullptr || node_type.node_->GetOpDesc() == nullptr, continue);
+    string block_batch_label;
+    (void)ge::AttrUtils::GetStr(node_type.node_->GetOpDesc(), ATTR_NAME_BATCH_LABEL, block_batch_label);
+    if (block_batch_label != batch_label) {
+      return false;
+    }
+  }
+  return true;
+}
+
 MemoryBlock *BlockMemAssigner::ApplyMemory(size_t block_size, size_t real_size, MemoryType mem_type, const NodePtr &n,
                                            uint32_t out_index, const vector<bool> &workspace_reuse_flag) {
   GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(n == nullptr, return nullptr, "Input parameter n is null.");
@@ -248,6 +263,8 @@ MemoryBlock *BlockMemAssigner::ApplyMemory(size_t block_size, size_t real_size,
 
   string ge_disable_reuse_mem_env = "0";
   (void)ge::GetContext().GetOption(kDisableReuseMemory, ge_disable_reuse_mem_env);
+  string share_weights = "0";
+  (void)ge::GetContext().GetOption(kMultiBatchShareWeights, share_weights);
   if (ge_disable_reuse_mem_env != "1") {
     int64_t convergence_label;
     bool reuse_mem_flag = true;
@@ -272,6 +289,9 @@ MemoryBlock *BlockMemAssigner::ApplyMemory(size_t block_size, size_t real_size,
             (op_type != ANN_DATA_TYPE) && (op_type != ZEROSLIKE) && (op_type != CONSTANTOP);
         auto stream_id = node_op_desc->GetStreamId();
         auto map_iter = reusable_streams_map_.find(stream_id);
+        string batch_label;
+        // not all op has ATTR_NAME_BATCH_LABEL, no need check return value
+        (void)ge::AttrUtils::GetStr(node_op_desc, ATTR_NAME_BATCH_LABEL, batch_label);
         if (is_reuse_memory && map_iter != reusable_streams_map_.end()) {
           for (auto it = reusable_blocks_.begin(); it != reusable_blocks_.end(); ++it) {
             MemoryBlock *reusable_block = *it;
@@ -287,7 +307,8 @@ MemoryBlock *BlockMemAssigner::ApplyMemory(size_t block_size, size_t real_size,
 
             // A node can reuse blocks of the same stream and preorder streams
             if (CanReuseBySize(reusable_block_counts_, *reusable_block, block_size) &&
-                CanReuseByStream(map_iter->second, *reusable_block)) {
+                CanReuseByStream(map_iter->second, *reusable_block) &&
+                ((share_weights != "1") || CanReuseByBatchLabel(*reusable_block, batch_label))) {
               GELOGD("Cross stream mem reuse, target stream:%ld, current stream:%ld", reusable_block->stream_id_,
                      stream_id);
               reusable_block->AddNodeTypeIndex({n, mem_type, out_index}, real_size);
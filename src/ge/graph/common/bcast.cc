@@ -165,4 +165,84 @@ void BCast::BCastIndexes(kVecInt &x_indexes, kVecInt &y_indexes) {
   Reverse(y_reshape_);
   Reverse(output_);
 }
+
+int64_t BCast::GetOutputElementNum() const {
+  int64_t num = 1;
+  for (auto dim : output_) {
+    num *= dim;
+  }
+  return num;
+}
+
+Status BCast::PrepareCompute(const std::vector<ConstGeTensorPtr> &input, size_t type_size, const void **x1_data,
+                             const void **x2_data) {
+  // Min input num is 2
+  if (input.size() < kMinDimNum) {
+    GELOGE(domi::PARAM_INVALID, "Input size is smaller than two.");
+    return domi::PARAM_INVALID;
+  }
+  GE_CHECK_NOTNULL(input[0]);
+  GE_CHECK_NOTNULL(input[1]);
+  // Only broadcast shape
+  Status ret =
+    GenerateBcastInfo(TransShapeToDimVec(input[0]->GetTensorDesc()), TransShapeToDimVec(input[1]->GetTensorDesc()));
+  if (ret != domi::SUCCESS) {
+    GELOGE(ret, "Greater broadcasting failed.");
+    return ret;
+  }
+
+  int64_t x_num = 1;
+  int64_t y_num = 1;
+  for (size_t i = 0; i < x_reshape_.size(); ++i) {
+    x_num *= x_reshape_[i];
+    y_num *= y_reshape_[i];
+  }
+  if (input[0]->GetData().size() < static_cast<size_t>(x_num) * type_size ||
+      input[1]->GetData().size() < static_cast<size_t>(y_num) * type_size) {
+    GELOGE(domi::PARAM_INVALID, "Data size of inputs %zu, %zu are smaller than their shapes %ld, %ld.",
+           input[0]->GetData().size(), input[1]->GetData().size(), x_num, y_num);
+    return domi::PARAM_INVALID;
+  }
+
+  *x1_data = input[0]->GetData().data();
+  *x2_data = input[1]->GetData().data();
+  return domi::SUCCESS;
+}
+
+void BCast::GetMergedDims(kVecInt &dims, kVecInt &x_strides, kVecInt &y_strides) const {
+  std::vector<bool> x_full;
+  std::vector<bool> y_full;
+  for (size_t i = 0; i < output_.size(); ++i) {
+    int64_t out_dim = output_[i];
+    if (out_dim == 1) {
+      continue;
+    }
+    // an input either covers the dim or is broadcast in it
+    bool x_cover = x_reshape_[i] == out_dim;
+    bool y_cover = y_reshape_[i] == out_dim;
+    if (!dims.empty() && x_full.back() == x_cover && y_full.back() == y_cover) {
+      dims.back() *= out_dim;
+      continue;
+    }
+    dims.push_back(out_dim);
+    x_full.push_back(x_cover);
+    y_full.push_back(y_cover);
+  }
+
+  x_strides.assign(dims.size(), 0);
+  y_strides.assign(dims.size(), 0);
+  int64_t x_inner = 1;
+  int64_t y_inner = 1;
+  for (size_t i = dims.size(); i > 0; --i) {
+    size_t dim = i - 1;
+    if (x_full[dim]) {
+      x_strides[dim] = x_inner;
+      x_inner *= dims[dim];
+    }
+    if (y_full[dim]) {
+      y_strides[dim] = y_inner;
+      y_inner *= dims[dim];
+    }
+  }
+}
 }  // namespace ge
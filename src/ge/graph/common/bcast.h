@@ -18,6 +18,7 @@
 #define GE_GRAPH_COMMON_BCAST_H_
 
 #include <stdint.h>
+#include <algorithm>
 #include <functional>
 #include <vector>
 
@@ -125,83 +126,106 @@ class BCast {
     return domi::SUCCESS;
   }
   void BCastIndexes(kVecInt &x_indexes, kVecInt &y_indexes);
-  template <typename InT, typename OutT>
-  Status BCastCompute(const std::vector<ConstGeTensorPtr> &input, std::vector<OutT> &v_output,
-                      const std::function<OutT(InT const &, InT const &)> &func) {
-    Status ret;
-    if (func == nullptr) {
-      GELOGE(domi::PARAM_INVALID, "Param func is null");
-      return domi::PARAM_INVALID;
-    }
-    // Min input num is 2
-    if (input.size() < kMinDimNum) {
-      GELOGE(domi::PARAM_INVALID, "Input size is smaller than two.");
-      return domi::PARAM_INVALID;
-    }
-    // Only broadcast shape
-    ret =
-      GenerateBcastInfo(TransShapeToDimVec(input[0]->GetTensorDesc()), TransShapeToDimVec(input[1]->GetTensorDesc()));
-    if (ret != domi::SUCCESS) {
-      GELOGE(ret, "Greater broadcasting failed.");
-      return ret;
-    }
 
-    kVecInt x_indexes;
-    kVecInt y_indexes;
-    BCastIndexes(x_indexes, y_indexes);
+  ///
+  /// @ingroup domi_calibration
+  /// @brief element num of output, valid after GenerateBcastInfo
+  ///
+  int64_t GetOutputElementNum() const;
+
+  ///
+  /// @ingroup domi_calibration
+  /// @brief compute output of a binary op with broadcast, indexes are walked lazily instead of materialised.
+  ///        same shape and scalar inputs end up in a single tight loop. Valid after GenerateBcastInfo.
+  /// @param [in] x_data      data of first input, holds as many elements as GetXReshape
+  /// @param [in] y_data      data of second input, holds as many elements as GetYReshape
+  /// @param [out] output     preallocated output, holds GetOutputElementNum elements
+  /// @param [in] func        functor OutT(InT const &, InT const &)
+  ///
+  template <typename InT, typename OutT, typename Func>
+  void BCastApply(const InT *x_data, const InT *y_data, OutT *output, Func &func) const {
+    (void)ForEachBlock([&](int64_t x_offset, bool x_step, int64_t y_offset, bool y_step, int64_t out_offset,
+                           int64_t count) {
+      const InT *x = x_data + x_offset;
+      const InT *y = y_data + y_offset;
+      OutT *out = output + out_offset;
+      if (x_step && y_step) {
+        for (int64_t i = 0; i < count; ++i) {
+          out[i] = func(x[i], y[i]);
+        }
+      } else if (x_step) {
+        const InT &y_value = *y;
+        for (int64_t i = 0; i < count; ++i) {
+          out[i] = func(x[i], y_value);
+        }
+      } else if (y_step) {
+        const InT &x_value = *x;
+        for (int64_t i = 0; i < count; ++i) {
+          out[i] = func(x_value, y[i]);
+        }
+      } else {
+        std::fill(out, out + count, func(*x, *y));
+      }
+      return true;
+    });
+  }
 
-    const void *x1_data = input[0]->GetData().data();
-    const void *x2_data = input[1]->GetData().data();
+  ///
+  /// @ingroup domi_calibration
+  /// @brief same as BCastApply, func reports failure such as overflow by ret, computing stops at the first failure
+  /// @param [in] func        functor OutT(InT const &, InT const &, DataType &, Status &)
+  /// @return     SUCCESS or the failure func reports
+  ///
+  template <typename InT, typename OutT, typename Func>
+  Status BCastApplyCheck(const InT *x_data, const InT *y_data, OutT *output, DataType data_type, Func &func) const {
+    Status ret = SUCCESS;
+    (void)ForEachBlock([&](int64_t x_offset, bool x_step, int64_t y_offset, bool y_step, int64_t out_offset,
+                           int64_t count) {
+      const InT *x = x_data + x_offset;
+      const InT *y = y_data + y_offset;
+      OutT *out = output + out_offset;
+      for (int64_t i = 0; i < count; ++i) {
+        out[i] = func(x_step ? x[i] : *x, y_step ? y[i] : *y, data_type, ret);
+        if (ret != SUCCESS) {
+          return false;
+        }
+      }
+      return true;
+    });
+    return ret;
+  }
 
-    for (size_t i = 0; i < x_indexes.size(); i++) {
-      int64_t x_index = x_indexes[i];
-      int64_t y_index = y_indexes[i];
-      auto value = func((*(reinterpret_cast<const InT *>(x1_data) + x_index)),
-                        (*(reinterpret_cast<const InT *>(x2_data) + y_index)));
-      v_output.push_back(value);
+  template <typename InT, typename OutT, typename Func>
+  Status BCastCompute(const std::vector<ConstGeTensorPtr> &input, std::vector<OutT> &v_output, Func func) {
+    const InT *x1_data = nullptr;
+    const InT *x2_data = nullptr;
+    Status ret = PrepareCompute(input, sizeof(InT), reinterpret_cast<const void **>(&x1_data),
+                                reinterpret_cast<const void **>(&x2_data));
+    if (ret != SUCCESS) {
+      return ret;
     }
 
-    return domi::SUCCESS;
+    v_output.resize(static_cast<size_t>(GetOutputElementNum()));
+    BCastApply(x1_data, x2_data, v_output.data(), func);
+    return SUCCESS;
   }
 
-  template <typename InT, typename OutT>
-  Status BCastComputeCheck(const std::vector<ConstGeTensorPtr> &input, std::vector<OutT> &v_output,
-                           const std::function<OutT(InT const &, InT const &, DataType &type, Status &)> &func) {
-    if (func == nullptr) {
-      GELOGE(PARAM_INVALID, "Param func is null");
-      return PARAM_INVALID;
-    }
-    // Min input num is 2
-    if (input.size() < kMinDimNum) {
-      GELOGE(PARAM_INVALID, "Input size is smaller than two.");
-      return PARAM_INVALID;
-    }
-    // Only broadcast shape
-    Status ret =
-      GenerateBcastInfo(TransShapeToDimVec(input[0]->GetTensorDesc()), TransShapeToDimVec(input[1]->GetTensorDesc()));
+  template <typename InT, typename OutT, typename Func>
+  Status BCastComputeCheck(const std::vector<ConstGeTensorPtr> &input, std::vector<OutT> &v_output, Func func) {
+    const InT *x1_data = nullptr;
+    const InT *x2_data = nullptr;
+    Status ret = PrepareCompute(input, sizeof(InT), reinterpret_cast<const void **>(&x1_data),
+                                reinterpret_cast<const void **>(&x2_data));
     if (ret != SUCCESS) {
-      GELOGE(ret, "Greater broadcasting failed.");
       return ret;
     }
 
     DataType data_type = input[0]->GetTensorDesc().GetDataType();
-    kVecInt x_indexes;
-    kVecInt y_indexes;
-    BCastIndexes(x_indexes, y_indexes);
-
-    const void *x1_data = input[0]->GetData().data();
-    const void *x2_data = input[1]->GetData().data();
-
-    for (size_t i = 0; i < x_indexes.size(); i++) {
-      int64_t x_index = x_indexes[i];
-      int64_t y_index = y_indexes[i];
-      auto value = func((*(reinterpret_cast<const InT *>(x1_data) + x_index)),
-                        (*(reinterpret_cast<const InT *>(x2_data) + y_index)), data_type, ret);
-      if (ret != SUCCESS) {
-        GELOGE(ret, "BCastComputeCheck func execute failed, datatype is %d.", data_type);
-        return ret;
-      }
-      v_output.push_back(value);
+    v_output.resize(static_cast<size_t>(GetOutputElementNum()));
+    ret = BCastApplyCheck(x1_data, x2_data, v_output.data(), data_type, func);
+    if (ret != SUCCESS) {
+      GELOGE(ret, "BCastComputeCheck func execute failed, datatype is %d.", data_type);
+      return ret;
     }
 
     return SUCCESS;
@@ -240,6 +264,83 @@ class BCast {
   ///
   void ReverseAllIntermediateShapes();
 
+  ///
+  /// @ingroup domi_calibration
+  /// @brief check inputs, generate broadcast info and get input data
+  /// @param [in] input       two input tensors
+  /// @param [in] type_size   size of input element
+  /// @param [out] x1_data    data of first input
+  /// @param [out] x2_data    data of second input
+  /// @return     SUCCESS or PARAM_INVALID
+  ///
+  Status PrepareCompute(const std::vector<ConstGeTensorPtr> &input, size_t type_size, const void **x1_data,
+                        const void **x2_data);
+
+  ///
+  /// @ingroup domi_calibration
+  /// @brief merge adjacent dims broadcasting the same way, dims of 1 are dropped, outermost first
+  /// @param [out] dims       merged output dims
+  /// @param [out] x_strides  element stride of x for each merged dim, 0 when x is broadcast in it
+  /// @param [out] y_strides  element stride of y for each merged dim, 0 when y is broadcast in it
+  ///
+  void GetMergedDims(kVecInt &dims, kVecInt &x_strides, kVecInt &y_strides) const;
+
+  ///
+  /// @ingroup domi_calibration
+  /// @brief call visitor for every contiguous run of the innermost merged dim, stops when visitor returns false
+  ///
+  template <typename Visitor>
+  bool ForEachBlock(Visitor visitor) const {
+    kVecInt dims;
+    kVecInt x_strides;
+    kVecInt y_strides;
+    GetMergedDims(dims, x_strides, y_strides);
+    if (dims.empty()) {
+      // every dim is 1
+      return visitor(0, false, 0, false, 0, 1);
+    }
+    for (auto dim : dims) {
+      if (dim == 0) {
+        return true;
+      }
+    }
+
+    const size_t inner = dims.size() - 1;
+    const int64_t count = dims[inner];
+    const bool x_step = x_strides[inner] != 0;
+    const bool y_step = y_strides[inner] != 0;
+    kVecInt coord(inner, 0);
+    int64_t x_offset = 0;
+    int64_t y_offset = 0;
+    int64_t out_offset = 0;
+    while (true) {
+      if (!visitor(x_offset, x_step, y_offset, y_step, out_offset, count)) {
+        return false;
+      }
+      out_offset += count;
+
+      // step outer dims like an odometer
+      size_t dim = inner;
+      while (dim > 0) {
+        --dim;
+        x_offset += x_strides[dim];
+        y_offset += y_strides[dim];
+        if (++coord[dim] < dims[dim]) {
+          break;
+        }
+        x_offset -= x_strides[dim] * dims[dim];
+        y_offset -= y_strides[dim] * dims[dim];
+        coord[dim] = 0;
+        if (dim == 0) {
+          return true;
+        }
+      }
+      if (inner == 0) {
+        return true;
+      }
+    }
+  }
+
   kVecInt x_reshape_;
   kVecInt x_bcast_;
   kVecInt y_reshape_;
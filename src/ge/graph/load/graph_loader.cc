@@ -16,10 +16,13 @@
 
 #include "graph/load/graph_loader.h"
 
+#include <cstdlib>
 #include <string>
 #include <vector>
 
+#include "common/ge/ge_util.h"
 #include "common/helper/model_helper.h"
+#include "common/model_parser/base.h"
 #include "common/util.h"
 #include "graph/ge_context.h"
 #include "graph/load/new_model_manager/davinci_model_parser.h"
@@ -29,6 +32,11 @@
 #include "runtime/dev.h"
 
 namespace ge {
+namespace {
+// the file must not be truncated or rewritten while a model mapped from it is loaded, or reading it raises SIGBUS
+const char *const kEnvMapModelFile = "GE_MAP_MODEL_FILE";
+}  // namespace
+
 GraphLoader::GraphLoader() = default;
 
 GraphLoader::~GraphLoader() = default;
@@ -231,6 +239,11 @@ Status GraphLoader::LoadDataFromFile(const std::string &path, const std::string
 
 Status GraphLoader::LoadModelFromFile(const std::string &path, const std::string &key_path, int32_t priority,
                                       const std::shared_ptr<ModelListener> &listener, uint32_t &model_id) {
+  // on request the unencrypted model is mapped, the weights are copied to device from the pages of the file
+  if (key_path.empty() && (std::getenv(kEnvMapModelFile) != nullptr)) {
+    return LoadMappedModelFromFile(path, priority, listener, model_id);
+  }
+
   Status ret;
   ModelData model_data;
 
@@ -269,8 +282,33 @@ Status GraphLoader::LoadModelFromFile(const std::string &path, const std::string
   return ret;
 }
 
+Status GraphLoader::LoadMappedModelFromFile(const std::string &path, int32_t priority,
+                                            const std::shared_ptr<ModelListener> &listener, uint32_t &model_id) {
+  if (!CheckInputPathValid(path)) {
+    GELOGE(PARAM_INVALID, "model path is invalid: %s", path.c_str());
+    return PARAM_INVALID;
+  }
+  GELOGI("Load mapped model begin, model path is: %s", path.c_str());
+  auto model_file = MakeShared<MappedModelFile>();
+  if (model_file == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "Create mapped model file failed");
+    return MEMALLOC_FAILED;
+  }
+  Status ret = model_file->Map(path.c_str(), priority);
+  if (ret != SUCCESS) {
+    GELOGE(ret, "LoadMappedModelFromFile: Map failed. ret = %u", ret);
+    return ret;
+  }
+  // the loaded model keeps the file mapped as long as it needs it
+  ret = LoadModel(model_file->GetModelData(), listener, model_id, model_file);
+  if (ret != SUCCESS) {
+    GELOGE(ret, "LoadModel: Load failed. ret = %u", ret);
+  }
+  return ret;
+}
+
 Status GraphLoader::LoadModel(const ModelData &model_data, const std::shared_ptr<ModelListener> &listener,
-                              uint32_t &model_id) {
+                              uint32_t &model_id, const std::shared_ptr<void> &model_owner) {
   try {
     GELOGI("Load model begin, model_id:%u.", model_id);
 
@@ -278,7 +316,7 @@ Status GraphLoader::LoadModel(const ModelData &model_data, const std::shared_ptr
     GE_CHK_RT_RET(rtSetDevice(0));
     auto model_manager = ModelManager::GetInstance();
     GE_CHECK_NOTNULL(model_manager);
-    Status ret = model_manager->LoadModelOffline(model_id, model_data, listener);
+    Status ret = model_manager->LoadModelOffline(model_id, model_data, listener, nullptr, 0, nullptr, 0, model_owner);
     if (ret != SUCCESS) {
       GE_CHK_RT(rtDeviceReset(0));
       GELOGE(ret, "LoadModel: Load failed.");
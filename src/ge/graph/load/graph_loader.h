@@ -51,11 +51,16 @@ class GraphLoader {
   static Status GetMaxUsedMemory(uint32_t model_id, uint64_t &max_size);
 
   static Status LoadModel(const ModelData &model_data, const std::shared_ptr<ModelListener> &listener,
-                          uint32_t &model_id);
+                          uint32_t &model_id, const std::shared_ptr<void> &model_owner = nullptr);
 
   static Status LoadModelFromFile(const std::string &path, const std::string &key_path, int32_t priority,
                                   const std::shared_ptr<ModelListener> &listener, uint32_t &model_id);
 
+  // taken by LoadModelFromFile for an unencrypted model when GE_MAP_MODEL_FILE is set, the model keeps the file
+  // mapped and the file must stay unchanged until the model is unloaded
+  static Status LoadMappedModelFromFile(const std::string &path, int32_t priority,
+                                        const std::shared_ptr<ModelListener> &listener, uint32_t &model_id);
+
   static Status CommandHandle(const Command &command);
 
   static Status GetMemoryInfo(int64_t &free);
@@ -16,15 +16,19 @@
 
 #include "graph/load/new_model_manager/data_dumper.h"
 
+#include <cstdlib>
 #include <utility>
 
 #include "common/properties_manager.h"
+#include "external/ge/ge_api_types.h"
 #include "framework/common/debug/ge_log.h"
+#include "framework/common/string_util.h"
 #include "framework/common/util.h"
 #include "graph/anchor.h"
 #include "graph/debug/ge_attr_define.h"
 #include "graph/load/new_model_manager/model_utils.h"
 #include "graph/utils/attr_utils.h"
+#include "graph/utils/tensor_utils.h"
 #include "proto/ge_ir.pb.h"
 #include "proto/op_mapping_info.pb.h"
 #include "runtime/mem.h"
@@ -32,6 +36,8 @@
 namespace {
 const uint32_t kAicpuLoadFlag = 1;
 const uint32_t kAicpuUnloadFlag = 0;
+const int kDecimal = 10;
+const char kStepRangeDelim = '-';
 }  // namespace
 
 static int32_t GetIrDataType(ge::DataType data_type) {
@@ -73,6 +79,154 @@ static int32_t GetIrDataType(ge::DataType data_type) {
 }
 
 namespace ge {
+namespace {
+void SetDumpOutput(const GeTensorDesc &tensor_desc, void *addr, aicpu::dump::Output &output) {
+  output.set_data_type(static_cast<int32_t>(GetIrDataType(tensor_desc.GetDataType())));
+  output.set_format(static_cast<int32_t>(tensor_desc.GetFormat()));
+
+  for (auto dim : tensor_desc.GetShape().GetDims()) {
+    output.mutable_shape()->add_dim(dim);
+  }
+
+  std::string origin_name;
+  int32_t origin_output_index = -1;
+  (void)AttrUtils::GetStr(&tensor_desc, ATTR_NAME_DATA_DUMP_ORIGIN_NAME, origin_name);
+  (void)AttrUtils::GetInt(&tensor_desc, ATTR_NAME_DATA_DUMP_ORIGIN_OUTPUT_INDEX, origin_output_index);
+  output.set_original_name(origin_name);
+  output.set_original_output_index(origin_output_index);
+  output.set_original_output_format(static_cast<int32_t>(tensor_desc.GetOriginFormat()));
+  output.set_original_output_data_type(static_cast<int32_t>(tensor_desc.GetOriginDataType()));
+  // due to lhisi virtual addr bug, cannot use args now
+  output.set_address(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(addr)));
+}
+
+uint64_t GetDumpSize(const GeTensorDesc &tensor_desc) {
+  uint32_t size = 0;
+  (void)TensorUtils::GetSize(tensor_desc, size);
+  return size;
+}
+
+bool ParseUint64(const std::string &value, uint64_t &result) {
+  if (value.empty()) {
+    return false;
+  }
+  char *ptr = nullptr;
+  result = std::strtoull(value.c_str(), &ptr, kDecimal);
+  return ptr != nullptr && *ptr == '\0' && value[0] != '-';
+}
+}  // namespace
+
+Status DumpFilter::Init(const std::map<std::string, std::string> &options) {
+  // the filter is built from scratch, and left empty when an option is invalid, so that it is never half built
+  *this = DumpFilter();
+  Status ret = Parse(options);
+  if (ret != SUCCESS) {
+    *this = DumpFilter();
+  }
+  return ret;
+}
+
+Status DumpFilter::Parse(const std::map<std::string, std::string> &options) {
+  for (const auto &option : options) {
+    std::string value = option.second;
+    StringUtils::Trim(value);
+    if (value.empty()) {
+      continue;
+    }
+
+    Status ret = SUCCESS;
+    if (option.first == OPTION_EXEC_DUMP_OP_NAME) {
+      try {
+        op_name_pattern_ = std::regex(value);
+        has_op_name_pattern_ = true;
+      } catch (const std::regex_error &e) {
+        GELOGE(PARAM_INVALID, "Dump op name pattern %s is invalid, %s.", value.c_str(), e.what());
+        ret = PARAM_INVALID;
+      }
+    } else if (option.first == OPTION_EXEC_DUMP_OP_TYPE) {
+      for (auto &op_type : StringUtils::Split(value, ',')) {
+        if (!StringUtils::Trim(op_type).empty()) {
+          (void)op_types_.insert(op_type);
+        }
+      }
+    } else if (option.first == OPTION_EXEC_DUMP_INPUT_INDEX) {
+      ret = ParseIndexes(value, input_indexes_);
+    } else if (option.first == OPTION_EXEC_DUMP_OUTPUT_INDEX) {
+      ret = ParseIndexes(value, output_indexes_);
+    } else if (option.first == OPTION_EXEC_DUMP_STEP) {
+      ret = ParseStep(value);
+    } else if (option.first == OPTION_EXEC_DUMP_INTERVAL) {
+      if (!ParseUint64(value, iteration_interval_) || iteration_interval_ == 0) {
+        GELOGE(PARAM_INVALID, "Dump interval %s is invalid.", value.c_str());
+        ret = PARAM_INVALID;
+      }
+    } else if (option.first == OPTION_EXEC_DUMP_MAX_BYTES) {
+      if (!ParseUint64(value, max_dump_bytes_)) {
+        GELOGE(PARAM_INVALID, "Dump max bytes %s is invalid.", value.c_str());
+        ret = PARAM_INVALID;
+      }
+    }
+    if (ret != SUCCESS) {
+      return ret;
+    }
+    GELOGI("Dump filter %s: %s.", option.first.c_str(), value.c_str());
+  }
+  return SUCCESS;
+}
+
+Status DumpFilter::ParseIndexes(const std::string &value, std::set<int> &indexes) {
+  for (auto &index_str : StringUtils::Split(value, ',')) {
+    StringUtils::Trim(index_str);
+    if (index_str.empty()) {
+      continue;
+    }
+    uint64_t index = 0;
+    if (!ParseUint64(index_str, index) || index > static_cast<uint64_t>(INT32_MAX)) {
+      GELOGE(PARAM_INVALID, "Dump index %s is invalid.", index_str.c_str());
+      return PARAM_INVALID;
+    }
+    (void)indexes.insert(static_cast<int>(index));
+  }
+  return SUCCESS;
+}
+
+Status DumpFilter::ParseStep(const std::string &value) {
+  auto pos = value.find(kStepRangeDelim);
+  std::string begin_str = value.substr(0, pos);
+  std::string end_str = (pos == std::string::npos) ? begin_str : value.substr(pos + 1);
+  StringUtils::Trim(begin_str);
+  StringUtils::Trim(end_str);
+  if (!ParseUint64(begin_str, iteration_begin_) || !ParseUint64(end_str, iteration_end_) ||
+      iteration_begin_ > iteration_end_) {
+    GELOGE(PARAM_INVALID, "Dump step %s is invalid, it should be like \"10\" or \"10-20\".", value.c_str());
+    return PARAM_INVALID;
+  }
+  return SUCCESS;
+}
+
+bool DumpFilter::IsOpNeedDump(const OpDescPtr &op_desc) const {
+  if (op_desc == nullptr) {
+    return false;
+  }
+  if (!op_types_.empty() && op_types_.count(op_desc->GetType()) == 0) {
+    return false;
+  }
+  return !has_op_name_pattern_ || std::regex_search(op_desc->GetName(), op_name_pattern_);
+}
+
+bool DumpFilter::IsInputNeedDump(int index) const { return input_indexes_.empty() || input_indexes_.count(index) > 0; }
+
+bool DumpFilter::IsOutputNeedDump(int index) const {
+  return output_indexes_.empty() || output_indexes_.count(index) > 0;
+}
+
+bool DumpFilter::IsIterationNeedDump(uint64_t iteration) const {
+  if (iteration < iteration_begin_ || iteration > iteration_end_) {
+    return false;
+  }
+  return (iteration - iteration_begin_) % iteration_interval_ == 0;
+}
+
 DataDumper::~DataDumper() {
   ReleaseDevMem(&dev_mem_load_);
   ReleaseDevMem(&dev_mem_unload_);
@@ -122,11 +276,19 @@ void DataDumper::SaveDumpTask(uint32_t task_id, const std::shared_ptr<OpDesc> &o
     return;
   }
 
+  if (!dump_filter_.IsOpNeedDump(op_desc)) {
+    GELOGD("Op %s is filtered out of dump.", op_desc->GetName().c_str());
+    return;
+  }
+
   GELOGI("Save dump task %s, id: %u.", op_desc->GetName().c_str(), task_id);
   op_list_.push_back({task_id, op_desc, args, true});
 
   for (auto iter = input_map_.equal_range(op_desc->GetName()); iter.first != iter.second; ++iter.first) {
     InnerInputMapping &inner_input_mapping = iter.first->second;
+    if (!dump_filter_.IsInputNeedDump(inner_input_mapping.input_anchor_index)) {
+      continue;
+    }
     auto &data_op = inner_input_mapping.data_op;
     if (data_op == nullptr) {
       GELOGE(PARAM_INVALID, "data_op is null.");
@@ -148,26 +310,22 @@ void DataDumper::SaveDumpTask(uint32_t task_id, const std::shared_ptr<OpDesc> &o
   }
 }
 
-Status DataDumper::LoadDumpInfo() {
-  GELOGI("%zu op need dump in %s.", op_list_.size(), model_name_.c_str());
-  if (op_list_.empty()) {
-    return SUCCESS;
-  }
-
-  aicpu::dump::OpMappingInfo op_mapping_info;
-
+Status DataDumper::BuildOpMappingInfo(aicpu::dump::OpMappingInfo &op_mapping_info) {
   op_mapping_info.set_dump_path(PropertiesManager::Instance().GetDumpOutputPath() + std::to_string(device_id_) + "/");
 
   op_mapping_info.set_model_name(model_name_);
   op_mapping_info.set_model_id(model_id_);
   op_mapping_info.set_flag(kAicpuLoadFlag);
 
+  uint64_t max_dump_bytes = dump_filter_.GetMaxDumpBytes();
+  iteration_dump_bytes_ = 0;
   for (const auto &op_iter : op_list_) {
     aicpu::dump::Task task;
     task.set_task_id(op_iter.task_id);
     task.mutable_op()->set_op_name(op_iter.op->GetName());
     task.mutable_op()->set_op_type(op_iter.op->GetType());
 
+    uint64_t task_dump_bytes = 0;
     if (op_iter.is_task) {
       // tbe or aicpu op
       const auto &output_descs = op_iter.op->GetAllOutputsDesc();
@@ -179,72 +337,112 @@ Status DataDumper::LoadDumpInfo() {
       }
 
       for (size_t i = 0; i < output_descs.size(); ++i) {
-        aicpu::dump::Output output;
-        output.set_data_type(static_cast<int32_t>(GetIrDataType(output_descs.at(i).GetDataType())));
-        output.set_format(static_cast<int32_t>(output_descs.at(i).GetFormat()));
-
-        for (auto dim : output_descs.at(i).GetShape().GetDims()) {
-          output.mutable_shape()->add_dim(dim);
+        if (!dump_filter_.IsOutputNeedDump(static_cast<int>(i))) {
+          continue;
         }
-
-        std::string origin_name;
-        int32_t origin_output_index = -1;
-        (void)AttrUtils::GetStr(&output_descs.at(i), ATTR_NAME_DATA_DUMP_ORIGIN_NAME, origin_name);
-        (void)AttrUtils::GetInt(&output_descs.at(i), ATTR_NAME_DATA_DUMP_ORIGIN_OUTPUT_INDEX, origin_output_index);
-        output.set_original_name(origin_name);
-        output.set_original_output_index(origin_output_index);
-        output.set_original_output_format(static_cast<int32_t>(output_descs.at(i).GetOriginFormat()));
-        output.set_original_output_data_type(static_cast<int32_t>(output_descs.at(i).GetOriginDataType()));
-        // due to lhisi virtual addr bug, cannot use args now
-        output.set_address(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(output_addrs[i])));
-
+        aicpu::dump::Output output;
+        SetDumpOutput(output_descs.at(i), output_addrs[i], output);
+        task_dump_bytes += GetDumpSize(output_descs.at(i));
         task.mutable_output()->Add(std::move(output));
       }
-      op_mapping_info.mutable_task()->Add(std::move(task));
-      continue;
-    }
+    } else {
+      // else data, const or variable op
+      aicpu::dump::Output output;
+      auto output_tensor = op_iter.op->GetOutputDescPtr(op_iter.output_anchor_index);
+      const std::vector<void *> output_addrs = ModelUtils::GetOutputDataAddrs(runtime_param_, op_iter.op, false);
+      if (output_tensor == nullptr) {
+        GELOGE(PARAM_INVALID, "output_tensor is null, index: %d, size: %zu.", op_iter.output_anchor_index,
+               op_iter.op->GetOutputsSize());
+        return PARAM_INVALID;
+      }
+      if (static_cast<size_t>(op_iter.output_anchor_index) >= output_addrs.size()) {
+        GELOGE(PARAM_INVALID, "Invalid output addrs size %zu, op %s, index: %d.", output_addrs.size(),
+               op_iter.op->GetName().c_str(), op_iter.output_anchor_index);
+        return PARAM_INVALID;
+      }
 
-    // else data, const or variable op
-    aicpu::dump::Output output;
-    auto output_tensor = op_iter.op->GetOutputDescPtr(op_iter.output_anchor_index);
-    const std::vector<void *> output_addrs = ModelUtils::GetOutputDataAddrs(runtime_param_, op_iter.op, false);
-    if (output_tensor == nullptr) {
-      GELOGE(PARAM_INVALID, "output_tensor is null, index: %d, size: %zu.", op_iter.output_anchor_index,
-             op_iter.op->GetOutputsSize());
-      return PARAM_INVALID;
+      SetDumpOutput(*output_tensor, output_addrs[op_iter.output_anchor_index], output);
+      task_dump_bytes += GetDumpSize(*output_tensor);
+      task.mutable_output()->Add(std::move(output));
     }
 
-    output.set_data_type(static_cast<int32_t>(GetIrDataType(output_tensor->GetDataType())));
-    output.set_format(static_cast<int32_t>(output_tensor->GetFormat()));
-
-    for (auto dim : output_tensor->GetShape().GetDims()) {
-      output.mutable_shape()->add_dim(dim);
+    if (task.output_size() == 0) {
+      continue;
+    }
+    if (max_dump_bytes != 0 && iteration_dump_bytes_ + task_dump_bytes > max_dump_bytes) {
+      GELOGW("Dump bytes of model %s exceed limit %lu, ops from %s are not dumped.", model_name_.c_str(),
+             max_dump_bytes, op_iter.op->GetName().c_str());
+      break;
     }
+    iteration_dump_bytes_ += task_dump_bytes;
+    op_mapping_info.mutable_task()->Add(std::move(task));
+  }
 
-    std::string origin_name;
-    int32_t origin_output_index = -1;
-    (void)AttrUtils::GetStr(output_tensor, ATTR_NAME_DATA_DUMP_ORIGIN_NAME, origin_name);
-    (void)AttrUtils::GetInt(output_tensor, ATTR_NAME_DATA_DUMP_ORIGIN_OUTPUT_INDEX, origin_output_index);
-    output.set_original_name(origin_name);
-    output.set_original_output_index(origin_output_index);
-    output.set_original_output_format(static_cast<int32_t>(output_tensor->GetOriginFormat()));
-    output.set_original_output_data_type(static_cast<int32_t>(output_tensor->GetOriginDataType()));
-    // due to lhisi virtual addr bug, cannot use args now
-    output.set_address(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(output_addrs[op_iter.output_anchor_index])));
+  return SUCCESS;
+}
 
-    task.mutable_output()->Add(std::move(output));
+Status DataDumper::LoadDumpInfo() {
+  GELOGI("%zu op need dump in %s.", op_list_.size(), model_name_.c_str());
+  if (op_list_.empty()) {
+    return SUCCESS;
+  }
 
-    op_mapping_info.mutable_task()->Add(std::move(task));
+  aicpu::dump::OpMappingInfo op_mapping_info;
+  Status ret = BuildOpMappingInfo(op_mapping_info);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  if (op_mapping_info.task_size() == 0) {
+    GELOGI("No op of %s left after dump filter.", model_name_.c_str());
+    return SUCCESS;
   }
 
-  std::string proto_str;
-  uint32_t proto_size = op_mapping_info.ByteSizeLong();
-  bool ret = op_mapping_info.SerializeToString(&proto_str);
-  if (!ret || proto_size == 0) {
-    GELOGE(FAILED, "Protobuf SerializeToString failed, proto size %u.", proto_size);
+  size_t proto_size = op_mapping_info.ByteSizeLong();
+  bool serialize_ret = op_mapping_info.SerializeToString(&load_proto_);
+  if (!serialize_ret || proto_size == 0) {
+    GELOGE(FAILED, "Protobuf SerializeToString failed, proto size %zu.", proto_size);
+    load_proto_.clear();
     return FAILED;
   }
 
+  if (!NeedDumpIteration()) {
+    GELOGI("Iteration %lu of %s need not dump, load dump info later.", iteration_, model_name_.c_str());
+    return SUCCESS;
+  }
+  return ExecuteLoadDumpInfo();
+}
+
+bool DataDumper::NeedDumpIteration() {
+  if (!dump_filter_.IsIterationNeedDump(iteration_)) {
+    return false;
+  }
+  uint64_t max_dump_bytes = dump_filter_.GetMaxDumpBytes();
+  if (max_dump_bytes != 0 && dumped_bytes_ + iteration_dump_bytes_ > max_dump_bytes) {
+    GELOGI("Dumped %lu bytes of %s, no more iterations are dumped.", dumped_bytes_, model_name_.c_str());
+    return false;
+  }
+  dumped_bytes_ += iteration_dump_bytes_;
+  return true;
+}
+
+Status DataDumper::OnIterationEnd() {
+  iteration_++;
+  if (load_proto_.empty()) {
+    return SUCCESS;
+  }
+
+  bool need_dump = NeedDumpIteration();
+  if (need_dump && !load_flag_) {
+    return ExecuteLoadDumpInfo();
+  }
+  if (!need_dump && load_flag_) {
+    return UnloadDumpInfo();
+  }
+  return SUCCESS;
+}
+
+Status DataDumper::ExecuteLoadDumpInfo() {
+  size_t proto_size = load_proto_.size();
   if (dev_mem_load_ != nullptr) {
     GELOGW("dev_mem_load_ has been used.");
     ReleaseDevMem(&dev_mem_load_);
@@ -256,7 +454,7 @@ Status DataDumper::LoadDumpInfo() {
     return RT_FAILED;
   }
 
-  rt_ret = rtMemcpy(dev_mem_load_, proto_size, proto_str.c_str(), proto_size, RT_MEMCPY_HOST_TO_DEVICE);
+  rt_ret = rtMemcpy(dev_mem_load_, proto_size, load_proto_.c_str(), proto_size, RT_MEMCPY_HOST_TO_DEVICE);
   if (rt_ret != RT_ERROR_NONE) {
     GELOGE(RT_FAILED, "Call rtMemcpy failed, ret: 0x%X", rt_ret);
     return RT_FAILED;
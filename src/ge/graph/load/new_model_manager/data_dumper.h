@@ -19,6 +19,8 @@
 
 #include <map>
 #include <memory>
+#include <regex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -26,7 +28,53 @@
 #include "graph/node.h"
 #include "task_info/task_info.h"
 
+namespace aicpu {
+namespace dump {
+class OpMappingInfo;
+}  // namespace dump
+}  // namespace aicpu
+
 namespace ge {
+///
+/// @ingroup ge
+/// @brief Selects ops, tensors and iterations to dump, everything is dumped when nothing is configured.
+///
+class DumpFilter {
+ public:
+  DumpFilter() = default;
+  ~DumpFilter() = default;
+
+  ///
+  /// @ingroup ge
+  /// @brief Init filter with dump options, such as ge.exec.dumpOpName. On an invalid option the filter is reset
+  ///        to select everything, none of the options takes effect.
+  /// @param [in] options: option key and value.
+  /// @return SUCCESS / PARAM_INVALID
+  ///
+  Status Init(const std::map<std::string, std::string> &options);
+
+  bool IsOpNeedDump(const OpDescPtr &op_desc) const;
+  bool IsInputNeedDump(int index) const;
+  bool IsOutputNeedDump(int index) const;
+  bool IsIterationNeedDump(uint64_t iteration) const;
+  uint64_t GetMaxDumpBytes() const { return max_dump_bytes_; }
+
+ private:
+  Status Parse(const std::map<std::string, std::string> &options);
+  static Status ParseIndexes(const std::string &value, std::set<int> &indexes);
+  Status ParseStep(const std::string &value);
+
+  bool has_op_name_pattern_ = false;
+  std::regex op_name_pattern_;
+  std::set<std::string> op_types_;
+  std::set<int> input_indexes_;
+  std::set<int> output_indexes_;
+  uint64_t iteration_begin_ = 0;
+  uint64_t iteration_end_ = UINT64_MAX;
+  uint64_t iteration_interval_ = 1;
+  uint64_t max_dump_bytes_ = 0;
+};
+
 class DataDumper {
  public:
   DataDumper()
@@ -46,6 +94,9 @@ class DataDumper {
   void SetModelId(uint32_t model_id) { model_id_ = model_id; }
   void SetMemory(const RuntimeParam &runtime_param) { runtime_param_ = runtime_param; }
   void SetDeviceId(uint32_t device_id) { device_id_ = device_id; }
+  Status SetDumpFilter(const std::map<std::string, std::string> &options) { return dump_filter_.Init(options); }
+  const DumpFilter &GetDumpFilter() const { return dump_filter_; }
+  uint64_t GetIteration() const { return iteration_; }
 
   void SaveDumpInput(const std::shared_ptr<Node> &node);
   // args is device memory stored first output addr
@@ -53,8 +104,18 @@ class DataDumper {
   Status LoadDumpInfo();
   Status UnloadDumpInfo();
 
+  ///
+  /// @ingroup ge
+  /// @brief Called after each model execution, loads or unloads dump info for the next iteration.
+  /// @return SUCCESS / others
+  ///
+  Status OnIterationEnd();
+
  private:
   void ReleaseDevMem(void **ptr) noexcept;
+  Status BuildOpMappingInfo(aicpu::dump::OpMappingInfo &op_mapping_info);
+  bool NeedDumpIteration();
+  Status ExecuteLoadDumpInfo();
 
   std::string model_name_;
   uint32_t model_id_;
@@ -69,6 +130,13 @@ class DataDumper {
   bool load_flag_;
   uint32_t device_id_;
 
+  DumpFilter dump_filter_;
+  uint64_t iteration_ = 0;
+  // serialized load info, kept to load again when a later iteration needs dump
+  std::string load_proto_;
+  uint64_t iteration_dump_bytes_ = 0;
+  uint64_t dumped_bytes_ = 0;
+
   struct InnerDumpInfo {
     uint32_t task_id;
     std::shared_ptr<OpDesc> op;
@@ -24,6 +24,7 @@
 #include "common/blocking_queue.h"
 #include "common/types.h"
 #include "common/ge_types.h"
+#include "framework/common/util.h"
 
 namespace ge {
 ///
@@ -33,7 +34,7 @@ namespace ge {
 ///
 class InputDataWrapper {
  public:
-  InputDataWrapper() : is_init(false) {}
+  InputDataWrapper() : is_init(false), push_time_us_(0) {}
 
   ~InputDataWrapper() {}
 
@@ -64,10 +65,19 @@ class InputDataWrapper {
   ///
   const InputData &GetInput() const { return input_; }
 
+  ///
+  /// @ingroup domi_ome
+  /// @brief the time the data was pushed to the DataInputer, in microseconds
+  ///
+  uint64_t GetPushTime() const { return push_time_us_; }
+
+  void SetPushTime(uint64_t push_time_us) { push_time_us_ = push_time_us; }
+
  private:
   OutputData output_;
   InputData input_;
   bool is_init;
+  uint64_t push_time_us_;
 };
 
 ///
@@ -112,6 +122,9 @@ class DataInputer {
   /// @return INTERNAL_ERROR  add failed
   ///
   domi::Status Push(const std::shared_ptr<InputDataWrapper> &data) {
+    if (data != nullptr) {
+      data->SetPushTime(GetCurrentTimestap());
+    }
     bool success = queue_.Push(data, false);
     return success ? domi::SUCCESS : domi::INTERNAL_ERROR;
   }
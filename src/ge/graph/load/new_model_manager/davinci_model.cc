@@ -80,9 +80,17 @@ namespace {
 const uint32_t DEFAULT_DATA_INDEX = 0;
 const uint32_t TRUE_BRANCH_STREAM_NUM = 1;
 const uint32_t THREAD_NUM = 16;
+// tasks are inited by contiguous chunks, each chunk binds the context once and returns one status
+const int32_t kMinTaskNumPerChunk = 256;
 const int kDecimal = 10;
 const int kBytes = 8;
 
+// shared by the loads of all models, so that a load does not start and stop its own threads
+ThreadPool &GetTaskInitPool() {
+  static ThreadPool executor(THREAD_NUM);
+  return executor;
+}
+
 class RtContextSwitchGuard {
  public:
   RtContextSwitchGuard(rtCtxMode_t mode, uint32_t device_id) : last_(nullptr), current_(nullptr) {
@@ -351,6 +359,12 @@ Status TransVarData(const NodePtr &var, const VarTransRoad &trans_road, uint64_t
 
   return SUCCESS;
 }
+
+// the time since start_us, zero if the clock went back
+uint64_t GetElapsedTime(uint64_t start_us) {
+  uint64_t now_us = GetCurrentTimestap();
+  return now_us > start_us ? now_us - start_us : 0;
+}
 }  // namespace
 
 std::mutex DavinciModel::tvm_bin_mutex_;
@@ -456,7 +470,6 @@ Status DavinciModel::Assign(const GeModelPtr &ge_model) {
     return FAILED;
   }
   ge_model_ = ge_model;
-  model_task_def_ = ge_model_->GetModelTaskDefPtr();
   return SUCCESS;
 }
 
@@ -467,10 +480,9 @@ Status DavinciModel::InitModelMem(void *dev_ptr, size_t memsize, void *weight_pt
   }
   is_model_has_inited_ = true;
   std::size_t data_size = TotalMemSize();
-  ge::Buffer weights = ge_model_->GetWeight();
-
-  uint8_t *weights_addr = weights.GetData();
-  std::size_t weights_size = weights.GetSize();
+  // the weights may be viewed in the model file, no copy on host
+  const uint8_t *weights_addr = ge_model_->GetWeightData();
+  std::size_t weights_size = ge_model_->GetWeightSize();
 
   GE_CHECK_LE(weights_size, ALLOC_MEMORY_MAX_SIZE);
 
@@ -585,6 +597,14 @@ void DavinciModel::CheckHasHcomOp() {
 }
 
 Status DavinciModel::DoTaskSink() {
+  // the task def of a lazily loaded model is parsed here, a broken one fails the load
+  Status ret = ge_model_->LoadModelTaskDef();
+  if (ret != SUCCESS) {
+    GELOGE(INTERNAL_ERROR, "Load model task def of model %s failed, ret:%u", name_.c_str(), ret);
+    return INTERNAL_ERROR;
+  }
+  model_task_def_ = ge_model_->GetModelTaskDefPtr();
+
   // task sink is supported as model_task_def is set
   if (model_task_def_) {
     GELOGI("do task_sink.");
@@ -1148,6 +1168,7 @@ Status DavinciModel::CopyTransData(const std::vector<DataBuffer> &data, uint32_t
     GELOGE(RT_FAILED, "Failed to copy memory to device, size %zu", tmp_result.length);
     return RT_FAILED;
   }
+  metrics_.AddInputBytes(tmp_result.length);
   GELOGI("[IMAS]CopyTransData memcpy graph_%u type[F] name[%s] output[%d] datasize[%zu]", runtime_param_.graph_id,
          data_op_list_[data_op_index]->GetName().c_str(), 0, tmp_result.length);
   return SUCCESS;
@@ -1182,6 +1203,7 @@ Status DavinciModel::CopyPlainData(const std::vector<DataBuffer> &data, uint32_t
   }
 
   GE_CHK_RT_RET(rtMemcpy(data_out_addr, copy_size, host_data_addr, copy_size, kind));
+  metrics_.AddInputBytes(copy_size);
 
   return SUCCESS;
 }
@@ -1276,17 +1298,20 @@ Status DavinciModel::ReturnResult(uint32_t model_id, uint32_t data_id, const boo
   // return result is not required
   if (!rslt_flg) {
     GELOGW("Compute failed, model id: %u", model_id);
+    metrics_.AddRun(false);
     GE_CHK_STATUS(listener_->OnComputeDone(model_id, data_id, INTERNAL_ERROR), "OnComputeDone failed");
     return INTERNAL_ERROR;
   }
 
   if (output_op_list_.empty()) {
     GELOGW("Output tensor list is empty, model id: %u", model_id);
+    metrics_.AddRun(false);
     GE_CHK_STATUS(listener_->OnComputeDone(model_id, data_id, INTERNAL_ERROR), "OnComputeDone failed");
     return INTERNAL_ERROR;
   }
 
   GE_CHECK_NOTNULL(output_data);
+  uint64_t return_start = GetCurrentTimestap();
   // index of data in output_data
   uint32_t data_index = 0;
 
@@ -1298,14 +1323,24 @@ Status DavinciModel::ReturnResult(uint32_t model_id, uint32_t data_id, const boo
     Status ret = ModelOutput::CopyResult(this, op_desc, *output_data, data_index, support_mem_shared_flag_);
     if (ret != SUCCESS) {
       GELOGE(INTERNAL_ERROR, "CopyResult failed, op name: %s", op_desc->GetName().c_str());
+      metrics_.AddRun(false);
       GE_CHK_STATUS(listener_->OnComputeDone(model_id, data_id, INTERNAL_ERROR), "OnComputeDone failed");
       return INTERNAL_ERROR;
     }
   }
 
+  // the outputs shared with the user are not copied
+  for (const auto &blob : output_data->blobs) {
+    if (!(blob.isDataSupportMemShare && support_mem_shared_flag_)) {
+      metrics_.AddOutputBytes(blob.length);
+    }
+  }
+
   GE_IF_BOOL_EXEC((DumpOpInputOutput(op_list_, model_id) != SUCCESS),
                   GELOGW("dump op failed, model_id: %u", model_id););
 
+  metrics_.RecordStage(kModelRunOutputReturn, GetElapsedTime(return_start));
+  metrics_.AddRun(true);
   GE_CHK_STATUS(listener_->OnComputeDone(model_id, data_id, SUCCESS), "OnComputeDone failed");
   return SUCCESS;
 }
@@ -1317,6 +1352,7 @@ Status DavinciModel::ReturnResult(uint32_t model_id, uint32_t data_id, const boo
 ///
 Status DavinciModel::ReturnNoOutput(uint32_t model_id, uint32_t data_id) {
   GELOGI("ReturnNoOutput model id:%u", model_id);
+  uint64_t return_start = GetCurrentTimestap();
   for (const auto &op_desc : variable_op_list_) {
     Status ret = VarManager::Instance(session_id_)
                      ->SyncBroadCastData2Var(runtime_param_.graph_id, op_desc->GetName(), op_desc, mem_base_);
@@ -1326,6 +1362,8 @@ Status DavinciModel::ReturnNoOutput(uint32_t model_id, uint32_t data_id) {
 
   GE_IF_BOOL_EXEC(DumpOpInputOutput(op_list_, model_id) != SUCCESS, GELOGW("dump op failed, model_id: %u", model_id););
   GE_CHK_BOOL_EXEC(listener_ != nullptr, return PARAM_INVALID, "listener_ is null!");
+  metrics_.RecordStage(kModelRunOutputReturn, GetElapsedTime(return_start));
+  metrics_.AddRun(true);
   GE_CHK_STATUS(listener_->OnComputeDone(model_id, data_id, SUCCESS), "OnComputeDone failed");
   return SUCCESS;
 }
@@ -1345,9 +1383,13 @@ Status DavinciModel::DumpOpInputOutput(map<uint32_t, OpDescPtr> &op_list, uint32
   char *ge_dump_env = getenv("DUMP_OP");
   int dump_op_switch = (ge_dump_env != nullptr) ? std::strtol(ge_dump_env, nullptr, kDecimal) : 0;
   // 10 for decimal number
-  if (dump_op_switch != 0) {
+  const DumpFilter &dump_filter = data_dumper_.GetDumpFilter();
+  if (dump_op_switch != 0 && dump_filter.IsIterationNeedDump(data_dumper_.GetIteration())) {
     int64_t cnt = 1;
     for (auto it : op_list) {
+      if (!dump_filter.IsOpNeedDump(it.second)) {
+        continue;
+      }
       if (maxDumpOpNum_ != 0 && cnt > maxDumpOpNum_) {
         GELOGW("dump op cnt > maxDumpOpNum, maxDumpOpNum: %ld.", maxDumpOpNum_);
         return SUCCESS;
@@ -1456,6 +1498,7 @@ void *DavinciModel::Run(DavinciModel *model) {
     GELOGI("Getting the input data, model_id:%u", model_id);
 
     GE_IF_BOOL_EXEC(!model->RunFlag(), break);
+    model->metrics_.RecordStage(kModelRunQueueWait, GetElapsedTime(data_wrapper->GetPushTime()));
 
     InputData current_data = data_wrapper->GetInput();
     GELOGI("Model thread Run begin, model id:%u, data index:%d.", model_id, current_data.index);
@@ -1470,12 +1513,14 @@ void *DavinciModel::Run(DavinciModel *model) {
     GE_TIMESTAMP_END(Model_SyncVarData, "Model Run SyncVarData");
 
     GELOGI("Copy input data, model id:%u", model_id);
+    uint64_t copy_start = GetCurrentTimestap();
     ret = model->CopyInputData(current_data, false);
     GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(
         ret != SUCCESS,
         (void)model->ReturnResult(model->model_id_, current_data.index, false, false, data_wrapper->GetOutput());
         CsaInteract::GetInstance().StoreInternalErrorCode(ret, ERROR_MODULE_FMK, JOBSUBSTATE_GRAPH_EXEC);
         continue, "Copy input data to model failed.");  // [No need to check value]
+    model->metrics_.RecordStage(kModelRunInputCopy, GetElapsedTime(copy_start));
 
     if (ProfilingManager::Instance().ProfilingOpTraceOn()) {
       GELOGI("GetOpTraceIterNum:%d", ProfilingManager::Instance().GetOpTraceIterNum());
@@ -1503,6 +1548,7 @@ void *DavinciModel::Run(DavinciModel *model) {
     } else {
       GE_TIMESTAMP_START(rtModelExecute);
       GELOGI("rtModelExecute start.");
+      uint64_t execute_start = GetCurrentTimestap();
       rtError_t rt_ret_prof_off = rtModelExecute(model->rt_model_handle_, model->rt_model_stream_, 0);
       GE_IF_BOOL_EXEC(
           rt_ret_prof_off != RT_ERROR_NONE, rslt_flg = false;
@@ -1511,9 +1557,11 @@ void *DavinciModel::Run(DavinciModel *model) {
           continue);
       GELOGI("rtModelExecute end");
       GE_TIMESTAMP_END(rtModelExecute, "GraphExcute::rtModelExecute");
+      model->metrics_.RecordStage(kModelRunExecute, GetElapsedTime(execute_start));
 
       GE_TIMESTAMP_START(rtStreamSynchronize);
       GELOGI("rtStreamSynchronize start.");
+      uint64_t sync_start = GetCurrentTimestap();
       rt_ret_prof_off = rtStreamSynchronize(model->rt_model_stream_);
       if (rt_ret_prof_off == RT_ERROR_END_OF_SEQUENCE) {
         seq_end_flag = true;
@@ -1526,6 +1574,7 @@ void *DavinciModel::Run(DavinciModel *model) {
                       continue);
       GELOGI("rtStreamSynchronize end.");
       GE_TIMESTAMP_END(rtStreamSynchronize, "GraphExcute::Wait for rtStreamSynchronize");
+      model->metrics_.RecordStage(kModelRunStreamSync, GetElapsedTime(sync_start));
 
       // collect profiling for ge
       if (ProfilingManager::Instance().ProfilingOn()) {
@@ -1544,6 +1593,8 @@ void *DavinciModel::Run(DavinciModel *model) {
 
     interator_count++;
     GELOGI("interator_count=%u", interator_count);
+    GE_IF_BOOL_EXEC(model->data_dumper_.OnIterationEnd() != SUCCESS,
+                    GELOGW("Update dump info failed, model id: %u", model_id));
   }
 
   CsaInteract::GetInstance().WriteInternalErrorCode();
@@ -1647,10 +1698,8 @@ void DavinciModel::UnbindTaskSinkStream() {
 
 Status DavinciModel::InitTaskInfo(ModelTaskDef &model_task_def) {
   GELOGI("InitTaskInfo in,task size %zu", model_task_def.task().size());
-  task_list_.resize(model_task_def.task_size());
-  std::vector<std::future<Status>> futures(model_task_def.task_size());
-  constexpr uint32_t thread_num = THREAD_NUM;
-  ThreadPool executor(thread_num);
+  int32_t task_size = model_task_def.task_size();
+  task_list_.resize(task_size);
   rtContext_t ctx = nullptr;
   rtError_t rt_ret = rtCtxGetCurrent(&ctx);
   if (rt_ret != RT_ERROR_NONE || ctx == nullptr) {
@@ -1658,33 +1707,47 @@ Status DavinciModel::InitTaskInfo(ModelTaskDef &model_task_def) {
     return RT_FAILED;
   }
 
-  for (int32_t i = 0; i < model_task_def.task_size(); ++i) {
-    futures[i] = executor.commit(
-        [](const domi::TaskDef &task, DavinciModel *model, rtContext_t ctx, int32_t idx) -> Status {
-          rtError_t ctx_ret = rtCtxSetCurrent(ctx);
-          if (ctx_ret != RT_ERROR_NONE) {
-            GELOGE(RT_FAILED, "Failed to set context from rt, error-code 0x%X.", ctx_ret);
-            return RT_FAILED;
-          }
-
-          model->task_list_[idx] = TaskInfoFactory::Instance().Create(static_cast<rtModelTaskType_t>(task.type()));
-
-          Status ret = FAILED;
-          if (model->task_list_[idx] != nullptr) {
-            ret = model->task_list_[idx]->Init(task, model);
-          }
-          return ret;
-        },
-        model_task_def.task(i), this, ctx, i);
+  auto init_tasks = [this, &model_task_def](int32_t begin, int32_t end) -> Status {
+    for (int32_t i = begin; i < end; ++i) {
+      const domi::TaskDef &task = model_task_def.task(i);
+      task_list_[i] = TaskInfoFactory::Instance().Create(static_cast<rtModelTaskType_t>(task.type()));
+      Status ret = (task_list_[i] == nullptr) ? FAILED : task_list_[i]->Init(task, this);
+      if (ret != SUCCESS) {
+        GELOGE(ret, "Task index %d init fail.", i);
+        return ret;
+      }
+    }
+    return SUCCESS;
+  };
+
+  int32_t chunk_num = std::min(static_cast<int32_t>(THREAD_NUM), task_size / kMinTaskNumPerChunk);
+  if (chunk_num <= 1) {
+    // the current thread is already bound to the context
+    return init_tasks(0, task_size);
+  }
+
+  int32_t chunk_size = (task_size + chunk_num - 1) / chunk_num;
+  std::vector<std::future<Status>> futures;
+  for (int32_t begin = 0; begin < task_size; begin += chunk_size) {
+    int32_t end = std::min(begin + chunk_size, task_size);
+    futures.emplace_back(GetTaskInitPool().commit([&init_tasks, ctx, begin, end]() -> Status {
+      rtError_t ctx_ret = rtCtxSetCurrent(ctx);
+      if (ctx_ret != RT_ERROR_NONE) {
+        GELOGE(RT_FAILED, "Failed to set context from rt, error-code 0x%X.", ctx_ret);
+        return RT_FAILED;
+      }
+      return init_tasks(begin, end);
+    }));
   }
 
-  Status ret;
-  for (size_t i = 0; i < futures.size(); ++i) {
-    ret = futures[i].get();
-    if (ret != SUCCESS) {
-      GELOGE(ret, "Task index %zu init fail.", i);
-      return ret;
-    }
+  // the chunks refer to the task defs and the model, all of them are waited even if one fails
+  Status ret = SUCCESS;
+  for (auto &future : futures) {
+    Status chunk_ret = future.get();
+    ret = (ret == SUCCESS) ? chunk_ret : ret;
+  }
+  if (ret != SUCCESS) {
+    return ret;
   }
 
   GELOGI("InitTaskInfo out");
@@ -2041,33 +2104,28 @@ Status DavinciModel::InitTbeHandle(const OpDescPtr &op_desc) {
     if (!kernel_store.FindTBEHandle(bin_file_key, bin_handle)) {
       GELOGI("TBE: can't find the kernel_name[%s] in HandleMap", bin_file_key);
 
-      rtDevBinary_t binary;
+      uint32_t magic = 0;
       std::string json_string;
       GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc, TVM_ATTR_NAME_MAGIC, json_string),
                       GELOGI("Get original type of session_graph_id."));
       if (json_string == "RT_DEV_BINARY_MAGIC_ELF_AICPU") {
-        binary.magic = RT_DEV_BINARY_MAGIC_ELF_AICPU;
+        magic = RT_DEV_BINARY_MAGIC_ELF_AICPU;
       } else if (json_string == "RT_DEV_BINARY_MAGIC_ELF") {
-        binary.magic = RT_DEV_BINARY_MAGIC_ELF;
+        magic = RT_DEV_BINARY_MAGIC_ELF;
       } else {
         GELOGE(PARAM_INVALID, "TBE: Invalid parameter magic number! json: %s", json_string.c_str());
         return PARAM_INVALID;
       }
 
-      binary.version = 0;
-      binary.data = tbe_kernel->GetBinData();
-      binary.length = tbe_kernel->GetBinDataSize();
-
-      GELOGI("TBE: binary.length: %lu", binary.length);
-      GE_CHK_RT_RET(rtDevBinaryRegister(&binary, &bin_handle));
-
       std::string meta_data;
       GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc, TVM_ATTR_NAME_METADATA, meta_data),
                       GELOGI("Get original type of json_string"));
-      GELOGI("TBE: meta data: %s", meta_data.empty() ? "null" : meta_data.c_str());
-      GE_IF_BOOL_EXEC(!meta_data.empty(), GE_CHK_RT_RET(rtMetadataRegister(bin_handle, meta_data.c_str())));
-
-      kernel_store.StoreTBEHandle(bin_file_key, bin_handle, tbe_kernel);
+      GELOGI("TBE: binary.length: %zu, meta data: %s", tbe_kernel->GetBinDataSize(),
+             meta_data.empty() ? "null" : meta_data.c_str());
+      // identical binaries of other models share one registration, the store looks the name up again under its
+      // lock so the binary is never registered twice for one name
+      GE_CHK_STATUS_RET(kernel_store.RegisterTBEHandle(bin_file_key, tbe_kernel, magic, meta_data, bin_handle),
+                        "TBE: register binary of %s failed.", bin_file_key);
     } else {
       GELOGI("TBE: find the kernel_name[%s] in HandleMap", bin_file_key);
       kernel_store.ReferTBEHandle(bin_file_key);
@@ -2210,27 +2268,38 @@ Status DavinciModel::InitModelStream(rtStream_t stream, bool async_mode) {
 Status DavinciModel::NnExecute(rtStream_t stream, bool async_mode, const InputData &input_data,
                                OutputData &output_data) {
   GELOGI("Model Run begin, model id:%u, data index:%d, flag:%d.", model_id_, input_data.index, async_mode);
+  bool run_success = false;
+  GE_MAKE_GUARD(record_run, [&] { metrics_.AddRun(run_success); });
   GE_CHK_STATUS(InitModelStream(stream, async_mode), "Init model stream fail.");
 
   GELOGI("do rtModelExecute task sink, model id:%u", input_data.model_id);
+  uint64_t copy_start = GetCurrentTimestap();
   Status ret = ModelZeroCopy(input_data, output_data);
   GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(ret != SUCCESS, return INTERNAL_ERROR, "Copy input data to model failed.");
+  metrics_.RecordStage(kModelRunInputCopy, GetElapsedTime(copy_start));
 
   GELOGI("current_data.index=%u", input_data.index);
 
   GELOGD("rtModelExecute do");
 
+  uint64_t execute_start = GetCurrentTimestap();
   rtError_t rt_ret = rtModelExecute(rt_model_handle_, rt_model_stream_, 0);
   GE_CHK_RT_EXEC(rt_ret, return INTERNAL_ERROR);
   GELOGI("rtModelExecute end");
+  metrics_.RecordStage(kModelRunExecute, GetElapsedTime(execute_start));
 
   if (async_mode) {
+    uint64_t sync_start = GetCurrentTimestap();
     rt_ret = rtStreamSynchronize(rt_model_stream_);
     GE_IF_BOOL_EXEC(rt_ret != RT_ERROR_NONE, return INTERNAL_ERROR);
+    metrics_.RecordStage(kModelRunStreamSync, GetElapsedTime(sync_start));
   }
 
+  uint64_t return_start = GetCurrentTimestap();
   ret = SyncDataAndDump();
   GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(ret != SUCCESS, return INTERNAL_ERROR, "Copy Output data to user failed.");
+  metrics_.RecordStage(kModelRunOutputReturn, GetElapsedTime(return_start));
+  GE_IF_BOOL_EXEC(data_dumper_.OnIterationEnd() != SUCCESS, GELOGW("Update dump info failed, model id: %u", model_id_));
 
   // collect profiling for ge
   if (ProfilingManager::Instance().ProfilingOn()) {
@@ -2240,6 +2309,7 @@ Status DavinciModel::NnExecute(rtStream_t stream, bool async_mode, const InputDa
 
   GELOGI("Model run end, model id:%u", model_id_);
   GEEVENT("Model Run thread end, model_id:%u", model_id_);
+  run_success = true;
   return SUCCESS;
 }
 
@@ -2396,6 +2466,20 @@ void DavinciModel::InitDataDumper() {
   data_dumper_.SetModelId(model_id_);
   data_dumper_.SetMemory(runtime_param_);
 
+  std::map<std::string, std::string> dump_options;
+  for (const char *key : {OPTION_EXEC_DUMP_OP_NAME, OPTION_EXEC_DUMP_OP_TYPE, OPTION_EXEC_DUMP_INPUT_INDEX,
+                          OPTION_EXEC_DUMP_OUTPUT_INDEX, OPTION_EXEC_DUMP_STEP, OPTION_EXEC_DUMP_INTERVAL,
+                          OPTION_EXEC_DUMP_MAX_BYTES}) {
+    std::string value;
+    // option may not be set up, no need to check value
+    if (ge::GetContext().GetOption(key, value) == GRAPH_SUCCESS) {
+      dump_options[key] = value;
+    }
+  }
+  if (data_dumper_.SetDumpFilter(dump_options) != SUCCESS) {
+    GELOGW("Invalid dump filter of model %s, none of the filters takes effect.", name_.c_str());
+  }
+
   int32_t device_id = 0;
   rtError_t rt_ret = rtGetDevice(&device_id);
   if (rt_ret != RT_ERROR_NONE || device_id < 0) {
@@ -37,6 +37,7 @@
 #include "graph/debug/ge_attr_define.h"
 #include "graph/load/new_model_manager/data_dumper.h"
 #include "graph/load/new_model_manager/data_inputer.h"
+#include "graph/load/new_model_manager/model_metrics.h"
 #include "graph/load/new_model_manager/model_utils.h"
 #include "graph/model.h"
 #include "graph/node.h"
@@ -155,6 +156,13 @@ class DavinciModel {
   ///
   DataInputer *const GetDataInputer() const { return data_inputer_; }
 
+  ///
+  /// @ingroup domi_ome
+  /// @brief get the latency histograms and counters of the executions
+  /// @return ModelMetrics
+  ///
+  ModelMetrics &GetMetrics() { return metrics_; }
+
   // get Stream number
   uint32_t StreamNum() const { return runtime_param_.stream_num; }
 
@@ -615,6 +623,8 @@ class DavinciModel {
   int64_t maxDumpOpNum_;
   // for data dump
   DataDumper data_dumper_;
+
+  ModelMetrics metrics_;
 };
 
 #define TIME_LOG_HEAD_FMT "       OP_ID   OP_NAME                OP_TYPE           ELAPSED TIME(ms)"
@@ -535,6 +535,15 @@ Status ModelManager::GetMaxUsedMemory(const uint32_t model_id, uint64_t &max_siz
   return SUCCESS;
 }
 
+Status ModelManager::GetModelMetrics(const uint32_t model_id, ModelMetricsInfo &metrics, bool reset) {
+  std::shared_ptr<DavinciModel> davinci_model = GetModel(model_id);
+  GE_CHK_BOOL_RET_STATUS(davinci_model != nullptr, PARAM_INVALID, "GetModelMetrics Failed, Invalid Model ID %u !",
+                         model_id);
+
+  metrics = davinci_model->GetMetrics().Snapshot(reset);
+  return SUCCESS;
+}
+
 Status ModelManager::GetInputOutputDescInfo(const uint32_t model_id, vector<InputOutputDescInfo> &input_desc,
                                             vector<InputOutputDescInfo> &output_desc) {
   std::shared_ptr<DavinciModel> davinci_model = GetModel(model_id);
@@ -575,7 +584,8 @@ Status ModelManager::GetInputOutputDescInfoForZeroCopy(const uint32_t model_id,
 }
 
 Status ModelManager::LoadModelOffline(uint32_t &model_id, const ModelData &model, shared_ptr<ModelListener> listener,
-                                      void *dev_ptr, size_t mem_size, void *weight_ptr, size_t weight_size) {
+                                      void *dev_ptr, size_t mem_size, void *weight_ptr, size_t weight_size,
+                                      const std::shared_ptr<void> &model_owner) {
   GE_CHK_BOOL_RET_STATUS(model.key.empty() || access(model.key.c_str(), F_OK) == 0, PARAM_INVALID,
                            "input key file path is not valid!");
   GenModelId(&model_id);
@@ -583,7 +593,8 @@ Status ModelManager::LoadModelOffline(uint32_t &model_id, const ModelData &model
   shared_ptr<DavinciModel> davinci_model = nullptr;
 
   ModelHelper model_helper;
-  Status ret = model_helper.LoadModel(model);
+  Status ret =
+      (model_owner == nullptr) ? model_helper.LoadModel(model) : model_helper.LoadModelLazily(model, model_owner);
   if (ret != SUCCESS) {
     GELOGE(ret, "load model failed.");
     return ret;
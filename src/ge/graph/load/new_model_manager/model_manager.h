@@ -29,6 +29,7 @@
 #include "common/ge_inner_error_codes.h"
 #include "common/helper/model_helper.h"
 #include "common/helper/om_file_helper.h"
+#include "graph/load/new_model_manager/model_metrics.h"
 #include "graph/model.h"
 #include "runtime/base.h"
 #include "graph/ge_context.h"
@@ -49,12 +50,14 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ModelManager {
   /// @param [in] model including model ptr and size
   /// @param [in] listener used to return result
   /// @param [in/out] info model task generate info
+  /// @param [in] model_owner if not null, keeps the model data valid and the weights are not copied on host
   /// @return Status run result
   /// @author
   ///
   ge::Status LoadModelOffline(uint32_t &model_id, const ModelData &model,
                               std::shared_ptr<ModelListener> listener = nullptr, void *dev_ptr = nullptr,
-                              size_t mem_size = 0, void *weight_ptr = nullptr, size_t weight_size = 0);
+                              size_t mem_size = 0, void *weight_ptr = nullptr, size_t weight_size = 0,
+                              const std::shared_ptr<void> &model_owner = nullptr);
 
   ///
   /// @ingroup domi_ome
@@ -166,6 +169,17 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ModelManager {
   ///
   ge::Status GetMaxUsedMemory(const uint32_t model_id, uint64_t &max_size);
 
+  ///
+  /// @ingroup domi_ome
+  /// @brief get the run and failure counts, the copied bytes and the stage latencies of a model
+  /// @param [in] model_id  model id
+  /// @param [out] metrics  metrics since the model was loaded or the last reset
+  /// @param [in] reset  start counting from zero again after this call
+  /// @return SUCCESS          success
+  /// @return PARAM_INVALID    parameter invalid
+  ///
+  ge::Status GetModelMetrics(const uint32_t model_id, ModelMetricsInfo &metrics, bool reset = false);
+
   ///
   /// @ingroup domi_ome
   /// @brief get model input and output size
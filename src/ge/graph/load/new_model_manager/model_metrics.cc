@@ -0,0 +1,142 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/load/new_model_manager/model_metrics.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace ge {
+namespace {
+const uint64_t kPermille = 1000;
+const uint64_t kP50 = 500;
+const uint64_t kP90 = 900;
+const uint64_t kP99 = 990;
+const uint64_t kP999 = 999;
+const uint32_t kMsbOfUint64 = 63;
+
+const char *const kStageNames[kModelRunStageNum] = {"queue_wait", "input_copy", "model_execute", "stream_sync",
+                                                    "output_return"};
+
+uint64_t TakeValue(std::atomic<uint64_t> &value, bool reset) {
+  return reset ? value.exchange(0, std::memory_order_relaxed) : value.load(std::memory_order_relaxed);
+}
+
+// the smallest value which at least permille/1000 of the values are not above
+uint64_t GetPercentile(const std::vector<uint64_t> &counts, uint64_t total, uint64_t permille, uint64_t max_us) {
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t rank = std::max<uint64_t>((total * permille + kPermille - 1) / kPermille, 1);
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < counts.size(); ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return std::min(LatencyHistogram::GetBucketUpperBound(i), max_us);
+    }
+  }
+  return max_us;
+}
+}  // namespace
+
+const uint32_t LatencyHistogram::kSubBucketBits;
+const uint32_t LatencyHistogram::kSubBucketNum;
+const uint32_t LatencyHistogram::kMaxValueBits;
+const uint32_t LatencyHistogram::kBucketNum;
+
+LatencyHistogram::LatencyHistogram() : sum_us_(0), max_us_(0) {
+  for (auto &bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+uint32_t LatencyHistogram::GetBucketIndex(uint64_t value_us) {
+  if (value_us < kSubBucketNum) {
+    return static_cast<uint32_t>(value_us);
+  }
+  uint32_t msb = kMsbOfUint64 - static_cast<uint32_t>(__builtin_clzll(value_us));
+  if (msb >= kMaxValueBits) {
+    return kBucketNum - 1;
+  }
+  uint32_t shift = msb - kSubBucketBits;
+  uint32_t sub_index = static_cast<uint32_t>(value_us >> shift) & (kSubBucketNum - 1);
+  return (shift + 1) * kSubBucketNum + sub_index;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(uint32_t index) {
+  if (index < kSubBucketNum) {
+    return index;
+  }
+  uint32_t shift = index / kSubBucketNum - 1;
+  uint64_t lower = static_cast<uint64_t>(kSubBucketNum + index % kSubBucketNum) << shift;
+  return lower + (static_cast<uint64_t>(1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value_us) {
+  buckets_[GetBucketIndex(value_us)].fetch_add(1, std::memory_order_relaxed);
+  sum_us_.fetch_add(value_us, std::memory_order_relaxed);
+  uint64_t max_us = max_us_.load(std::memory_order_relaxed);
+  while (value_us > max_us && !max_us_.compare_exchange_weak(max_us, value_us, std::memory_order_relaxed)) {
+  }
+}
+
+LatencyStats LatencyHistogram::Snapshot(bool reset) {
+  LatencyStats stats;
+  std::vector<uint64_t> counts(kBucketNum, 0);
+  for (uint32_t i = 0; i < kBucketNum; ++i) {
+    counts[i] = TakeValue(buckets_[i], reset);
+    stats.count += counts[i];
+  }
+  stats.sum_us = TakeValue(sum_us_, reset);
+  stats.max_us = TakeValue(max_us_, reset);
+  stats.p50_us = GetPercentile(counts, stats.count, kP50, stats.max_us);
+  stats.p90_us = GetPercentile(counts, stats.count, kP90, stats.max_us);
+  stats.p99_us = GetPercentile(counts, stats.count, kP99, stats.max_us);
+  stats.p999_us = GetPercentile(counts, stats.count, kP999, stats.max_us);
+  return stats;
+}
+
+ModelMetrics::ModelMetrics() : run_count_(0), fail_count_(0), input_bytes_(0), output_bytes_(0) {}
+
+void ModelMetrics::RecordStage(ModelRunStage stage, uint64_t cost_us) {
+  if (stage < kModelRunStageNum) {
+    stages_[stage].Record(cost_us);
+  }
+}
+
+void ModelMetrics::AddRun(bool success) {
+  run_count_.fetch_add(1, std::memory_order_relaxed);
+  if (!success) {
+    fail_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+ModelMetricsInfo ModelMetrics::Snapshot(bool reset) {
+  ModelMetricsInfo info;
+  info.run_count = TakeValue(run_count_, reset);
+  info.fail_count = TakeValue(fail_count_, reset);
+  info.input_bytes = TakeValue(input_bytes_, reset);
+  info.output_bytes = TakeValue(output_bytes_, reset);
+  for (uint32_t i = 0; i < kModelRunStageNum; ++i) {
+    info.stages[i] = stages_[i].Snapshot(reset);
+  }
+  return info;
+}
+
+std::string ModelMetrics::GetStageName(ModelRunStage stage) {
+  return stage < kModelRunStageNum ? kStageNames[stage] : "unknown";
+}
+}  // namespace ge
@@ -0,0 +1,140 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_LOAD_NEW_MODEL_MANAGER_MODEL_METRICS_H_
+#define GE_GRAPH_LOAD_NEW_MODEL_MANAGER_MODEL_METRICS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace ge {
+///
+/// @ingroup domi_ome
+/// @brief the stages of one execution of a DavinciModel
+///
+enum ModelRunStage {
+  kModelRunQueueWait = 0,  // from DataInputer::Push to the model thread popping the data
+  kModelRunInputCopy,      // copy of the inputs to the model memory
+  kModelRunExecute,        // rtModelExecute
+  kModelRunStreamSync,     // rtStreamSynchronize
+  kModelRunOutputReturn,   // copy of the outputs to the user
+  kModelRunStageNum
+};
+
+///
+/// @ingroup domi_ome
+/// @brief latency statistics of one stage, in microseconds
+///
+struct LatencyStats {
+  uint64_t count = 0;
+  uint64_t sum_us = 0;
+  uint64_t max_us = 0;
+  uint64_t p50_us = 0;
+  uint64_t p90_us = 0;
+  uint64_t p99_us = 0;
+  uint64_t p999_us = 0;
+};
+
+///
+/// @ingroup domi_ome
+/// @brief runtime metrics of a model since it was loaded or the metrics were last reset
+///
+struct ModelMetricsInfo {
+  uint64_t run_count = 0;
+  uint64_t fail_count = 0;
+  uint64_t input_bytes = 0;   // bytes copied from the user to the model
+  uint64_t output_bytes = 0;  // bytes copied from the model to the user
+  LatencyStats stages[kModelRunStageNum];
+};
+
+///
+/// @ingroup domi_ome
+/// @brief histogram of latencies in log-linear buckets, like HdrHistogram: values below 16us are exact, above it
+///        every power of two is split into 16 buckets, so a percentile is within 1/16 of the recorded value.
+///        Record is lock-free and may race with Snapshot, a value recorded meanwhile lands in this snapshot or the
+///        next one.
+///
+class LatencyHistogram {
+ public:
+  static const uint32_t kSubBucketBits = 4;
+  static const uint32_t kSubBucketNum = 1U << kSubBucketBits;
+  // values up to 2^36us, about 19 hours, larger ones are counted in the last bucket
+  static const uint32_t kMaxValueBits = 36;
+  static const uint32_t kBucketNum = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketNum;
+
+  LatencyHistogram();
+  ~LatencyHistogram() = default;
+  LatencyHistogram(const LatencyHistogram &) = delete;
+  LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+  void Record(uint64_t value_us);
+
+  ///
+  /// @ingroup domi_ome
+  /// @brief get the statistics of the recorded values
+  /// @param [in] reset clear the values taken by this snapshot
+  ///
+  LatencyStats Snapshot(bool reset);
+
+  static uint32_t GetBucketIndex(uint64_t value_us);
+  // the largest value counted in the bucket
+  static uint64_t GetBucketUpperBound(uint32_t index);
+
+ private:
+  std::atomic<uint64_t> buckets_[kBucketNum];
+  std::atomic<uint64_t> sum_us_;
+  std::atomic<uint64_t> max_us_;
+};
+
+///
+/// @ingroup domi_ome
+/// @brief runtime metrics of a DavinciModel, updated by the model thread and read by ModelManager::GetModelMetrics
+///
+class ModelMetrics {
+ public:
+  ModelMetrics();
+  ~ModelMetrics() = default;
+  ModelMetrics(const ModelMetrics &) = delete;
+  ModelMetrics &operator=(const ModelMetrics &) = delete;
+
+  void RecordStage(ModelRunStage stage, uint64_t cost_us);
+
+  void AddRun(bool success);
+
+  void AddInputBytes(uint64_t bytes) { input_bytes_.fetch_add(bytes, std::memory_order_relaxed); }
+
+  void AddOutputBytes(uint64_t bytes) { output_bytes_.fetch_add(bytes, std::memory_order_relaxed); }
+
+  ///
+  /// @ingroup domi_ome
+  /// @brief get the metrics
+  /// @param [in] reset start counting from zero again after this snapshot
+  ///
+  ModelMetricsInfo Snapshot(bool reset);
+
+  static std::string GetStageName(ModelRunStage stage);
+
+ private:
+  LatencyHistogram stages_[kModelRunStageNum];
+  std::atomic<uint64_t> run_count_;
+  std::atomic<uint64_t> fail_count_;
+  std::atomic<uint64_t> input_bytes_;
+  std::atomic<uint64_t> output_bytes_;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_LOAD_NEW_MODEL_MANAGER_MODEL_METRICS_H_
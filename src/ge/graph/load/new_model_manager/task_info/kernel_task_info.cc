@@ -25,6 +25,7 @@
 #include "framework/common/l2_cache_optimize.h"
 #include "graph/load/new_model_manager/davinci_model.h"
 #include "graph/load/new_model_manager/model_utils.h"
+#include "graph/manager/graph_mem_allocator.h"
 #include "runtime/kernel.h"
 
 namespace ge {
@@ -144,7 +145,7 @@ Status KernelTaskInfo::Distribute() {
 }
 
 Status KernelTaskInfo::Release() {
-  FreeRtMem(&args_);
+  FreeArgs();
   FreeRtMem(&flowtable_);
   FreeRtMem(&custom_info_.input_descs);
   FreeRtMem(&custom_info_.input_addrs);
@@ -202,10 +203,9 @@ Status KernelTaskInfo::InitTVMTask(DavinciModel *davinci_model, uint16_t offset,
   tensor_device_addrs.insert(tensor_device_addrs.end(), workspace_data_addrs.begin(), workspace_data_addrs.end());
 
   // malloc args memory
-  rt_ret = rtMalloc(&args_, args_size_, RT_MEMORY_HBM);
-  if (rt_ret != RT_ERROR_NONE) {
-    GELOGE(RT_FAILED, "Call rt api failed, ret: 0x%X", rt_ret);
-    return RT_FAILED;
+  Status ret = MallocArgs(args_size_);
+  if (ret != SUCCESS) {
+    return ret;
   }
 
   // copy orign args
@@ -359,10 +359,9 @@ Status KernelTaskInfo::InitAICPUCustomTask(const std::map<uint32_t, std::shared_
   *(reinterpret_cast<uint64_t *>(args + ctx_.argsOffset[4])) =
       reinterpret_cast<uint64_t>(custom_info_.attr_handle);  // arg 4
 
-  rt_ret = rtMalloc(&args_, args_size_, RT_MEMORY_HBM);
-  if (rt_ret != RT_ERROR_NONE) {
-    GELOGE(RT_FAILED, "Call rt api failed, ret: 0x%X", rt_ret);
-    return RT_FAILED;
+  ret = MallocArgs(args_size_);
+  if (ret != SUCCESS) {
+    return ret;
   }
 
   rt_ret = rtMemcpy(args_, kernel_def.args_size(), kernel_def.args().data(), kernel_def.args_size(),
@@ -426,13 +425,12 @@ Status KernelTaskInfo::InitCceTask(DavinciModel *davinci_model, const domi::Kern
   }
 
   // args
-  rtError_t rt_ret = rtMalloc(&args_, kernel_def.args_size(), RT_MEMORY_HBM);
-  if (rt_ret != RT_ERROR_NONE) {
-    GELOGE(RT_FAILED, "Call rt api failed, ret: 0x%X", rt_ret);
-    return RT_FAILED;
+  ret = MallocArgs(kernel_def.args_size());
+  if (ret != SUCCESS) {
+    return ret;
   }
 
-  rt_ret = rtMemcpy(args_, kernel_def.args_size(), kernel_def.args().data(), kernel_def.args_size(),
+  rtError_t rt_ret = rtMemcpy(args_, kernel_def.args_size(), kernel_def.args().data(), kernel_def.args_size(),
                     RT_MEMCPY_HOST_TO_DEVICE);
   if (rt_ret != RT_ERROR_NONE) {
     GELOGE(RT_FAILED, "Call rt api failed, ret: 0x%X", rt_ret);
@@ -496,14 +494,14 @@ Status KernelTaskInfo::InitAicpuTask(const std::map<uint32_t, OpDescPtr> &op_lis
   }
 
   // malloc device memory for args
-  rtError_t rt_ret = rtMalloc(static_cast<void **>(&args_), args_size_, RT_MEMORY_HBM);
-  if (rt_ret != RT_ERROR_NONE) {
-    GELOGE(RT_FAILED, "Call rt api(rtMalloc) failed, ret: 0x%X", rt_ret);
-    return RT_FAILED;
+  Status ret = MallocArgs(args_size_);
+  if (ret != SUCCESS) {
+    return ret;
   }
 
   // copy args to device
-  rt_ret = rtMemcpy(args_, args_size_, static_cast<void *>(args_addr.get()), args_size_, RT_MEMCPY_HOST_TO_DEVICE);
+  rtError_t rt_ret =
+      rtMemcpy(args_, args_size_, static_cast<void *>(args_addr.get()), args_size_, RT_MEMCPY_HOST_TO_DEVICE);
   if (rt_ret != RT_ERROR_NONE) {
     GELOGE(RT_FAILED, "Call rt api(rtMemcpy) failed, ret: 0x%X", rt_ret);
     return RT_FAILED;
@@ -624,6 +622,34 @@ Status KernelTaskInfo::SetContext(const domi::KernelDef &kernel_def) {
   return SUCCESS;
 }
 
+Status KernelTaskInfo::MallocArgs(uint32_t args_size) {
+  // args are small and come and go with every model load, so they are taken from the caching allocator.
+  // They are cached stream independent: the model streams are destroyed on unload, a block cached under one of
+  // them would never be reused by the next load.
+  CachingAllocator *caching_allocator = MemManager::CachingInstance(RT_MEMORY_HBM);
+  if (caching_allocator == nullptr) {
+    GELOGE(RT_FAILED, "Get caching allocator failed.");
+    return RT_FAILED;
+  }
+  args_ = caching_allocator->Malloc(args_size);
+  if (args_ == nullptr) {
+    GELOGE(RT_FAILED, "Malloc args failed, size: %u", args_size);
+    return RT_FAILED;
+  }
+  return SUCCESS;
+}
+
+void KernelTaskInfo::FreeArgs() {
+  if (args_ == nullptr) {
+    return;
+  }
+  CachingAllocator *caching_allocator = MemManager::CachingInstance(RT_MEMORY_HBM);
+  if (caching_allocator == nullptr || caching_allocator->Free(static_cast<uint8_t *>(args_)) != SUCCESS) {
+    GELOGE(RT_FAILED, "Free args failed.");
+  }
+  args_ = nullptr;
+}
+
 void KernelTaskInfo::FreeRtMem(void **ptr) {
   if (ptr == nullptr || *ptr == nullptr) {
     return;
@@ -94,6 +94,10 @@ class KernelTaskInfo : public TaskInfo {
 
   Status SetFlowtable(std::string &flowtable, const domi::KernelDef &kernel_def);
 
+  Status MallocArgs(uint32_t args_size);
+
+  void FreeArgs();
+
   static void FreeRtMem(void **ptr);
 
   void *stub_func_;
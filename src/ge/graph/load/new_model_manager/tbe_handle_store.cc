@@ -16,31 +16,50 @@
 
 #include "graph/load/new_model_manager/tbe_handle_store.h"
 
+#include <cstring>
 #include <limits>
+#include <tuple>
+#include <utility>
+
 #include "common/ge_inner_error_codes.h"
 #include "framework/common/debug/ge_log.h"
 #include "runtime/kernel.h"
 
 namespace ge {
-void TbeHandleInfo::used_inc(uint32_t num) {
-  if (used_ > std::numeric_limits<uint32_t>::max() - num) {
-    GELOGE(INTERNAL_ERROR, "Used[%u] reach numeric max.", used_);
-    return;
+namespace {
+const uint64_t kFnvOffsetBasis = 14695981039346656037UL;
+const uint64_t kFnvPrime = 1099511628211UL;
+
+uint64_t FnvHash(const uint8_t *data, size_t size, uint64_t hash) {
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= data[i];
+    hash *= kFnvPrime;
   }
+  return hash;
+}
+}  // namespace
 
-  used_ += num;
+void TbeHandleInfo::used_inc(uint32_t num) {
+  uint32_t used = used_.load();
+  do {
+    if (used > std::numeric_limits<uint32_t>::max() - num) {
+      GELOGE(INTERNAL_ERROR, "Used[%u] reach numeric max.", used);
+      return;
+    }
+  } while (!used_.compare_exchange_weak(used, used + num));
 }
 
 void TbeHandleInfo::used_dec(uint32_t num) {
-  if (used_ < std::numeric_limits<uint32_t>::min() + num) {
-    GELOGE(INTERNAL_ERROR, "Used[%u] reach numeric min.", used_);
-    return;
-  }
-
-  used_ -= num;
+  uint32_t used = used_.load();
+  do {
+    if (used < std::numeric_limits<uint32_t>::min() + num) {
+      GELOGE(INTERNAL_ERROR, "Used[%u] reach numeric min.", used);
+      return;
+    }
+  } while (!used_.compare_exchange_weak(used, used - num));
 }
 
-uint32_t TbeHandleInfo::used_num() const { return used_; }
+uint32_t TbeHandleInfo::used_num() const { return used_.load(); }
 
 void *TbeHandleInfo::handle() const { return handle_; }
 
@@ -58,7 +77,7 @@ TBEHandleStore &TBEHandleStore::GetInstance() {
 /// @return true: found / false: not found.
 ///
 bool TBEHandleStore::FindTBEHandle(const std::string &name, void *&handle) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  ReadLockGuard lock(lock_);
   auto it = kernels_.find(name);
   if (it == kernels_.end()) {
     return false;
@@ -78,16 +97,51 @@ bool TBEHandleStore::FindTBEHandle(const std::string &name, void *&handle) {
 /// @return NA
 ///
 void TBEHandleStore::StoreTBEHandle(const std::string &name, void *handle, std::shared_ptr<OpKernelBin> &kernel) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  WriteLockGuard lock(lock_);
   auto it = kernels_.find(name);
   if (it == kernels_.end()) {
-    TbeHandleInfo info(handle, kernel);
-    info.used_inc();
-    kernels_.emplace(name, info);
-  } else {
+    it = kernels_.emplace(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple(handle, kernel))
+             .first;
+  }
+  TbeHandleInfo &info = it->second;
+  info.used_inc();
+}
+
+///
+/// @ingroup ge
+/// @brief Find TBE handle by name, register its binary and store it if not found, all under one lock.
+/// @param [in] name: TBE handle name.
+/// @param [in] kernel: TBE kernel bin to register.
+/// @param [in] magic: binary magic, such as RT_DEV_BINARY_MAGIC_ELF.
+/// @param [in] meta_data: meta data registered with the binary, may be empty.
+/// @param [out] handle: TBE handle addr found or registered.
+/// @return SUCCESS / others
+///
+Status TBEHandleStore::RegisterTBEHandle(const std::string &name, std::shared_ptr<OpKernelBin> &kernel,
+                                         uint32_t magic, const std::string &meta_data, void *&handle) {
+  // a lookup and a store under separate locks let two callers both register the binary, but the name keeps one
+  // handle and its binary is released once when the name is erased
+  WriteLockGuard lock(lock_);
+  auto it = kernels_.find(name);
+  if (it != kernels_.end()) {
     TbeHandleInfo &info = it->second;
     info.used_inc();
+    handle = info.handle();
+    return SUCCESS;
+  }
+
+  void *bin_handle = nullptr;
+  Status ret = RegisterBinary(kernel, magic, meta_data, bin_handle);
+  if (ret != SUCCESS) {
+    return ret;
   }
+  it = kernels_
+           .emplace(std::piecewise_construct, std::forward_as_tuple(name),
+                    std::forward_as_tuple(bin_handle, kernel))
+           .first;
+  it->second.used_inc();
+  handle = bin_handle;
+  return SUCCESS;
 }
 
 ///
@@ -97,7 +151,8 @@ void TBEHandleStore::StoreTBEHandle(const std::string &name, void *handle, std::
 /// @return NA
 ///
 void TBEHandleStore::ReferTBEHandle(const std::string &name) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  // entries are only erased under the write lock, the used num itself is atomic
+  ReadLockGuard lock(lock_);
   auto it = kernels_.find(name);
   if (it == kernels_.end()) {
     GELOGE(INTERNAL_ERROR, "Kernel[%s] not found in stored.", name.c_str());
@@ -115,7 +170,7 @@ void TBEHandleStore::ReferTBEHandle(const std::string &name) {
 /// @return NA
 ///
 void TBEHandleStore::EraseTBEHandle(const std::map<std::string, uint32_t> &names) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  WriteLockGuard lock(lock_);
   for (auto &item : names) {
     auto it = kernels_.find(item.first);
     if (it == kernels_.end()) {
@@ -127,12 +182,117 @@ void TBEHandleStore::EraseTBEHandle(const std::map<std::string, uint32_t> &names
     if (info.used_num() > item.second) {
       info.used_dec(item.second);
     } else {
-      rtError_t rt_ret = rtDevBinaryUnRegister(info.handle());
-      if (rt_ret != RT_ERROR_NONE) {
-        GELOGE(INTERNAL_ERROR, "Kernel[%s] UnRegister handle fail:%u.", item.first.c_str(), rt_ret);
-      }
+      UnRegisterBinary(info.handle());
       kernels_.erase(it);
     }
   }
 }
+
+uint64_t TBEHandleStore::GetBinaryHash(const OpKernelBin &kernel, uint32_t magic, const std::string &meta_data) {
+  uint64_t hash = FnvHash(kernel.GetBinData(), kernel.GetBinDataSize(), kFnvOffsetBasis);
+  hash = FnvHash(reinterpret_cast<const uint8_t *>(&magic), sizeof(magic), hash);
+  return FnvHash(reinterpret_cast<const uint8_t *>(meta_data.data()), meta_data.size(), hash);
+}
+
+bool TBEHandleStore::IsSameBinary(const BinaryHandleInfo &info, const OpKernelBin &kernel, uint32_t magic,
+                                  const std::string &meta_data) {
+  if (info.kernel == nullptr || info.magic != magic || info.meta_data != meta_data ||
+      info.kernel->GetBinDataSize() != kernel.GetBinDataSize()) {
+    return false;
+  }
+  return memcmp(info.kernel->GetBinData(), kernel.GetBinData(), kernel.GetBinDataSize()) == 0;
+}
+
+///
+/// @ingroup ge
+/// @brief Register kernel binary to runtime, a binary with the same content is registered only once.
+/// @param [in] kernel: TBE kernel bin to register.
+/// @param [in] magic: binary magic, such as RT_DEV_BINARY_MAGIC_ELF.
+/// @param [in] meta_data: meta data registered with the binary, may be empty.
+/// @param [out] handle: registered binary handle.
+/// @return SUCCESS / others
+///
+Status TBEHandleStore::RegisterBinary(const std::shared_ptr<OpKernelBin> &kernel, uint32_t magic,
+                                      const std::string &meta_data, void *&handle) {
+  if (kernel == nullptr) {
+    GELOGE(PARAM_INVALID, "Kernel bin to register is null.");
+    return PARAM_INVALID;
+  }
+  uint64_t hash = GetBinaryHash(*kernel, magic, meta_data);
+
+  std::lock_guard<std::mutex> lock(binary_mutex_);
+  auto range = binary_hashes_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    auto bin_it = binaries_.find(it->second);
+    if (bin_it != binaries_.end() && IsSameBinary(bin_it->second, *kernel, magic, meta_data)) {
+      bin_it->second.used++;
+      handle = it->second;
+      GELOGI("TBE: binary of kernel[%s] registered before, used[%u].", kernel->GetName().c_str(),
+             bin_it->second.used);
+      return SUCCESS;
+    }
+  }
+
+  rtDevBinary_t binary;
+  binary.magic = magic;
+  binary.version = 0;
+  binary.data = kernel->GetBinData();
+  binary.length = kernel->GetBinDataSize();
+  void *bin_handle = nullptr;
+  rtError_t rt_ret = rtDevBinaryRegister(&binary, &bin_handle);
+  if (rt_ret != RT_ERROR_NONE) {
+    GELOGE(RT_FAILED, "Kernel[%s] rtDevBinaryRegister fail:%u.", kernel->GetName().c_str(), rt_ret);
+    return RT_FAILED;
+  }
+  if (!meta_data.empty()) {
+    rt_ret = rtMetadataRegister(bin_handle, meta_data.c_str());
+    if (rt_ret != RT_ERROR_NONE) {
+      GELOGE(RT_FAILED, "Kernel[%s] rtMetadataRegister fail:%u.", kernel->GetName().c_str(), rt_ret);
+      (void)rtDevBinaryUnRegister(bin_handle);
+      return RT_FAILED;
+    }
+  }
+
+  BinaryHandleInfo &info = binaries_[bin_handle];
+  info.hash = hash;
+  info.magic = magic;
+  info.meta_data = meta_data;
+  info.kernel = kernel;
+  info.used = 1;
+  binary_hashes_.emplace(hash, bin_handle);
+  handle = bin_handle;
+  return SUCCESS;
+}
+
+///
+/// @ingroup ge
+/// @brief Release a binary got from RegisterBinary, it is unregistered from runtime when no one uses it.
+/// @param [in] handle: registered binary handle.
+/// @return NA
+///
+void TBEHandleStore::UnRegisterBinary(void *handle) {
+  std::lock_guard<std::mutex> lock(binary_mutex_);
+  auto it = binaries_.find(handle);
+  if (it != binaries_.end()) {
+    BinaryHandleInfo &info = it->second;
+    if (info.used > 1) {
+      info.used--;
+      return;
+    }
+    auto range = binary_hashes_.equal_range(info.hash);
+    for (auto hash_it = range.first; hash_it != range.second; ++hash_it) {
+      if (hash_it->second == handle) {
+        binary_hashes_.erase(hash_it);
+        break;
+      }
+    }
+    binaries_.erase(it);
+  }
+
+  // handles not registered through the store are unregistered directly
+  rtError_t rt_ret = rtDevBinaryUnRegister(handle);
+  if (rt_ret != RT_ERROR_NONE) {
+    GELOGE(INTERNAL_ERROR, "UnRegister handle fail:%u.", rt_ret);
+  }
+}
 }  // namespace ge
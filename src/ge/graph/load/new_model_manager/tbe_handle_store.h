@@ -17,6 +17,8 @@
 #ifndef GE_GRAPH_LOAD_NEW_MODEL_MANAGER_TBE_HANDLE_STORE_H_
 #define GE_GRAPH_LOAD_NEW_MODEL_MANAGER_TBE_HANDLE_STORE_H_
 
+#include <pthread.h>
+#include <atomic>
 #include <cstdint>
 
 #include <map>
@@ -26,15 +28,58 @@
 #include <unordered_map>
 
 #include "common/fmk_types.h"
+#include "common/ge_inner_error_codes.h"
 #include "graph/op_kernel_bin.h"
 
 namespace ge {
+///
+/// @ingroup ge
+/// @brief Readers share the lock, a writer holds it alone.
+///
+class ReadWriteLock {
+ public:
+  ReadWriteLock() { (void)pthread_rwlock_init(&lock_, nullptr); }
+  ~ReadWriteLock() { (void)pthread_rwlock_destroy(&lock_); }
+
+  ReadWriteLock(const ReadWriteLock &) = delete;
+  ReadWriteLock &operator=(const ReadWriteLock &) = delete;
+
+  void ReadLock() { (void)pthread_rwlock_rdlock(&lock_); }
+  void WriteLock() { (void)pthread_rwlock_wrlock(&lock_); }
+  void UnLock() { (void)pthread_rwlock_unlock(&lock_); }
+
+ private:
+  pthread_rwlock_t lock_;
+};
+
+class ReadLockGuard {
+ public:
+  explicit ReadLockGuard(ReadWriteLock &lock) : lock_(lock) { lock_.ReadLock(); }
+  ~ReadLockGuard() { lock_.UnLock(); }
+
+ private:
+  ReadWriteLock &lock_;
+};
+
+class WriteLockGuard {
+ public:
+  explicit WriteLockGuard(ReadWriteLock &lock) : lock_(lock) { lock_.WriteLock(); }
+  ~WriteLockGuard() { lock_.UnLock(); }
+
+ private:
+  ReadWriteLock &lock_;
+};
+
 class TbeHandleInfo {
  public:
   TbeHandleInfo(void *handle, std::shared_ptr<OpKernelBin> &kernel) : used_(0), handle_(handle), kernel_(kernel) {}
 
   ~TbeHandleInfo() { handle_ = nullptr; }
 
+  TbeHandleInfo(const TbeHandleInfo &) = delete;
+  TbeHandleInfo &operator=(const TbeHandleInfo &) = delete;
+
+  // used num is changed atomically, the caller only needs to share the store lock
   void used_inc(uint32_t num = 1);
   void used_dec(uint32_t num = 1);
   uint32_t used_num() const;
@@ -42,12 +87,21 @@ class TbeHandleInfo {
   void *handle() const;
 
  private:
-  uint32_t used_;
+  std::atomic<uint32_t> used_;
 
   void *handle_;
   std::shared_ptr<OpKernelBin> kernel_;
 };
 
+// a registered device binary, shared by every kernel whose binary has the same content
+struct BinaryHandleInfo {
+  uint64_t hash = 0;
+  uint32_t magic = 0;
+  std::string meta_data;
+  std::shared_ptr<OpKernelBin> kernel;
+  uint32_t used = 0;
+};
+
 class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY TBEHandleStore {
  public:
   static TBEHandleStore &GetInstance();
@@ -71,6 +125,19 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY TBEHandleStore {
   ///
   void StoreTBEHandle(const std::string &name, void *handle, std::shared_ptr<OpKernelBin> &kernel);
 
+  ///
+  /// @ingroup ge
+  /// @brief Find TBE handle by name, register its binary and store it if not found, all under one lock.
+  /// @param [in] name: TBE handle name.
+  /// @param [in] kernel: TBE kernel bin to register.
+  /// @param [in] magic: binary magic, such as RT_DEV_BINARY_MAGIC_ELF.
+  /// @param [in] meta_data: meta data registered with the binary, may be empty.
+  /// @param [out] handle: TBE handle addr found or registered.
+  /// @return SUCCESS / others
+  ///
+  Status RegisterTBEHandle(const std::string &name, std::shared_ptr<OpKernelBin> &kernel, uint32_t magic,
+                           const std::string &meta_data, void *&handle);
+
   ///
   /// @ingroup ge
   /// @brief Increase reference of registered TBE handle info.
@@ -87,12 +154,41 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY TBEHandleStore {
   ///
   void EraseTBEHandle(const std::map<std::string, uint32_t> &names);
 
+  ///
+  /// @ingroup ge
+  /// @brief Register kernel binary to runtime, a binary with the same content is registered only once.
+  /// @param [in] kernel: TBE kernel bin to register.
+  /// @param [in] magic: binary magic, such as RT_DEV_BINARY_MAGIC_ELF.
+  /// @param [in] meta_data: meta data registered with the binary, may be empty.
+  /// @param [out] handle: registered binary handle.
+  /// @return SUCCESS / others
+  ///
+  Status RegisterBinary(const std::shared_ptr<OpKernelBin> &kernel, uint32_t magic, const std::string &meta_data,
+                        void *&handle);
+
+  ///
+  /// @ingroup ge
+  /// @brief Release a binary got from RegisterBinary, it is unregistered from runtime when no one uses it.
+  /// @param [in] handle: registered binary handle.
+  /// @return NA
+  ///
+  void UnRegisterBinary(void *handle);
+
+  static uint64_t GetBinaryHash(const OpKernelBin &kernel, uint32_t magic, const std::string &meta_data);
+
  private:
   TBEHandleStore() = default;
   ~TBEHandleStore() = default;
 
-  std::mutex mutex_;
+  static bool IsSameBinary(const BinaryHandleInfo &info, const OpKernelBin &kernel, uint32_t magic,
+                           const std::string &meta_data);
+
+  ReadWriteLock lock_;
   std::unordered_map<std::string, TbeHandleInfo> kernels_;
+
+  std::mutex binary_mutex_;
+  std::unordered_map<void *, BinaryHandleInfo> binaries_;
+  std::unordered_multimap<uint64_t, void *> binary_hashes_;
 };
 }  // namespace ge
 
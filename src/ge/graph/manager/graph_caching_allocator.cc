@@ -0,0 +1,194 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/manager/graph_caching_allocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "framework/common/debug/ge_log.h"
+
+namespace ge {
+bool CachingAllocator::BlockComparator::operator()(const MemoryBlock *left, const MemoryBlock *right) const {
+  if (left->stream != right->stream) {
+    return reinterpret_cast<uintptr_t>(left->stream) < reinterpret_cast<uintptr_t>(right->stream);
+  }
+  if (left->size != right->size) {
+    return left->size < right->size;
+  }
+  return reinterpret_cast<uintptr_t>(left->ptr) < reinterpret_cast<uintptr_t>(right->ptr);
+}
+
+CachingAllocator::CachingAllocator(rtMemType_t memory_type)
+    : memory_type_(memory_type), bypass_(std::getenv(kEnvDisableMemoryCache) != nullptr) {
+  GELOGI("CachingAllocator memory type[%u] created, bypass = %d.", memory_type_, static_cast<int>(bypass_));
+}
+
+CachingAllocator::~CachingAllocator() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  EmptyCacheLocked();
+  if (!allocated_blocks_.empty()) {
+    // memory still in use is released by its owner through rtFree after the cache is gone
+    GELOGW("CachingAllocator memory type[%u] destroyed with %zu blocks in use.", memory_type_,
+           allocated_blocks_.size());
+  }
+  for (auto &it : allocated_blocks_) {
+    delete it.second;
+  }
+  allocated_blocks_.clear();
+}
+
+size_t CachingAllocator::RoundSize(size_t size) {
+  size_t round_size = (size < kLargeBlockThreshold) ? kSmallRoundSize : kLargeRoundSize;
+  if (size == 0) {
+    return round_size;
+  }
+  return (size + round_size - 1) / round_size * round_size;
+}
+
+uint8_t *CachingAllocator::Malloc(size_t size, rtStream_t stream, uint32_t device_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t round_size = bypass_ ? size : RoundSize(size);
+
+  MemoryBlock *block = nullptr;
+  if (!bypass_) {
+    MemoryBlock key(stream, round_size, nullptr);
+    auto it = free_blocks_.lower_bound(&key);
+    if (it != free_blocks_.end() && (*it)->stream == stream && (*it)->size <= round_size * kMaxReuseRatio) {
+      block = *it;
+      free_blocks_.erase(it);
+      statistics_.cache_hit_count++;
+    }
+  }
+
+  if (block == nullptr) {
+    uint8_t *memory_addr = MallocFromRuntime(round_size, device_id);
+    if (memory_addr == nullptr) {
+      // give the cached blocks back to runtime and retry once
+      EmptyCacheLocked();
+      memory_addr = MallocFromRuntime(round_size, device_id);
+    }
+    if (memory_addr == nullptr) {
+      GELOGE(ge::INTERNAL_ERROR, "CachingAllocator::Malloc failed, device_id = %u, size = %zu.", device_id, size);
+      return nullptr;
+    }
+    block = new (std::nothrow) MemoryBlock(stream, round_size, memory_addr);
+    if (block == nullptr) {
+      GELOGE(ge::INTERNAL_ERROR, "Alloc MemoryBlock failed.");
+      (void)FreeToRuntime(memory_addr, round_size, device_id);
+      return nullptr;
+    }
+    statistics_.cache_miss_count++;
+  }
+
+  block->requested_size = size;
+  allocated_blocks_[block->ptr] = block;
+  statistics_.allocated_bytes += block->size;
+  statistics_.requested_bytes += size;
+  UpdatePeak();
+  GELOGD("CachingAllocator::Malloc size = %zu, block size = %zu, device_id = %u.", size, block->size, device_id);
+  return block->ptr;
+}
+
+Status CachingAllocator::Free(uint8_t *memory_addr, uint32_t device_id) {
+  if (memory_addr == nullptr) {
+    GELOGE(ge::PARAM_INVALID, "CachingAllocator::Free memory_addr is null.");
+    return ge::PARAM_INVALID;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = allocated_blocks_.find(memory_addr);
+  if (it == allocated_blocks_.end()) {
+    GELOGW("CachingAllocator::Free memory was not malloced by cache, release to runtime, device_id = %u.", device_id);
+    return FreeToRuntime(memory_addr, 0, device_id);
+  }
+
+  MemoryBlock *block = it->second;
+  allocated_blocks_.erase(it);
+  statistics_.allocated_bytes -= block->size;
+  statistics_.requested_bytes -= block->requested_size;
+  block->requested_size = 0;
+
+  if (bypass_) {
+    Status ret = FreeToRuntime(block->ptr, block->size, device_id);
+    delete block;
+    return ret;
+  }
+
+  free_blocks_.insert(block);
+  return ge::SUCCESS;
+}
+
+void CachingAllocator::EmptyCache() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  EmptyCacheLocked();
+}
+
+void CachingAllocator::EmptyCacheLocked() {
+  for (auto block : free_blocks_) {
+    if (FreeToRuntime(block->ptr, block->size, 0) != ge::SUCCESS) {
+      GELOGW("CachingAllocator::EmptyCache free block failed, size = %zu.", block->size);
+    }
+    delete block;
+  }
+  free_blocks_.clear();
+}
+
+MemoryStatistics CachingAllocator::GetStatistics() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+void CachingAllocator::ResetPeakStatistics() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  statistics_.peak_allocated_bytes = statistics_.allocated_bytes;
+  statistics_.peak_reserved_bytes = statistics_.reserved_bytes;
+}
+
+void CachingAllocator::SetBypass(bool bypass) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (bypass && !bypass_) {
+    EmptyCacheLocked();
+  }
+  bypass_ = bypass;
+}
+
+uint8_t *CachingAllocator::MallocFromRuntime(size_t size, uint32_t device_id) {
+  uint8_t *memory_addr = nullptr;
+  if (rtMalloc(reinterpret_cast<void **>(&memory_addr), size, memory_type_) != RT_ERROR_NONE) {
+    GELOGW("CachingAllocator rtMalloc failed, device_id = %u, size = %zu.", device_id, size);
+    return nullptr;
+  }
+  statistics_.rt_malloc_count++;
+  statistics_.reserved_bytes += size;
+  return memory_addr;
+}
+
+Status CachingAllocator::FreeToRuntime(uint8_t *memory_addr, size_t size, uint32_t device_id) {
+  if (rtFree(memory_addr) != RT_ERROR_NONE) {
+    GELOGE(ge::INTERNAL_ERROR, "CachingAllocator rtFree failed, device_id = %u.", device_id);
+    return ge::INTERNAL_ERROR;
+  }
+  statistics_.rt_free_count++;
+  statistics_.reserved_bytes -= std::min(static_cast<uint64_t>(size), statistics_.reserved_bytes);
+  return ge::SUCCESS;
+}
+
+void CachingAllocator::UpdatePeak() {
+  statistics_.peak_allocated_bytes = std::max(statistics_.peak_allocated_bytes, statistics_.allocated_bytes);
+  statistics_.peak_reserved_bytes = std::max(statistics_.peak_reserved_bytes, statistics_.reserved_bytes);
+}
+}  // namespace ge
@@ -0,0 +1,143 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_MANAGER_GRAPH_CACHING_ALLOCATOR_H_
+#define GE_GRAPH_MANAGER_GRAPH_CACHING_ALLOCATOR_H_
+
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#include "framework/common/ge_inner_error_codes.h"
+#include "runtime/mem.h"
+#include "runtime/stream.h"
+
+namespace ge {
+// Sizes below kLargeBlockThreshold are rounded to kSmallRoundSize, bigger ones to kLargeRoundSize.
+constexpr size_t kSmallRoundSize = 512;
+constexpr size_t kLargeRoundSize = 2 * 1024 * 1024;
+constexpr size_t kLargeBlockThreshold = 1024 * 1024;
+// a cached block is only reused when it is at most kMaxReuseRatio times the rounded request
+constexpr size_t kMaxReuseRatio = 2;
+
+// setting this environment variable bypasses the cache and hits rtMalloc/rtFree directly
+const char *const kEnvDisableMemoryCache = "GE_DISABLE_MEMORY_CACHE";
+
+struct MemoryStatistics {
+  uint64_t allocated_bytes = 0;       // bytes of blocks currently handed out
+  uint64_t requested_bytes = 0;       // bytes callers asked for, before rounding
+  uint64_t reserved_bytes = 0;        // bytes currently held from runtime, in use or cached
+  uint64_t peak_allocated_bytes = 0;
+  uint64_t peak_reserved_bytes = 0;
+  uint64_t rt_malloc_count = 0;
+  uint64_t rt_free_count = 0;
+  uint64_t cache_hit_count = 0;
+  uint64_t cache_miss_count = 0;
+
+  ///
+  /// @brief share of reserved memory not backing a caller's request, 0 when nothing is reserved
+  ///
+  double Fragmentation() const {
+    return reserved_bytes == 0 ? 0.0 : 1.0 - static_cast<double>(requested_bytes) / reserved_bytes;
+  }
+};
+
+struct MemoryBlock {
+  MemoryBlock(rtStream_t stream, size_t size, uint8_t *ptr) : stream(stream), size(size), ptr(ptr) {}
+
+  rtStream_t stream;
+  size_t size;
+  size_t requested_size = 0;
+  uint8_t *ptr;
+};
+
+class CachingAllocator {
+ public:
+  explicit CachingAllocator(rtMemType_t memory_type);
+
+  virtual ~CachingAllocator();
+
+  CachingAllocator(const CachingAllocator &) = delete;
+  CachingAllocator &operator=(const CachingAllocator &) = delete;
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief malloc memory, reusing a cached block freed on the same stream when possible
+  /// @param [in] size memory size
+  /// @param [in] stream stream the memory is used on, nullptr for stream independent memory
+  /// @param [in] device_id device id
+  /// @return memory address, nullptr if failed
+  ///
+  uint8_t *Malloc(size_t size, rtStream_t stream = nullptr, uint32_t device_id = 0);
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief return memory to the cache
+  /// @param [in] memory_addr memory address got from Malloc
+  /// @param [in] device_id device id
+  /// @return Status result of function
+  ///
+  Status Free(uint8_t *memory_addr, uint32_t device_id = 0);
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief release all cached blocks which are not in use back to runtime
+  /// @return void
+  ///
+  void EmptyCache();
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief get a snapshot of the memory statistics
+  /// @return MemoryStatistics
+  ///
+  MemoryStatistics GetStatistics();
+
+  void ResetPeakStatistics();
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief when bypass is on, every Malloc/Free goes straight to runtime, for debugging
+  /// @param [in] bypass switch
+  ///
+  void SetBypass(bool bypass);
+
+  bool IsBypass() const { return bypass_; }
+
+  static size_t RoundSize(size_t size);
+
+ private:
+  struct BlockComparator {
+    bool operator()(const MemoryBlock *left, const MemoryBlock *right) const;
+  };
+
+  uint8_t *MallocFromRuntime(size_t size, uint32_t device_id);
+  Status FreeToRuntime(uint8_t *memory_addr, size_t size, uint32_t device_id);
+  void EmptyCacheLocked();
+  void UpdatePeak();
+
+  rtMemType_t memory_type_;
+  bool bypass_;
+  std::mutex mutex_;
+  // free blocks, ordered by (stream, size, address)
+  std::set<MemoryBlock *, BlockComparator> free_blocks_;
+  std::unordered_map<uint8_t *, MemoryBlock *> allocated_blocks_;
+  MemoryStatistics statistics_;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_MANAGER_GRAPH_CACHING_ALLOCATOR_H_
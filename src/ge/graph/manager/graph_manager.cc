@@ -51,6 +51,7 @@
 #include "graph/passes/reshape_remove_pass.h"
 #include "graph/passes/same_transdata_breadth_fusion_pass.h"
 #include "graph/passes/transop_breadth_fusion_pass.h"
+#include "graph/passes/transop_chain_canonicalize_pass.h"
 #include "graph/passes/transop_depth_fusion_pass.h"
 #include "graph/passes/transop_nearby_allreduce_fusion_pass.h"
 #include "graph/passes/transop_without_reshape_fusion_pass.h"
@@ -267,12 +268,16 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
   GE_CHECK_NOTNULL(graph_node->GetGraph());
   auto compute_graph = GraphUtils::GetComputeGraph(*graph_node->GetGraph());
   GE_IF_BOOL_EXEC(compute_graph == nullptr, GELOGE(FAILED, "compute graph is NULL."); return FAILED);
+  // the passes run by this compile report to the profiler of the graph
+  PassProfilerPtr pass_profiler = PassProfiler::CreateIfEnabled();
+  PassProfileScope pass_profile_scope(pass_profiler);
+  graph_node->SetPassProfiler(pass_profiler);
   GraphUtils::DumpGEGraph(compute_graph, "BeforeSummaryHandle");
   GraphUtils::DumpGEGraphToOnnx(*compute_graph, "BeforeSummaryHandle");
   // optimize the summary op in graph: store the summary name and replace the summary ops with net_output op.
   GE_TIMESTAMP_START(HandleSummaryOp);
   auto ret = graph_optimize_.HandleSummaryOp(compute_graph);
-  GE_TIMESTAMP_END(HandleSummaryOp, "GraphManager::HandleSummaryOp");
+  GE_TIMESTAMP_PROFILED_END(HandleSummaryOp, "GraphManager::HandleSummaryOp");
   GE_CHK_BOOL_EXEC(ret == SUCCESS, return ret, "[RunTrainGraph] HandleSummaryOp failed.");
   GE_TIMESTAMP_START(GraphPrepare);
   ret = graph_preparer_.Prepare(graph_node->GetGraph(), inputs, compute_graph, session_id);
@@ -280,7 +285,7 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
     GELOGE(ret, "ATC RunGraph input compute graph is NULL");
     return ret;
   }
-  GE_TIMESTAMP_END(GraphPrepare, "GraphPrepare::Prepare");
+  GE_TIMESTAMP_PROFILED_END(GraphPrepare, "GraphPrepare::Prepare");
   compute_graph->SetSessionID(session_id);
   GraphUtils::DumpGEGraph(compute_graph, "OptimizeOriginalGraphAfter");
   GraphUtils::DumpGEGraphToOnnx(*compute_graph, "OptimizeOriginalGraphAfter");
@@ -290,7 +295,7 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
   GE_CHK_STATUS_EXEC(compute_graph->InferShapeInNeed(),
                      GELOGE(GE_GRAPH_INFERSHAPE_FAILED, " OriginGraph infershape failed");
                      return GE_GRAPH_INFERSHAPE_FAILED;)
-  GE_TIMESTAMP_END(InferShape, "ComputeGraph::InferShapeInNeed");
+  GE_TIMESTAMP_PROFILED_END(InferShape, "ComputeGraph::InferShapeInNeed");
   // graph partition
   std::vector<SubGraphInfoPtr> sub_graph_list;
   GE_TIMESTAMP_START(GraphPartition);
@@ -299,7 +304,7 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
     GELOGE(ret, "Graph partition Failed");
     return ret;
   }
-  GE_TIMESTAMP_END(GraphPartition, "GraphPartitioner::Partition1");
+  GE_TIMESTAMP_PROFILED_END(GraphPartition, "GraphPartitioner::Partition1");
   GE_TIMESTAMP_START(SetSubgraph);
   // use default 16 multi thread
   const uint32_t thread_num = 16;
@@ -308,7 +313,7 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
   std::vector<std::future<Status>> vector_future(sub_graph_list_size);
   for (size_t i = 0; i < sub_graph_list_size; ++i) {
     vector_future[i] = executor.commit(GraphManager::ProcessSubGraphWithMultiThreads, this, sub_graph_list[i],
-                                       session_id, GetThreadLocalContext());
+                                       session_id, GetThreadLocalContext(), pass_profiler);
   }
   for (size_t i = 0; i < vector_future.size(); ++i) {
     Status ret_status = vector_future[i].get();
@@ -317,7 +322,7 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
       return ret_status;
     }
   }
-  GE_TIMESTAMP_END(SetSubgraph, "SetSubGraph");
+  GE_TIMESTAMP_PROFILED_END(SetSubgraph, "SetSubGraph");
 
   ComputeGraphPtr merged_compute_graph = nullptr;
 
@@ -329,7 +334,7 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
   }
   merged_compute_graph->SetSessionID(session_id);
   merged_compute_graph->SetGraphID(graph_node->GetGraphId());
-  GE_TIMESTAMP_END(MergeSubgraph, "GraphManager::MergeSubGraph");
+  GE_TIMESTAMP_PROFILED_END(MergeSubgraph, "GraphManager::MergeSubGraph");
 
   GraphUtils::DumpGEGraph(merged_compute_graph, "mergedComputeGraph");
   GraphUtils::DumpGEGraphToOnnx(*merged_compute_graph, "mergedComputeGraph");
@@ -343,7 +348,7 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
       GELOGE(ret, "Optimize after merge subgraph failed.");
       return ret;
     }
-    GE_TIMESTAMP_END(OptimizeAfterMergeSubgraph, "GraphManager::OptimizeAfterMergeSubGraph");
+    GE_TIMESTAMP_PROFILED_END(OptimizeAfterMergeSubgraph, "GraphManager::OptimizeAfterMergeSubGraph");
   }
 
   GraphUtils::DumpGEGraph(merged_compute_graph, "OptimizeMergeSubGraphAfter");
@@ -382,6 +387,10 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
   sub_graph_list[0]->SetSubGraph(merged_compute_graph);
   // set subgraphlist to graphnode
   graph_node->SetSubGraph(sub_graph_list);
+  if (pass_profiler != nullptr) {
+    GEEVENT("[GEPERFTRACE] The pass profiling of graph %u is %s", graph_node->GetGraphId(),
+            pass_profiler->ToJson().c_str());
+  }
   GE_TIMESTAMP_END(PreRun, "GraphManager::PreRun");
   GEEVENT("[GEPERFTRACE] GE PreRun End");
   return ret;
@@ -419,6 +428,8 @@ Status GraphManager::StartForRunGraph(const GraphNodePtr &graph_node, const std:
       GELOGE(ret, "LoadGraph Failed.");
       return ret;
     }
+  } else {
+    residency_manager_.Touch(graph_node->GetGraphId());
   }
   return ret;
 }
@@ -444,6 +455,7 @@ Status GraphManager::LoadGraph(const GeModelPtr &ge_model, const GraphNodePtr &g
     graph_node->SetLoadFlag(true);
     ge_model->SetModelId(model_id_info.model_id);
     graph_node->SetGeModel(ge_model);
+    residency_manager_.OnModelLoaded(graph_node->GetGraphId(), ge_model);
   }
   return SUCCESS;
 }
@@ -674,6 +686,7 @@ Status GraphManager::RemoveGraph(const GraphId &graph_id) {
     }
   }
   var_acc_ctrl_.RemoveGraph(graph_id);
+  residency_manager_.OnModelUnloaded(graph_id);
   graph_map_.erase(it);
   auto ge_model = graph_node->GetGeModel();
   if (ge_model != nullptr) {
@@ -824,6 +837,15 @@ Status GraphManager::ParseOptions(const std::map<std::string, std::string> &opti
   // Original model file name
   ParseOption(options, ORIGINAL_MODEL_FILE, options_.original_model_file);
 
+  // Set never evict graphs
+  std::string never_evict_graphs;
+  ParseOption(options, NEVER_EVICT_GRAPHS, never_evict_graphs);
+  ret = residency_manager_.ParsePinnedGraphs(never_evict_graphs);
+  if (ret != SUCCESS) {
+    GELOGE(GE_GRAPH_OPTIONS_INVALID, "Key:ge.neverEvictGraphs, its value %s is invalid", never_evict_graphs.c_str());
+    return GE_GRAPH_OPTIONS_INVALID;
+  }
+
   return SUCCESS;
 }
 
@@ -1019,6 +1041,17 @@ Status GraphManager::GetGraphNode(const GraphId &graph_id, GraphNodePtr &out) {
   return SUCCESS;
 }
 
+Status GraphManager::GetPassProfiler(const GraphId &graph_id, PassProfilerPtr &pass_profiler) {
+  GraphNodePtr graph_node = nullptr;
+  Status ret = GetGraphNode(graph_id, graph_node);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  GE_CHECK_NOTNULL(graph_node);
+  pass_profiler = graph_node->GetPassProfiler();
+  return SUCCESS;
+}
+
 Status GraphManager::GetVariable(const std::string &name, Tensor &val) {
   GeTensorPtr ge_tensor_ptr = TensorAdapter::AsGeTensorPtr(val);
   GE_CHECK_NOTNULL(ge_tensor_ptr);
@@ -1331,6 +1364,7 @@ Status GraphManager::OptimizeAfterMergeSubGraph(ge::ComputeGraphPtr &compute_gra
   GE_IF_BOOL_EXEC(options == "default" || options == "1", GELOGI("turn on variable accelerator");
                   GE_CHK_STATUS_RET(after_merge_passes.AddPass(new (std::nothrow) VariableOpPass(&var_acc_ctrl_))))
   GE_CHK_STATUS_RET(after_merge_passes.AddPass(new (std::nothrow) TransOpDepthFusionPass))
+  GE_CHK_STATUS_RET(after_merge_passes.AddPass(new (std::nothrow) TransOpChainCanonicalizePass))
   GE_CHK_STATUS_RET(after_merge_passes.AddPass(new (std::nothrow) TransOpBreadthFusionPass))
   GE_CHK_STATUS_RET(after_merge_passes.AddPass(new (std::nothrow) VariableRefDeleteOpPass))
   GE_CHK_STATUS_RET(after_merge_passes.AddPass(new (std::nothrow) SameTransdataBreadthFusionPass))
@@ -1426,6 +1460,7 @@ Status GraphManager::LoadGraphAsync(const GeModelPtr &ge_model, const GraphNodeP
     }
     ge_model->SetModelId(model_id_info.model_id);
     graph_node->SetGeModel(ge_model);
+    residency_manager_.OnModelLoaded(graph_node->GetGraphId(), ge_model);
   }
   return SUCCESS;
 }
@@ -1455,26 +1490,45 @@ Status GraphManager::CheckAndReleaseMemory(const GeModelPtr &ge_model, const Gra
   if (free_memory >= (memory_size + weight_size)) {
     return SUCCESS;
   }
+
+  // blocks cached by the caching allocator are not in use, give them back before unloading any model
+  CachingAllocator *caching_allocator = MemManager::CachingInstance(RT_MEMORY_HBM);
+  if (caching_allocator != nullptr) {
+    caching_allocator->EmptyCache();
+    result = GraphLoader::GetMemoryInfo(free_memory);
+    if (result != SUCCESS) {
+      return result;
+    }
+    if (free_memory >= (memory_size + weight_size)) {
+      GELOGI("CheckAndReleaseMemory Graph[%u] fits after empty cache, free_memory_size[%ld]", graph_node->GetGraphId(),
+             free_memory);
+      return SUCCESS;
+    }
+  }
+  // unload least recently used models only until the loading model fits
+  std::vector<ModelResidency> victims;
+  if (!residency_manager_.SelectVictims(graph_node->GetGraphId(), static_cast<uint64_t>(memory_size + weight_size),
+                                        static_cast<uint64_t>(free_memory), victims)) {
+    GELOGW("CheckAndReleaseMemory Graph[%u] may not fit even after unloading %zu models.", graph_node->GetGraphId(),
+           victims.size());
+  }
   rtError_t rt_ret;
-  for (auto &it : graph_map_) {
-    auto graph_id = it.second->GetGraphId();
-    auto model = it.second->GetGeModel();
-    if (model == nullptr) {
+  for (const auto &victim : victims) {
+    auto graph_id = victim.graph_id;
+    auto it = graph_map_.find(graph_id);
+    if (it == graph_map_.end() || it->second == nullptr || it->second->GetGeModel() == nullptr) {
+      residency_manager_.OnModelUnloaded(graph_id);
       continue;
     }
-    auto model_id = model->GetModelId();
+    auto model_id = it->second->GetGeModel()->GetModelId();
     // not loaded,no need unload
-    if (!it.second->GetLoadFlag()) {
+    if (!it->second->GetLoadFlag()) {
       GELOGI("CheckAndReleaseMemory graph[%u] has not been loaded.", graph_id);
+      residency_manager_.OnModelUnloaded(graph_id);
       continue;
     }
-    uint64_t max_memory_size = 0;
-    result = GraphLoader::GetMaxUsedMemory(model_id, max_memory_size);
-    if (result != SUCCESS) {
-      continue;
-    }
-    GELOGI("CheckAndReleaseMemory try to UnloadGraph[%u], model[%u] which MaxUsedMemory[%lu].", graph_id, model_id,
-           max_memory_size);
+    GELOGI("CheckAndReleaseMemory try to UnloadGraph[%u], model[%u] which footprint[%lu].", graph_id, model_id,
+           victim.Footprint());
     rt_ret = rtSetDevice(GetContext().DeviceId());
     if (rt_ret != RT_ERROR_NONE) {
       GELOGE(RT_FAILED, "[GraphManager:] rtSetDevice failed, modelId=%u, graphId=%u.", model_id, graph_id);
@@ -1489,16 +1543,20 @@ Status GraphManager::CheckAndReleaseMemory(const GeModelPtr &ge_model, const Gra
       GELOGE(RT_FAILED, "[GraphManager:] rtDeviceReset failed, modelId=%u, graphId=%u.", model_id, graph_id);
       continue;
     }
-    it.second->SetLoadFlag(false);
+    it->second->SetLoadFlag(false);
+    residency_manager_.RecordEviction(victim);
     GELOGI("CheckAndReleaseMemory UnloadGraph[%u], model[%u] success and set LoadFlag to false.", graph_id, model_id);
   }
   return SUCCESS;
 }
 
 Status GraphManager::ProcessSubGraphWithMultiThreads(GraphManager *graph_manager, SubGraphInfoPtr &sub_graph_info_ptr,
-                                                     uint64_t session_id, const GEThreadLocalContext &ge_context) {
+                                                     uint64_t session_id, const GEThreadLocalContext &ge_context,
+                                                     const PassProfilerPtr &pass_profiler) {
   Status ret = SUCCESS;
   GetThreadLocalContext() = ge_context;
+  // the subgraph passes report to the profiler of the compile, like the passes on the PreRun thread
+  PassProfileScope pass_profile_scope(pass_profiler);
   if (sub_graph_info_ptr != nullptr && graph_manager != nullptr) {
     ComputeGraphPtr compute_graph_tmp = sub_graph_info_ptr->GetSubGraph();
     const std::string &engine_name = sub_graph_info_ptr->GetEngineName();
@@ -1672,6 +1730,8 @@ void GraphManager::RunThread(GraphManager *graph_manager) {
       args.graph_node->SetLoadFlag(true);
       GELOGI("LoadGraph[%u], model[%u] success and set LoadFlag to true.", args.graph_node->GetGraphId(),
              args.ge_model->GetModelId());
+    } else {
+      graph_manager->residency_manager_.Touch(args.graph_node->GetGraphId());
     }
 
     if (graph_manager->GetTrainFlag()) {
@@ -34,6 +34,7 @@
 #include "graph/ge_local_context.h"
 #include "graph/load/graph_loader.h"
 #include "graph/manager/graph_manager_utils.h"
+#include "graph/manager/model_residency_manager.h"
 #include "graph/manager/util/variable_accelerate_ctrl.h"
 #include "graph/optimize/graph_optimize.h"
 #include "graph/partition/graph_partition.h"
@@ -150,6 +151,26 @@ class GraphManager {
 
   bool IsGraphNeedRebuild(uint32_t graph_id);
 
+  ///
+  /// @ingroup ge_graph
+  /// @brief pin the model of graph so it is never unloaded to make room for other models
+  /// @param [in] graph_id graph id
+  /// @param [in] pinned pin or unpin
+  /// @return void
+  ///
+  void SetGraphPinned(GraphId graph_id, bool pinned) { residency_manager_.SetPinned(graph_id, pinned); }
+
+  ResidencyStatistics GetResidencyStatistics() { return residency_manager_.GetStatistics(); }
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief get the time and the effect of each pass in the last compile of graph, GE_PASS_PROFILING=1 enables it
+  /// @param [in] graph_id graph id
+  /// @param [out] pass_profiler the pass stats, nullptr if the passes were not profiled
+  /// @return Status result of function
+  ///
+  Status GetPassProfiler(const GraphId &graph_id, PassProfilerPtr &pass_profiler);
+
  private:
   struct PreRunArgs {
     GraphId graph_id;
@@ -175,7 +196,8 @@ class GraphManager {
   std::shared_ptr<GraphModelListener> GetModelListener() const { return graph_run_listener_; }
 
   static Status ProcessSubGraphWithMultiThreads(GraphManager *graph_manager, SubGraphInfoPtr &sub_graph_info_ptr,
-                                                uint64_t session_id, const GEThreadLocalContext &ge_context);
+                                                uint64_t session_id, const GEThreadLocalContext &ge_context,
+                                                const PassProfilerPtr &pass_profiler);
   Status PreRun(const GraphNodePtr &graph_node, const std::vector<GeTensor> &inputs, vector<GeModelPtr> &ge_models,
                 GeModelPtr &ge_model, uint64_t session_id = INVALID_SESSION_ID);
 
@@ -294,6 +316,8 @@ class GraphManager {
 
   VarAccelerateCtrl var_acc_ctrl_;
 
+  ModelResidencyManager residency_manager_;
+
   std::mutex run_mutex_;
 };
 };  // namespace ge
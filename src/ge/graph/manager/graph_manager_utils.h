@@ -35,6 +35,7 @@
 #include "graph/compute_graph.h"
 #include "graph/graph.h"
 #include "graph/model.h"
+#include "graph/passes/pass_profiler.h"
 #include "model/ge_model.h"
 #include "register/register_fmk_types.h"
 
@@ -157,6 +158,8 @@ class GraphNode {
   void SetLoadFlag(bool load_flag) { load_flag_ = load_flag; }
   void SetGeModel(const GeModelPtr &ge_model) { ge_model_ = ge_model; }
   GeModelPtr GetGeModel() const { return ge_model_; }
+  void SetPassProfiler(const PassProfilerPtr &pass_profiler) { pass_profiler_ = pass_profiler; }
+  PassProfilerPtr GetPassProfiler() const { return pass_profiler_; }
   void Lock();
   void Unlock();
 
@@ -173,6 +176,8 @@ class GraphNode {
   bool build_flag_;
   bool load_flag_;
   GeModelPtr ge_model_;
+  // the pass profiling of the last compile
+  PassProfilerPtr pass_profiler_;
   BlockingQueue<uint8_t> sem_;
 };
 
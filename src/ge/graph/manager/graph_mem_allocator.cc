@@ -48,9 +48,10 @@ void MemoryAllocator::Finalize(uint32_t device_id) {
 }
 
 uint8_t *MemoryAllocator::MallocMemory(uint64_t memory_size, uint32_t device_id) const {
-  uint8_t *memory_addr = nullptr;
-
-  if (rtMalloc(reinterpret_cast<void **>(&memory_addr), memory_size, memory_type_) != RT_ERROR_NONE) {
+  CachingAllocator *caching_allocator = MemManager::CachingInstance(memory_type_);
+  uint8_t *memory_addr =
+      (caching_allocator == nullptr) ? nullptr : caching_allocator->Malloc(memory_size, nullptr, device_id);
+  if (memory_addr == nullptr) {
     GELOGE(ge::INTERNAL_ERROR,
            "MemoryAllocator::MallocMemory device_id = %u,"
            " size= %lu",
@@ -65,8 +66,9 @@ uint8_t *MemoryAllocator::MallocMemory(uint64_t memory_size, uint32_t device_id)
 
 Status MemoryAllocator::FreeMemory(uint8_t *memory_addr, uint32_t device_id) const {
   GELOGI("MemoryAllocator::FreeMemory device_id = %u", device_id);
-  if (rtFree(memory_addr) != RT_ERROR_NONE) {
-    GELOGE(ge::INTERNAL_ERROR, "MemoryAllocator::MallocMemory device_id = %u", device_id);
+  CachingAllocator *caching_allocator = MemManager::CachingInstance(memory_type_);
+  if (caching_allocator == nullptr || caching_allocator->Free(memory_addr, device_id) != ge::SUCCESS) {
+    GELOGE(ge::INTERNAL_ERROR, "MemoryAllocator::FreeMemory device_id = %u", device_id);
     return ge::INTERNAL_ERROR;
   }
   memory_addr = nullptr;
@@ -156,6 +158,10 @@ MemManager &MemManager::Instance() {
 
 MemoryAllocator *MemManager::Instance(rtMemType_t memory_type) { return Instance().GetMemoryAllocator(memory_type); }
 
+CachingAllocator *MemManager::CachingInstance(rtMemType_t memory_type) {
+  return Instance().GetCachingAllocator(memory_type);
+}
+
 Status MemManager::Initialize(const std::vector<rtMemType_t> &memory_type) {
   std::lock_guard<std::mutex> lock(allocator_mutex_);
   MemoryAllocator *memory_allocator = nullptr;
@@ -192,20 +198,32 @@ Status MemManager::Initialize(const std::vector<rtMemType_t> &memory_type) {
 
 void MemManager::Finalize() noexcept {
   GELOGI("Finalize.");
-  std::lock_guard<std::mutex> lock(allocator_mutex_);
-  for (auto &memory_allocator : memory_allocator_map_) {
-    if (memory_allocator.second != nullptr) {
-      memory_allocator.second->Finalize(0);
-      delete memory_allocator.second;
-      memory_allocator.second = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(allocator_mutex_);
+    for (auto &memory_allocator : memory_allocator_map_) {
+      if (memory_allocator.second != nullptr) {
+        memory_allocator.second->Finalize(0);
+        delete memory_allocator.second;
+        memory_allocator.second = nullptr;
+      }
+    }
+
+    if (default_memory_allocator_ != nullptr) {
+      delete default_memory_allocator_;
+      default_memory_allocator_ = nullptr;
     }
+    memory_allocator_map_.clear();
   }
 
-  if (default_memory_allocator_ != nullptr) {
-    delete default_memory_allocator_;
-    default_memory_allocator_ = nullptr;
+  // caching allocators go last, memory allocators above return their memory to them
+  std::lock_guard<std::mutex> lock(caching_allocator_mutex_);
+  for (auto &caching_allocator : caching_allocator_map_) {
+    if (caching_allocator.second != nullptr) {
+      delete caching_allocator.second;
+      caching_allocator.second = nullptr;
+    }
   }
-  memory_allocator_map_.clear();
+  caching_allocator_map_.clear();
 }
 
 MemoryAllocator *MemManager::GetMemoryAllocator(rtMemType_t memory_type) {
@@ -224,4 +242,22 @@ MemoryAllocator *MemManager::GetMemoryAllocator(rtMemType_t memory_type) {
 
   return memory_allocator;
 }
+
+CachingAllocator *MemManager::GetCachingAllocator(rtMemType_t memory_type) {
+  std::lock_guard<std::mutex> lock(caching_allocator_mutex_);
+  auto it = caching_allocator_map_.find(memory_type);
+  if (it != caching_allocator_map_.end()) {
+    return it->second;
+  }
+
+  // memory callers such as single op run without MemManager::Initialize, so create it on demand
+  auto caching_allocator = new (std::nothrow) CachingAllocator(memory_type);
+  if (caching_allocator == nullptr) {
+    GELOGE(ge::INTERNAL_ERROR, "Create CachingAllocator memory type[%u] failed.", memory_type);
+    return nullptr;
+  }
+  caching_allocator_map_[memory_type] = caching_allocator;
+  GELOGI("Create CachingAllocator memory type[%u] success.", memory_type);
+  return caching_allocator;
+}
 }  // namespace ge
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "framework/common/ge_inner_error_codes.h"
+#include "graph/manager/graph_caching_allocator.h"
 #include "graph/node.h"
 #include "runtime/mem.h"
 
@@ -140,6 +141,7 @@ class MemManager {
   virtual ~MemManager();
   static MemManager &Instance();
   static MemoryAllocator *Instance(rtMemType_t memory_type);
+  static CachingAllocator *CachingInstance(rtMemType_t memory_type);
   MemManager(const MemManager &) = delete;
   MemManager &operator=(const MemManager &) = delete;
   ///
@@ -166,9 +168,19 @@ class MemManager {
   ///
   MemoryAllocator *GetMemoryAllocator(rtMemType_t memory_type);
 
+  ///
+  /// @ingroup ge_graph
+  /// @brief get caching allocator of memory type, create it when first used
+  /// @param [in] memory_type memory type
+  /// @return CachingAllocator, nullptr if failed
+  ///
+  CachingAllocator *GetCachingAllocator(rtMemType_t memory_type);
+
   std::map<rtMemType_t, MemoryAllocator *> memory_allocator_map_;
   MemoryAllocator *default_memory_allocator_;
   std::mutex allocator_mutex_;
+  std::map<rtMemType_t, CachingAllocator *> caching_allocator_map_;
+  std::mutex caching_allocator_mutex_;
 };
 };  // namespace ge
 
@@ -0,0 +1,165 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/manager/model_residency_manager.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/string_util.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/utils/attr_utils.h"
+
+namespace ge {
+namespace {
+const int kDecimal = 10;
+
+uint64_t GetModelSizeAttr(const GeModelPtr &ge_model, const std::string &attr_name) {
+  int64_t value = 0;
+  if (!AttrUtils::GetInt(ge_model, attr_name, value) || value < 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(value);
+}
+}  // namespace
+
+uint64_t ModelResidencyManager::GetModelFootprint(const GeModelPtr &ge_model) {
+  if (ge_model == nullptr) {
+    return 0;
+  }
+  // the var memory is not counted, UnloadModel leaves it to the VarManager of the session
+  return GetModelSizeAttr(ge_model, ATTR_MODEL_MEMORY_SIZE) + GetModelSizeAttr(ge_model, ATTR_MODEL_WEIGHT_SIZE);
+}
+
+void ModelResidencyManager::OnModelLoaded(GraphId graph_id, const GeModelPtr &ge_model) {
+  if (ge_model == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  ModelResidency &residency = resident_models_[graph_id];
+  residency.graph_id = graph_id;
+  residency.model_id = ge_model->GetModelId();
+  residency.feature_map_size = GetModelSizeAttr(ge_model, ATTR_MODEL_MEMORY_SIZE);
+  residency.weight_size = GetModelSizeAttr(ge_model, ATTR_MODEL_WEIGHT_SIZE);
+  residency.var_size = GetModelSizeAttr(ge_model, ATTR_MODEL_VAR_SIZE);
+  residency.last_use = ++use_clock_;
+  GELOGI("Model[%u] of graph[%u] resident, footprint[%lu], var size[%lu].", residency.model_id, graph_id,
+         residency.Footprint(), residency.var_size);
+}
+
+void ModelResidencyManager::OnModelUnloaded(GraphId graph_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  (void)resident_models_.erase(graph_id);
+}
+
+void ModelResidencyManager::Touch(GraphId graph_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = resident_models_.find(graph_id);
+  if (it != resident_models_.end()) {
+    it->second.last_use = ++use_clock_;
+  }
+}
+
+void ModelResidencyManager::SetPinned(GraphId graph_id, bool pinned) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pinned) {
+    (void)pinned_graphs_.insert(graph_id);
+  } else {
+    (void)pinned_graphs_.erase(graph_id);
+  }
+}
+
+bool ModelResidencyManager::IsPinned(GraphId graph_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pinned_graphs_.count(graph_id) > 0;
+}
+
+Status ModelResidencyManager::ParsePinnedGraphs(const std::string &never_evict_graphs) {
+  std::vector<std::string> graph_ids = StringUtils::Split(never_evict_graphs, ',');
+  for (auto &graph_id_str : graph_ids) {
+    StringUtils::Trim(graph_id_str);
+    if (graph_id_str.empty()) {
+      continue;
+    }
+    char *ptr = nullptr;
+    auto graph_id = std::strtoul(graph_id_str.c_str(), &ptr, kDecimal);
+    if (ptr != nullptr && *ptr != '\0') {
+      GELOGE(PARAM_INVALID, "Never evict graph id %s is invalid.", graph_id_str.c_str());
+      return PARAM_INVALID;
+    }
+    SetPinned(static_cast<GraphId>(graph_id), true);
+  }
+  return SUCCESS;
+}
+
+bool ModelResidencyManager::SelectVictims(GraphId loading_graph_id, uint64_t required_size, uint64_t free_size,
+                                          std::vector<ModelResidency> &victims) {
+  victims.clear();
+  if (free_size >= required_size) {
+    return true;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<ModelResidency> candidates;
+  for (const auto &it : resident_models_) {
+    if (it.first == loading_graph_id || pinned_graphs_.count(it.first) > 0) {
+      continue;
+    }
+    candidates.emplace_back(it.second);
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const ModelResidency &left, const ModelResidency &right) { return left.last_use < right.last_use; });
+
+  uint64_t available_size = free_size;
+  for (const auto &candidate : candidates) {
+    if (available_size >= required_size) {
+      break;
+    }
+    victims.emplace_back(candidate);
+    available_size += candidate.Footprint();
+  }
+
+  if (available_size < required_size) {
+    statistics_.insufficient_count++;
+    GELOGW("Required memory[%lu] does not fit even after evicting %zu models, available[%lu].", required_size,
+           victims.size(), available_size);
+    return false;
+  }
+  return true;
+}
+
+void ModelResidencyManager::RecordEviction(const ModelResidency &victim) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  statistics_.eviction_count++;
+  statistics_.evicted_bytes += victim.Footprint();
+  (void)resident_models_.erase(victim.graph_id);
+}
+
+ResidencyStatistics ModelResidencyManager::GetStatistics() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+std::vector<ModelResidency> ModelResidencyManager::GetResidentModels() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<ModelResidency> models;
+  for (const auto &it : resident_models_) {
+    models.emplace_back(it.second);
+  }
+  return models;
+}
+}  // namespace ge
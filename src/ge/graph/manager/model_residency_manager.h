@@ -0,0 +1,131 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_MANAGER_MODEL_RESIDENCY_MANAGER_H_
+#define GE_GRAPH_MANAGER_MODEL_RESIDENCY_MANAGER_H_
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/ge_inner_error_codes.h"
+#include "graph/manager/graph_manager_utils.h"
+#include "model/ge_model.h"
+
+namespace ge {
+struct ModelResidency {
+  GraphId graph_id = 0;
+  uint32_t model_id = 0;
+  uint64_t feature_map_size = 0;
+  uint64_t weight_size = 0;
+  // held by the VarManager of the session, which keeps it when the model is unloaded
+  uint64_t var_size = 0;
+  uint64_t last_use = 0;
+
+  // the memory freed by unloading the model
+  uint64_t Footprint() const { return feature_map_size + weight_size; }
+};
+
+struct ResidencyStatistics {
+  uint64_t eviction_count = 0;
+  uint64_t evicted_bytes = 0;
+  // times a load could not be made to fit even after evicting every evictable model
+  uint64_t insufficient_count = 0;
+};
+
+///
+/// @ingroup ge_graph
+/// @brief tracks device memory footprint and recency of loaded models, picks LRU victims when memory is short
+///
+class ModelResidencyManager {
+ public:
+  ModelResidencyManager() = default;
+  ~ModelResidencyManager() = default;
+
+  ModelResidencyManager(const ModelResidencyManager &) = delete;
+  ModelResidencyManager &operator=(const ModelResidencyManager &) = delete;
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief record a loaded model, its footprint is read from model attrs
+  /// @param [in] graph_id graph the model belongs to
+  /// @param [in] ge_model loaded model
+  /// @return void
+  ///
+  void OnModelLoaded(GraphId graph_id, const GeModelPtr &ge_model);
+
+  void OnModelUnloaded(GraphId graph_id);
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief mark the model of graph as most recently used
+  /// @param [in] graph_id graph id
+  /// @return void
+  ///
+  void Touch(GraphId graph_id);
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief pinned graphs are never evicted
+  /// @param [in] graph_id graph id
+  /// @param [in] pinned pin or unpin
+  /// @return void
+  ///
+  void SetPinned(GraphId graph_id, bool pinned);
+
+  bool IsPinned(GraphId graph_id);
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief parse pinned graphs from option value, such as "1,3,4"
+  /// @param [in] never_evict_graphs option value
+  /// @return Status result of function
+  ///
+  Status ParsePinnedGraphs(const std::string &never_evict_graphs);
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief select least recently used models to unload until required memory fits
+  /// @param [in] loading_graph_id graph going to be loaded, never selected
+  /// @param [in] required_size memory size the loading model needs
+  /// @param [in] free_size device free memory size
+  /// @param [out] victims models to unload, least recently used first
+  /// @return true if required memory fits after evicting victims
+  ///
+  bool SelectVictims(GraphId loading_graph_id, uint64_t required_size, uint64_t free_size,
+                     std::vector<ModelResidency> &victims);
+
+  void RecordEviction(const ModelResidency &victim);
+
+  ResidencyStatistics GetStatistics();
+
+  std::vector<ModelResidency> GetResidentModels();
+
+  static uint64_t GetModelFootprint(const GeModelPtr &ge_model);
+
+ private:
+  std::mutex mutex_;
+  uint64_t use_clock_ = 0;
+  std::map<GraphId, ModelResidency> resident_models_;
+  std::set<GraphId> pinned_graphs_;
+  ResidencyStatistics statistics_;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_MANAGER_MODEL_RESIDENCY_MANAGER_H_
@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "common/op/ge_op_utils.h"
 #include "graph/utils/graph_utils.h"
@@ -39,25 +40,37 @@ Status EnginePlacer::Run() {
     GELOGE(GE_CLI_GE_NOT_INITIALIZED, "Run enginePlacer failed");
     return FAILED;
   }
-  // Assign engine for each node in the graph
+  // Assign engine for each node in the graph, the nodes without one are placed together
+  std::vector<NodePtr> unplaced_nodes;
+  std::vector<OpDescPtr> unplaced_op_descs;
   for (const auto &node_ptr : compute_graph_->GetDirectNode()) {
     GE_CHECK_NOTNULL(node_ptr);
     GE_CHECK_NOTNULL(node_ptr->GetOpDesc());
-    std::string engine_name;
     // Check if this node has assigned engine
     if ((!node_ptr->GetOpDesc()->GetOpKernelLibName().empty())) {
-      engine_name = node_ptr->GetOpDesc()->GetOpEngineName();
-    } else {
-      // Call placer cost model to get the "best" engine for this node
-      engine_name = instance_ptr->DNNEngineManagerObj().GetDNNEngineName(node_ptr->GetOpDesc());
-      // If can't get op's engine name, return failed
-      if (engine_name.empty()) {
-        GELOGE(GE_CLI_GE_NOT_INITIALIZED, "Can not find engine of op type %s",
-               node_ptr->GetOpDesc()->GetType().c_str());
+      if (AssignEngineAndLog(node_ptr, node_ptr->GetOpDesc()->GetOpEngineName()) != SUCCESS) {
+        GELOGE(GE_GRAPH_ASSIGN_ENGINE_FAILED, "[GraphPartitioner]: AssignEngineAndLog FAILED");
         return FAILED;
       }
+    } else {
+      unplaced_nodes.emplace_back(node_ptr);
+      unplaced_op_descs.emplace_back(node_ptr->GetOpDesc());
+    }
+  }
+
+  // Call placer cost model to get the "best" engine for these nodes
+  std::vector<std::string> engine_names;
+  if (instance_ptr->DNNEngineManagerObj().GetDNNEngineNames(unplaced_op_descs, engine_names) != SUCCESS) {
+    GELOGE(GE_GRAPH_ASSIGN_ENGINE_FAILED, "Get engines of %zu nodes failed", unplaced_nodes.size());
+    return FAILED;
+  }
+  for (size_t i = 0; i < unplaced_nodes.size(); ++i) {
+    // If can't get op's engine name, return failed
+    if (engine_names[i].empty()) {
+      GELOGE(GE_CLI_GE_NOT_INITIALIZED, "Can not find engine of op type %s", unplaced_op_descs[i]->GetType().c_str());
+      return FAILED;
     }
-    if (AssignEngineAndLog(node_ptr, engine_name) != SUCCESS) {
+    if (AssignEngineAndLog(unplaced_nodes[i], engine_names[i]) != SUCCESS) {
       GELOGE(GE_GRAPH_ASSIGN_ENGINE_FAILED, "[GraphPartitioner]: AssignEngineAndLog FAILED");
       return FAILED;
     }
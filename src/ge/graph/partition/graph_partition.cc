@@ -41,6 +41,19 @@ const char *const kPlaceHolderType = "PlaceHolder";
 const int kOneGraph = 1;  // only one graph
 const int kRankOne = 1;   // order of graph list is 0,1,2,3..., 1 means second order
 const int kRankZero = 0;  // order of graph list is 0,1,2,3..., 0 means first order
+const size_t kBitsPerWord = 64;
+
+inline void SetBit(std::vector<uint64_t> &bits, size_t index) {
+  bits[index / kBitsPerWord] |= (1ULL << (index % kBitsPerWord));
+}
+
+inline void ResetBit(std::vector<uint64_t> &bits, size_t index) {
+  bits[index / kBitsPerWord] &= ~(1ULL << (index % kBitsPerWord));
+}
+
+inline bool TestBit(const std::vector<uint64_t> &bits, size_t index) {
+  return (index / kBitsPerWord < bits.size()) && ((bits[index / kBitsPerWord] & (1ULL << (index % kBitsPerWord))) != 0);
+}
 }  // namespace
 namespace ge {
 Status ge::GraphPartitioner::CheckIfEnd2PldEmpty(ge::ComputeGraphPtr &output_merged_compute_graph) {
@@ -165,6 +178,9 @@ void ge::GraphPartitioner::ClearAllPartitionData(Mode mode) {
   index_2_end_.clear();
   cluster_2_partition_.clear();
   clusters_.clear();
+  cluster_ancestors_.clear();
+  child_ancestors_.clear();
+  visit_stamps_.clear();
   node_2_cluster_.clear();
   pld_2_end_.clear();
   end_2_pld_.clear();
@@ -593,7 +609,7 @@ Status ge::GraphPartitioner::AddPartitionsToGraphNode(vector<ge::SubGraphInfoPtr
 }
 
 // check if two clusters can merge
-bool ge::GraphPartitioner::IsMergeable(size_t parent_cluster, size_t child_cluster, size_t upper_bound) {
+bool ge::GraphPartitioner::IsMergeable(size_t parent_cluster, size_t child_cluster) {
   if ((clusters_[parent_cluster] == nullptr) || (clusters_[parent_cluster]->nodes_.empty()) ||
       (clusters_[child_cluster] == nullptr) || (clusters_[child_cluster]->nodes_.empty())) {
     return false;
@@ -607,15 +623,11 @@ bool ge::GraphPartitioner::IsMergeable(size_t parent_cluster, size_t child_clust
            clusters_[child_cluster]->engine_name_.c_str(), clusters_[child_cluster]->stream_label_.c_str());
     return false;
   }
-  // Check if parent_cluster,child_cluster is reachable
-  RemoveEdge(parent_cluster, child_cluster);
   // Check if there is a path between parent and child, if return true, can not merge
-  if (HasSecondPath(parent_cluster, child_cluster, upper_bound)) {
-    GELOGI("Find second path from %zu to %zu, upper bound is %zu", parent_cluster, child_cluster, upper_bound);
-    InsertEdge(parent_cluster, child_cluster);
+  if (HasSecondPath(parent_cluster, child_cluster)) {
+    GELOGI("Find second path from %zu to %zu", parent_cluster, child_cluster);
     return false;
   }
-  InsertEdge(parent_cluster, child_cluster);
   return true;
 }
 
@@ -677,6 +689,10 @@ void ge::GraphPartitioner::InsertEdge(size_t from, size_t to) {
 void ge::GraphPartitioner::MarkClusters() {
   GELOGI("MarkClusters starts. cluster size is %zu", clusters_.size());
   size_t cluster_size = clusters_.size();
+  child_ancestors_.assign((cluster_size + kBitsPerWord - 1) / kBitsPerWord, 0);
+  cluster_ancestors_.assign(cluster_size, std::vector<uint64_t>());
+  visit_stamps_.assign(cluster_size, 0);
+  visit_stamp_ = 0;
   for (size_t child_cluster = 0; child_cluster < cluster_size; child_cluster++) {
     auto found_child_cluster = clusters_[child_cluster];
     if (found_child_cluster == nullptr) {
@@ -688,22 +704,125 @@ void ge::GraphPartitioner::MarkClusters() {
     for (const auto &parent_cluster : copy_parents_clusters) {
       ordered_cluster.emplace_back(parent_cluster);
     }
-    // sort cluster according to it's output amount
+    // sort cluster according to it's output amount, then index, so that the result does not depend on hash order
     auto comp_func = [this](const size_t &parent_cluster1, const size_t &parent_cluster2) -> bool {
-      return clusters_[parent_cluster1]->out_clu_.size() < clusters_[parent_cluster2]->out_clu_.size();
+      size_t out_size1 = clusters_[parent_cluster1]->out_clu_.size();
+      size_t out_size2 = clusters_[parent_cluster2]->out_clu_.size();
+      return (out_size1 < out_size2) || ((out_size1 == out_size2) && (parent_cluster1 < parent_cluster2));
     };
     std::sort(ordered_cluster.begin(), ordered_cluster.end(), comp_func);
+    InitChildAncestors(child_cluster);
     auto child_merged = child_cluster;
     for (const auto &parent_cluster : ordered_cluster) {
-      if (IsMergeable(parent_cluster, child_merged, child_cluster)) {
+      if (IsMergeable(parent_cluster, child_merged)) {
+        size_t child_before_merge = child_merged;
         MergeTwoClusters(parent_cluster, child_merged);
+        UpdateAncestors(parent_cluster, child_before_merge, child_merged, child_cluster);
         GELOGD("Merging cluster %zu and %zu to %zu", parent_cluster, child_cluster, child_merged);
       }
     }
+    KeepAncestors(copy_parents_clusters, child_merged, child_cluster);
   }
+  cluster_ancestors_.clear();
+  child_ancestors_.clear();
+  visit_stamps_.clear();
   GELOGI("MarkClusters ends.");
 }
 
+/// Clusters are marked in topological order, so all parents of the cluster being marked are marked already and
+/// keep their ancestor bitsets. Ancestors always have smaller indexes, so only the leading words are used
+void ge::GraphPartitioner::InitChildAncestors(size_t child_cluster) {
+  std::fill(child_ancestors_.begin(), child_ancestors_.begin() + child_cluster / kBitsPerWord + 1, 0);
+  for (auto parent_cluster : clusters_[child_cluster]->in_clu_) {
+    size_t parent_index = GetMergedIndex(parent_cluster);
+    SetBit(child_ancestors_, parent_index);
+    const auto &parent_ancestors = cluster_ancestors_[parent_index];
+    for (size_t i = 0; i < parent_ancestors.size(); ++i) {
+      child_ancestors_[i] |= parent_ancestors[i];
+    }
+  }
+}
+
+/// After merging parent and child, every marked descendant of them is reachable from all ancestors of the child.
+/// The ancestors of parent are ancestors of child already, so child_ancestors_ only loses the merged clusters.
+/// Merging means there was no second path, so the descendants walked here are the ones a failed search visits
+void ge::GraphPartitioner::UpdateAncestors(size_t parent_cluster, size_t child_cluster, size_t merged_cluster,
+                                           size_t upper_bound) {
+  ReleaseAncestors(parent_cluster);
+  ReleaseAncestors(child_cluster);
+  ResetBit(child_ancestors_, parent_cluster);
+  ResetBit(child_ancestors_, child_cluster);
+  size_t words = upper_bound / kBitsPerWord + 1;
+  std::vector<size_t> temp_stack;
+  ++visit_stamp_;
+  temp_stack.push_back(merged_cluster);
+  visit_stamps_[merged_cluster] = visit_stamp_;
+  while (!temp_stack.empty()) {
+    size_t cluster = temp_stack.back();
+    temp_stack.pop_back();
+    // clusters after upper_bound are not marked yet, so they do not have ancestor bitsets
+    for (auto out_clu : clusters_[cluster]->out_clu_) {
+      if (out_clu >= upper_bound) {
+        continue;
+      }
+      size_t out_index = GetMergedIndex(out_clu);
+      if (visit_stamps_[out_index] == visit_stamp_) {
+        continue;
+      }
+      visit_stamps_[out_index] = visit_stamp_;
+      temp_stack.push_back(out_index);
+      auto &ancestors = cluster_ancestors_[out_index];
+      if (ancestors.empty()) {
+        continue;
+      }
+      if (ancestors.size() < words) {
+        ancestors.resize(words, 0);
+      }
+      for (size_t i = 0; i < words; ++i) {
+        ancestors[i] |= child_ancestors_[i];
+      }
+      SetBit(ancestors, merged_cluster);
+    }
+  }
+}
+
+/// Ancestor bitset is only read when marking an output of the cluster, so it is released once all outputs are marked
+void ge::GraphPartitioner::KeepAncestors(const ClusterSet &parent_clusters, size_t merged_cluster,
+                                         size_t upper_bound) {
+  auto has_unmarked_output = [this, upper_bound](size_t cluster) -> bool {
+    for (auto out_clu : clusters_[cluster]->out_clu_) {
+      if (out_clu > upper_bound) {
+        return true;
+      }
+    }
+    return false;
+  };
+  for (auto parent_cluster : parent_clusters) {
+    size_t parent_index = GetMergedIndex(parent_cluster);
+    if ((parent_index != merged_cluster) && !has_unmarked_output(parent_index)) {
+      ReleaseAncestors(parent_index);
+    }
+  }
+  auto words_end = child_ancestors_.begin() + upper_bound / kBitsPerWord + 1;
+  bool has_ancestor = std::any_of(child_ancestors_.begin(), words_end, [](uint64_t word) -> bool { return word != 0; });
+  if (has_ancestor && has_unmarked_output(merged_cluster)) {
+    cluster_ancestors_[merged_cluster].assign(child_ancestors_.begin(), words_end);
+  }
+}
+
+void ge::GraphPartitioner::ReleaseAncestors(size_t cluster) {
+  std::vector<uint64_t>().swap(cluster_ancestors_[cluster]);
+}
+
+size_t ge::GraphPartitioner::GetMergedIndex(size_t cluster) const {
+  size_t index = cluster;
+  // merging always keeps the smaller index, so the chain ends
+  while (clusters_.at(index)->index_ != index) {
+    index = clusters_.at(index)->index_;
+  }
+  return index;
+}
+
 Status ge::GraphPartitioner::SplitSubGraphs(ge::ComputeGraphPtr compute_graph) {
   GELOGI("SplitSubGraphs starts.");
   if (compute_graph == nullptr) {
@@ -774,31 +893,13 @@ Status ge::GraphPartitioner::SplitSubGraphs(ge::ComputeGraphPtr compute_graph) {
   return SUCCESS;
 }
 
-/// before calling this function, the direct path between src and dst are already removed.
-/// return true if a second path is found
-bool ge::GraphPartitioner::HasSecondPath(size_t src, size_t dst, size_t upper_bound) {
-  if (clusters_.at(src)->out_clu_.empty() || clusters_.at(dst)->in_clu_.empty()) {
-    return false;
-  }
-  /// Avoid recursion since stack space might be limited.
-  /// We instead keep a stack of nodes to visit.
-  std::vector<size_t> temp_stack;
-  std::unordered_set<size_t> visited;
-  temp_stack.push_back(src);
-  while (!temp_stack.empty()) {
-    size_t cluster = temp_stack.back();
-    temp_stack.pop_back();
-    ClusterPtr cur_cluster = clusters_[cluster];
-    if (!visited.insert(cluster).second) {
-      continue;
-    }
-    for (auto out : cur_cluster->out_clu_) {
-      if (out == dst) {
-        return true;  // There is cycle
-      }
-      if (out < upper_bound) {
-        temp_stack.push_back(out);
-      }
+/// child_ancestors_ holds all ancestors of dst, which is the cluster being marked.
+/// return true if another output of src reaches dst, merged clusters may leave an edge to src itself
+bool ge::GraphPartitioner::HasSecondPath(size_t src, size_t dst) {
+  for (auto out : clusters_[src]->out_clu_) {
+    size_t out_index = GetMergedIndex(out);
+    if ((out_index != dst) && (out_index != src) && TestBit(child_ancestors_, out_index)) {
+      return true;  // There is cycle
     }
   }
   return false;
@@ -105,7 +105,7 @@ class GraphPartitioner {
   Status RemoveNodeAndEdgeBetweenEndPld(ComputeGraphPtr &output_merged_compute_graph,
                                         const std::vector<SubGraphInfoPtr> &sub_graph_list);
   void AddEndPldInformationToSubGraphInfo(SubGraphInfoPtr &sub_graph_info);
-  bool IsMergeable(size_t parent_cluster, size_t child_cluster, size_t upper_bound);
+  bool IsMergeable(size_t parent_cluster, size_t child_cluster);
 
   // Link from->to
   void InsertEdge(size_t from, size_t to);
@@ -114,8 +114,21 @@ class GraphPartitioner {
   void RemoveEdge(size_t parent_cluster, size_t child_cluster);
   void MergeTwoClusters(size_t parent_cluster, size_t &child_cluster);
 
-  // Check if there's a second path between two clusters. The max path length is upper_bound
-  bool HasSecondPath(size_t src, size_t dst, size_t upper_bound);
+  // Check if there's a second path between two clusters, dst must be the cluster being marked
+  bool HasSecondPath(size_t src, size_t dst);
+
+  /// Ancestor bitsets of clusters, indexed by topological cluster index. Only marked clusters which still have
+  /// unmarked outputs keep their bitsets, the cluster being marked builds its own from its parents.
+  /// Limits: the bitset of cluster i takes i/64 words, so a wide graph whose early clusters keep outputs far down
+  /// holds up to N*N/128 words (about 1 GB for 128k clusters). UpdateAncestors walks all marked descendants of the
+  /// merged cluster, which is O(N) per merge, the same as the failed searches it replaces
+  void InitChildAncestors(size_t child_cluster);
+  void UpdateAncestors(size_t parent_cluster, size_t child_cluster, size_t merged_cluster, size_t upper_bound);
+  void KeepAncestors(const ClusterSet &parent_clusters, size_t merged_cluster, size_t upper_bound);
+  void ReleaseAncestors(size_t cluster);
+
+  // Cluster index that an index refers to after all merges, clusters_ of a merged index may point to a stale cluster
+  size_t GetMergedIndex(size_t cluster) const;
 
   // Mark all clusters
   void MarkClusters();
@@ -149,6 +162,10 @@ class GraphPartitioner {
   std::unordered_map<size_t, ClusterPtr> clusters_;                     // index to cluster ptr, contains all nodes
   std::unordered_map<NodePtr, std::shared_ptr<Cluster>> node_2_cluster_;  // node map to cluster
   std::unordered_map<std::shared_ptr<Cluster>, ComputeGraphPtr> cluster_2_partition_;  // cluster map to subgraph
+  std::vector<std::vector<uint64_t>> cluster_ancestors_;  // index to ancestor bitset, empty if released or no ancestor
+  std::vector<size_t> visit_stamps_;                     // last walk that visited the cluster, by index
+  size_t visit_stamp_ = 0;
+  std::vector<uint64_t> child_ancestors_;                // ancestor bitset of the cluster being marked
 };
 }  // namespace ge
 
@@ -17,6 +17,7 @@
 #include "graph/passes/aicpu_constant_folding_pass.h"
 
 #include <memory>
+#include <securec.h>
 #include <vector>
 
 #include "common/debug/log.h"
@@ -34,6 +35,8 @@ namespace {
 const char *const kKernelLibName = "aicpu_kernel";
 const uint64_t kReleaseFlag = 1;
 const uint64_t kDouble = 2;
+const size_t kStagingAlignSize = 64;
+const size_t kMemCopyIoNum = 4;
 }  // namespace
 namespace ge {
 Status AicpuConstantFoldingPass::Run(ge::NodePtr &node) {
@@ -50,39 +53,22 @@ Status AicpuConstantFoldingPass::Run(ge::NodePtr &node) {
     return SUCCESS;
   }
   OpDescPtr node_desc = node->GetOpDesc();  // checked before
-  vector<DataPtrInfo> data_vec;
-  vector<AddrAndType> input_addrs;
   vector<uint64_t> output_addrs;
-  Status ret = GetInputAddrs(weight_vec, input_addrs);
-  if (ret != SUCCESS) {
-    ReleaseMemory(input_addrs, output_addrs, data_vec);
-    return SUCCESS;
-  }
-
-  ret = GetOutputAddrs(node_desc, output_addrs);
+  Status ret = LaunchSingleOpRunTask(node, weight_vec, output_addrs);
   if (ret != SUCCESS) {
-    ReleaseMemory(input_addrs, output_addrs, data_vec);
-    return SUCCESS;
-  }
-
-  ret = LaunchSingleOpRunTask(node, input_addrs, output_addrs);
-  if (ret != SUCCESS) {
-    ReleaseMemory(input_addrs, output_addrs, data_vec);
     return SUCCESS;
   }
   GELOGI("[Node:%s] Launch singleOpRunTask success", node->GetName().c_str());
 
-  vector<uint64_t> data_infos;
-  ret = GenerateDataPtrInfo(output_addrs, data_vec, data_infos);
+  vector<DataPtrInfo> data_vec;
+  ret = GenerateDataPtrInfo(output_addrs, data_vec);
   if (ret != SUCCESS) {
-    ReleaseMemory(input_addrs, output_addrs, data_vec);
     return SUCCESS;
   }
   GELOGI("[Node:%s] Generate dataPtrInfo success", node->GetName().c_str());
 
-  ret = LaunchMemCopyTask(data_infos);
+  ret = LaunchMemCopyTask(data_vec);
   if (ret != SUCCESS) {
-    ReleaseMemory(input_addrs, output_addrs, data_vec);
     return SUCCESS;
   }
   GELOGI("[Node:%s] Launch memCopyTask success", node->GetName().c_str());
@@ -90,10 +76,8 @@ Status AicpuConstantFoldingPass::Run(ge::NodePtr &node) {
   vector<GeTensorPtr> outputs;
   ret = GenerateGeTensor(node_desc, data_vec, outputs);
   if (ret != SUCCESS) {
-    ReleaseMemory(input_addrs, output_addrs, data_vec);
     return SUCCESS;
   }
-  ReleaseMemory(input_addrs, output_addrs, data_vec);
   GELOGI("[Node:%s] Generate geTensor success", node->GetName().c_str());
   return Folding(node, outputs);
 }
@@ -118,234 +102,230 @@ bool AicpuConstantFoldingPass::CheckInput(const NodePtr &node, vector<ConstGeTen
   return true;
 }
 
-Status AicpuConstantFoldingPass::GetInputAddrs(const vector<ConstGeTensorPtr> &weight_vec,
-                                               vector<AddrAndType> &input_addrs) {
-  if (weight_vec.empty()) {
-    GELOGE(FAILED, "Weight is null");
-    return FAILED;
+AicpuConstantFoldingPass::StagingBuffer::~StagingBuffer() {
+  if (device_base_ != nullptr) {
+    GE_CHK_RT(rtFree(device_base_));
+    device_base_ = nullptr;
   }
-  for (const ConstGeTensorPtr &weight : weight_vec) {
-    void *input_addr = nullptr;
-    GE_CHK_RT_RET(rtMalloc(&input_addr, weight->GetData().size(), RT_MEMORY_HBM));
-
-    rtError_t rt_ret = rtMemcpy(input_addr, weight->GetData().size(), weight->GetData().data(),
-                                weight->GetData().size(), RT_MEMCPY_HOST_TO_DEVICE);
-    if (rt_ret != RT_ERROR_NONE) {
-      GELOGE(rt_ret, "rtMemcpy error");
-      GE_CHK_RT(rtFree(input_addr));
-      return FAILED;
-    }
+}
 
-    AddrAndType input_info = {static_cast<uint64_t>(reinterpret_cast<uintptr_t>(input_addr)), kData};
-    input_addrs.emplace_back(input_info);
-  }
-  return SUCCESS;
+void AicpuConstantFoldingPass::StagingBuffer::Clear() { size_ = 0; }
+
+size_t AicpuConstantFoldingPass::StagingBuffer::AddBlock(size_t size) {
+  size_t offset = size_;
+  size_ += (size + kStagingAlignSize - 1) / kStagingAlignSize * kStagingAlignSize;
+  return offset;
 }
 
-Status AicpuConstantFoldingPass::GetOutputAddrs(const OpDescPtr &node_desc, vector<uint64_t> &output_addrs) {
-  if (node_desc->GetOutputsSize() == 0) {
-    GELOGE(FAILED, "Output size is 0 ");
-    return FAILED;
+Status AicpuConstantFoldingPass::StagingBuffer::Reserve(size_t host_size) {
+  if (host_size > size_) {
+    GELOGE(PARAM_INVALID, "Host size %zu is bigger than staging size %zu.", host_size, size_);
+    return PARAM_INVALID;
   }
-  for (size_t i = 0; i < node_desc->GetOutputsSize(); ++i) {
-    void *summary_addr = nullptr;
-    GE_CHK_RT_RET(rtMalloc(&summary_addr, sizeof(aicpu::FWKAdapter::ResultSummary), RT_MEMORY_HBM));
-    output_addrs.emplace_back(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(summary_addr)));
+  if (size_ > capacity_) {
+    if (device_base_ != nullptr) {
+      GE_CHK_RT(rtFree(device_base_));
+      device_base_ = nullptr;
+      capacity_ = 0;
+    }
+    GE_CHK_RT_RET(rtMalloc(&device_base_, size_, RT_MEMORY_HBM));
+    capacity_ = size_;
+    GELOGD("Staging buffer grows to %zu.", capacity_);
   }
+  host_image_.assign(host_size, 0);
   return SUCCESS;
 }
 
-Status AicpuConstantFoldingPass::GenerateDataPtrInfo(const vector<uint64_t> &output_addrs,
-                                                     vector<DataPtrInfo> &data_vec, vector<uint64_t> &data_infos) {
-  for (uint64_t output_addr : output_addrs) {
-    aicpu::FWKAdapter::ResultSummary result_summary;
-    GE_CHK_RT_RET(rtMemcpy(&result_summary, sizeof(aicpu::FWKAdapter::ResultSummary),
-                           reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(output_addr)),
-                           sizeof(aicpu::FWKAdapter::ResultSummary), RT_MEMCPY_DEVICE_TO_HOST));
-    void *raw_data_addr = nullptr;
-    GE_CHK_RT_RET(rtMalloc(&raw_data_addr, result_summary.raw_data_size, RT_MEMORY_HBM));
-
-    void *shape_data_addr = nullptr;
-    rtError_t rt_ret = rtMalloc(&shape_data_addr, result_summary.shape_data_size, RT_MEMORY_HBM);
-    if (rt_ret != RT_ERROR_NONE) {
-      GELOGE(rt_ret, "rtMalloc error");
-      GE_CHK_RT(rtFree(raw_data_addr));
-      return FAILED;
-    }
-    DataPtrInfo raw_data_info;
-    raw_data_info.release_flag = kReleaseFlag;
-    raw_data_info.data_size = result_summary.raw_data_size;
-    raw_data_info.src_ptr = result_summary.raw_data_ptr;
-    raw_data_info.dst_ptr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(raw_data_addr));
-    data_vec.emplace_back(raw_data_info);
+uint64_t AicpuConstantFoldingPass::StagingBuffer::DeviceAddr(size_t offset) const {
+  return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(device_base_) + offset);
+}
 
-    DataPtrInfo shape_data_info;
-    shape_data_info.release_flag = kReleaseFlag;
-    shape_data_info.data_size = result_summary.shape_data_size;
-    shape_data_info.src_ptr = result_summary.shape_data_ptr;
-    shape_data_info.dst_ptr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(shape_data_addr));
-    data_vec.emplace_back(shape_data_info);
-  }
-  for (const DataPtrInfo &data_info : data_vec) {
-    data_infos.emplace_back(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&data_info)));
+Status AicpuConstantFoldingPass::StagingBuffer::CopyToDevice() const {
+  if (host_image_.empty()) {
+    return SUCCESS;
   }
+  GE_CHK_RT_RET(
+      rtMemcpy(device_base_, capacity_, host_image_.data(), host_image_.size(), RT_MEMCPY_HOST_TO_DEVICE));
   return SUCCESS;
 }
 
-Status AicpuConstantFoldingPass::UpdateWorkSpaceAddr(string &task_info, STR_FWK_OP_KERNEL &task) const {
-  // Update the workspace_addr
-  if (task_info.empty()) {
-    GELOGE(FAILED, "task_info is empty ");
-    return FAILED;
+Status AicpuConstantFoldingPass::GetKernelInfoStore(std::shared_ptr<OpsKernelInfoStore> &kernel_info) const {
+  auto instance_ptr = ge::GELib::GetInstance();
+  if (instance_ptr == nullptr || !instance_ptr->InitFlag()) {
+    GELOGE(GE_CLI_GE_NOT_INITIALIZED, "GE is not initialized");
+    return GE_CLI_GE_NOT_INITIALIZED;
   }
-  void *workspace_addr = nullptr;
-  GE_CHK_RT_RET(rtMalloc(&workspace_addr, task_info.size(), RT_MEMORY_HBM));
-  rtError_t rt_ret =
-      rtMemcpy(workspace_addr, task_info.size(), task_info.data(), task_info.size(), RT_MEMCPY_HOST_TO_DEVICE);
-  if (rt_ret != RT_ERROR_NONE) {
-    GELOGE(rt_ret, "rtMemcpy error");
-    GE_CHK_RT(rtFree(workspace_addr));
+  kernel_info = instance_ptr->OpsKernelManagerObj().GetOpsKernelInfoStore(kKernelLibName);
+  if (kernel_info == nullptr) {
+    GELOGE(FAILED, "Get op kernel info store failed");
     return FAILED;
   }
-
-  uint64_t workspace_base_addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(workspace_addr));
-  task.fwkKernelBase.fwk_kernel.workspaceBaseAddr = workspace_base_addr;
   return SUCCESS;
 }
 
-Status AicpuConstantFoldingPass::UpdateInputAndOutputAddr(const vector<uint64_t> &io_addrs,
-                                                          STR_FWK_OP_KERNEL &task) const {
-  auto addrs_size = sizeof(uint64_t) * (io_addrs.size());
-  if (addrs_size < 1) {
+AicpuConstantFoldingPass::TaskBlocks AicpuConstantFoldingPass::AddTaskBlocks(size_t io_num, size_t workspace_size) {
+  TaskBlocks blocks;
+  blocks.io_offset = staging_buffer_.AddBlock(sizeof(uint64_t) * io_num);
+  blocks.workspace_offset = staging_buffer_.AddBlock(workspace_size);
+  blocks.task_offset = staging_buffer_.AddBlock(sizeof(STR_FWK_OP_KERNEL));
+  return blocks;
+}
+
+Status AicpuConstantFoldingPass::WriteTaskBlocks(const TaskBlocks &blocks, const vector<uint64_t> &io_addrs,
+                                                 const string &task_info, STR_FWK_OP_KERNEL &task, void *&task_buf) {
+  if (io_addrs.empty()) {
     GELOGE(FAILED, "addrs_size is less than 1 ");
     return FAILED;
   }
-  void *input_output_addr = nullptr;
-  GE_CHK_RT_RET(rtMalloc(&input_output_addr, addrs_size, RT_MEMORY_HBM));
-  rtError_t rt_ret = rtMemcpy(input_output_addr, addrs_size, io_addrs.data(), addrs_size, RT_MEMCPY_HOST_TO_DEVICE);
-  if (rt_ret != RT_ERROR_NONE) {
-    GELOGE(rt_ret, "rtMemcpy error");
-    GE_CHK_RT(rtFree(input_output_addr));
+  if (task_info.empty()) {
+    GELOGE(FAILED, "task_info is empty ");
     return FAILED;
   }
-
-  uint64_t in_out_addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(input_output_addr));
-  task.fwkKernelBase.fwk_kernel.inputOutputAddr = in_out_addr;
+  size_t addrs_size = sizeof(uint64_t) * io_addrs.size();
+  GE_CHK_BOOL_RET_STATUS(memcpy_s(staging_buffer_.HostAddr(blocks.io_offset), addrs_size, io_addrs.data(),
+                                  addrs_size) == EOK, FAILED, "Copy io addrs failed.");
+  GE_CHK_BOOL_RET_STATUS(memcpy_s(staging_buffer_.HostAddr(blocks.workspace_offset), task_info.size(),
+                                  task_info.data(), task_info.size()) == EOK, FAILED, "Copy task info failed.");
+  task.fwkKernelBase.fwk_kernel.inputOutputAddr = staging_buffer_.DeviceAddr(blocks.io_offset);
+  task.fwkKernelBase.fwk_kernel.workspaceBaseAddr = staging_buffer_.DeviceAddr(blocks.workspace_offset);
+  GE_CHK_BOOL_RET_STATUS(memcpy_s(staging_buffer_.HostAddr(blocks.task_offset), sizeof(STR_FWK_OP_KERNEL), &task,
+                                  sizeof(STR_FWK_OP_KERNEL)) == EOK, FAILED, "Copy task failed.");
+  task_buf = reinterpret_cast<void *>(static_cast<uintptr_t>(staging_buffer_.DeviceAddr(blocks.task_offset)));
   return SUCCESS;
 }
 
-Status AicpuConstantFoldingPass::UpdateSingleOpAddr(string &task_info, const vector<AddrAndType> &input_addrs,
-                                                    const vector<uint64_t> &outputs_addr_vec, STR_FWK_OP_KERNEL &task) {
-  // Build the SingleOpAddr
-  vector<uint64_t> inputs_addr_vec;
-  for (const auto &item : input_addrs) {
-    inputs_addr_vec.push_back(item.input_addr);
+Status AicpuConstantFoldingPass::PackSingleOpRunTask(const vector<ConstGeTensorPtr> &weight_vec, size_t output_num,
+                                                     const string &task_info, STR_FWK_OP_KERNEL &task,
+                                                     vector<uint64_t> &output_addrs, void *&task_buf) {
+  if (weight_vec.empty()) {
+    GELOGE(FAILED, "Weight is null");
+    return FAILED;
   }
-  vector<uint64_t> io_addrs;
-  io_addrs.insert(io_addrs.end(), inputs_addr_vec.begin(), inputs_addr_vec.end());
-  io_addrs.insert(io_addrs.end(), outputs_addr_vec.begin(), outputs_addr_vec.end());
-
-  Status ret = UpdateInputAndOutputAddr(io_addrs, task);
-  if (ret != SUCCESS) {
-    GELOGE(ret, "UpdateInputAndOutputAddr error");
-    return ret;
+  if (output_num == 0) {
+    GELOGE(FAILED, "Output size is 0 ");
+    return FAILED;
   }
-  ret = UpdateWorkSpaceAddr(task_info, task);
-  if (ret != SUCCESS) {
-    GELOGE(ret, "UpdateWorkSpaceAddr error");
-    return ret;
+  // weights, io addrs, workspace and task are copied to device, result summaries are only written by device
+  staging_buffer_.Clear();
+  vector<size_t> input_offsets;
+  for (const ConstGeTensorPtr &weight : weight_vec) {
+    GE_CHECK_NOTNULL(weight);
+    input_offsets.emplace_back(staging_buffer_.AddBlock(weight->GetData().size()));
   }
-  return SUCCESS;
-}
+  TaskBlocks blocks = AddTaskBlocks(weight_vec.size() + output_num, task_info.size());
+  size_t host_size = staging_buffer_.GetSize();
+  size_t summary_offset = staging_buffer_.AddBlock(sizeof(aicpu::FWKAdapter::ResultSummary) * output_num);
+  GE_CHK_STATUS_RET(staging_buffer_.Reserve(host_size), "Reserve staging buffer failed.");
 
-Status AicpuConstantFoldingPass::UpdateMemCopyAddr(string &task_info, const vector<uint64_t> &data_infos,
-                                                   vector<uint64_t> &internal_addrs, STR_FWK_OP_KERNEL &task) {
-  vector<uint64_t> release_flags;
-  vector<uint64_t> data_sizes;
-  vector<uint64_t> src_addrs;
-  vector<uint64_t> dst_addrs;
-  for (auto item : data_infos) {
-    auto *data_info_ptr = reinterpret_cast<DataPtrInfo *>(reinterpret_cast<uintptr_t>(item));  // pointer cannot be null
-    release_flags.push_back(data_info_ptr->release_flag);
-    data_sizes.push_back(data_info_ptr->data_size);
-    src_addrs.push_back(data_info_ptr->src_ptr);
-    dst_addrs.push_back(data_info_ptr->dst_ptr);
-  }
-  vector<vector<uint64_t>> inputs = {release_flags, data_sizes, src_addrs, dst_addrs};
-  auto data_size = sizeof(uint64_t) * (data_infos.size());
   vector<uint64_t> io_addrs;
-  if (data_infos.size() > 0) {
-    for (const auto &item : inputs) {
-      void *input_addr_ptr = nullptr;
-      GE_CHK_RT_RET(rtMalloc(&input_addr_ptr, data_size, RT_MEMORY_HBM));
-      rtError_t rt_ret = rtMemcpy(input_addr_ptr, data_size, item.data(), data_size, RT_MEMCPY_HOST_TO_DEVICE);
-      if (rt_ret != RT_ERROR_NONE) {
-        GELOGE(rt_ret, "rtMemcpy error");
-        GE_CHK_RT(rtFree(input_addr_ptr));
-        return FAILED;
-      }
-      uint64_t input_addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(input_addr_ptr));
-      io_addrs.push_back(input_addr);
+  for (size_t i = 0; i < weight_vec.size(); ++i) {
+    const auto &data = weight_vec[i]->GetData();
+    if (data.size() > 0) {
+      GE_CHK_BOOL_RET_STATUS(memcpy_s(staging_buffer_.HostAddr(input_offsets[i]), data.size(), data.data(),
+                                      data.size()) == EOK, FAILED, "Copy weight %zu failed.", i);
     }
+    io_addrs.emplace_back(staging_buffer_.DeviceAddr(input_offsets[i]));
   }
-  internal_addrs = io_addrs;
+  for (size_t i = 0; i < output_num; ++i) {
+    output_addrs.emplace_back(
+        staging_buffer_.DeviceAddr(summary_offset + i * sizeof(aicpu::FWKAdapter::ResultSummary)));
+  }
+  io_addrs.insert(io_addrs.end(), output_addrs.begin(), output_addrs.end());
+  GE_CHK_STATUS_RET(WriteTaskBlocks(blocks, io_addrs, task_info, task, task_buf), "Write task blocks failed.");
+  return staging_buffer_.CopyToDevice();
+}
 
-  Status ret = UpdateInputAndOutputAddr(io_addrs, task);
-  if (ret != SUCCESS) {
-    GELOGE(ret, "UpdateInputAndOutputAddr error");
-    return ret;
+Status AicpuConstantFoldingPass::GenerateDataPtrInfo(const vector<uint64_t> &output_addrs,
+                                                     vector<DataPtrInfo> &data_vec) const {
+  if (output_addrs.empty()) {
+    GELOGE(FAILED, "Output size is 0 ");
+    return FAILED;
   }
-  ret = UpdateWorkSpaceAddr(task_info, task);
-  if (ret != SUCCESS) {
-    GELOGE(ret, "UpdateWorkSpaceAddr error");
-    return ret;
+  // summaries are contiguous in staging buffer, read back at once
+  vector<aicpu::FWKAdapter::ResultSummary> result_summaries(output_addrs.size());
+  size_t summaries_size = sizeof(aicpu::FWKAdapter::ResultSummary) * result_summaries.size();
+  GE_CHK_RT_RET(rtMemcpy(result_summaries.data(), summaries_size,
+                         reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(output_addrs[0])), summaries_size,
+                         RT_MEMCPY_DEVICE_TO_HOST));
+  for (const auto &result_summary : result_summaries) {
+    DataPtrInfo raw_data_info;
+    raw_data_info.release_flag = kReleaseFlag;
+    raw_data_info.data_size = result_summary.raw_data_size;
+    raw_data_info.src_ptr = result_summary.raw_data_ptr;
+    raw_data_info.dst_ptr = 0;
+    data_vec.emplace_back(raw_data_info);
+
+    DataPtrInfo shape_data_info;
+    shape_data_info.release_flag = kReleaseFlag;
+    shape_data_info.data_size = result_summary.shape_data_size;
+    shape_data_info.src_ptr = result_summary.shape_data_ptr;
+    shape_data_info.dst_ptr = 0;
+    data_vec.emplace_back(shape_data_info);
   }
   return SUCCESS;
 }
 
-Status AicpuConstantFoldingPass::LaunchSingleOpRunTask(const NodePtr &node, const vector<AddrAndType> &input_addrs,
-                                                       const vector<uint64_t> &output_addrs) {
-  void *task_buf = nullptr;
-  auto instance_ptr = ge::GELib::GetInstance();
-  if (instance_ptr == nullptr || !instance_ptr->InitFlag()) {
-    GELOGE(GE_CLI_GE_NOT_INITIALIZED, "GE is not initialized");
-    return GE_CLI_GE_NOT_INITIALIZED;
-  }
-  OpsKernelInfoStorePtr kernel_info = instance_ptr->OpsKernelManagerObj().GetOpsKernelInfoStore(kKernelLibName);
-  if (kernel_info == nullptr) {
-    GELOGE(FAILED, "Get op kernel info store failed");
+Status AicpuConstantFoldingPass::PackMemCopyTask(const string &task_info, vector<DataPtrInfo> &data_vec,
+                                                 STR_FWK_OP_KERNEL &task, void *&task_buf) {
+  if (data_vec.empty()) {
+    GELOGE(FAILED, "data_vec is empty ");
     return FAILED;
   }
+  // the four memcopy arrays, io addrs, workspace and task are copied to device, copy destinations are device only
+  staging_buffer_.Clear();
+  size_t array_size = sizeof(uint64_t) * data_vec.size();
+  vector<size_t> array_offsets;
+  for (size_t i = 0; i < kMemCopyIoNum; ++i) {
+    array_offsets.emplace_back(staging_buffer_.AddBlock(array_size));
+  }
+  TaskBlocks blocks = AddTaskBlocks(kMemCopyIoNum, task_info.size());
+  size_t host_size = staging_buffer_.GetSize();
+  vector<size_t> dst_offsets;
+  for (const DataPtrInfo &data_info : data_vec) {
+    dst_offsets.emplace_back(staging_buffer_.AddBlock(data_info.data_size));
+  }
+  GE_CHK_STATUS_RET(staging_buffer_.Reserve(host_size), "Reserve staging buffer failed.");
+
+  for (size_t i = 0; i < data_vec.size(); ++i) {
+    data_vec[i].dst_ptr = staging_buffer_.DeviceAddr(dst_offsets[i]);
+    auto release_flags = reinterpret_cast<uint64_t *>(staging_buffer_.HostAddr(array_offsets[0]));
+    auto data_sizes = reinterpret_cast<uint64_t *>(staging_buffer_.HostAddr(array_offsets[1]));
+    auto src_addrs = reinterpret_cast<uint64_t *>(staging_buffer_.HostAddr(array_offsets[2]));
+    auto dst_addrs = reinterpret_cast<uint64_t *>(staging_buffer_.HostAddr(array_offsets[3]));
+    release_flags[i] = data_vec[i].release_flag;
+    data_sizes[i] = data_vec[i].data_size;
+    src_addrs[i] = data_vec[i].src_ptr;
+    dst_addrs[i] = data_vec[i].dst_ptr;
+  }
+  vector<uint64_t> io_addrs;
+  for (size_t offset : array_offsets) {
+    io_addrs.emplace_back(staging_buffer_.DeviceAddr(offset));
+  }
+  GE_CHK_STATUS_RET(WriteTaskBlocks(blocks, io_addrs, task_info, task, task_buf), "Write task blocks failed.");
+  return staging_buffer_.CopyToDevice();
+}
+
+Status AicpuConstantFoldingPass::LaunchSingleOpRunTask(const NodePtr &node, const vector<ConstGeTensorPtr> &weight_vec,
+                                                       vector<uint64_t> &output_addrs) {
+  OpsKernelInfoStorePtr kernel_info;
+  Status ret = GetKernelInfoStore(kernel_info);
+  if (ret != SUCCESS) {
+    return ret;
+  }
   STR_FWK_OP_KERNEL aicpu_task;
   aicpu_task.fwkKernelBase.fwk_kernel.inputOutputAddr = 0;
   aicpu_task.fwkKernelBase.fwk_kernel.workspaceBaseAddr = 0;
   std::string task_info;
-  Status ret = kernel_info->GenSingleOpRunTask(node, aicpu_task, task_info);
+  ret = kernel_info->GenSingleOpRunTask(node, aicpu_task, task_info);
   if (ret != SUCCESS) {
     return ret;
   }
-  std::function<void()> callback = [&]() {
-    void *input_output_ptr =
-        reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(aicpu_task.fwkKernelBase.fwk_kernel.inputOutputAddr));
-    if (input_output_ptr != nullptr) {
-      GE_CHK_RT(rtFree(input_output_ptr));
-    }
-    void *workspace_addr_ptr =
-        reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(aicpu_task.fwkKernelBase.fwk_kernel.workspaceBaseAddr));
-    if (workspace_addr_ptr != nullptr) {
-      GE_CHK_RT(rtFree(workspace_addr_ptr));
-    }
-  };
-  GE_MAKE_GUARD(release, callback);
 
-  ret = UpdateSingleOpAddr(task_info, input_addrs, output_addrs, aicpu_task);
-  if (ret != SUCCESS) {
-    GELOGE(ret, "UpdateSingleOpAddr error");
-    return ret;
-  }
-  ret = GenerateTaskForLaunch(aicpu_task, task_buf);
+  void *task_buf = nullptr;
+  ret = PackSingleOpRunTask(weight_vec, node->GetOpDesc()->GetOutputsSize(), task_info, aicpu_task, output_addrs,
+                            task_buf);
   if (ret != SUCCESS) {
-    GELOGE(ret, "GenerateTaskForLaunch error");
+    GELOGE(ret, "PackSingleOpRunTask error");
     return ret;
   }
   ret = KernelLaunch(task_buf);
@@ -353,57 +333,28 @@ Status AicpuConstantFoldingPass::LaunchSingleOpRunTask(const NodePtr &node, cons
     GELOGE(ret, "KernelLaunch error");
     return ret;
   }
-
   return SUCCESS;
 }
 
-Status AicpuConstantFoldingPass::LaunchMemCopyTask(const vector<uint64_t> &data_infos) {
-  void *task_buf = nullptr;
-  auto instance_ptr = ge::GELib::GetInstance();
-  if (instance_ptr == nullptr || !instance_ptr->InitFlag()) {
-    GELOGE(GE_CLI_GE_NOT_INITIALIZED, "GE is not initialized");
-    return GE_CLI_GE_NOT_INITIALIZED;
-  }
-  OpsKernelInfoStorePtr kernel_info = instance_ptr->OpsKernelManagerObj().GetOpsKernelInfoStore(kKernelLibName);
-  if (kernel_info == nullptr) {
-    GELOGE(FAILED, "Get op kernel info store failed");
-    return FAILED;
+Status AicpuConstantFoldingPass::LaunchMemCopyTask(vector<DataPtrInfo> &data_vec) {
+  OpsKernelInfoStorePtr kernel_info;
+  Status ret = GetKernelInfoStore(kernel_info);
+  if (ret != SUCCESS) {
+    return ret;
   }
   STR_FWK_OP_KERNEL aicpu_task;
   aicpu_task.fwkKernelBase.fwk_kernel.inputOutputAddr = 0;
   aicpu_task.fwkKernelBase.fwk_kernel.workspaceBaseAddr = 0;
   std::string task_info;
-  Status ret = kernel_info->GenMemCopyTask(data_infos.size(), aicpu_task, task_info);
+  ret = kernel_info->GenMemCopyTask(data_vec.size(), aicpu_task, task_info);
   if (ret != SUCCESS) {
     return ret;
   }
 
-  vector<uint64_t> internal_addrs;
-  std::function<void()> callback = [&]() {
-    for (auto item : internal_addrs) {
-      GE_CHK_RT(rtFree(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(item))));  // pointer cannot be null
-    }
-    void *input_output_ptr =
-        reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(aicpu_task.fwkKernelBase.fwk_kernel.inputOutputAddr));
-    if (input_output_ptr != nullptr) {
-      GE_CHK_RT(rtFree(input_output_ptr));
-    }
-    void *workspace_addr_ptr =
-        reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(aicpu_task.fwkKernelBase.fwk_kernel.workspaceBaseAddr));
-    if (workspace_addr_ptr != nullptr) {
-      GE_CHK_RT(rtFree(workspace_addr_ptr));
-    }
-  };
-  GE_MAKE_GUARD(release, callback);
-
-  ret = UpdateMemCopyAddr(task_info, data_infos, internal_addrs, aicpu_task);
-  if (ret != SUCCESS) {
-    GELOGE(ret, "UpdateMemCopyAddr error");
-    return ret;
-  }
-  ret = GenerateTaskForLaunch(aicpu_task, task_buf);
+  void *task_buf = nullptr;
+  ret = PackMemCopyTask(task_info, data_vec, aicpu_task, task_buf);
   if (ret != SUCCESS) {
-    GELOGE(ret, "GenerateTaskForLaunch error");
+    GELOGE(ret, "PackMemCopyTask error");
     return ret;
   }
   ret = KernelLaunch(task_buf);
@@ -414,27 +365,11 @@ Status AicpuConstantFoldingPass::LaunchMemCopyTask(const vector<uint64_t> &data_
   return SUCCESS;
 }
 
-Status AicpuConstantFoldingPass::GenerateTaskForLaunch(STR_FWK_OP_KERNEL &aicpu_task, void *&task_buf) const {
-  GE_CHK_RT_RET(rtMalloc(&task_buf, sizeof(STR_FWK_OP_KERNEL), RT_MEMORY_HBM));
-
-  rtError_t rt_ret = rtMemcpy(task_buf, sizeof(STR_FWK_OP_KERNEL), reinterpret_cast<void *>(&aicpu_task),
-                              sizeof(STR_FWK_OP_KERNEL), RT_MEMCPY_HOST_TO_DEVICE);
-  if (rt_ret != RT_ERROR_NONE) {
-    GELOGE(rt_ret, "rtMemcpy error");
-    GE_CHK_RT(rtFree(task_buf));
-    return FAILED;
-  }
-  return SUCCESS;
-}
-
 Status AicpuConstantFoldingPass::KernelLaunch(void *task_buf) const {
   rtModel_t model = nullptr;
   rtStream_t stream = nullptr;
   rtStream_t stream_run = nullptr;
   std::function<void()> callback = [&]() {
-    if (task_buf != nullptr) {
-      GE_CHK_RT(rtFree(task_buf));
-    }
     if (model != nullptr) {
       GE_CHK_RT(rtModelDestroy(model));
     }
@@ -491,12 +426,25 @@ Status AicpuConstantFoldingPass::KernelLaunch(void *task_buf) const {
 }
 
 Status AicpuConstantFoldingPass::GenerateGeTensor(const OpDescPtr &node_desc, const vector<DataPtrInfo> &data_vec,
-                                                  vector<GeTensorPtr> &outputs) {
+                                                  vector<GeTensorPtr> &outputs) const {
   if ((node_desc->GetOutputsSize() * kDouble) != data_vec.size()) {
     GELOGE(FAILED, "node[%s] something wrong with output size", node_desc->GetName().c_str());
     return FAILED;
   }
 
+  // copy destinations are contiguous in staging buffer, read back at once
+  uint64_t dst_base = data_vec.front().dst_ptr;
+  uint64_t dst_size = data_vec.back().dst_ptr + data_vec.back().data_size - dst_base;
+  std::unique_ptr<uint8_t[]> dst_data(new (std::nothrow) uint8_t[dst_size]());
+  if (dst_data == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "new dst_data failed");
+    return INTERNAL_ERROR;
+  }
+  if (dst_size > 0) {
+    GE_CHK_RT_RET(rtMemcpy(dst_data.get(), dst_size, reinterpret_cast<void *>(static_cast<uintptr_t>(dst_base)),
+                           dst_size, RT_MEMCPY_DEVICE_TO_HOST));
+  }
+
   for (size_t i = 0; i < node_desc->GetOutputsSize(); i++) {
     auto output_tensor_desc = node_desc->GetOutputDesc(static_cast<uint32_t>(i));
     GeTensorPtr output_ptr = MakeShared<GeTensor>(output_tensor_desc);
@@ -506,30 +454,15 @@ Status AicpuConstantFoldingPass::GenerateGeTensor(const OpDescPtr &node_desc, co
     }
     const DataPtrInfo &raw_data_info = data_vec.at(i * kDouble);
     uint64_t raw_data_size = raw_data_info.data_size;
-    std::unique_ptr<uint8_t[]> data_addr(new (std::nothrow) uint8_t[raw_data_size]());
-    if (data_addr == nullptr) {
-      GELOGE(MEMALLOC_FAILED, "new data_addr failed");
-      return INTERNAL_ERROR;
-    }
-    GE_CHK_RT_RET(rtMemcpy(data_addr.get(), raw_data_size,
-                           reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(raw_data_info.dst_ptr)), raw_data_size,
-                           RT_MEMCPY_DEVICE_TO_HOST));
-    GE_IF_BOOL_EXEC(output_ptr->SetData(data_addr.get(), raw_data_size) != GRAPH_SUCCESS,
+    GE_IF_BOOL_EXEC(output_ptr->SetData(dst_data.get() + (raw_data_info.dst_ptr - dst_base), raw_data_size) !=
+                        GRAPH_SUCCESS,
                     GELOGE(FAILED, "set data failed");
                     return FAILED);
     GELOGI("GenerateGeTensor: raw_data_size %lu", raw_data_size);
 
     const DataPtrInfo &shape_data_info = data_vec.at(i * kDouble + 1);
-    uint64_t shape_data_size = shape_data_info.data_size;
-    uint64_t dim_num = shape_data_size / sizeof(uint64_t);
-    std::unique_ptr<int64_t[]> shape_addr(new (std::nothrow) int64_t[dim_num]());
-    if (shape_addr == nullptr) {
-      GELOGE(MEMALLOC_FAILED, "new shape_addr failed");
-      return INTERNAL_ERROR;
-    }
-    GE_CHK_RT_RET(rtMemcpy(shape_addr.get(), shape_data_size,
-                           reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(shape_data_info.dst_ptr)),
-                           shape_data_size, RT_MEMCPY_DEVICE_TO_HOST));
+    uint64_t dim_num = shape_data_info.data_size / sizeof(uint64_t);
+    auto shape_addr = reinterpret_cast<const int64_t *>(dst_data.get() + (shape_data_info.dst_ptr - dst_base));
     std::vector<int64_t> shapeDims;
     for (size_t idx = 0; idx < dim_num; idx++) {
       shapeDims.push_back(shape_addr[idx]);
@@ -541,18 +474,4 @@ Status AicpuConstantFoldingPass::GenerateGeTensor(const OpDescPtr &node_desc, co
   }
   return SUCCESS;
 }
-
-void AicpuConstantFoldingPass::ReleaseMemory(const vector<AddrAndType> &input_addrs,
-                                             const vector<uint64_t> &output_addrs,
-                                             const vector<DataPtrInfo> &data_vec) const {
-  for (const auto &item : input_addrs) {
-    GE_CHK_RT(rtFree(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(item.input_addr))));
-  }
-  for (auto item : output_addrs) {
-    GE_CHK_RT(rtFree(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(item))));
-  }
-  for (const auto &item : data_vec) {
-    GE_CHK_RT(rtFree(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(item.dst_ptr))));
-  }
-}
 }  // namespace ge
@@ -17,6 +17,7 @@
 #ifndef GE_GRAPH_PASSES_AICPU_CONSTANT_FOLDING_PASS_H_
 #define GE_GRAPH_PASSES_AICPU_CONSTANT_FOLDING_PASS_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -42,26 +43,67 @@ class AicpuConstantFoldingPass : public FoldingPass {
     uint64_t src_ptr;
     uint64_t dst_ptr;
   } __attribute__((packed));
+
+  // offsets of the io address table, workspace and task of a launch in the staging buffer
+  struct TaskBlocks {
+    size_t io_offset;
+    size_t workspace_offset;
+    size_t task_offset;
+  };
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief device buffer packing all payloads of a launch, so a launch costs one copy to device.
+  /// It is reused by every node folded by the pass and only reallocated when it has to grow.
+  ///
+  class StagingBuffer {
+   public:
+    StagingBuffer() = default;
+    ~StagingBuffer();
+
+    StagingBuffer(const StagingBuffer &) = delete;
+    StagingBuffer &operator=(const StagingBuffer &) = delete;
+
+    void Clear();
+    size_t AddBlock(size_t size);
+    size_t GetSize() const { return size_; }
+
+    ///
+    /// @ingroup ge_graph
+    /// @brief make device memory fit all blocks added, and prepare host image of the leading blocks
+    /// @param [in] host_size size of leading blocks copied to device, the rest are device only
+    /// @return Status result of function
+    ///
+    Status Reserve(size_t host_size);
+    uint8_t *HostAddr(size_t offset) { return host_image_.data() + offset; }
+    uint64_t DeviceAddr(size_t offset) const;
+    Status CopyToDevice() const;
+
+   private:
+    void *device_base_ = nullptr;
+    size_t capacity_ = 0;
+    size_t size_ = 0;
+    std::vector<uint8_t> host_image_;
+  };
+
   bool CheckInput(const ge::NodePtr &node, vector<ConstGeTensorPtr> &weight_vec);
-  Status GetInputAddrs(const vector<ConstGeTensorPtr> &weight_vec, vector<AddrAndType> &input_addrs);
-  Status GetOutputAddrs(const OpDescPtr &node_desc, vector<uint64_t> &output_addrs);
-  Status GenerateTaskForLaunch(STR_FWK_OP_KERNEL &aicpu_task, void *&task_buf) const;
-  Status GenerateDataPtrInfo(const vector<uint64_t> &output_addrs, vector<DataPtrInfo> &data_vec,
-                             vector<uint64_t> &data_infos);
+  Status GetKernelInfoStore(std::shared_ptr<OpsKernelInfoStore> &kernel_info) const;
+  TaskBlocks AddTaskBlocks(size_t io_num, size_t workspace_size);
+  Status WriteTaskBlocks(const TaskBlocks &blocks, const vector<uint64_t> &io_addrs, const string &task_info,
+                         STR_FWK_OP_KERNEL &task, void *&task_buf);
+  Status PackSingleOpRunTask(const vector<ConstGeTensorPtr> &weight_vec, size_t output_num, const string &task_info,
+                             STR_FWK_OP_KERNEL &task, vector<uint64_t> &output_addrs, void *&task_buf);
+  Status PackMemCopyTask(const string &task_info, vector<DataPtrInfo> &data_vec, STR_FWK_OP_KERNEL &task,
+                         void *&task_buf);
+  Status GenerateDataPtrInfo(const vector<uint64_t> &output_addrs, vector<DataPtrInfo> &data_vec) const;
   Status GenerateGeTensor(const OpDescPtr &node_desc, const vector<DataPtrInfo> &data_vec,
-                          vector<GeTensorPtr> &outputs);
-  Status UpdateWorkSpaceAddr(string &task_info, STR_FWK_OP_KERNEL &task) const;
-  Status UpdateInputAndOutputAddr(const vector<uint64_t> &io_addrs, STR_FWK_OP_KERNEL &task) const;
-  Status UpdateSingleOpAddr(string &task_info, const vector<AddrAndType> &input_addrs,
-                            const vector<uint64_t> &outputs_addr_vec, STR_FWK_OP_KERNEL &task);
-  Status UpdateMemCopyAddr(string &task_info, const vector<uint64_t> &data_infos, vector<uint64_t> &internal_addrs,
-                           STR_FWK_OP_KERNEL &task);
-  Status LaunchSingleOpRunTask(const NodePtr &node, const vector<AddrAndType> &input_addrs,
-                               const vector<uint64_t> &output_addrs);
-  Status LaunchMemCopyTask(const vector<uint64_t> &data_infos);
-  void ReleaseMemory(const vector<AddrAndType> &input_addrs, const vector<uint64_t> &output_addrs,
-                     const vector<DataPtrInfo> &data_vec) const;
-  Status KernelLaunch(void *aicpu_task) const;
+                          vector<GeTensorPtr> &outputs) const;
+  Status LaunchSingleOpRunTask(const NodePtr &node, const vector<ConstGeTensorPtr> &weight_vec,
+                               vector<uint64_t> &output_addrs);
+  Status LaunchMemCopyTask(vector<DataPtrInfo> &data_vec);
+  Status KernelLaunch(void *task_buf) const;
+
+  StagingBuffer staging_buffer_;
 };
 }  // namespace ge
 
@@ -16,12 +16,15 @@
 
 #include "graph/passes/base_pass.h"
 
+#include <algorithm>
 #include <queue>
 #include <unordered_set>
 
 #include "common/debug/log.h"
 #include "framework/common/debug/ge_log.h"
+#include "framework/common/util.h"
 #include "graph/compute_graph.h"
+#include "graph/passes/pass_profiler.h"
 #include "graph/utils/graph_utils.h"
 
 namespace ge {
@@ -70,6 +73,9 @@ Status RunPasses(NodePtr &node, const NamesToPass &names_to_passes, std::unorder
     return FAILED;
   }
   GELOGD("Begin to run pass for node %s", node->GetName().c_str());
+  PassProfiler *profiler = PassProfiler::GetCurrent();
+  // the node may be deleted by a pass, its graph is kept to count the nodes
+  auto graph = node->GetOwnerComputeGraph();
   for (const auto &name_to_pass : names_to_passes) {
     if (name_to_pass.second == nullptr) {
       GELOGE(INTERNAL_ERROR, "There is null pointer in passes(%s), skip it", name_to_pass.first.c_str());
@@ -78,7 +84,14 @@ Status RunPasses(NodePtr &node, const NamesToPass &names_to_passes, std::unorder
 
     GELOGD("Begin to run pass %s", name_to_pass.first.c_str());
     name_to_pass.second->init();
+    uint64_t start_usec = 0;
+    size_t node_num_before = 0;
+    if (profiler != nullptr) {
+      node_num_before = (graph == nullptr) ? 0 : graph->GetDirectNodesSize();
+      start_usec = GetCurrentTimestap();
+    }
     auto result = name_to_pass.second->Run(node);
+    uint64_t cost_usec = (profiler == nullptr) ? 0 : GetCurrentTimestap() - start_usec;
     if (result != SUCCESS) {
       GELOGE(INTERNAL_ERROR,
              "Failed to process pass %s on node %s, result "
@@ -88,6 +101,7 @@ Status RunPasses(NodePtr &node, const NamesToPass &names_to_passes, std::unorder
     }
 
     auto nodes_to_re_pass = name_to_pass.second->GetNodesNeedRePass();
+    uint64_t re_pass_triggers = 0;
     for (const auto &node_to_re_pass : nodes_to_re_pass) {
       if (node_to_re_pass == nullptr) {
         GELOGW("Found null re-pass node when executing %s on node %s type %s", name_to_pass.first.c_str(),
@@ -97,6 +111,7 @@ Status RunPasses(NodePtr &node, const NamesToPass &names_to_passes, std::unorder
       if (node_to_re_pass->IsAllInNodesSeen(nodes_seen)) {
         GELOGD("The node %s will be re-pass later", node_to_re_pass->GetName().c_str());
         nodes_re_pass.insert(node_to_re_pass);
+        re_pass_triggers++;
       } else {
         GELOGD("The node %s are not all seen, don't set repass this time", node_to_re_pass->GetName().c_str());
       }
@@ -104,6 +119,16 @@ Status RunPasses(NodePtr &node, const NamesToPass &names_to_passes, std::unorder
 
     auto nodes_deleted_by_pass = name_to_pass.second->GetNodesDeleted();
     nodes_deleted.insert(nodes_deleted_by_pass.begin(), nodes_deleted_by_pass.end());
+    if (profiler != nullptr) {
+      // the deleted nodes are reported by the pass, the added ones are counted by the number of nodes
+      size_t node_num_after = (graph == nullptr) ? 0 : graph->GetDirectNodesSize();
+      size_t node_num_kept = node_num_before - std::min(node_num_before, nodes_deleted_by_pass.size());
+      uint64_t nodes_added = (node_num_after > node_num_kept) ? node_num_after - node_num_kept : 0;
+      bool is_changed =
+          !nodes_to_re_pass.empty() || !nodes_deleted_by_pass.empty() || node_num_after != node_num_before;
+      profiler->AddNodePassRun(name_to_pass.first, cost_usec, is_changed, nodes_added, nodes_deleted_by_pass.size(),
+                               re_pass_triggers);
+    }
     if (nodes_deleted_by_pass.count(node.get()) > 0) {
       GELOGD("The node %s was deleted by pass %s, stop the remain passes", node->GetName().c_str(),
              name_to_pass.first.c_str());
@@ -163,8 +188,10 @@ Status GEPass::Run(const NamesToPass &names_to_passes) {
   GetAllNodesNoInputEdge(graph_, nodes, nodes_seen, nodes_last);
   GELOGD("Start points count %zu", nodes.size());
   int re_pass_times = 0;
+  uint64_t sweep_count = 0;
 
   do {
+    sweep_count++;
     for (auto &node : nodes_re_pass) {
       nodes.push(node);
       nodes_seen.insert(node.get());
@@ -206,6 +233,10 @@ Status GEPass::Run(const NamesToPass &names_to_passes) {
   if (re_pass_times == kMaxRePassTimes) {
     GELOGW("re_pass_times should not come to %d", kMaxRePassTimes);
   }
+  PassProfiler *profiler = PassProfiler::GetCurrent();
+  if (profiler != nullptr) {
+    profiler->AddGEPassRun(sweep_count);
+  }
   GELOGD("All passes runs end");
 
   return SUCCESS;
@@ -0,0 +1,276 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/passes/common_subexpression_elimination_pass.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/ge_inner_error_codes.h"
+#include "framework/common/debug/ge_log.h"
+#include "graph/common/omg_util.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+
+namespace ge {
+namespace {
+// ops which hold or change a state, talk to the outside, produce random values or steer the control flow
+const std::unordered_set<std::string> kStatefulOpTypes = {
+    DATA, AIPPDATA, NETOUTPUT, VARIABLE, VARIABLEV2, VARHANDLEOP, TEMPORARYVARIABLE, DESTROYTEMPORARYVARIABLE,
+    READVARIABLEOP, VARISINITIALIZEDOP, ISVARIABLEINITIALIZED, CONSTANT, CONSTANTOP, PLACEHOLDER, END, ENDGRAPH,
+    SWITCH, SWITCHN, REFSWITCH, MERGE, REFMERGE, ENTER, REFENTER, EXIT, REFEXIT, LOOPCOND, NEXTITERATION,
+    REFNEXTITERATION, CONTROLTRIGGER, STREAMSWITCH, STREAMSWITCHN, STREAMACTIVE, STREAMMERGE, MEMCPYASYNC, SEND,
+    RECV, DROPOUTGENMASK, MULTINOMIAL, ASSERT, ATOMICADDRCLEAN, GETNEXT, INITDATA, NOOP, FRAMEWORKOP, LogTimeStamp,
+    "Print", "TruncatedNormal", "CountUpTo"};
+const std::vector<std::string> kStatefulOpTypePrefixes = {"Apply",   "ResourceApply", "SparseApply", "Assign",
+                                                          "Scatter", "Hcom",          "Random",      "Variable",
+                                                          "Stream",  "Save",          "Restore"};
+
+bool IsStatefulOpType(const std::string &type) {
+  if (kStatefulOpTypes.count(type) > 0) {
+    return true;
+  }
+  return std::any_of(kStatefulOpTypePrefixes.begin(), kStatefulOpTypePrefixes.end(),
+                     [&type](const std::string &prefix) { return type.compare(0, prefix.size(), prefix) == 0; });
+}
+
+// attrs naming the node itself or the ops it came from, they differ between nodes doing the same
+bool IsNodeNameAttr(const std::string &name) {
+  return (name == ATTR_NAME_DATA_DUMP_ORIGIN_OP_NAMES) || (name == ATTR_NAME_DATA_DUMP_ORIGIN_NAME) ||
+         (name == ATTR_NAME_DATA_DUMP_GROUP_OP_NAME);
+}
+
+// a ref op writes an input in place, it has an output named as that input
+bool IsRefOp(const OpDescPtr &op_desc) {
+  auto output_names = op_desc->GetAllOutputName();
+  for (const auto &input_name : op_desc->GetAllInputNames()) {
+    if (output_names.count(input_name) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+void AppendValue(const T &value, std::ostringstream &key) {
+  key << value << ',';
+}
+
+void AppendValue(const std::string &value, std::ostringstream &key) { key << value.size() << ':' << value << ','; }
+
+template <typename T>
+void AppendValue(const std::vector<T> &values, std::ostringstream &key) {
+  key << '[';
+  for (const auto &value : values) {
+    AppendValue(value, key);
+  }
+  key << ']';
+}
+
+template <typename T>
+bool AppendAttrValue(const GeAttrValue &attr_value, std::ostringstream &key) {
+  T value;
+  if (attr_value.GetValue<T>(value) != GRAPH_SUCCESS) {
+    return false;
+  }
+  AppendValue(value, key);
+  return true;
+}
+
+///
+/// Append the attr to the key, the attrs of tensors, graphs and the other types which could not
+/// be compared by value make the node not a candidate.
+///
+bool AppendAttr(const std::string &name, const GeAttrValue &attr_value, std::ostringstream &key) {
+  key << name << '=' << static_cast<int>(attr_value.GetValueType()) << ':';
+  switch (attr_value.GetValueType()) {
+    case GeAttrValue::VT_STRING:
+      return AppendAttrValue<GeAttrValue::STR>(attr_value, key);
+    case GeAttrValue::VT_FLOAT:
+      return AppendAttrValue<GeAttrValue::FLOAT>(attr_value, key);
+    case GeAttrValue::VT_BOOL:
+      return AppendAttrValue<GeAttrValue::BOOL>(attr_value, key);
+    case GeAttrValue::VT_INT:
+      return AppendAttrValue<GeAttrValue::INT>(attr_value, key);
+    case GeAttrValue::VT_DATA_TYPE:
+      return AppendAttrValue<GeAttrValue::DATA_TYPE>(attr_value, key);
+    case GeAttrValue::VT_LIST_LIST_INT:
+      return AppendAttrValue<GeAttrValue::LIST_LIST_INT>(attr_value, key);
+    case GeAttrValue::VT_LIST_STRING:
+      return AppendAttrValue<GeAttrValue::LIST_STR>(attr_value, key);
+    case GeAttrValue::VT_LIST_FLOAT:
+      return AppendAttrValue<GeAttrValue::LIST_FLOAT>(attr_value, key);
+    case GeAttrValue::VT_LIST_BOOL:
+      return AppendAttrValue<GeAttrValue::LIST_BOOL>(attr_value, key);
+    case GeAttrValue::VT_LIST_INT:
+      return AppendAttrValue<GeAttrValue::LIST_INT>(attr_value, key);
+    case GeAttrValue::VT_LIST_DATA_TYPE:
+      return AppendAttrValue<GeAttrValue::LIST_DATA_TYPE>(attr_value, key);
+    default:
+      return false;
+  }
+}
+
+void AppendTensorDesc(const ConstGeTensorDescPtr &tensor_desc, std::ostringstream &key) {
+  if (tensor_desc == nullptr) {
+    key << "null;";
+    return;
+  }
+  key << static_cast<int>(tensor_desc->GetDataType()) << ',' << static_cast<int>(tensor_desc->GetFormat()) << ',';
+  AppendValue(tensor_desc->GetShape().GetDims(), key);
+  key << ';';
+}
+}  // namespace
+
+Status CommonSubexpressionEliminationPass::Run(NodePtr &node) {
+  GE_CHECK_NOTNULL(node);
+  GE_CHECK_NOTNULL(node->GetOpDesc());
+  if (!IsCandidate(node)) {
+    return SUCCESS;
+  }
+  std::string key;
+  if (!GetNodeKey(node, key)) {
+    return SUCCESS;
+  }
+
+  auto iter = keys_to_node_.find(key);
+  if (iter == keys_to_node_.end()) {
+    keys_to_node_.emplace(key, node);
+    return SUCCESS;
+  }
+  NodePtr kept_node = iter->second;
+  if (kept_node == node) {
+    return SUCCESS;
+  }
+  // the kept node may have been changed or deleted by the other passes since it was recorded
+  std::string kept_key;
+  if ((kept_node->GetOwnerComputeGraph() != node->GetOwnerComputeGraph()) || !GetNodeKey(kept_node, kept_key) ||
+      (kept_key != key)) {
+    iter->second = node;
+    return SUCCESS;
+  }
+  return MergeNode(node, kept_node);
+}
+
+bool CommonSubexpressionEliminationPass::IsCandidate(const NodePtr &node) {
+  // the nodes without data inputs are sources, such as data, const and variable, they are left to the other passes
+  if (node->GetInDataNodes().empty()) {
+    return false;
+  }
+  std::string type;
+  if (GetOriginalType(node, type) != SUCCESS) {
+    return false;
+  }
+  if (IsStatefulOpType(type)) {
+    return false;
+  }
+  // IdentifyReferencePass runs after this pass, the ref ops are found by their names here
+  if (IsRefOp(node->GetOpDesc())) {
+    return false;
+  }
+  bool is_ref = false;
+  (void)AttrUtils::GetBool(node->GetOpDesc(), ATTR_NAME_REFERENCE, is_ref);
+  return !is_ref;
+}
+
+///
+/// The key of a node is made of its type, attrs, input and output descs, the out anchors feeding it and
+/// its control inputs. Node names are unique in a graph, so that the peer anchors are named by their owners.
+///
+bool CommonSubexpressionEliminationPass::GetNodeKey(const NodePtr &node, std::string &key) {
+  auto op_desc = node->GetOpDesc();
+  std::ostringstream key_stream;
+  key_stream << std::setprecision(std::numeric_limits<float>::max_digits10);
+  key_stream << node->GetType() << '|';
+  for (const auto &name_to_attr : op_desc->GetAllAttrs()) {
+    if (IsNodeNameAttr(name_to_attr.first)) {
+      continue;
+    }
+    if (!AppendAttr(name_to_attr.first, name_to_attr.second, key_stream)) {
+      GELOGD("The attr %s of node %s could not be compared, skip it", name_to_attr.first.c_str(),
+             node->GetName().c_str());
+      return false;
+    }
+  }
+
+  key_stream << "|in:";
+  for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+    auto peer_out_anchor = in_anchor->GetPeerOutAnchor();
+    if (peer_out_anchor == nullptr) {
+      key_stream << "-1;";
+      continue;
+    }
+    key_stream << peer_out_anchor->GetOwnerNode()->GetName() << ':' << peer_out_anchor->GetIdx() << ';';
+    AppendTensorDesc(op_desc->GetInputDescPtr(static_cast<uint32_t>(in_anchor->GetIdx())), key_stream);
+  }
+
+  std::vector<std::string> in_control_names;
+  for (const auto &in_control_node : node->GetInControlNodes()) {
+    in_control_names.emplace_back(in_control_node->GetName());
+  }
+  std::sort(in_control_names.begin(), in_control_names.end());
+  key_stream << "|ctrl:";
+  AppendValue(in_control_names, key_stream);
+
+  key_stream << "|out:";
+  for (size_t i = 0; i < op_desc->GetOutputsSize(); ++i) {
+    AppendTensorDesc(op_desc->MutableOutputDesc(static_cast<uint32_t>(i)), key_stream);
+  }
+  key = key_stream.str();
+  return true;
+}
+
+Status CommonSubexpressionEliminationPass::MergeNode(NodePtr &node, NodePtr &kept_node) {
+  GELOGI("Merge node %s into the same node %s, type %s", node->GetName().c_str(), kept_node->GetName().c_str(),
+         node->GetType().c_str());
+  for (const auto &out_anchor : node->GetAllOutDataAnchors()) {
+    auto kept_out_anchor = kept_node->GetOutDataAnchor(out_anchor->GetIdx());
+    GE_CHECK_NOTNULL(kept_out_anchor);
+    for (const auto &peer_in_anchor : out_anchor->GetPeerInDataAnchors()) {
+      if ((GraphUtils::RemoveEdge(out_anchor, peer_in_anchor) != GRAPH_SUCCESS) ||
+          (GraphUtils::AddEdge(kept_out_anchor, peer_in_anchor) != GRAPH_SUCCESS)) {
+        GELOGE(FAILED, "Failed to move the output %d of node %s to node %s", out_anchor->GetIdx(),
+               node->GetName().c_str(), kept_node->GetName().c_str());
+        return FAILED;
+      }
+    }
+    for (const auto &peer_in_control_anchor : out_anchor->GetPeerInControlAnchors()) {
+      if ((GraphUtils::RemoveEdge(out_anchor, peer_in_control_anchor) != GRAPH_SUCCESS) ||
+          (!kept_out_anchor->IsLinkedWith(peer_in_control_anchor) &&
+           (GraphUtils::AddEdge(kept_out_anchor, peer_in_control_anchor) != GRAPH_SUCCESS))) {
+        GELOGE(FAILED, "Failed to move the control output %d of node %s to node %s", out_anchor->GetIdx(),
+               node->GetName().c_str(), kept_node->GetName().c_str());
+        return FAILED;
+      }
+    }
+  }
+  if (GraphUtils::MoveOutCtrlEdges(node, kept_node) != GRAPH_SUCCESS) {
+    GELOGE(FAILED, "Failed to move the out control edges of node %s to node %s", node->GetName().c_str(),
+           kept_node->GetName().c_str());
+    return FAILED;
+  }
+
+  // the users of the kept node may be the same as each other now
+  AddRePassNodesWithInOut(kept_node);
+  return IsolateAndDeleteNode(node, {});
+}
+}  // namespace ge
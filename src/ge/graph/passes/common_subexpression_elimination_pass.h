@@ -0,0 +1,45 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_PASSES_COMMON_SUBEXPRESSION_ELIMINATION_PASS_H_
+#define GE_GRAPH_PASSES_COMMON_SUBEXPRESSION_ELIMINATION_PASS_H_
+
+#include <string>
+#include <unordered_map>
+
+#include "graph/passes/base_pass.h"
+
+namespace ge {
+///
+/// Merges the nodes which compute the same value: same op type, same attributes, same output descs,
+/// fed by the same out anchors and depending on the same control nodes. The nodes are visited in
+/// topological order, so that once a node is merged, its users become equivalent and merge on re-pass.
+/// Stateful ops, ops with side effects and ref ops, which write an input in place, are never merged.
+/// The dump attrs naming the original ops are not compared, the kept node keeps its own.
+///
+class CommonSubexpressionEliminationPass : public BaseNodePass {
+ public:
+  Status Run(NodePtr &node) override;
+
+ private:
+  static bool IsCandidate(const NodePtr &node);
+  static bool GetNodeKey(const NodePtr &node, std::string &key);
+  Status MergeNode(NodePtr &node, NodePtr &kept_node);
+
+  std::unordered_map<std::string, NodePtr> keys_to_node_;
+};
+}  // namespace ge
+#endif  // GE_GRAPH_PASSES_COMMON_SUBEXPRESSION_ELIMINATION_PASS_H_
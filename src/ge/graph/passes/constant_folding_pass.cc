@@ -21,6 +21,7 @@
 #include "common/debug/log.h"
 #include "common/types.h"
 #include "framework/common/debug/ge_log.h"
+#include "graph/passes/folding_result_cache.h"
 #include "graph/utils/attr_utils.h"
 #include "graph/utils/node_utils.h"
 #include "graph/utils/op_desc_utils.h"
@@ -55,6 +56,12 @@ Status ConstantFoldingPass::Run(ge::NodePtr &node) {
   }
   auto inputs = OpDescUtils::GetInputData(input_nodes);
   vector<GeTensorPtr> outputs;
+  FoldingResultCache &folding_cache = FoldingResultCache::Instance();
+  std::string folding_key = folding_cache.GetFoldingKey(node_desc, inputs);
+  if (folding_cache.Find(folding_key, inputs, outputs)) {
+    GELOGD("Fold node %s type %s with cached result", node->GetName().c_str(), node->GetType().c_str());
+    return Folding(node, outputs);
+  }
   auto ret = op_kernel->Compute(node_desc, inputs, outputs);
   if (ret != SUCCESS) {
     if (ret == NOT_CHANGED) {
@@ -71,6 +78,7 @@ Status ConstantFoldingPass::Run(ge::NodePtr &node) {
     return INTERNAL_ERROR;
   }
 
+  folding_cache.Insert(folding_key, inputs, outputs);
   return Folding(node, outputs);
 }
 }  // namespace ge
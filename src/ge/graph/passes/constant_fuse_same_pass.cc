@@ -16,6 +16,8 @@
 
 #include "graph/passes/constant_fuse_same_pass.h"
 
+#include <climits>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <string>
@@ -33,6 +35,31 @@ namespace ge {
 namespace {
 const size_t kCorrectNum = 1;
 const char *const kOriginElementNumAttrName = "origin_element_num";
+const uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+const uint64_t kFnvPrime = 1099511628211ULL;
+
+// FNV-1a over 8 bytes a step, the tail byte by byte
+uint64_t HashContent(const uint8_t *data, size_t size) {
+  uint64_t hash = kFnvOffsetBasis;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    (void)memcpy(&word, data + i, sizeof(uint64_t));
+    hash = (hash ^ word) * kFnvPrime;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ data[i]) * kFnvPrime;
+  }
+  return hash;
+}
+
+bool IsSameConst(const SameConstKey &key, const SameConstKey &other) {
+  if ((key.data_size != other.data_size) || (key.data_type != other.data_type) || (key.format != other.format) ||
+      (key.shape != other.shape)) {
+    return false;
+  }
+  return (key.data_size == 0) || (memcmp(key.data, other.data, key.data_size) == 0);
+}
 
 bool CheckConstInAndOut(const NodePtr &node) {
   // has none in control
@@ -69,15 +96,22 @@ Status ConstantFuseSamePass::Run(ge::ComputeGraphPtr graph) {
   GELOGI("ConstantFuseSamePass in.");
 
   std::map<SameConstKey, std::vector<NodePtr>> fuse_nodes;
-  GetFuseConstNodes(graph, fuse_nodes);
+  SameContentBuckets same_content_nodes;
+  GetFuseConstNodes(graph, fuse_nodes, same_content_nodes);
 
-  return FuseConstNodes(graph, fuse_nodes);
+  Status ret = FuseConstNodes(graph, fuse_nodes);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  return FuseSameContentNodes(graph, same_content_nodes);
 }
 
 void ConstantFuseSamePass::GetFuseConstNodes(ComputeGraphPtr &graph,
-                                             std::map<SameConstKey, std::vector<NodePtr>> &fuse_nodes) {
+                                             std::map<SameConstKey, std::vector<NodePtr>> &fuse_nodes,
+                                             SameContentBuckets &same_content_nodes) {
   int total_const_nums = 0;
   int insert_const_nums = 0;
+  int same_content_nums = 0;
   for (auto &node : graph->GetDirectNode()) {
     if (node->GetType() != CONSTANT && node->GetType() != CONSTANTOP) {
       continue;
@@ -98,22 +132,31 @@ void ConstantFuseSamePass::GetFuseConstNodes(ComputeGraphPtr &graph,
       GELOGW("The const node %s does not have weight attr, skip it", node->GetName().c_str());
       continue;
     }
-    int64_t origin_element_num = -1;
-    if (!AttrUtils::GetInt(weight->MutableTensorDesc(), kOriginElementNumAttrName, origin_element_num)) {
-      GELOGI("The const %s does not have origin element num attribute, skip it", node->GetName().c_str());
+    auto output_tensor = op_desc->MutableOutputDesc(0);
+    if (output_tensor == nullptr) {
+      GELOGW("The const %s does not have output 0, skip to fusion", node->GetName().c_str());
       continue;
     }
-    if (origin_element_num != 1) {
+    int64_t origin_element_num = -1;
+    if (!AttrUtils::GetInt(weight->MutableTensorDesc(), kOriginElementNumAttrName, origin_element_num) ||
+        (origin_element_num != 1)) {
+      const Buffer weight_data = weight->GetData();
+      if (dedup_any_size_ && (weight_data.size() <= static_cast<size_t>(INT_MAX))) {
+        SameConstKey content_key;
+        content_key.data_size = static_cast<int>(weight_data.size());
+        content_key.data = weight_data.GetData();
+        content_key.data_type = output_tensor->GetDataType();
+        content_key.format = output_tensor->GetFormat();
+        content_key.shape = output_tensor->GetShape().GetDims();
+        AddSameContentNode(node, content_key, same_content_nodes);
+        ++same_content_nums;
+        continue;
+      }
       GELOGI("The const %s origin element num %ld, does not support to fusion now", node->GetName().c_str(),
              origin_element_num);
       continue;
     }
 
-    auto output_tensor = op_desc->MutableOutputDesc(0);
-    if (output_tensor == nullptr) {
-      GELOGW("The const %s does not have output 0, skip to fusion", node->GetName().c_str());
-      continue;
-    }
     auto data_type = output_tensor->GetDataType();
     auto type_size = GetSizeByDataType(data_type);
     if (type_size < 0) {
@@ -135,8 +178,23 @@ void ConstantFuseSamePass::GetFuseConstNodes(ComputeGraphPtr &graph,
            TypeUtils::DataTypeToSerialString(map_key.data_type).c_str(), map_key.data_size, map_key.shape.size(),
            node->GetName().c_str());
   }
-  GELOGI("ConstantFuseSamePass, total_const_nums %d, insert_const_nums %d, fuse_nodes size is %zu.", total_const_nums,
-         insert_const_nums, fuse_nodes.size());
+  GELOGI("ConstantFuseSamePass, total_const_nums %d, insert_const_nums %d, fuse_nodes size is %zu, "
+         "same_content_nums %d, content buckets size is %zu.",
+         total_const_nums, insert_const_nums, fuse_nodes.size(), same_content_nums, same_content_nodes.size());
+}
+
+void ConstantFuseSamePass::AddSameContentNode(const NodePtr &node, const SameConstKey &key,
+                                              SameContentBuckets &same_content_nodes) {
+  auto &bucket = same_content_nodes[HashContent(key.data, static_cast<size_t>(key.data_size))];
+  for (auto &consts : bucket) {
+    if (IsSameConst(consts.key, key)) {
+      consts.nodes.emplace_back(node);
+      GELOGD("The const %s has the same content as %s, data_size %d", node->GetName().c_str(),
+             consts.nodes.at(0)->GetName().c_str(), key.data_size);
+      return;
+    }
+  }
+  bucket.emplace_back(SameContentConsts{key, {node}});
 }
 
 Status ConstantFuseSamePass::MoveOutDataEdges(NodePtr &src_node, NodePtr &dst_node) {
@@ -172,24 +230,42 @@ Status ConstantFuseSamePass::MoveOutDataEdges(NodePtr &src_node, NodePtr &dst_no
 Status ConstantFuseSamePass::FuseConstNodes(ComputeGraphPtr &graph,
                                             std::map<SameConstKey, std::vector<NodePtr>> &fuse_nodes) {
   for (auto iter = fuse_nodes.begin(); iter != fuse_nodes.end(); ++iter) {
-    auto nodes = iter->second;
-    size_t len = nodes.size();
-    auto first_node = nodes.at(0);
-    for (size_t i = 1; i < len; ++i) {
-      auto node = nodes.at(i);
-      // the const node which can be fused has none input(both data and control in)
-      if (GraphUtils::MoveOutCtrlEdges(node, first_node) != SUCCESS) {
-        return FAILED;
-      }
-      if (MoveOutDataEdges(node, first_node) != SUCCESS) {
-        return FAILED;
-      }
-      if (GraphUtils::RemoveNodeWithoutRelink(graph, node) != SUCCESS) {
-        GELOGE(FAILED, "[%s] RemoveNodeWithoutRelink failed.", node->GetName().c_str());
+    if (FuseNodes(graph, iter->second) != SUCCESS) {
+      return FAILED;
+    }
+  }
+  return SUCCESS;
+}
+
+Status ConstantFuseSamePass::FuseSameContentNodes(ComputeGraphPtr &graph, SameContentBuckets &same_content_nodes) {
+  // the buckets are visited by hash, the first node of a group is the first one of the graph anyway
+  for (auto &bucket : same_content_nodes) {
+    for (auto &consts : bucket.second) {
+      if (FuseNodes(graph, consts.nodes) != SUCCESS) {
         return FAILED;
       }
     }
   }
   return SUCCESS;
 }
+
+Status ConstantFuseSamePass::FuseNodes(ComputeGraphPtr &graph, std::vector<NodePtr> &nodes) {
+  size_t len = nodes.size();
+  auto first_node = nodes.at(0);
+  for (size_t i = 1; i < len; ++i) {
+    auto node = nodes.at(i);
+    // the const node which can be fused has none input(both data and control in)
+    if (GraphUtils::MoveOutCtrlEdges(node, first_node) != SUCCESS) {
+      return FAILED;
+    }
+    if (MoveOutDataEdges(node, first_node) != SUCCESS) {
+      return FAILED;
+    }
+    if (GraphUtils::RemoveNodeWithoutRelink(graph, node) != SUCCESS) {
+      GELOGE(FAILED, "[%s] RemoveNodeWithoutRelink failed.", node->GetName().c_str());
+      return FAILED;
+    }
+  }
+  return SUCCESS;
+}
 }  // namespace ge
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -61,14 +62,34 @@ struct SameConstKey {
   }
 };
 
+///
+/// @brief Const nodes of the same content, they are confirmed by memcmp in a bucket of the same content hash
+///
+struct SameContentConsts {
+  SameConstKey key;
+  std::vector<NodePtr> nodes;
+};
+using SameContentBuckets = std::unordered_map<uint64_t, std::vector<SameContentConsts>>;
+
 class ConstantFuseSamePass : public GraphPass {
  public:
+  ///
+  /// @param [in] dedup_any_size fuse consts of any size by their content, not only the ones of one origin element
+  ///
+  explicit ConstantFuseSamePass(bool dedup_any_size = false) : dedup_any_size_(dedup_any_size) {}
+
   Status Run(ge::ComputeGraphPtr graph) override;
 
  private:
-  void GetFuseConstNodes(ComputeGraphPtr &graph, std::map<SameConstKey, std::vector<NodePtr>> &fuse_nodes);
+  void GetFuseConstNodes(ComputeGraphPtr &graph, std::map<SameConstKey, std::vector<NodePtr>> &fuse_nodes,
+                         SameContentBuckets &same_content_nodes);
+  void AddSameContentNode(const NodePtr &node, const SameConstKey &key, SameContentBuckets &same_content_nodes);
   Status MoveOutDataEdges(NodePtr &src_node, NodePtr &dst_node);
   Status FuseConstNodes(ComputeGraphPtr &graph, std::map<SameConstKey, std::vector<NodePtr>> &fuse_nodes);
+  Status FuseSameContentNodes(ComputeGraphPtr &graph, SameContentBuckets &same_content_nodes);
+  Status FuseNodes(ComputeGraphPtr &graph, std::vector<NodePtr> &nodes);
+
+  bool dedup_any_size_;
 };
 }  // namespace ge
 #endif  // GE_GRAPH_PASSES_CONSTANT_FUSE_SAME_PASS_H_
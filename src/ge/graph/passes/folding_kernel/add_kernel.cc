@@ -77,58 +77,40 @@ bool AddKernel::OverflowCheck(const T &x, const T &y, DataType data_type) {
 template <typename InT>
 Status AddKernel::BCastAdd(const OpDescPtr &op_desc_ptr, const std::vector<ConstGeTensorPtr> &input,
                            std::vector<GeTensorPtr> &v_output) {
-  // only broadcast shape
-  BCast bcast;
-  Status ret = bcast.GenerateBcastInfo(ge::BCast::TransShapeToDimVec(input[kAddFirstInput]->GetTensorDesc()),
-                                       ge::BCast::TransShapeToDimVec(input[kAddSecondInput]->GetTensorDesc()));
-  if (ret != SUCCESS) {
-    GELOGE(ret, "Greater broadcasting failed.");
-    return ret;
-  }
-
-  std::vector<int64_t> x_indexes;
-  std::vector<int64_t> y_indexes;
-  bcast.BCastIndexes(x_indexes, y_indexes);
-
-  if (input[kAddFirstInput]->GetData().size() < sizeof(InT)) {
-    GELOGE(FAILED, "The size of the first input is less than the size of the InT.");
-    return FAILED;
-  }
-  auto x1_data = reinterpret_cast<const InT *>(input[kAddFirstInput]->GetData().data());
-
-  if (input[kAddSecondInput]->GetData().size() < sizeof(InT)) {
-    GELOGE(FAILED, "The size of the second input is less than the size of the InT.");
+  if ((input[kAddFirstInput]->GetData().size() < sizeof(InT)) ||
+      (input[kAddSecondInput]->GetData().size() < sizeof(InT))) {
+    GELOGE(FAILED, "The size of the inputs is less than the size of the InT.");
     return FAILED;
   }
-  auto x2_data = reinterpret_cast<const InT *>(input[kAddSecondInput]->GetData().data());
-
-  size_t data_num = x_indexes.size();
-  InT *data = nullptr;
-  data = new (std::nothrow) InT[data_num]();
-  GE_CHECK_NOTNULL(data);
 
-  DataType data_type = input[kAddFirstInput]->GetTensorDesc().GetDataType();
-  for (size_t i = 0; i < data_num; i++) {
-    auto x_index = *(x1_data + x_indexes[i]);
-    auto y_index = *(x2_data + y_indexes[i]);
-    if (OverflowCheck<InT>(x_index, y_index, data_type)) {
+  auto add_func = [this](InT const &x, InT const &y, DataType &type, Status &ret) -> InT {
+    if (OverflowCheck<InT>(x, y, type)) {
       GELOGE(PARAM_INVALID, "Result of add is overflow.");
-      GE_DELETE_NEW_ARRAY(data);
-      return PARAM_INVALID;
+      ret = PARAM_INVALID;
+      return static_cast<InT>(0);
     }
-    data[i] = x_index + y_index;
+    return x + y;
+  };
+
+  // only broadcast shape, output is computed without materialising broadcast indexes
+  BCast bcast;
+  std::vector<InT> data;
+  Status ret = bcast.BCastComputeCheck<InT>(input, data, add_func);
+  if (ret != SUCCESS) {
+    GELOGE(ret, "Greater broadcasting failed.");
+    return ret;
   }
+  size_t data_num = data.size();
+  DataType data_type = input[kAddFirstInput]->GetTensorDesc().GetDataType();
 
   GeTensorPtr output_ptr = MakeShared<GeTensor>(op_desc_ptr->GetOutputDesc(kAddFirstOutput));
   if (output_ptr == nullptr) {
     GELOGE(MEMALLOC_FAILED, "Make shared failed");
-    GE_DELETE_NEW_ARRAY(data);
     return MEMALLOC_FAILED;
   }
-  if (output_ptr->SetData(reinterpret_cast<uint8_t *>(data), data_num * sizeof(InT))) {
+  if (output_ptr->SetData(reinterpret_cast<uint8_t *>(data.data()), data_num * sizeof(InT))) {
     GELOGW("GetRange: SetData failed");
   }
-  GE_DELETE_NEW_ARRAY(data);
 
   output_ptr->MutableTensorDesc().SetDataType(data_type);
   vector<int64_t> bcast_dims = bcast.GetOutputShape();
@@ -62,19 +62,18 @@ Status CheckYIsZero(T const &y, DataType &type) {
 }
 
 // mod(x,y) equals to x - y * floor(x/y)
-#define DEFINE_FUNC_BY_TYPE(TYPE)                                                         \
-  std::function<TYPE(TYPE const &, TYPE const &, DataType &, Status &)> func_##TYPE = []( \
-      TYPE const &a, TYPE const &b, DataType &type, Status &ret) -> TYPE {                \
-    ret = CheckYIsZero(b, type);                                                          \
-    if (ret != SUCCESS) {                                                                 \
-      return static_cast<TYPE>(0);                                                        \
-    }                                                                                     \
-    return (a - b * FloorDiv(a, b));                                                      \
+#define DEFINE_FUNC_BY_TYPE(TYPE)                                                            \
+  auto func_##TYPE = [](TYPE const &a, TYPE const &b, DataType &type, Status &ret) -> TYPE { \
+    ret = CheckYIsZero(b, type);                                                             \
+    if (ret != SUCCESS) {                                                                    \
+      return static_cast<TYPE>(0);                                                           \
+    }                                                                                        \
+    return (a - b * FloorDiv(a, b));                                                         \
   };
 
-#define SET_BCAST_COMPUTE_CASE(DTYPE, TYPE)                           \
-  case DTYPE:                                                         \
-    ret = bcast.BCastComputeCheck(input, y_data_##TYPE, func_##TYPE); \
+#define SET_BCAST_COMPUTE_CASE(DTYPE, TYPE)                                 \
+  case DTYPE:                                                               \
+    ret = bcast.BCastComputeCheck<TYPE>(input, y_data_##TYPE, func_##TYPE); \
     break;
 
 #define SET_OUTPUT(DTYPE, TYPE)                                                                                  \
@@ -38,14 +38,14 @@ const size_t kMaximumFirstOutput = 0;
 const std::set<DataType> kMaximumSupportedType = {DT_FLOAT, DT_FLOAT16, DT_INT8,   DT_INT16,  DT_UINT16, DT_UINT8,
                                                   DT_INT32, DT_INT64,   DT_UINT32, DT_UINT64, DT_DOUBLE};
 
-#define DEFINE_FUNC_BY_TYPE(TYPE)                                                                          \
-  std::function<TYPE(TYPE const &, TYPE const &)> func_##TYPE = [](TYPE const &a, TYPE const &b) -> TYPE { \
-    return (a > b ? a : b);                                                                                \
+#define DEFINE_FUNC_BY_TYPE(TYPE)                               \
+  auto func_##TYPE = [](TYPE const &a, TYPE const &b) -> TYPE { \
+    return (a > b ? a : b);                                     \
   };
 
-#define SET_BCAST_COMPUTE_CASE(DTYPE, TYPE)                      \
-  case DTYPE:                                                    \
-    ret = bcast.BCastCompute(input, y_data_##TYPE, func_##TYPE); \
+#define SET_BCAST_COMPUTE_CASE(DTYPE, TYPE)                            \
+  case DTYPE:                                                          \
+    ret = bcast.BCastCompute<TYPE>(input, y_data_##TYPE, func_##TYPE); \
     break;
 
 #define SET_OUTPUT(DTYPE, TYPE)                                                                                  \
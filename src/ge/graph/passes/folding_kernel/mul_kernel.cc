@@ -45,19 +45,18 @@ Status IsOverflow(T const &a, T const &b, DataType &type) {
   }
 }
 
-#define DEFINE_FUNC_WITH_STATUS_BY_TYPE(TYPE)                                             \
-  std::function<TYPE(TYPE const &, TYPE const &, DataType &, Status &)> func_##TYPE = []( \
-      TYPE const &a, TYPE const &b, DataType &type, Status &ret) -> TYPE {                \
-    ret = IsOverflow(a, b, type);                                                         \
-    if (ret != SUCCESS) {                                                                 \
-      return static_cast<TYPE>(0);                                                        \
-    }                                                                                     \
-    return a * b;                                                                         \
+#define DEFINE_FUNC_WITH_STATUS_BY_TYPE(TYPE)                                                \
+  auto func_##TYPE = [](TYPE const &a, TYPE const &b, DataType &type, Status &ret) -> TYPE { \
+    ret = IsOverflow(a, b, type);                                                            \
+    if (ret != SUCCESS) {                                                                    \
+      return static_cast<TYPE>(0);                                                           \
+    }                                                                                        \
+    return a * b;                                                                            \
   };
 
-#define SET_BCAST_COMPUTE_CASE(DTYPE, TYPE)                           \
-  case DTYPE:                                                         \
-    ret = bcast.BCastComputeCheck(input, y_data_##TYPE, func_##TYPE); \
+#define SET_BCAST_COMPUTE_CASE(DTYPE, TYPE)                                 \
+  case DTYPE:                                                               \
+    ret = bcast.BCastComputeCheck<TYPE>(input, y_data_##TYPE, func_##TYPE); \
     break;
 
 #define SET_OUTPUT(DTYPE, TYPE)                                                                                  \
@@ -33,14 +33,14 @@ const size_t kSubFirstOutput = 0;
 const size_t kSubOutputSize = 1;
 const size_t kSubInputSize = 2;
 
-#define DEFINE_FUNC_BY_TYPE(TYPE)                                                                          \
-  std::function<TYPE(TYPE const &, TYPE const &)> func_##TYPE = [](TYPE const &a, TYPE const &b) -> TYPE { \
-    return a - b;                                                                                          \
+#define DEFINE_FUNC_BY_TYPE(TYPE)                               \
+  auto func_##TYPE = [](TYPE const &a, TYPE const &b) -> TYPE { \
+    return a - b;                                               \
   };
 
-#define SET_BCAST_COMPUTE_CASE(DTYPE, TYPE)                      \
-  case DTYPE:                                                    \
-    ret = bcast.BCastCompute(input, y_data_##TYPE, func_##TYPE); \
+#define SET_BCAST_COMPUTE_CASE(DTYPE, TYPE)                            \
+  case DTYPE:                                                          \
+    ret = bcast.BCastCompute<TYPE>(input, y_data_##TYPE, func_##TYPE); \
     break;
 
 #define SET_OUTPUT(DTYPE, TYPE)                                                                                  \
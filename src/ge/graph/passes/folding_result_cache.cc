@@ -0,0 +1,332 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/passes/folding_result_cache.h"
+
+#include <cstring>
+#include <map>
+
+#include "framework/common/debug/ge_log.h"
+#include "graph/debug/ge_attr_define.h"
+
+namespace ge {
+namespace {
+const size_t kDefaultCacheCapacity = 64 * 1024 * 1024;
+// one folding takes at most this part of the capacity, so a big constant does not flush the cache
+const size_t kMaxResultRatio = 4;
+const uint64_t kHashMultiplier = 0x9E3779B97F4A7C15ULL;
+const uint64_t kHashSeed = 0xCBF29CE484222325ULL;
+const uint64_t kHashShift = 29;
+
+// attrs naming the op or placing it, the folding results do not depend on them
+bool IsIgnoredAttr(const std::string &attr_name) {
+  return attr_name == ATTR_NAME_NAME || attr_name == ATTR_NAME_DATA_DUMP_ORIGIN_OP_NAMES ||
+         attr_name == ATTR_NAME_STREAM_LABEL;
+}
+
+void AppendInt(std::string &key, int64_t value) {
+  key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void AppendTensorDesc(std::string &key, const GeTensorDesc &tensor_desc) {
+  AppendInt(key, static_cast<int64_t>(tensor_desc.GetDataType()));
+  AppendInt(key, static_cast<int64_t>(tensor_desc.GetFormat()));
+  const std::vector<int64_t> dims = tensor_desc.GetShape().GetDims();
+  AppendInt(key, static_cast<int64_t>(dims.size()));
+  for (int64_t dim : dims) {
+    AppendInt(key, dim);
+  }
+}
+
+void AppendString(std::string &key, const std::string &value) {
+  AppendInt(key, static_cast<int64_t>(value.size()));
+  key.append(value);
+}
+
+template <typename T>
+bool AppendValue(std::string &key, const GeAttrValue &attr_value) {
+  T value;
+  if (attr_value.GetValue<T>(value) != GRAPH_SUCCESS) {
+    return false;
+  }
+  key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  return true;
+}
+
+template <typename T>
+bool AppendListValue(std::string &key, const GeAttrValue &attr_value) {
+  std::vector<T> values;
+  if (attr_value.GetValue<std::vector<T>>(values) != GRAPH_SUCCESS) {
+    return false;
+  }
+  AppendInt(key, static_cast<int64_t>(values.size()));
+  for (const T &value : values) {
+    key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+  return true;
+}
+
+bool AppendAttrValue(std::string &key, const GeAttrValue &attr_value) {
+  auto value_type = attr_value.GetValueType();
+  AppendInt(key, static_cast<int64_t>(value_type));
+  switch (value_type) {
+    case GeAttrValue::VT_NONE:
+      return true;
+    case GeAttrValue::VT_INT:
+      return AppendValue<GeAttrValue::INT>(key, attr_value);
+    case GeAttrValue::VT_FLOAT:
+      return AppendValue<GeAttrValue::FLOAT>(key, attr_value);
+    case GeAttrValue::VT_BOOL:
+      return AppendValue<GeAttrValue::BOOL>(key, attr_value);
+    case GeAttrValue::VT_DATA_TYPE:
+      return AppendValue<GeAttrValue::DATA_TYPE>(key, attr_value);
+    case GeAttrValue::VT_LIST_INT:
+      return AppendListValue<GeAttrValue::INT>(key, attr_value);
+    case GeAttrValue::VT_LIST_FLOAT:
+      return AppendListValue<GeAttrValue::FLOAT>(key, attr_value);
+    case GeAttrValue::VT_LIST_DATA_TYPE:
+      return AppendListValue<GeAttrValue::DATA_TYPE>(key, attr_value);
+    case GeAttrValue::VT_LIST_BOOL: {
+      GeAttrValue::LIST_BOOL values;
+      if (attr_value.GetValue<GeAttrValue::LIST_BOOL>(values) != GRAPH_SUCCESS) {
+        return false;
+      }
+      AppendInt(key, static_cast<int64_t>(values.size()));
+      for (bool value : values) {
+        key.push_back(value ? '\1' : '\0');
+      }
+      return true;
+    }
+    case GeAttrValue::VT_STRING: {
+      GeAttrValue::STR value;
+      if (attr_value.GetValue<GeAttrValue::STR>(value) != GRAPH_SUCCESS) {
+        return false;
+      }
+      AppendString(key, value);
+      return true;
+    }
+    case GeAttrValue::VT_LIST_STRING: {
+      GeAttrValue::LIST_STR values;
+      if (attr_value.GetValue<GeAttrValue::LIST_STR>(values) != GRAPH_SUCCESS) {
+        return false;
+      }
+      AppendInt(key, static_cast<int64_t>(values.size()));
+      for (const auto &value : values) {
+        AppendString(key, value);
+      }
+      return true;
+    }
+    case GeAttrValue::VT_LIST_LIST_INT: {
+      GeAttrValue::LIST_LIST_INT values;
+      if (attr_value.GetValue<GeAttrValue::LIST_LIST_INT>(values) != GRAPH_SUCCESS) {
+        return false;
+      }
+      AppendInt(key, static_cast<int64_t>(values.size()));
+      for (const auto &value : values) {
+        AppendInt(key, static_cast<int64_t>(value.size()));
+        for (int64_t item : value) {
+          AppendInt(key, item);
+        }
+      }
+      return true;
+    }
+    case GeAttrValue::VT_TENSOR_DESC: {
+      GeTensorDesc value;
+      if (attr_value.GetValue<GeTensorDesc>(value) != GRAPH_SUCCESS) {
+        return false;
+      }
+      AppendTensorDesc(key, value);
+      return true;
+    }
+    default:
+      // tensors, graphs, bytes and named attrs, too costly to compare, such ops are not cached
+      return false;
+  }
+}
+
+// attrs are sorted by name, so equal ops get the same key
+bool AppendAttrs(std::string &key, const OpDescPtr &op_desc) {
+  for (const auto &it : op_desc->GetAllAttrs()) {
+    if (IsIgnoredAttr(it.first)) {
+      continue;
+    }
+    AppendString(key, it.first);
+    if (!AppendAttrValue(key, it.second)) {
+      GELOGD("Attr %s of op %s can not be cached.", it.first.c_str(), op_desc->GetName().c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t GetTensorsSize(const std::vector<ConstGeTensorPtr> &tensors) {
+  size_t size = 0;
+  for (const auto &tensor : tensors) {
+    size += tensor->GetData().size();
+  }
+  return size;
+}
+
+size_t GetTensorsSize(const std::vector<GeTensorPtr> &tensors) {
+  size_t size = 0;
+  for (const auto &tensor : tensors) {
+    size += (tensor == nullptr) ? 0 : tensor->GetData().size();
+  }
+  return size;
+}
+
+bool IsSameData(const std::vector<ConstGeTensorPtr> &left, const std::vector<ConstGeTensorPtr> &right) {
+  if (left.size() != right.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < left.size(); ++i) {
+    const auto &left_data = left[i]->GetData();
+    const auto &right_data = right[i]->GetData();
+    if (left_data.size() != right_data.size()) {
+      return false;
+    }
+    if (left_data.data() != right_data.data() && left_data.size() > 0 &&
+        memcmp(left_data.data(), right_data.data(), left_data.size()) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+FoldingResultCache &FoldingResultCache::Instance() {
+  static FoldingResultCache instance;
+  return instance;
+}
+
+FoldingResultCache::FoldingResultCache() : capacity_(kDefaultCacheCapacity) {}
+
+uint64_t FoldingResultCache::GetDataHash(const uint8_t *data, size_t size) {
+  uint64_t hash = kHashSeed ^ size;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    memcpy(&word, data + i, sizeof(uint64_t));
+    hash = (hash ^ word) * kHashMultiplier;
+    hash ^= hash >> kHashShift;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ data[i]) * kHashMultiplier;
+  }
+  return hash;
+}
+
+std::string FoldingResultCache::GetFoldingKey(const OpDescPtr &op_desc,
+                                              const std::vector<ConstGeTensorPtr> &inputs) const {
+  if (op_desc == nullptr) {
+    return "";
+  }
+  for (const auto &input : inputs) {
+    if (input == nullptr) {
+      return "";
+    }
+  }
+  if (GetTensorsSize(inputs) > capacity_ / kMaxResultRatio) {
+    return "";
+  }
+
+  std::string key = op_desc->GetType();
+  key.push_back('\0');
+  if (!AppendAttrs(key, op_desc)) {
+    return "";
+  }
+  for (const auto &input_desc : op_desc->GetAllInputsDesc()) {
+    AppendTensorDesc(key, input_desc);
+  }
+  for (const auto &output_desc : op_desc->GetAllOutputsDesc()) {
+    AppendTensorDesc(key, output_desc);
+  }
+  for (const auto &input : inputs) {
+    AppendTensorDesc(key, input->GetTensorDesc());
+    const auto &data = input->GetData();
+    AppendInt(key, static_cast<int64_t>(GetDataHash(data.data(), data.size())));
+  }
+  return key;
+}
+
+bool FoldingResultCache::Find(const std::string &key, const std::vector<ConstGeTensorPtr> &inputs,
+                              std::vector<GeTensorPtr> &outputs) {
+  if (key.empty()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = results_.find(key);
+  if (it == results_.end() || !IsSameData(it->second.inputs, inputs)) {
+    statistics_.miss_count++;
+    return false;
+  }
+  lru_keys_.splice(lru_keys_.begin(), lru_keys_, it->second.lru_iter);
+  outputs = it->second.outputs;
+  statistics_.hit_count++;
+  statistics_.saved_bytes += GetTensorsSize(outputs);
+  return true;
+}
+
+void FoldingResultCache::Insert(const std::string &key, const std::vector<ConstGeTensorPtr> &inputs,
+                                const std::vector<GeTensorPtr> &outputs) {
+  if (key.empty()) {
+    return;
+  }
+  size_t size = key.size() + GetTensorsSize(inputs) + GetTensorsSize(outputs);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (size > capacity_ / kMaxResultRatio || results_.count(key) > 0) {
+    return;
+  }
+  EvictUntilFit(size);
+  lru_keys_.push_front(key);
+  FoldingResult &result = results_[key];
+  result.inputs = inputs;
+  result.outputs = outputs;
+  result.size = size;
+  result.lru_iter = lru_keys_.begin();
+  statistics_.cached_bytes += size;
+}
+
+void FoldingResultCache::EvictUntilFit(size_t size) {
+  while (!lru_keys_.empty() && statistics_.cached_bytes + size > capacity_) {
+    auto it = results_.find(lru_keys_.back());
+    if (it != results_.end()) {
+      statistics_.cached_bytes -= it->second.size;
+      results_.erase(it);
+    }
+    lru_keys_.pop_back();
+    statistics_.evict_count++;
+  }
+}
+
+void FoldingResultCache::SetCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = capacity;
+  EvictUntilFit(0);
+}
+
+void FoldingResultCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  lru_keys_.clear();
+  results_.clear();
+  statistics_ = FoldingCacheStatistics();
+}
+
+FoldingCacheStatistics FoldingResultCache::GetStatistics() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+}  // namespace ge
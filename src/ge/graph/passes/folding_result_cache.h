@@ -0,0 +1,103 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_PASSES_FOLDING_RESULT_CACHE_H_
+#define GE_GRAPH_PASSES_FOLDING_RESULT_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "graph/ge_attr_value.h"
+#include "graph/ge_tensor.h"
+#include "graph/op_desc.h"
+
+namespace ge {
+struct FoldingCacheStatistics {
+  uint64_t hit_count = 0;
+  uint64_t miss_count = 0;
+  uint64_t evict_count = 0;
+  // output bytes of the folding results served from cache instead of computed
+  uint64_t saved_bytes = 0;
+  uint64_t cached_bytes = 0;
+};
+
+///
+/// @ingroup ge_graph
+/// @brief results of host constant folding, keyed by op type, attrs, tensor descs and input contents.
+/// It lives across passes and graphs, so repeated subgraphs and recompiled graphs fold each op once.
+/// Cached outputs are shared by all hits and must not be modified.
+///
+class FoldingResultCache {
+ public:
+  static FoldingResultCache &Instance();
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief build cache key of folding an op on inputs
+  /// @param [in] op_desc op to fold
+  /// @param [in] inputs const inputs of op
+  /// @return key, empty if the folding can not be cached
+  ///
+  std::string GetFoldingKey(const OpDescPtr &op_desc, const std::vector<ConstGeTensorPtr> &inputs) const;
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief find folding result, inputs are compared byte by byte to rule out hash collision
+  /// @param [in] key key from GetFoldingKey
+  /// @param [in] inputs const inputs of op
+  /// @param [out] outputs cached outputs
+  /// @return true if found
+  ///
+  bool Find(const std::string &key, const std::vector<ConstGeTensorPtr> &inputs, std::vector<GeTensorPtr> &outputs);
+
+  void Insert(const std::string &key, const std::vector<ConstGeTensorPtr> &inputs,
+              const std::vector<GeTensorPtr> &outputs);
+
+  void SetCapacity(size_t capacity);
+
+  void Clear();
+
+  FoldingCacheStatistics GetStatistics();
+
+  static uint64_t GetDataHash(const uint8_t *data, size_t size);
+
+ private:
+  struct FoldingResult {
+    std::vector<ConstGeTensorPtr> inputs;
+    std::vector<GeTensorPtr> outputs;
+    size_t size = 0;
+    std::list<std::string>::iterator lru_iter;
+  };
+
+  FoldingResultCache();
+  ~FoldingResultCache() = default;
+
+  void EvictUntilFit(size_t size);
+
+  std::mutex mutex_;
+  size_t capacity_;
+  // most recently used first
+  std::list<std::string> lru_keys_;
+  std::unordered_map<std::string, FoldingResult> results_;
+  FoldingCacheStatistics statistics_;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_PASSES_FOLDING_RESULT_CACHE_H_
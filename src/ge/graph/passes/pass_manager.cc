@@ -15,12 +15,57 @@
  */
 
 #include "inc/pass_manager.h"
+
+#include <cxxabi.h>
+#include <cstdlib>
+#include <typeinfo>
+#include <unordered_set>
+
 #include "common/debug/log.h"
 #include "common/types.h"
 #include "common/util.h"
+#include "graph/passes/pass_profiler.h"
 #include "graph/utils/node_utils.h"
 
 namespace ge {
+namespace {
+// the graph passes have no names, they are reported by their class names
+std::string GetPassName(GraphPass &pass) {
+  const char *mangled_name = typeid(pass).name();
+  int status = 0;
+  char *demangled_name = abi::__cxa_demangle(mangled_name, nullptr, nullptr, &status);
+  std::string name = (status == 0 && demangled_name != nullptr) ? demangled_name : mangled_name;
+  free(demangled_name);
+  return name;
+}
+
+Status RunWithProfiling(const ComputeGraphPtr &graph, GraphPass &pass, PassProfiler &profiler) {
+  // the nodes are held until the pass ends, so a new node could not take the address of a deleted one
+  auto nodes_before = graph->GetAllNodes();
+  std::unordered_set<Node *> node_set_before;
+  for (const auto &node : nodes_before) {
+    node_set_before.insert(node.get());
+  }
+
+  uint64_t start_usec = GetCurrentTimestap();
+  Status status = pass.Run(graph);
+  uint64_t cost_usec = GetCurrentTimestap() - start_usec;
+
+  uint64_t nodes_added = 0;
+  uint64_t nodes_kept = 0;
+  for (const auto &node : graph->GetAllNodes()) {
+    if (node_set_before.count(node.get()) > 0) {
+      nodes_kept++;
+    } else {
+      nodes_added++;
+    }
+  }
+  profiler.AddGraphPassRun(GetPassName(pass), cost_usec, node_set_before.size(), status == SUCCESS, nodes_added,
+                           node_set_before.size() - nodes_kept);
+  return status;
+}
+}  // namespace
+
 const vector<GraphPass *>& PassManager::GraphPasses() const { return graph_passes_; }
 
 Status PassManager::AddPass(GraphPass *pass) {
@@ -37,11 +82,12 @@ Status PassManager::Run(const ComputeGraphPtr &graph) {
 Status PassManager::Run(const ComputeGraphPtr &graph, vector<GraphPass *> &passes) {
   GE_CHECK_NOTNULL(graph);
   bool not_changed = true;
+  PassProfiler *profiler = PassProfiler::GetCurrent();
 
   for (auto &pass : passes) {
     GE_CHECK_NOTNULL(pass);
 
-    Status status = pass->Run(graph);
+    Status status = (profiler == nullptr) ? pass->Run(graph) : RunWithProfiling(graph, *pass, *profiler);
     if (status == SUCCESS) {
       not_changed = false;
     } else if (status != NOT_CHANGED) {
@@ -0,0 +1,162 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/passes/pass_profiler.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "common/ge/ge_util.h"
+#include "framework/common/debug/ge_log.h"
+#include "nlohmann/json.hpp"
+
+namespace ge {
+namespace {
+const char *const kPassProfilingEnv = "GE_PASS_PROFILING";
+const char *const kPassProfilingOn = "1";
+
+thread_local PassProfiler *current_profiler = nullptr;
+}  // namespace
+
+PassProfilerPtr PassProfiler::CreateIfEnabled() {
+  const char *profiling = std::getenv(kPassProfilingEnv);
+  if (profiling == nullptr || strcmp(profiling, kPassProfilingOn) != 0) {
+    return nullptr;
+  }
+  PassProfilerPtr profiler = MakeShared<PassProfiler>();
+  if (profiler == nullptr) {
+    GELOGW("Make shared failed, the passes will not be profiled.");
+  }
+  return profiler;
+}
+
+PassProfiler *PassProfiler::GetCurrent() { return current_profiler; }
+
+PassProfileStat &PassProfiler::GetStat(const std::string &name, bool is_node_pass) {
+  auto iter = name_to_index_.find(name);
+  if (iter != name_to_index_.end()) {
+    return stats_[iter->second];
+  }
+  name_to_index_.emplace(name, stats_.size());
+  PassProfileStat stat;
+  stat.name = name;
+  stat.is_node_pass = is_node_pass;
+  stats_.emplace_back(stat);
+  return stats_.back();
+}
+
+void PassProfiler::AddGraphPassRun(const std::string &name, uint64_t cost_us, uint64_t nodes_visited, bool is_changed,
+                                   uint64_t nodes_added, uint64_t nodes_deleted) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PassProfileStat &stat = GetStat(name, false);
+  stat.run_count++;
+  stat.cost_us += cost_us;
+  stat.nodes_visited += nodes_visited;
+  stat.change_count += is_changed ? 1 : 0;
+  stat.nodes_added += nodes_added;
+  stat.nodes_deleted += nodes_deleted;
+}
+
+void PassProfiler::AddNodePassRun(const std::string &name, uint64_t cost_us, bool is_changed, uint64_t nodes_added,
+                                  uint64_t nodes_deleted, uint64_t re_pass_triggers) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PassProfileStat &stat = GetStat(name, true);
+  stat.run_count++;
+  stat.cost_us += cost_us;
+  stat.nodes_visited++;
+  stat.change_count += is_changed ? 1 : 0;
+  stat.nodes_added += nodes_added;
+  stat.nodes_deleted += nodes_deleted;
+  stat.re_pass_triggers += re_pass_triggers;
+}
+
+void PassProfiler::AddGEPassRun(uint64_t sweep_count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ge_pass_run_count_++;
+  ge_pass_sweep_count_ += sweep_count;
+}
+
+void PassProfiler::AddStageRun(const std::string &name, uint64_t cost_us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = stage_to_index_.find(name);
+  if (iter == stage_to_index_.end()) {
+    iter = stage_to_index_.emplace(name, stage_stats_.size()).first;
+    CompileStageStat stat;
+    stat.name = name;
+    stage_stats_.emplace_back(stat);
+  }
+  CompileStageStat &stat = stage_stats_[iter->second];
+  stat.run_count++;
+  stat.cost_us += cost_us;
+}
+
+std::vector<PassProfileStat> PassProfiler::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+std::vector<CompileStageStat> PassProfiler::GetStageStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stage_stats_;
+}
+
+uint64_t PassProfiler::GetGEPassRunCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return ge_pass_run_count_;
+}
+
+uint64_t PassProfiler::GetGEPassSweepCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return ge_pass_sweep_count_;
+}
+
+std::string PassProfiler::ToJson() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  nlohmann::json report;
+  report["ge_pass_run_count"] = ge_pass_run_count_;
+  report["ge_pass_sweep_count"] = ge_pass_sweep_count_;
+  report["passes"] = nlohmann::json::array();
+  for (const auto &stat : stats_) {
+    nlohmann::json pass;
+    pass["name"] = stat.name;
+    pass["type"] = stat.is_node_pass ? "node" : "graph";
+    pass["run_count"] = stat.run_count;
+    pass["cost_us"] = stat.cost_us;
+    pass["nodes_visited"] = stat.nodes_visited;
+    pass["change_count"] = stat.change_count;
+    pass["nodes_added"] = stat.nodes_added;
+    pass["nodes_deleted"] = stat.nodes_deleted;
+    pass["re_pass_triggers"] = stat.re_pass_triggers;
+    report["passes"].push_back(pass);
+  }
+  report["stages"] = nlohmann::json::array();
+  for (const auto &stat : stage_stats_) {
+    nlohmann::json stage;
+    stage["name"] = stat.name;
+    stage["run_count"] = stat.run_count;
+    stage["cost_us"] = stat.cost_us;
+    report["stages"].push_back(stage);
+  }
+  return report.dump();
+}
+
+PassProfileScope::PassProfileScope(const PassProfilerPtr &profiler)
+    : profiler_(profiler), last_profiler_(current_profiler) {
+  current_profiler = profiler.get();
+}
+
+PassProfileScope::~PassProfileScope() { current_profiler = last_profiler_; }
+}  // namespace ge
@@ -0,0 +1,135 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_PASSES_PASS_PROFILER_H_
+#define GE_GRAPH_PASSES_PASS_PROFILER_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "framework/common/debug/ge_log.h"
+
+///
+/// Ends a stage started by GE_TIMESTAMP_START like GE_TIMESTAMP_END, and adds its cost to
+/// the profiler of this thread if there is one.
+///
+#define GE_TIMESTAMP_PROFILED_END(stage, stage_name)                                                    \
+  do {                                                                                                  \
+    uint64_t costUsec_##stage = ge::GetCurrentTimestap() - startUsec_##stage;                           \
+    GEEVENT("[GEPERFTRACE] The time cost of %s is [%lu] micro second.", (stage_name), costUsec_##stage);\
+    ge::PassProfiler *profiler_##stage = ge::PassProfiler::GetCurrent();                                \
+    if (profiler_##stage != nullptr) {                                                                  \
+      profiler_##stage->AddStageRun((stage_name), costUsec_##stage);                                    \
+    }                                                                                                   \
+  } while (0)
+
+namespace ge {
+struct PassProfileStat {
+  std::string name;
+  bool is_node_pass = false;
+  // runs of a graph pass, or nodes a node pass is run on
+  uint64_t run_count = 0;
+  uint64_t cost_us = 0;
+  uint64_t nodes_visited = 0;
+  // runs which changed the graph
+  uint64_t change_count = 0;
+  uint64_t nodes_added = 0;
+  uint64_t nodes_deleted = 0;
+  // nodes a node pass asked to run the passes on again
+  uint64_t re_pass_triggers = 0;
+};
+
+// a stage of the compile, such as the partition or the build
+struct CompileStageStat {
+  std::string name;
+  uint64_t run_count = 0;
+  uint64_t cost_us = 0;
+};
+
+///
+/// Collects the time and the effect of every pass run during one compile of a graph, and the time of
+/// the compile stages. The stats of the runs with the same name are summed up, in the order they first run.
+/// PassManager and GEPass report to the profiler of the current thread, there is none unless
+/// the env GE_PASS_PROFILING is set to 1, so the passes are not slowed down by default.
+///
+class PassProfiler {
+ public:
+  ///
+  /// Create a profiler if the env GE_PASS_PROFILING is set to 1.
+  /// @return nullptr if the profiling is off
+  ///
+  static std::shared_ptr<PassProfiler> CreateIfEnabled();
+
+  // the profiler the passes run on this thread report to
+  static PassProfiler *GetCurrent();
+
+  void AddGraphPassRun(const std::string &name, uint64_t cost_us, uint64_t nodes_visited, bool is_changed,
+                       uint64_t nodes_added, uint64_t nodes_deleted);
+
+  void AddNodePassRun(const std::string &name, uint64_t cost_us, bool is_changed, uint64_t nodes_added,
+                      uint64_t nodes_deleted, uint64_t re_pass_triggers);
+
+  // a GEPass run goes over the graph once, plus once for each round of re-pass
+  void AddGEPassRun(uint64_t sweep_count);
+
+  void AddStageRun(const std::string &name, uint64_t cost_us);
+
+  std::vector<PassProfileStat> GetStats() const;
+
+  std::vector<CompileStageStat> GetStageStats() const;
+
+  uint64_t GetGEPassRunCount() const;
+
+  uint64_t GetGEPassSweepCount() const;
+
+  std::string ToJson() const;
+
+ private:
+  PassProfileStat &GetStat(const std::string &name, bool is_node_pass);
+
+  mutable std::mutex mutex_;
+  std::vector<PassProfileStat> stats_;
+  std::map<std::string, size_t> name_to_index_;
+  std::vector<CompileStageStat> stage_stats_;
+  std::map<std::string, size_t> stage_to_index_;
+  uint64_t ge_pass_run_count_ = 0;
+  uint64_t ge_pass_sweep_count_ = 0;
+};
+
+using PassProfilerPtr = std::shared_ptr<PassProfiler>;
+
+///
+/// Makes a profiler current on this thread for the lifetime of the scope, nullptr leaves the profiling off.
+///
+class PassProfileScope {
+ public:
+  explicit PassProfileScope(const PassProfilerPtr &profiler);
+  ~PassProfileScope();
+
+  PassProfileScope(const PassProfileScope &) = delete;
+  PassProfileScope &operator=(const PassProfileScope &) = delete;
+
+ private:
+  PassProfilerPtr profiler_;
+  PassProfiler *last_profiler_;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_PASSES_PASS_PROFILER_H_
@@ -0,0 +1,532 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/passes/transop_chain_canonicalize_pass.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_set>
+
+#include "common/formats/format_transfers/format_transfer.h"
+#include "common/ge_inner_error_codes.h"
+#include "common/types.h"
+#include "framework/common/debug/ge_log.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/type_utils.h"
+
+namespace ge {
+namespace {
+const char *const kAttrNameSrcFormat = "src_format";
+const char *const kAttrNameDstFormat = "dst_format";
+const char *const kAttrNamePerm = "perm";
+const size_t kMinChainSize = 2;
+const int kInvalidAxis = -1;
+
+// the logical axes of the 4D formats are N, C, H, W, in this order
+const std::string kLogicalAxes = "NCHW";
+const std::map<Format, std::string> kPlainFormatAxes = {
+    {FORMAT_NCHW, "NCHW"}, {FORMAT_NHWC, "NHWC"}, {FORMAT_HWCN, "HWCN"}, {FORMAT_CHWN, "CHWN"}};
+
+// the casts keeping every value of the source type
+const std::map<DataType, std::set<DataType>> kLosslessCasts = {
+    {DT_BOOL,
+     {DT_INT8, DT_UINT8, DT_INT16, DT_UINT16, DT_INT32, DT_UINT32, DT_INT64, DT_UINT64, DT_FLOAT16, DT_FLOAT,
+      DT_DOUBLE}},
+    {DT_INT8, {DT_INT16, DT_INT32, DT_INT64, DT_FLOAT16, DT_FLOAT, DT_DOUBLE}},
+    {DT_UINT8, {DT_INT16, DT_UINT16, DT_INT32, DT_UINT32, DT_INT64, DT_UINT64, DT_FLOAT16, DT_FLOAT, DT_DOUBLE}},
+    {DT_INT16, {DT_INT32, DT_INT64, DT_FLOAT, DT_DOUBLE}},
+    {DT_UINT16, {DT_INT32, DT_UINT32, DT_INT64, DT_UINT64, DT_FLOAT, DT_DOUBLE}},
+    {DT_INT32, {DT_INT64, DT_DOUBLE}},
+    {DT_UINT32, {DT_INT64, DT_UINT64, DT_DOUBLE}},
+    {DT_FLOAT16, {DT_FLOAT, DT_DOUBLE}},
+    {DT_FLOAT, {DT_DOUBLE}}};
+
+const std::set<DataType> kFloatDataTypes = {DT_FLOAT16, DT_FLOAT, DT_DOUBLE};
+
+enum FormatFamily { kFamilyNone, kFamily4D, kFamilyND };
+
+FormatFamily GetFormatFamily(Format format) {
+  if (format == FORMAT_ND || format == FORMAT_FRACTAL_NZ) {
+    return kFamilyND;
+  }
+  if (kPlainFormatAxes.count(format) > 0 || format == FORMAT_NC1HWC0 || format == FORMAT_FRACTAL_Z) {
+    return kFamily4D;
+  }
+  return kFamilyNone;
+}
+
+// the formats whose dims are the logical axes, the others pack the axes into blocks
+bool IsPlainFormat(Format format) { return format == FORMAT_ND || kPlainFormatAxes.count(format) > 0; }
+
+// the logical axis of each dim of a plain desc, empty if the desc is not plain
+std::vector<int> GetDimAxes(Format format, size_t rank) {
+  std::vector<int> axes;
+  if (format == FORMAT_ND) {
+    for (size_t i = 0; i < rank; ++i) {
+      axes.emplace_back(static_cast<int>(i));
+    }
+    return axes;
+  }
+  auto iter = kPlainFormatAxes.find(format);
+  if (iter == kPlainFormatAxes.end() || iter->second.size() != rank) {
+    return axes;
+  }
+  for (char axis_name : iter->second) {
+    axes.emplace_back(static_cast<int>(kLogicalAxes.find(axis_name)));
+  }
+  return axes;
+}
+
+bool GetPerm(const OpDescPtr &op_desc, std::vector<int64_t> &perm) {
+  return AttrUtils::GetListInt(op_desc, PERMUTE_ATTR_ORDER, perm) ||
+         AttrUtils::GetListInt(op_desc, kAttrNamePerm, perm);
+}
+
+bool IsLosslessCast(DataType src_data_type, DataType dst_data_type) {
+  auto iter = kLosslessCasts.find(src_data_type);
+  return iter != kLosslessCasts.end() && iter->second.count(dst_data_type) > 0;
+}
+
+///
+/// A value of src_data_type held exactly in another type casts to dst_data_type the same as from src_data_type when
+/// the cast keeps the value or rounds it to a float type. Otherwise the cast may saturate from one type and wrap or
+/// truncate from the other, such as int16 -> float -> int8 against int16 -> int8.
+///
+bool IsSameCastResult(DataType src_data_type, DataType dst_data_type) {
+  return (src_data_type == dst_data_type) || (kFloatDataTypes.count(dst_data_type) > 0) ||
+         IsLosslessCast(src_data_type, dst_data_type);
+}
+
+bool IsSameDims(const GeTensorDesc &desc1, const GeTensorDesc &desc2) {
+  return desc1.GetShape().GetDims() == desc2.GetShape().GetDims();
+}
+
+///
+/// The layout of the tensor along a chain. Each logical axis of the tensor is tracked back to the axis of the chain
+/// input it holds: TransData moves the data but keeps the axes, Transpose permutes them.
+///
+class LayoutState {
+ public:
+  bool Init(const GeTensorDesc &input_desc) {
+    format_ = input_desc.GetFormat();
+    family_ = GetFormatFamily(format_);
+    if (family_ == kFamilyNone) {
+      return false;
+    }
+    return !IsPlainFormat(format_) || CheckPlainDesc(input_desc);
+  }
+
+  bool TransData(const GeTensorDesc &input_desc, const GeTensorDesc &output_desc) {
+    if ((input_desc.GetDataType() != output_desc.GetDataType()) ||
+        (GetFormatFamily(output_desc.GetFormat()) != family_)) {
+      return false;
+    }
+    format_ = output_desc.GetFormat();
+    return !IsPlainFormat(format_) || CheckPlainDesc(output_desc);
+  }
+
+  bool Transpose(const GeTensorDesc &input_desc, const GeTensorDesc &output_desc, const std::vector<int64_t> &perm) {
+    if ((input_desc.GetDataType() != output_desc.GetDataType()) ||
+        (GetFormatFamily(output_desc.GetFormat()) != family_) || axes_.empty()) {
+      return false;
+    }
+    auto input_axes = GetDimAxes(input_desc.GetFormat(), input_desc.GetShape().GetDimNum());
+    auto output_axes = GetDimAxes(output_desc.GetFormat(), output_desc.GetShape().GetDimNum());
+    size_t rank = axes_.size();
+    if ((input_axes.size() != rank) || (output_axes.size() != rank) || (perm.size() != rank)) {
+      return false;
+    }
+    std::vector<int> axes(rank, kInvalidAxis);
+    std::vector<bool> permuted(rank, false);
+    for (size_t i = 0; i < rank; ++i) {
+      if ((perm[i] < 0) || (perm[i] >= static_cast<int64_t>(rank)) || permuted[perm[i]]) {
+        return false;
+      }
+      permuted[perm[i]] = true;
+      // the dim i of the output is the dim perm[i] of the input
+      axes[output_axes[i]] = axes_[input_axes[perm[i]]];
+    }
+    axes_ = axes;
+    format_ = output_desc.GetFormat();
+    return CheckPlainDesc(output_desc);
+  }
+
+  bool IsIdentity() const {
+    for (size_t i = 0; i < axes_.size(); ++i) {
+      if (axes_[i] != static_cast<int>(i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // the perm of one transpose from the chain input to the chain output
+  bool GetPerm(const GeTensorDesc &input_desc, const GeTensorDesc &output_desc, std::vector<int64_t> &perm) const {
+    auto input_axes = GetDimAxes(input_desc.GetFormat(), input_desc.GetShape().GetDimNum());
+    auto output_axes = GetDimAxes(output_desc.GetFormat(), output_desc.GetShape().GetDimNum());
+    if (axes_.empty() || (input_axes.size() != axes_.size()) || (output_axes.size() != axes_.size())) {
+      return false;
+    }
+    perm.clear();
+    for (int output_axis : output_axes) {
+      auto iter = std::find(input_axes.begin(), input_axes.end(), axes_[output_axis]);
+      perm.emplace_back(static_cast<int64_t>(iter - input_axes.begin()));
+    }
+    return true;
+  }
+
+ private:
+  bool CheckPlainDesc(const GeTensorDesc &desc) {
+    auto dims = desc.GetShape().GetDims();
+    auto dim_axes = GetDimAxes(desc.GetFormat(), dims.size());
+    if (dim_axes.empty()) {
+      return false;
+    }
+    if (input_dims_.empty()) {
+      // the first plain desc of the chain, no transpose is before it, so that the axes are the input's
+      input_dims_.resize(dim_axes.size());
+      axes_.clear();
+      for (size_t i = 0; i < dim_axes.size(); ++i) {
+        input_dims_[dim_axes[i]] = dims[i];
+        axes_.emplace_back(static_cast<int>(i));
+      }
+      return true;
+    }
+    if (dim_axes.size() != axes_.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < dims.size(); ++i) {
+      if (dims[i] != input_dims_[axes_[dim_axes[i]]]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  Format format_ = FORMAT_RESERVED;
+  FormatFamily family_ = kFamilyNone;
+  // axes_[i] is the logical axis of the chain input which the logical axis i of the tensor holds
+  std::vector<int> axes_;
+  // dims of the chain input by logical axis, empty until a plain desc is met
+  std::vector<int64_t> input_dims_;
+};
+
+bool HasSingleConsumer(const NodePtr &node) {
+  auto out_anchor = node->GetOutDataAnchor(0);
+  return (out_anchor != nullptr) && (out_anchor->GetPeerInDataAnchors().size() == 1);
+}
+
+Status UpdateTransOp(const NodePtr &node, const GeTensorDesc &input_desc, const GeTensorDesc &output_desc,
+                     const std::vector<int64_t> &perm) {
+  auto op_desc = node->GetOpDesc();
+  if ((op_desc->UpdateInputDesc(0, input_desc) != GRAPH_SUCCESS) ||
+      (op_desc->UpdateOutputDesc(0, output_desc) != GRAPH_SUCCESS)) {
+    GELOGE(FAILED, "Failed to update the descs of node %s", node->GetName().c_str());
+    return FAILED;
+  }
+  bool ret = true;
+  if (node->GetType() == CAST) {
+    if (op_desc->HasAttr(CAST_ATTR_SRCT)) {
+      ret = ret && AttrUtils::SetInt(op_desc, CAST_ATTR_SRCT, static_cast<int64_t>(input_desc.GetDataType()));
+    }
+    if (op_desc->HasAttr(CAST_ATTR_DSTT)) {
+      ret = ret && AttrUtils::SetInt(op_desc, CAST_ATTR_DSTT, static_cast<int64_t>(output_desc.GetDataType()));
+    }
+    if (op_desc->HasAttr(CAST_ATTR_DST_TYPE)) {
+      ret = ret && AttrUtils::SetInt(op_desc, CAST_ATTR_DST_TYPE, static_cast<int64_t>(output_desc.GetDataType()));
+    }
+  } else if (node->GetType() == TRANSDATA) {
+    if (op_desc->HasAttr(ATTR_NAME_INPUT_FORMAT)) {
+      ret = ret && AttrUtils::SetInt(op_desc, ATTR_NAME_INPUT_FORMAT, static_cast<int64_t>(input_desc.GetFormat()));
+    }
+    if (op_desc->HasAttr(ATTR_NAME_OUTPUT_FORMAT)) {
+      ret = ret && AttrUtils::SetInt(op_desc, ATTR_NAME_OUTPUT_FORMAT, static_cast<int64_t>(output_desc.GetFormat()));
+    }
+    if (op_desc->HasAttr(kAttrNameSrcFormat)) {
+      ret = ret &&
+            AttrUtils::SetStr(op_desc, kAttrNameSrcFormat, TypeUtils::FormatToSerialString(input_desc.GetFormat()));
+    }
+    if (op_desc->HasAttr(kAttrNameDstFormat)) {
+      ret = ret &&
+            AttrUtils::SetStr(op_desc, kAttrNameDstFormat, TypeUtils::FormatToSerialString(output_desc.GetFormat()));
+    }
+  } else {
+    const std::string &perm_attr = op_desc->HasAttr(PERMUTE_ATTR_ORDER) ? PERMUTE_ATTR_ORDER : kAttrNamePerm;
+    ret = AttrUtils::SetListInt(op_desc, perm_attr, perm);
+  }
+  if (!ret) {
+    GELOGE(FAILED, "Failed to update the attrs of node %s", node->GetName().c_str());
+    return FAILED;
+  }
+  return SUCCESS;
+}
+}  // namespace
+
+Status TransOpChainCanonicalizePass::Run(ComputeGraphPtr graph) {
+  GE_CHECK_NOTNULL(graph);
+  std::vector<std::vector<NodePtr>> chains;
+  for (const auto &node : graph->GetDirectNode()) {
+    if (!IsChainHead(node)) {
+      continue;
+    }
+    auto chain = GetChain(node);
+    if (chain.size() >= kMinChainSize) {
+      chains.emplace_back(std::move(chain));
+    }
+  }
+
+  size_t removed_num = 0;
+  for (const auto &chain : chains) {
+    ChainPlan plan;
+    if (!GetChainPlan(chain, plan)) {
+      continue;
+    }
+    Status ret = RebuildChain(graph, chain, plan);
+    if (ret != SUCCESS) {
+      GELOGE(ret, "Failed to rebuild the trans op chain from node %s", chain.front()->GetName().c_str());
+      return ret;
+    }
+    size_t op_num = plan.data_types.size() - 1 + ((plan.layout_op == kLayoutNone) ? 0 : 1);
+    GELOGD("The trans op chain of %zu ops from node %s is simplified to %zu ops", chain.size(),
+           chain.front()->GetName().c_str(), op_num);
+    removed_num += chain.size() - op_num;
+  }
+  GELOGI("TransOpChainCanonicalizePass removed %zu trans ops from %zu chains", removed_num, chains.size());
+  return SUCCESS;
+}
+
+bool TransOpChainCanonicalizePass::IsChainOp(const NodePtr &node) {
+  if ((node == nullptr) || (node->GetOpDesc() == nullptr)) {
+    return false;
+  }
+  const auto &type = node->GetType();
+  if ((type != CAST) && (type != TRANSDATA) && (type != TRANSPOSE) && (type != TRANSPOSED)) {
+    return false;
+  }
+  auto op_desc = node->GetOpDesc();
+  auto in_anchor = node->GetInDataAnchor(0);
+  auto out_anchor = node->GetOutDataAnchor(0);
+  if ((node->GetInDataNodes().size() != 1) || (in_anchor == nullptr) || (in_anchor->GetPeerOutAnchor() == nullptr) ||
+      (out_anchor == nullptr) || (op_desc->GetOutputsSize() != 1)) {
+    return false;
+  }
+  // the control edges order the ops against the others, such ops are kept as they are
+  if (!node->GetInControlNodes().empty() || !node->GetOutControlNodes().empty() ||
+      !out_anchor->GetPeerInControlAnchors().empty()) {
+    return false;
+  }
+  std::vector<int64_t> perm;
+  return (type == CAST) || (type == TRANSDATA) || GetPerm(op_desc, perm);
+}
+
+bool TransOpChainCanonicalizePass::IsChainHead(const NodePtr &node) {
+  if (!IsChainOp(node)) {
+    return false;
+  }
+  auto src_node = node->GetInDataAnchor(0)->GetPeerOutAnchor()->GetOwnerNode();
+  return !IsChainOp(src_node) || !HasSingleConsumer(src_node);
+}
+
+std::vector<NodePtr> TransOpChainCanonicalizePass::GetChain(const NodePtr &head) {
+  std::vector<NodePtr> chain = {head};
+  NodePtr node = head;
+  while (HasSingleConsumer(node)) {
+    auto next_node = node->GetOutDataAnchor(0)->GetPeerInDataAnchors().at(0)->GetOwnerNode();
+    if (!IsChainOp(next_node)) {
+      break;
+    }
+    chain.emplace_back(next_node);
+    node = next_node;
+  }
+  return chain;
+}
+
+std::vector<DataType> TransOpChainCanonicalizePass::MinimizeCasts(const std::vector<DataType> &data_types) {
+  std::vector<DataType> result;
+  for (auto data_type : data_types) {
+    // the middle type is dropped when it holds the value exactly and the next cast gives the same from both sides
+    while ((result.size() > 1) && IsLosslessCast(result[result.size() - 2], result.back()) &&
+           IsSameCastResult(result[result.size() - 2], data_type)) {
+      result.pop_back();
+    }
+    if (result.empty() || (result.back() != data_type)) {
+      result.emplace_back(data_type);
+    }
+  }
+  return result;
+}
+
+bool TransOpChainCanonicalizePass::GetChainPlan(const std::vector<NodePtr> &chain, ChainPlan &plan) {
+  GeTensorDesc input_desc = chain.front()->GetOpDesc()->GetInputDesc(0);
+  LayoutState layout;
+  if (!layout.Init(input_desc)) {
+    GELOGD("The format %s of the chain from node %s is not supported",
+           TypeUtils::FormatToSerialString(input_desc.GetFormat()).c_str(), chain.front()->GetName().c_str());
+    return false;
+  }
+  std::vector<DataType> data_types = {input_desc.GetDataType()};
+  bool has_trans_data = false;
+  bool has_transpose = false;
+  GeTensorDesc output_desc = input_desc;
+  for (const auto &node : chain) {
+    auto op_desc = node->GetOpDesc();
+    GeTensorDesc node_input_desc = op_desc->GetInputDesc(0);
+    GeTensorDesc node_output_desc = op_desc->GetOutputDesc(0);
+    if ((node_input_desc.GetFormat() != output_desc.GetFormat()) ||
+        (node_input_desc.GetDataType() != output_desc.GetDataType()) || !IsSameDims(node_input_desc, output_desc)) {
+      GELOGD("The input desc of node %s does not match its peer", node->GetName().c_str());
+      return false;
+    }
+    bool composed = false;
+    if (node->GetType() == CAST) {
+      composed = (node_input_desc.GetFormat() == node_output_desc.GetFormat()) &&
+                 IsSameDims(node_input_desc, node_output_desc);
+      data_types.emplace_back(node_output_desc.GetDataType());
+    } else if (node->GetType() == TRANSDATA) {
+      composed = layout.TransData(node_input_desc, node_output_desc);
+      has_trans_data = true;
+    } else {
+      std::vector<int64_t> perm;
+      composed = GetPerm(op_desc, perm) && layout.Transpose(node_input_desc, node_output_desc, perm);
+      has_transpose = true;
+    }
+    if (!composed) {
+      GELOGD("The node %s, type %s could not be composed into the chain", node->GetName().c_str(),
+             node->GetType().c_str());
+      return false;
+    }
+    output_desc = node_output_desc;
+  }
+
+  Format input_format = input_desc.GetFormat();
+  Format output_format = output_desc.GetFormat();
+  formats::TransArgs trans_args = {nullptr, input_format, output_format, {}, {}, input_desc.GetDataType()};
+  if (layout.IsIdentity() && (input_format == output_format)) {
+    if (!IsSameDims(input_desc, output_desc)) {
+      return false;
+    }
+    plan.layout_op = kLayoutNone;
+  } else if (has_transpose && layout.GetPerm(input_desc, output_desc, plan.perm)) {
+    // both ends are plain, a transpose between them is kept as one
+    plan.layout_op = kLayoutTranspose;
+  } else if (layout.IsIdentity() && has_trans_data && formats::FormatTransferExists(trans_args)) {
+    plan.layout_op = kLayoutTransData;
+  } else {
+    return false;
+  }
+
+  plan.data_types = MinimizeCasts(data_types);
+  size_t cast_num = plan.data_types.size() - 1;
+  if (plan.layout_op != kLayoutNone) {
+    // the packed shapes depend on the data type, so that a packed end is transferred in its own data type,
+    // otherwise the layout op moves the least bytes between the casts
+    if (!IsPlainFormat(input_format) && !IsPlainFormat(output_format) &&
+        (input_desc.GetDataType() != output_desc.GetDataType())) {
+      return false;
+    } else if (!IsPlainFormat(input_format)) {
+      plan.layout_pos = 0;
+    } else if (!IsPlainFormat(output_format)) {
+      plan.layout_pos = cast_num;
+    } else {
+      for (size_t i = 1; i <= cast_num; ++i) {
+        if (GetSizeByDataType(plan.data_types[i]) < GetSizeByDataType(plan.data_types[plan.layout_pos])) {
+          plan.layout_pos = i;
+        }
+      }
+    }
+  }
+  size_t op_num = cast_num + ((plan.layout_op == kLayoutNone) ? 0 : 1);
+  return op_num < chain.size();
+}
+
+Status TransOpChainCanonicalizePass::RebuildChain(const ComputeGraphPtr &graph, const std::vector<NodePtr> &chain,
+                                                  const ChainPlan &plan) {
+  OutDataAnchorPtr out_anchor = chain.front()->GetInDataAnchor(0)->GetPeerOutAnchor();
+  GE_CHECK_NOTNULL(out_anchor);
+  std::vector<InDataAnchorPtr> dst_anchors;
+  for (const auto &peer_in_anchor : chain.back()->GetOutDataAnchor(0)->GetPeerInDataAnchors()) {
+    dst_anchors.emplace_back(peer_in_anchor);
+  }
+  GeTensorDesc desc = chain.front()->GetOpDesc()->GetInputDesc(0);
+  GeTensorDesc output_desc = chain.back()->GetOpDesc()->GetOutputDesc(0);
+
+  std::deque<NodePtr> casts;
+  std::deque<NodePtr> layout_ops;
+  for (const auto &node : chain) {
+    node->GetInDataAnchor(0)->UnlinkAll();
+    node->GetOutDataAnchor(0)->UnlinkAll();
+    if (node->GetType() == CAST) {
+      casts.emplace_back(node);
+    } else if ((node->GetType() == TRANSDATA) == (plan.layout_op == kLayoutTransData)) {
+      layout_ops.emplace_back(node);
+    }
+  }
+
+  // the new chain is made of the first nodes of each type
+  std::unordered_set<Node *> kept_nodes;
+  auto append_node = [&](const NodePtr &node, const GeTensorDesc &node_output_desc) -> Status {
+    GE_CHK_STATUS_RET(UpdateTransOp(node, desc, node_output_desc, plan.perm), "Update trans op failed");
+    if (GraphUtils::AddEdge(out_anchor, node->GetInDataAnchor(0)) != GRAPH_SUCCESS) {
+      GELOGE(FAILED, "Failed to link node %s", node->GetName().c_str());
+      return FAILED;
+    }
+    kept_nodes.insert(node.get());
+    out_anchor = node->GetOutDataAnchor(0);
+    desc = node_output_desc;
+    return SUCCESS;
+  };
+  size_t cast_num = plan.data_types.size() - 1;
+  for (size_t i = 0; i <= cast_num; ++i) {
+    if ((plan.layout_op != kLayoutNone) && (i == plan.layout_pos)) {
+      if (layout_ops.empty()) {
+        GELOGE(FAILED, "No layout op in the chain from node %s", chain.front()->GetName().c_str());
+        return FAILED;
+      }
+      GeTensorDesc layout_output_desc = output_desc;
+      layout_output_desc.SetDataType(desc.GetDataType());
+      GE_CHK_STATUS_RET(append_node(layout_ops.front(), layout_output_desc), "Append the layout op failed");
+    }
+    if (i < cast_num) {
+      GeTensorDesc cast_output_desc = desc;
+      cast_output_desc.SetDataType(plan.data_types[i + 1]);
+      GE_CHK_STATUS_RET(append_node(casts[i], cast_output_desc), "Append the cast failed");
+    }
+  }
+  for (const auto &dst_anchor : dst_anchors) {
+    if (GraphUtils::AddEdge(out_anchor, dst_anchor) != GRAPH_SUCCESS) {
+      GELOGE(FAILED, "Failed to link the chain to node %s", dst_anchor->GetOwnerNode()->GetName().c_str());
+      return FAILED;
+    }
+  }
+
+  for (const auto &node : chain) {
+    if (kept_nodes.count(node.get()) > 0) {
+      continue;
+    }
+    GELOGI("Remove trans op %s, type %s from the chain", node->GetName().c_str(), node->GetType().c_str());
+    if (GraphUtils::RemoveNodeWithoutRelink(graph, node) != GRAPH_SUCCESS) {
+      GELOGE(FAILED, "Failed to remove node %s", node->GetName().c_str());
+      return FAILED;
+    }
+  }
+  return SUCCESS;
+}
+}  // namespace ge
@@ -0,0 +1,60 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_PASSES_TRANSOP_CHAIN_CANONICALIZE_PASS_H_
+#define GE_GRAPH_PASSES_TRANSOP_CHAIN_CANONICALIZE_PASS_H_
+
+#include <vector>
+
+#include "inc/graph_pass.h"
+
+namespace ge {
+///
+/// Simplifies linear chains of Cast, TransData and Transpose ops. The layout ops of a chain are composed into
+/// one state of format and axes permutation, and its casts into the shortest sequence rounding the values the
+/// same way. The chain is rebuilt from its own nodes with at most one layout op, or removed if it does nothing.
+///
+class TransOpChainCanonicalizePass : public GraphPass {
+ public:
+  Status Run(ComputeGraphPtr graph) override;
+
+ private:
+  enum LayoutOpType { kLayoutNone, kLayoutTransData, kLayoutTranspose };
+
+  struct ChainPlan {
+    std::vector<DataType> data_types;  // the data type after each cast, the first one is the input's
+    LayoutOpType layout_op = kLayoutNone;
+    std::vector<int64_t> perm;         // perm of the transpose, from the chain input to the chain output
+    size_t layout_pos = 0;             // the layout op runs after this number of casts
+  };
+
+  static bool IsChainOp(const NodePtr &node);
+  static bool IsChainHead(const NodePtr &node);
+  static std::vector<NodePtr> GetChain(const NodePtr &head);
+  static bool GetChainPlan(const std::vector<NodePtr> &chain, ChainPlan &plan);
+
+  ///
+  /// Drop the casts which have no effect. A cast keeping every value of its input can be left out, as the
+  /// next cast gets the same values from the type before it, while a lossy cast rounds and must stay.
+  /// @param data_types: the input type followed by the output type of each cast
+  /// @return the input type followed by the output type of each cast still needed
+  ///
+  static std::vector<DataType> MinimizeCasts(const std::vector<DataType> &data_types);
+
+  static Status RebuildChain(const ComputeGraphPtr &graph, const std::vector<NodePtr> &chain, const ChainPlan &plan);
+};
+}  // namespace ge
+#endif  // GE_GRAPH_PASSES_TRANSOP_CHAIN_CANONICALIZE_PASS_H_
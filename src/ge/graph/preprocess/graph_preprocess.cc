@@ -37,6 +37,7 @@
 #include "graph/passes/aicpu_constant_folding_pass.h"
 #include "graph/passes/assert_pass.h"
 #include "graph/passes/base_pass.h"
+#include "graph/passes/common_subexpression_elimination_pass.h"
 #include "graph/passes/constant_folding_pass.h"
 #include "graph/passes/constant_fuse_same_pass.h"
 #include "graph/passes/control_trigger_pass.h"
@@ -1286,7 +1287,7 @@ Status GraphPrepare::OptimizeForPreprocess() {
   PassManager original_graph_passes;
   // Graph pass
   try {
-    (void)original_graph_passes.AddPass(new ConstantFuseSamePass);
+    (void)original_graph_passes.AddPass(new ConstantFuseSamePass(true));
     (void)original_graph_passes.AddPass(new VariablePrepareOpPass);
     (void)original_graph_passes.AddPass(new IteratorOpPass);
     (void)original_graph_passes.AddPass(new ShapeOperateOpRemovePass);
@@ -1345,6 +1346,8 @@ Status GraphPrepare::OptimizeForPreprocess() {
   names_to_passes.emplace_back("SwitchLogicRemovePass", &switch_logic_remove_pass);
   MergePass merge_pass;
   names_to_passes.emplace_back("MergePass", &merge_pass);
+  CommonSubexpressionEliminationPass cse_pass;
+  names_to_passes.emplace_back("CommonSubexpressionEliminationPass", &cse_pass);
   GE_TIMESTAMP_START(names_to_passes);
   ret = ge_passes.Run(names_to_passes);
   GE_TIMESTAMP_END(names_to_passes, "GraphPrepare::NamesToPasses");
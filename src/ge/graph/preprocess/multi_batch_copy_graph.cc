@@ -16,12 +16,16 @@
 
 #include "graph/preprocess/multi_batch_copy_graph.h"
 
+#include <functional>
+#include <future>
 #include <queue>
 #include <set>
 #include <string>
 
 #include "common/formats/utils/formats_trans_utils.h"
 #include "common/ge/ge_util.h"
+#include "common/thread_pool.h"
+#include "external/ge/ge_api_types.h"
 #include "framework/common/debug/ge_log.h"
 #include "framework/common/ge_inner_error_codes.h"
 #include "framework/common/string_util.h"
@@ -43,11 +47,44 @@ const int kDataInIndex = 0;
 const int kMergeDataOutIndex = 0;
 const size_t kMaxShapesCount = 16;
 const size_t kMinShapesCount = 2;
+const size_t kMaxCopyThreadsNum = 16;
 
 inline bool IsDataLikeType(const std::string &node_type) {
   return (node_type == DATA) || (node_type == AIPP);
 }
 
+inline bool IsWeightType(const std::string &node_type) {
+  return (node_type == CONSTANT) || (node_type == CONSTANTOP) || (node_type == VARIABLE);
+}
+
+inline bool IsInScope(bool in_branch, EdgeScope scope) {
+  return (scope == kAllEdges) || ((scope == kBranchEdges) == in_branch);
+}
+
+// shared by all copyers, the threads are started once for the process
+ThreadPool &GetCopyThreadPool() {
+  static ThreadPool thread_pool(static_cast<uint32_t>(kMaxCopyThreadsNum));
+  return thread_pool;
+}
+
+// run the func for each batch on the copy thread pool, and wait for all of them
+Status RunForEachBatch(size_t batch_count, const std::function<Status(size_t)> &func) {
+  auto &thread_pool = GetCopyThreadPool();
+  std::vector<std::future<Status>> vector_future;
+  for (size_t batch_num = 0; batch_num < batch_count; ++batch_num) {
+    vector_future.emplace_back(thread_pool.commit([&func, batch_num]() -> Status { return func(batch_num); }));
+  }
+  Status ret = SUCCESS;
+  for (size_t i = 0; i < vector_future.size(); ++i) {
+    Status ret_status = vector_future[i].get();
+    if (ret_status != SUCCESS) {
+      GELOGE(ret_status, "Failed to process batch %zu", i);
+      ret = ret_status;
+    }
+  }
+  return ret;
+}
+
 NodePtr InsertMergeNodeToGraph(const std::string &name, size_t input_num, const ComputeGraphPtr &graph) {
   OpDescPtr desc = MakeShared<OpDesc>();
   if (desc == nullptr) {
@@ -86,7 +123,7 @@ NodePtr InsertMergeNodeToGraph(const std::string &name, size_t input_num, const
   return graph->AddNode(desc);
 }
 
-NodePtr InsertCopyNode(const NodePtr &node, const std::string &name) {
+OpDescPtr CreateCopyOpDesc(const NodePtr &node, const std::string &name) {
   auto src_op_desc = node->GetOpDesc();
   if (src_op_desc == nullptr) {
     GELOGE(INTERNAL_ERROR, "Failed to copy node %s to %s, the OpDesc is null", node->GetName().c_str(), name.c_str());
@@ -118,8 +155,7 @@ NodePtr InsertCopyNode(const NodePtr &node, const std::string &name) {
     }
     output_desc->CopyAttrsFrom(src_op_desc->GetOutputDesc(i));
   }
-  auto graph = node->GetOwnerComputeGraph();
-  return graph->AddNode(desc);
+  return desc;
 }
 
 Status CalcShape(const std::vector<int64_t> &batch_shape, GeShape &data_shape) {
@@ -260,10 +296,19 @@ Status MultiBatchGraphCopyer::CreateNewNodes() {
     return INTERNAL_ERROR;
   }
 
-  for (const auto &node : origin_all_nodes_) {
-    auto node_type = node->GetType();
+  std::vector<NodeStatus> nodes_status;
+  GetNodesStatus(nodes_status);
+  if (parallel_copy_) {
+    auto ret = StageBatchBranchNodes(nodes_status);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+  }
+
+  for (size_t i = 0; i < origin_all_nodes_.size(); ++i) {
+    const auto &node = origin_all_nodes_[i];
     Status ret = INTERNAL_ERROR;
-    auto branch_status = GetNodeStatus(node);
+    auto branch_status = nodes_status[i];
     GELOGD("Process node %s, status %d", node->GetName().c_str(), static_cast<int>(branch_status));
     switch (branch_status) {
       case kNodeStartNode:
@@ -288,22 +333,76 @@ Status MultiBatchGraphCopyer::CreateNewNodes() {
       return ret;
     }
   }
+  staged_nodes_.clear();
+  staged_indexes_.clear();
   return SUCCESS;
 }
-NodeStatus MultiBatchGraphCopyer::GetNodeStatus(const NodePtr &node) {
+void MultiBatchGraphCopyer::GetNodesStatus(std::vector<NodeStatus> &nodes_status) {
+  // the data nodes with SwitchN and the nodes copyed, known before any node is created
+  std::set<Node *> branch_nodes;
+  for (const auto &node : origin_all_nodes_) {
+    auto branch_status = GetNodeStatus(node, branch_nodes);
+    if ((branch_status == kNodeInBatchBranch) ||
+        ((branch_status == kNodeStartNode) &&
+         !IsAllDimsPositive(NodeUtils::GetOutputDesc(*node, kDataOutIndex).GetShape().GetDims()))) {
+      branch_nodes.insert(node.get());
+    }
+    nodes_status.emplace_back(branch_status);
+  }
+}
+NodeStatus MultiBatchGraphCopyer::GetNodeStatus(const NodePtr &node, const std::set<Node *> &branch_nodes) {
   if (node->GetType() == NETOUTPUT) {
     return kNodeOutBatchBranch;
   }
   if (IsDataLikeType(node->GetType()) && !IsOnlyOutputToAipp(node)) {
     return kNodeStartNode;
   }
+  if (share_weights_ && IsWeightType(node->GetType())) {
+    return kNodeOutBatchBranch;
+  }
   for (auto &in_node : node->GetInDataNodes()) {
-    if (IsInBatchBranch(in_node)) {
+    if (branch_nodes.count(in_node.get()) > 0) {
       return kNodeInBatchBranch;
     }
   }
   return kNodeOutBatchBranch;
 }
+Status MultiBatchGraphCopyer::StageBatchBranchNodes(const std::vector<NodeStatus> &nodes_status) {
+  std::vector<NodePtr> branch_nodes;
+  for (size_t i = 0; i < origin_all_nodes_.size(); ++i) {
+    if (nodes_status[i] == kNodeInBatchBranch) {
+      staged_indexes_[origin_all_nodes_[i].get()] = branch_nodes.size();
+      branch_nodes.emplace_back(origin_all_nodes_[i]);
+    }
+  }
+  if (branch_nodes.empty()) {
+    return SUCCESS;
+  }
+
+  // each batch copies its own nodes into a graph of its own, the origin nodes are only read
+  staged_nodes_.assign(shapes_.size(), std::vector<NodePtr>(branch_nodes.size()));
+  return RunForEachBatch(shapes_.size(), [this, &branch_nodes](size_t batch_num) -> Status {
+    auto batch_graph_name = graph_->GetName() + "_huawei_mbatch_batch_" + std::to_string(batch_num);
+    auto batch_graph = MakeShared<ComputeGraph>(batch_graph_name);
+    if (batch_graph == nullptr) {
+      GELOGE(OUT_OF_MEMORY, "Failed to create the graph for batch %zu", batch_num);
+      return OUT_OF_MEMORY;
+    }
+    auto &nodes = staged_nodes_[batch_num];
+    for (size_t i = 0; i < branch_nodes.size(); ++i) {
+      auto desc = CopyOpDescInBatchBranch(branch_nodes[i], batch_num);
+      nodes[i] = (desc == nullptr) ? nullptr : batch_graph->AddNode(desc);
+      if (nodes[i] == nullptr) {
+        GELOGE(INTERNAL_ERROR, "Failed to copy node %s for batch %zu", branch_nodes[i]->GetName().c_str(), batch_num);
+        return INTERNAL_ERROR;
+      }
+    }
+    return SUCCESS;
+  });
+}
+OpDescPtr MultiBatchGraphCopyer::CopyOpDescInBatchBranch(const NodePtr &node, size_t batch_num) {
+  return CreateCopyOpDesc(node, node->GetName() + "_huawei_mbatch_batch_" + std::to_string(batch_num));
+}
 NodePtr MultiBatchGraphCopyer::InsertMergeNode(const NodePtr &node, int index) {
   if (index < 0) {
     // the merge node must has data inputs, if origin connection is a control
@@ -334,7 +433,8 @@ NodePtr MultiBatchGraphCopyer::InsertMergeNode(const NodePtr &node, int index) {
   GELOGI("Create merge node %s for node %s index %d", merge_node_name.c_str(), node->GetName().c_str(), index);
   return merge_node;
 }
-Status MultiBatchGraphCopyer::CopyInDataEdges(const NodePtr &origin_node, int batch_num, const NodePtr &copyed_node) {
+Status MultiBatchGraphCopyer::CopyInDataEdges(const NodePtr &origin_node, int batch_num, const NodePtr &copyed_node,
+                                              EdgeScope scope) {
   for (auto &in_anchor : origin_node->GetAllInDataAnchors()) {
     auto origin_src_anchor = in_anchor->GetPeerOutAnchor();
     if (origin_src_anchor == nullptr) {
@@ -342,6 +442,9 @@ Status MultiBatchGraphCopyer::CopyInDataEdges(const NodePtr &origin_node, int ba
       continue;
     }
     auto origin_src_node = origin_src_anchor->GetOwnerNode();
+    if (!IsInScope(IsInBatchBranch(origin_src_node), scope)) {
+      continue;
+    }
     auto dst_anchor = copyed_node->GetInDataAnchor(in_anchor->GetIdx());
     GE_CHECK_NOTNULL(dst_anchor);
     auto switchn_iter = data_nodes_to_switchn_.find(origin_src_node.get());
@@ -384,7 +487,11 @@ Status MultiBatchGraphCopyer::CopyInDataEdges(const NodePtr &origin_node, int ba
   }
   return SUCCESS;
 }
-Status MultiBatchGraphCopyer::CopyInControlEdges(const NodePtr &node, int batch_num, const NodePtr &copyed_node) {
+Status MultiBatchGraphCopyer::CopyInControlEdges(const NodePtr &node, int batch_num, const NodePtr &copyed_node,
+                                                 EdgeScope scope) {
+  if (!IsInScope(shared_control_nodes_.count(node.get()) == 0, scope)) {
+    return SUCCESS;
+  }
   for (auto &origin_src_node : node->GetInControlNodes()) {
     auto switchn_iter = data_nodes_to_switchn_.find(origin_src_node.get());
     if (switchn_iter != data_nodes_to_switchn_.end()) {
@@ -517,59 +624,100 @@ Status MultiBatchGraphCopyer::CheckCopyResult(const std::vector<NodePtr> &start_
 bool MultiBatchGraphCopyer::IsInBatchBranch(const NodePtr &node) {
   return (nodes_to_batch_nodes_.count(node.get()) > 0) || (data_nodes_to_switchn_.count(node.get()) > 0);
 }
-Status MultiBatchGraphCopyer::LinkDataToMerge(const NodePtr &data, const NodePtr &merge) {
-  // The caller should make sure that the there is a SwitchN node in the map
-  auto &switchn = data_nodes_to_switchn_[data.get()];
-  GELOGI("Link edge bwetween data %s to merge %s throw switchn %s", data->GetName().c_str(), merge->GetName().c_str(),
-         switchn->GetName().c_str());
-  for (size_t i = 0; i < shapes_.size(); ++i) {
-    auto ret = GraphUtils::AddEdge(switchn->GetOutDataAnchor(i), merge->GetInDataAnchor(i));
-    if (ret != GRAPH_SUCCESS) {
-      GELOGE(INTERNAL_ERROR, "Failed to add edge between switchn %s(%zu) to merge %s(%zu), error-code %u",
-             switchn->GetName().c_str(), i, merge->GetName().c_str(), i, ret);
-      return INTERNAL_ERROR;
+bool MultiBatchGraphCopyer::IsMergedInBranch(const NodePtr &node) {
+  if (nodes_to_merge_nodes_.count(node.get()) == 0) {
+    return false;
+  }
+  // a node without data output is linked to its merge through a const, which is created in the graph
+  return (data_nodes_to_switchn_.count(node.get()) > 0) ||
+         ((nodes_to_batch_nodes_.count(node.get()) > 0) && (node->GetAllOutDataAnchorsSize() > 0));
+}
+void MultiBatchGraphCopyer::MarkSharedControlNodes() {
+  // the nodes controlled by a shared node or linked to a merge const, and all nodes joined to them by control edges
+  std::queue<Node *> nodes;
+  for (const auto &item : nodes_to_batch_nodes_) {
+    auto node = item.first;
+    bool shared = (nodes_to_merge_nodes_.count(node) > 0) && (node->GetAllOutDataAnchorsSize() == 0);
+    for (const auto &in_node : node->GetInControlNodes()) {
+      shared = shared || (nodes_to_batch_nodes_.count(in_node.get()) == 0);
+    }
+    if (shared) {
+      shared_control_nodes_.insert(node);
+      nodes.push(node);
     }
   }
+  while (!nodes.empty()) {
+    auto node = nodes.front();
+    nodes.pop();
+    std::vector<NodePtr> control_nodes;
+    for (const auto &in_node : node->GetInControlNodes()) {
+      control_nodes.emplace_back(in_node);
+    }
+    for (const auto &out_node : node->GetOutControlNodes()) {
+      control_nodes.emplace_back(out_node);
+    }
+    for (const auto &control_node : control_nodes) {
+      if ((nodes_to_batch_nodes_.count(control_node.get()) > 0) &&
+          shared_control_nodes_.insert(control_node.get()).second) {
+        nodes.push(control_node.get());
+      }
+    }
+  }
+}
+Status MultiBatchGraphCopyer::LinkDataToMerge(const NodePtr &data, const NodePtr &merge, size_t batch_num) {
+  auto iter = data_nodes_to_switchn_.find(data.get());
+  if (iter == data_nodes_to_switchn_.end()) {
+    GELOGE(INTERNAL_ERROR, "Failed to link data %s to merge %s, no switchn found", data->GetName().c_str(),
+           merge->GetName().c_str());
+    return INTERNAL_ERROR;
+  }
+  auto &switchn = iter->second;
+  GELOGD("Link edge bwetween data %s to merge %s throw switchn %s", data->GetName().c_str(), merge->GetName().c_str(),
+         switchn->GetName().c_str());
+  auto ret = GraphUtils::AddEdge(switchn->GetOutDataAnchor(batch_num), merge->GetInDataAnchor(batch_num));
+  if (ret != GRAPH_SUCCESS) {
+    GELOGE(INTERNAL_ERROR, "Failed to add edge between switchn %s(%zu) to merge %s(%zu), error-code %u",
+           switchn->GetName().c_str(), batch_num, merge->GetName().c_str(), batch_num, ret);
+    return INTERNAL_ERROR;
+  }
   return SUCCESS;
 }
-Status MultiBatchGraphCopyer::LinkNodeToMerge(const NodePtr &node, int out_index, const NodePtr &merge) {
-  auto &copyed_nodes = nodes_to_batch_nodes_[node.get()];
-  if (copyed_nodes.size() != shapes_.size()) {
-    GELOGE(INTERNAL_ERROR,
-           "Failed to create merge node for node %s, the copyed nodes for it count %zu different with shape %zu",
-           node->GetName().c_str(), copyed_nodes.size(), shapes_.size());
+Status MultiBatchGraphCopyer::LinkNodeToMerge(const NodePtr &node, int out_index, const NodePtr &merge,
+                                              size_t batch_num) {
+  auto iter = nodes_to_batch_nodes_.find(node.get());
+  if ((iter == nodes_to_batch_nodes_.end()) || (iter->second.size() != shapes_.size())) {
+    GELOGE(INTERNAL_ERROR, "Failed to create merge node for node %s, the copyed nodes for it different with shape %zu",
+           node->GetName().c_str(), shapes_.size());
     return INTERNAL_ERROR;
   }
-  for (size_t i = 0; i < copyed_nodes.size(); ++i) {
-    auto src_node = copyed_nodes[i];
-    if (src_node->GetAllOutDataAnchorsSize() == 0) {
-      // if the node does not has any data output, we should create an const for it, like this:
-      //       c          d
-      // node ---> const ---> merge
-      auto const_name = src_node->GetName() + "_merge_const";
-      GELOGI("The node %s on the batch branch edge does not have any data output, create a const %s for it",
-             src_node->GetName().c_str(), const_name.c_str());
-      auto const_node = InsertConst(const_name, graph_);
-      if (const_node == nullptr) {
-        GELOGE(OUT_OF_MEMORY, "Failed to create const for node %s to connect to a merge node",
-               src_node->GetName().c_str());
-        return OUT_OF_MEMORY;
-      }
-      auto ret = GraphUtils::AddEdge(src_node->GetOutControlAnchor(), const_node->GetInControlAnchor());
-      if (ret != GRAPH_SUCCESS) {
-        GELOGE(INTERNAL_ERROR, "Failed to add control edge from %s to %s", src_node->GetName().c_str(),
-               const_node->GetName().c_str());
-        return INTERNAL_ERROR;
-      }
-      src_node = const_node;
+  auto src_node = iter->second[batch_num];
+  if (src_node->GetAllOutDataAnchorsSize() == 0) {
+    // if the node does not has any data output, we should create an const for it, like this:
+    //       c          d
+    // node ---> const ---> merge
+    auto const_name = src_node->GetName() + "_merge_const";
+    GELOGI("The node %s on the batch branch edge does not have any data output, create a const %s for it",
+           src_node->GetName().c_str(), const_name.c_str());
+    auto const_node = InsertConst(const_name, graph_);
+    if (const_node == nullptr) {
+      GELOGE(OUT_OF_MEMORY, "Failed to create const for node %s to connect to a merge node",
+             src_node->GetName().c_str());
+      return OUT_OF_MEMORY;
     }
-    auto ret = GraphUtils::AddEdge(src_node->GetOutDataAnchor(out_index), merge->GetInDataAnchor(i));
+    auto ret = GraphUtils::AddEdge(src_node->GetOutControlAnchor(), const_node->GetInControlAnchor());
     if (ret != GRAPH_SUCCESS) {
-      GELOGE(INTERNAL_ERROR,
-             "Failed to add edge between copyed node %s(%d) to inserted merge node %s(%zu), error-code %u",
-             copyed_nodes[i]->GetName().c_str(), out_index, merge->GetName().c_str(), i, ret);
+      GELOGE(INTERNAL_ERROR, "Failed to add control edge from %s to %s", src_node->GetName().c_str(),
+             const_node->GetName().c_str());
       return INTERNAL_ERROR;
     }
+    src_node = const_node;
+  }
+  auto ret = GraphUtils::AddEdge(src_node->GetOutDataAnchor(out_index), merge->GetInDataAnchor(batch_num));
+  if (ret != GRAPH_SUCCESS) {
+    GELOGE(INTERNAL_ERROR,
+           "Failed to add edge between copyed node %s(%d) to inserted merge node %s(%zu), error-code %u",
+           iter->second[batch_num]->GetName().c_str(), out_index, merge->GetName().c_str(), batch_num, ret);
+    return INTERNAL_ERROR;
   }
   return SUCCESS;
 }
@@ -704,8 +852,21 @@ Status MultiBatchGraphCopyer::InsertMergeForEdgeNode(const NodePtr &node) {
 }
 Status MultiBatchGraphCopyer::CopyNodeInBatchBranch(const NodePtr &node) {
   auto &copyed_nodes = nodes_to_batch_nodes_[node.get()];
+  auto staged_iter = staged_indexes_.find(node.get());
   for (size_t i = 0; i < shapes_.size(); ++i) {
-    auto copyed_node = InsertCopyNode(node, node->GetName() + "_huawei_mbatch_batch_" + std::to_string(i));
+    NodePtr copyed_node;
+    if (staged_iter != staged_indexes_.end()) {
+      // the node copyed ahead is moved to the graph, in the same order as the serial copy
+      copyed_node = staged_nodes_[i][staged_iter->second];
+      if (copyed_node->SetOwnerComputeGraph(graph_) == GRAPH_SUCCESS) {
+        copyed_node = graph_->AddNode(copyed_node);
+      } else {
+        copyed_node = nullptr;
+      }
+    } else {
+      auto desc = CopyOpDescInBatchBranch(node, i);
+      copyed_node = (desc == nullptr) ? nullptr : graph_->AddNode(desc);
+    }
     if (copyed_node == nullptr) {
       GELOGE(INTERNAL_ERROR, "Failed to add node to graph when copy node %s", node->GetName().c_str());
       return INTERNAL_ERROR;
@@ -718,6 +879,15 @@ Status MultiBatchGraphCopyer::CopyNodeInBatchBranch(const NodePtr &node) {
 }
 Status MultiBatchGraphCopyer::LinkEdges() {
   Status ret;
+  EdgeScope scope = kAllEdges;
+  if (parallel_copy_) {
+    MarkSharedControlNodes();
+    ret = RunForEachBatch(shapes_.size(), [this](size_t batch_num) { return LinkBranchEdges(batch_num); });
+    if (ret != SUCCESS) {
+      return ret;
+    }
+    scope = kSharedEdges;
+  }
   for (const auto &node : origin_all_nodes_) {
     if (data_nodes_to_switchn_.count(node.get()) > 0) {
       ret = LinkDataToSwitchN(node);
@@ -725,14 +895,14 @@ Status MultiBatchGraphCopyer::LinkEdges() {
         return ret;
       }
     }
-    if (nodes_to_merge_nodes_.count(node.get()) > 0) {
+    if ((nodes_to_merge_nodes_.count(node.get()) > 0) && IsInScope(IsMergedInBranch(node), scope)) {
       ret = LinkToMerge(node);
       if (ret != SUCCESS) {
         return ret;
       }
     }
     if (nodes_to_batch_nodes_.count(node.get()) > 0) {
-      ret = LinkToNodeInBranch(node);
+      ret = LinkToNodeInBranch(node, scope);
     } else {
       ret = LinkToNodeOutBranch(node);
     }
@@ -742,6 +912,30 @@ Status MultiBatchGraphCopyer::LinkEdges() {
   }
   return SUCCESS;
 }
+Status MultiBatchGraphCopyer::LinkBranchEdges(size_t batch_num) {
+  for (const auto &node : origin_all_nodes_) {
+    if (IsMergedInBranch(node)) {
+      auto ret = LinkToMerge(node, batch_num);
+      if (ret != SUCCESS) {
+        return ret;
+      }
+    }
+    auto iter = nodes_to_batch_nodes_.find(node.get());
+    if (iter == nodes_to_batch_nodes_.end()) {
+      continue;
+    }
+    const auto &copyed_node = iter->second.at(batch_num);
+    auto ret = CopyInDataEdges(node, batch_num, copyed_node, kBranchEdges);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+    ret = CopyInControlEdges(node, batch_num, copyed_node, kBranchEdges);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+  }
+  return SUCCESS;
+}
 Status MultiBatchGraphCopyer::LinkDataToSwitchN(const NodePtr &data) {
   auto switchn = data_nodes_to_switchn_[data.get()];
   auto ret =
@@ -760,21 +954,34 @@ Status MultiBatchGraphCopyer::LinkDataToSwitchN(const NodePtr &data) {
   return SUCCESS;
 }
 Status MultiBatchGraphCopyer::LinkToMerge(const NodePtr &node) {
-  auto &merge_nodes = nodes_to_merge_nodes_[node.get()];
+  for (size_t i = 0; i < shapes_.size(); ++i) {
+    auto ret = LinkToMerge(node, i);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+  }
+  return SUCCESS;
+}
+Status MultiBatchGraphCopyer::LinkToMerge(const NodePtr &node, size_t batch_num) {
+  auto iter = nodes_to_merge_nodes_.find(node.get());
+  if (iter == nodes_to_merge_nodes_.end()) {
+    return SUCCESS;
+  }
+  auto &merge_nodes = iter->second;
   for (size_t i = 0; i < merge_nodes.size(); ++i) {
     auto merge_node = merge_nodes[i];
     if (merge_node == nullptr) {
       continue;
     }
     if (nodes_to_batch_nodes_.count(node.get()) > 0) {
-      auto ret = LinkNodeToMerge(node, i, merge_node);
+      auto ret = LinkNodeToMerge(node, i, merge_node, batch_num);
       if (ret != SUCCESS) {
         return ret;
       }
       continue;
     }
     if (data_nodes_to_switchn_.count(node.get()) > 0) {
-      auto ret = LinkDataToMerge(node, merge_node);
+      auto ret = LinkDataToMerge(node, merge_node, batch_num);
       if (ret != SUCCESS) {
         return ret;
       }
@@ -786,14 +993,14 @@ Status MultiBatchGraphCopyer::LinkToMerge(const NodePtr &node) {
   }
   return SUCCESS;
 }
-Status MultiBatchGraphCopyer::LinkToNodeInBranch(const NodePtr &node) {
+Status MultiBatchGraphCopyer::LinkToNodeInBranch(const NodePtr &node, EdgeScope scope) {
   auto &branch_nodes = nodes_to_batch_nodes_[node.get()];
   for (size_t i = 0; i < branch_nodes.size(); ++i) {
-    auto ret = CopyInDataEdges(node, i, branch_nodes[i]);
+    auto ret = CopyInDataEdges(node, i, branch_nodes[i], scope);
     if (ret != SUCCESS) {
       return ret;
     }
-    ret = CopyInControlEdges(node, i, branch_nodes[i]);
+    ret = CopyInControlEdges(node, i, branch_nodes[i], scope);
     if (ret != SUCCESS) {
       return ret;
     }
@@ -909,6 +1116,14 @@ Status ProcessMultiBatch(ComputeGraphPtr &graph) {
   for (auto &shape : shapes) {
     copyer.AddShape(shape);
   }
+  if ((GetContext().GetOption(MULTI_BATCH_SHARE_WEIGHTS, option) == GRAPH_SUCCESS) && (option == "1")) {
+    GELOGI("Share the weights between the batch branches");
+    copyer.SetShareWeights(true);
+  }
+  if ((GetContext().GetOption(MULTI_BATCH_PARALLEL_COPY, option) == GRAPH_SUCCESS) && (option == "1")) {
+    GELOGI("Copy the batch branches in parallel");
+    copyer.SetParallelCopy(true);
+  }
   return copyer.CopyGraph();
 }
 }  // namespace multibatch
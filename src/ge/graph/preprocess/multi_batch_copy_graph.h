@@ -20,6 +20,8 @@
 #include <vector>
 #include <map>
 #include <queue>
+#include <set>
+#include <string>
 
 #include "external/ge/ge_api_error_codes.h"
 #include "graph/compute_graph.h"
@@ -34,6 +36,13 @@ enum NodeStatus {
   kNodeStartNode,
 };
 
+// the in edges of the copyed nodes: all of them, the ones inside a batch branch, or the ones from the shared nodes
+enum EdgeScope {
+  kAllEdges,
+  kBranchEdges,
+  kSharedEdges,
+};
+
 class MultiBatchGraphCopyer {
  public:
   explicit MultiBatchGraphCopyer(ComputeGraphPtr &graph) : graph_(graph) {}
@@ -43,6 +52,28 @@ class MultiBatchGraphCopyer {
     shapes_.emplace_back(shape);
   }
 
+  ///
+  /// In the weight sharing mode, the weight nodes(Const/Variable) are never copied into the batch branches, even if
+  /// some of their inputs are in the branches. Their inputs from the branches are linked through merge nodes like
+  /// those of any other node out of the branches, so all branches update and read the same weights. With the same
+  /// option the memory assigner keeps each block to one gear, and overlays the gears. Off by default.
+  /// @param share_weights
+  ///
+  void SetShareWeights(bool share_weights) {
+    share_weights_ = share_weights;
+  }
+
+  ///
+  /// In the parallel mode, the nodes of each batch branch are copied on a shared thread pool, and moved to the graph in
+  /// the order of the serial copy. The edges on the anchors owned by one branch are linked on the pool too, in the
+  /// order of the serial copy, the anchors shared by the branches (SwitchN control, weights, merge consts) are linked
+  /// serially. Both modes give the same graph, up to the peer order of every anchor. Off by default.
+  /// @param parallel_copy
+  ///
+  void SetParallelCopy(bool parallel_copy) {
+    parallel_copy_ = parallel_copy;
+  }
+
   Status CopyGraph();
 
  private:
@@ -51,6 +82,9 @@ class MultiBatchGraphCopyer {
 
   // add nodes functions
   Status CreateNewNodes();
+  void GetNodesStatus(std::vector<NodeStatus> &nodes_status);
+  Status StageBatchBranchNodes(const std::vector<NodeStatus> &nodes_status);
+  OpDescPtr CopyOpDescInBatchBranch(const NodePtr &node, size_t batch_num);
 
   NodePtr InsertShapeDataNode();
   Status InsertSwitchNForData(const NodePtr &data);
@@ -76,22 +110,29 @@ class MultiBatchGraphCopyer {
 
   // link edges functions
   Status LinkEdges();
+  Status LinkBranchEdges(size_t batch_num);
   Status LinkDataToSwitchN(const NodePtr &data);
   Status LinkToMerge(const NodePtr &node);
-  Status LinkToNodeInBranch(const NodePtr &node);
+  Status LinkToMerge(const NodePtr &node, size_t batch_num);
+  Status LinkToNodeInBranch(const NodePtr &node, EdgeScope scope);
   Status LinkToNodeOutBranch(const NodePtr &node);
-  Status LinkDataToMerge(const NodePtr &data, const NodePtr &merge);
-  Status LinkNodeToMerge(const NodePtr &node, int out_index, const NodePtr &merge);
-  Status CopyInDataEdges(const NodePtr &origin_node, int batch_num, const NodePtr &copyed_node);
-  Status CopyInControlEdges(const NodePtr &node, int batch_num, const NodePtr &copyed_node);
+  Status LinkDataToMerge(const NodePtr &data, const NodePtr &merge, size_t batch_num);
+  Status LinkNodeToMerge(const NodePtr &node, int out_index, const NodePtr &merge, size_t batch_num);
+  Status CopyInDataEdges(const NodePtr &origin_node, int batch_num, const NodePtr &copyed_node, EdgeScope scope);
+  Status CopyInControlEdges(const NodePtr &node, int batch_num, const NodePtr &copyed_node, EdgeScope scope);
 
   bool IsInBatchBranch(const NodePtr &node);
-  NodeStatus GetNodeStatus(const NodePtr &node);
+  // the merge of a node is linked in the branch, unless a const is created for it
+  bool IsMergedInBranch(const NodePtr &node);
+  void MarkSharedControlNodes();
+  NodeStatus GetNodeStatus(const NodePtr &node, const std::set<Node *> &branch_nodes);
   Status CheckCopyResult(const std::vector<NodePtr> &start_nodes);
 
   // arguments
   ComputeGraphPtr graph_;
   std::vector<std::vector<int64_t>> shapes_;
+  bool share_weights_ = false;
+  bool parallel_copy_ = false;
 
   // the shape data node created
   NodePtr shape_data_;
@@ -105,6 +146,13 @@ class MultiBatchGraphCopyer {
   // the nodes in-batch-branch, and the nodes copyed by shapes
   std::map<Node *, std::vector<NodePtr>> nodes_to_batch_nodes_;
 
+  // the nodes copyed ahead for each batch, in the order of the nodes in-batch-branch
+  std::vector<std::vector<NodePtr>> staged_nodes_;
+  std::map<Node *, size_t> staged_indexes_;
+
+  // the nodes in-batch-branch whose control edges are linked serially, to keep the peer order on both ends
+  std::set<Node *> shared_control_nodes_;
+
   // the data nodes, and the SwitchN nodes inserted after it
   std::map<Node *, NodePtr> data_nodes_to_switchn_;
 
@@ -31,6 +31,7 @@
 #include "common/profiling/profiling_manager.h"
 #include "graph/manager/graph_mem_allocator.h"
 #include "graph/manager/graph_var_manager.h"
+#include "graph/utils/graph_utils.h"
 #include "runtime/kernel.h"
 #include "graph/ge_context.h"
 #include "graph/ge_global_options.h"
@@ -325,6 +326,9 @@ Status GELib::Finalize() {
   Status final_em_status = engine_manager_.Finalize();
   GELOGI("sessionManager finalization.");
   Status final_sm_status = session_manager_.Finalize();
+  // the graphs dumped so far are written even if a manager failed to finalize
+  GELOGI("Graph dump flush.");
+  GraphUtils::FlushDumpGraph();
 
   if (final_em_status != SUCCESS) {
     GELOGE(final_em_status);
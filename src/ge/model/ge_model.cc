@@ -19,6 +19,9 @@
 #include <utility>
 
 #include "common/debug/log.h"
+#include "common/ge/ge_util.h"
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/util.h"
 #include "graph/debug/ge_attr_define.h"
 #include "graph/utils/attr_utils.h"
 
@@ -40,11 +43,70 @@ GeModel::GeModel() {
 
 const Graph &GeModel::GetGraph() const { return this->graph_; }
 
-std::shared_ptr<domi::ModelTaskDef> GeModel::GetModelTaskDefPtr() const { return this->task_; }
+Status GeModel::LoadModelTaskDef() const {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  if (task_data_ == nullptr) {
+    return SUCCESS;
+  }
+  auto task = MakeShared<domi::ModelTaskDef>();
+  if (task == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "Create model task def ptr failed");
+    return MEMALLOC_FAILED;
+  }
+  if (!ReadProtoFromArray(task_data_, static_cast<int>(task_size_), task.get())) {
+    GELOGE(INTERNAL_ERROR, "Parse model task def of model %s failed, size:%zu", name_.c_str(), task_size_);
+    return INTERNAL_ERROR;
+  }
+  GELOGI("Parse model task def of model %s, op_size:%d, stream_num:%u", name_.c_str(), task->op().size(),
+         task->stream_num());
+  task_ = task;
+  task_data_ = nullptr;
+  task_size_ = 0;
+  return SUCCESS;
+}
 
-const TBEKernelStore &GeModel::GetTBEKernelStore() const { return this->tbe_kernal_store_; }
+std::shared_ptr<domi::ModelTaskDef> GeModel::GetModelTaskDefPtr() const {
+  if (LoadModelTaskDef() != SUCCESS) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  return this->task_;
+}
 
-Buffer GeModel::GetWeight() const { return this->weights_buffer_; }
+const TBEKernelStore &GeModel::GetTBEKernelStore() const {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  if (tbe_kernel_data_ != nullptr) {
+    if (tbe_kernal_store_.Load(tbe_kernel_data_, tbe_kernel_size_)) {
+      GELOGI("Load tbe kernels of model %s success", name_.c_str());
+    } else {
+      GELOGW("Load tbe kernels of model %s failed", name_.c_str());
+    }
+    tbe_kernel_data_ = nullptr;
+    tbe_kernel_size_ = 0;
+  }
+  return this->tbe_kernal_store_;
+}
+
+Buffer GeModel::GetWeight() const {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  if (weights_data_ != nullptr) {
+    // copied once, the buffer shares its data with the ones returned later
+    weights_buffer_ = Buffer::CopyFrom(weights_data_, weights_size_);
+    weights_data_ = nullptr;
+    weights_size_ = 0;
+  }
+  return this->weights_buffer_;
+}
+
+const uint8_t *GeModel::GetWeightData() const {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  return (weights_data_ != nullptr) ? weights_data_ : weights_buffer_.GetData();
+}
+
+size_t GeModel::GetWeightSize() const {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  return (weights_data_ != nullptr) ? weights_size_ : weights_buffer_.GetSize();
+}
 
 std::string GeModel::GetName() const { return this->name_; }
 
@@ -56,13 +118,50 @@ uint8_t GeModel::GetPlatformType() const { return this->platform_type_; }
 
 void GeModel::SetGraph(const Graph &graph) { this->graph_ = graph; }
 
-void GeModel::SetModelTaskDef(const std::shared_ptr<domi::ModelTaskDef> &task) { this->task_ = task; }
+void GeModel::SetModelTaskDef(const std::shared_ptr<domi::ModelTaskDef> &task) {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  this->task_ = task;
+  task_data_ = nullptr;
+  task_size_ = 0;
+}
 
 void GeModel::SetTBEKernelStore(const TBEKernelStore &tbe_kernal_store) {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
   this->tbe_kernal_store_ = tbe_kernal_store;
+  tbe_kernel_data_ = nullptr;
+  tbe_kernel_size_ = 0;
+}
+
+void GeModel::SetWeight(const Buffer &weights_buffer) {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  this->weights_buffer_ = weights_buffer;
+  weights_data_ = nullptr;
+  weights_size_ = 0;
 }
 
-void GeModel::SetWeight(const Buffer &weights_buffer) { this->weights_buffer_ = weights_buffer; }
+void GeModel::SetDataOwner(const std::shared_ptr<void> &data_owner) { data_owner_ = data_owner; }
+
+void GeModel::SetWeightView(const uint8_t *data, size_t size) {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  weights_buffer_ = Buffer();
+  weights_data_ = data;
+  weights_size_ = (data == nullptr) ? 0 : size;
+}
+
+void GeModel::SetModelTaskDefData(const uint8_t *data, size_t size) {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  // an empty partition gives an empty task def, as the eager load does
+  task_ = MakeShared<domi::ModelTaskDef>();
+  task_data_ = (size == 0) ? nullptr : data;
+  task_size_ = (task_data_ == nullptr) ? 0 : size;
+}
+
+void GeModel::SetTBEKernelData(const uint8_t *data, size_t size) {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  tbe_kernal_store_ = TBEKernelStore();
+  tbe_kernel_data_ = (size == 0) ? nullptr : data;
+  tbe_kernel_size_ = (tbe_kernel_data_ == nullptr) ? 0 : size;
+}
 
 void GeModel::SetName(const std::string &name) { this->name_ = name; }
 
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "common/tbe_kernel_store.h"
@@ -38,9 +39,18 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GeModel : public AttrHolder
   GeModel &operator=(const GeModel &other) = delete;
 
   const Graph &GetGraph() const;
+  // nullptr if the task def viewed in the loaded model can not be parsed
   std::shared_ptr<domi::ModelTaskDef> GetModelTaskDefPtr() const;
+  ///
+  /// @brief Parse the task def viewed in the loaded model, does nothing if it is parsed or set
+  /// @return INTERNAL_ERROR if the task def can not be parsed
+  ///
+  Status LoadModelTaskDef() const;
   const TBEKernelStore &GetTBEKernelStore() const;
+  // a viewed weight is copied on the first call, the later ones share that copy
   Buffer GetWeight() const;
+  const uint8_t *GetWeightData() const;
+  size_t GetWeightSize() const;
 
   std::string GetName() const;
   uint32_t GetVersion() const;
@@ -52,6 +62,16 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GeModel : public AttrHolder
   void SetTBEKernelStore(const TBEKernelStore &tbe_kernal_store);
   void SetWeight(const Buffer &weights_buffer);
 
+  ///
+  /// @brief Keep the partitions of a loaded model in place instead of copying them. The task def and the tbe kernel
+  /// store are parsed on the first get.
+  /// @param [in] data_owner  keeps the partitions valid as long as the model
+  ///
+  void SetDataOwner(const std::shared_ptr<void> &data_owner);
+  void SetWeightView(const uint8_t *data, size_t size);
+  void SetModelTaskDefData(const uint8_t *data, size_t size);
+  void SetTBEKernelData(const uint8_t *data, size_t size);
+
   void SetName(const std::string &name);
   void SetVersion(uint32_t version);
   void SetPlatformVersion(const std::string &platform_version);
@@ -77,9 +97,19 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GeModel : public AttrHolder
   ProtoAttrMapHelper attrs_;
 
   Graph graph_;
-  std::shared_ptr<domi::ModelTaskDef> task_;
-  TBEKernelStore tbe_kernal_store_;
-  Buffer weights_buffer_;
+  mutable std::shared_ptr<domi::ModelTaskDef> task_;
+  mutable TBEKernelStore tbe_kernal_store_;
+  mutable Buffer weights_buffer_;
+
+  // partitions viewed in the loaded model, parsed on first get
+  std::shared_ptr<void> data_owner_;
+  mutable const uint8_t *weights_data_ = nullptr;
+  mutable size_t weights_size_ = 0;
+  mutable const uint8_t *task_data_ = nullptr;
+  mutable size_t task_size_ = 0;
+  mutable const uint8_t *tbe_kernel_data_ = nullptr;
+  mutable size_t tbe_kernel_size_ = 0;
+  mutable std::mutex lazy_mutex_;
 
   std::string name_;
   uint32_t version_ = {0};
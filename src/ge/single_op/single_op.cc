@@ -19,7 +19,11 @@
 #include "common/fmk_types.h"
 #include "common/profiling/profiling_manager.h"
 #include "framework/common/debug/ge_log.h"
+#include "framework/common/debug/log.h"
 #include "graph/load/new_model_manager/model_utils.h"
+#include "graph/manager/graph_mem_allocator.h"
+#include "graph/utils/op_desc_utils.h"
+#include "graph/utils/tensor_utils.h"
 #include "runtime/mem.h"
 
 namespace ge {
@@ -156,4 +160,185 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status SingleOp::ExecuteAsync(c
 }
 
 void SingleOp::SetStream(rtStream_t stream) { stream_ = stream; }
+
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY DynamicSingleOp::~DynamicSingleOp() { FreeOutputBuffers(); }
+
+void DynamicSingleOp::SetStream(rtStream_t stream) { stream_ = stream; }
+
+std::string DynamicSingleOp::GetShapeKey(const std::vector<GeTensorDesc> &tensor_desc) {
+  std::string key;
+  for (size_t i = 0; i < tensor_desc.size(); ++i) {
+    if (i > 0) {
+      key += ";";
+    }
+    const std::vector<int64_t> dims = tensor_desc[i].GetShape().GetDims();
+    for (size_t j = 0; j < dims.size(); ++j) {
+      if (j > 0) {
+        key += ",";
+      }
+      key += std::to_string(dims[j]);
+    }
+  }
+  return key;
+}
+
+Status DynamicSingleOp::ValidateArgs(const std::vector<GeTensorDesc> &input_desc,
+                                     const std::vector<DataBuffer> &inputs) {
+  if (input_desc.size() != num_inputs_ || inputs.size() != num_inputs_) {
+    GELOGE(PARAM_INVALID, "Input num mismatch. model expect %zu, but given %zu descs and %zu buffers", num_inputs_,
+           input_desc.size(), inputs.size());
+    return PARAM_INVALID;
+  }
+
+  for (size_t i = 0; i < num_inputs_; ++i) {
+    uint32_t tensor_size = 0;
+    if (TensorUtils::GetTensorSizeInBytes(input_desc[i], tensor_size) != GRAPH_SUCCESS) {
+      GELOGE(PARAM_INVALID, "Calc size of input[%zu] failed", i);
+      return PARAM_INVALID;
+    }
+    // preventing from read out of bound
+    if (inputs[i].length < tensor_size) {
+      GELOGE(PARAM_INVALID, "Input size mismatch. index = %zu, shape expect %u, but given %u", i, tensor_size,
+             inputs[i].length);
+      return PARAM_INVALID;
+    }
+  }
+  return SUCCESS;
+}
+
+Status DynamicSingleOp::InferShape(const std::vector<GeTensorDesc> &input_desc,
+                                   std::vector<GeTensorDesc> &output_desc) {
+  for (size_t i = 0; i < num_inputs_; ++i) {
+    if (op_desc_->UpdateInputDesc(static_cast<uint32_t>(i), input_desc[i]) != GRAPH_SUCCESS) {
+      GELOGE(INTERNAL_ERROR, "Update input desc[%zu] of %s failed", i, op_desc_->GetName().c_str());
+      return INTERNAL_ERROR;
+    }
+  }
+
+  Operator op = OpDescUtils::CreateOperatorFromOpDesc(op_desc_);
+  if (op_desc_->CallInferFunc(op) != GRAPH_SUCCESS) {
+    GELOGE(INTERNAL_ERROR, "Infer shape of %s failed", op_desc_->GetName().c_str());
+    return INTERNAL_ERROR;
+  }
+
+  output_desc.clear();
+  for (size_t i = 0; i < num_outputs_; ++i) {
+    output_desc.emplace_back(op_desc_->GetOutputDesc(static_cast<uint32_t>(i)));
+  }
+  return SUCCESS;
+}
+
+Status DynamicSingleOp::AllocateOutputs(const std::vector<GeTensorDesc> &output_desc, std::vector<DataBuffer> &outputs) {
+  CachingAllocator *caching_allocator = MemManager::CachingInstance(RT_MEMORY_HBM);
+  GE_CHECK_NOTNULL(caching_allocator);
+  // no outputs given, all of them are allocated by the op
+  if (outputs.empty()) {
+    outputs.resize(num_outputs_);
+  }
+  if (outputs.size() != num_outputs_) {
+    GELOGE(PARAM_INVALID, "Output num mismatch. model expect %zu, but given %zu", num_outputs_, outputs.size());
+    return PARAM_INVALID;
+  }
+  output_buffers_.resize(num_outputs_, nullptr);
+  output_buffer_sizes_.resize(num_outputs_, 0);
+
+  for (size_t i = 0; i < num_outputs_; ++i) {
+    uint32_t tensor_size = 0;
+    if (TensorUtils::GetTensorMemorySizeInBytes(output_desc[i], tensor_size) != GRAPH_SUCCESS) {
+      GELOGE(INTERNAL_ERROR, "Calc size of output[%zu] failed", i);
+      return INTERNAL_ERROR;
+    }
+    // the buffer of the caller is used as it is, the op never writes to other memory than it was given
+    if (outputs[i].data != nullptr) {
+      if (outputs[i].length < tensor_size) {
+        GELOGE(PARAM_INVALID, "Output size mismatch. index = %zu, shape expect %u, but given %u", i, tensor_size,
+               outputs[i].length);
+        return PARAM_INVALID;
+      }
+      continue;
+    }
+
+    if (output_buffer_sizes_[i] < tensor_size) {
+      if (output_buffers_[i] != nullptr) {
+        (void)caching_allocator->Free(output_buffers_[i]);
+        output_buffers_[i] = nullptr;
+        output_buffer_sizes_[i] = 0;
+      }
+      output_buffers_[i] = caching_allocator->Malloc(tensor_size, stream_);
+      if (output_buffers_[i] == nullptr) {
+        GELOGE(MEMALLOC_FAILED, "Malloc output[%zu] failed, size = %u", i, tensor_size);
+        return MEMALLOC_FAILED;
+      }
+      output_buffer_sizes_[i] = tensor_size;
+    }
+    outputs[i].data = output_buffers_[i];
+    outputs[i].length = tensor_size;
+  }
+  return SUCCESS;
+}
+
+OpTask *DynamicSingleOp::SelectTask(const std::vector<GeTensorDesc> &input_desc) {
+  if (!tbe_tasks_.empty()) {
+    auto it = tbe_tasks_.find(GetShapeKey(input_desc));
+    if (it != tbe_tasks_.end()) {
+      return it->second.get();
+    }
+  }
+  if (aicpu_task_ != nullptr && GetShapeKey(input_desc) == aicpu_shape_key_) {
+    return aicpu_task_.get();
+  }
+  return nullptr;
+}
+
+void DynamicSingleOp::FreeOutputBuffers() {
+  CachingAllocator *caching_allocator = MemManager::CachingInstance(RT_MEMORY_HBM);
+  for (auto buffer : output_buffers_) {
+    if (buffer != nullptr && caching_allocator != nullptr) {
+      (void)caching_allocator->Free(buffer);
+    }
+  }
+  output_buffers_.clear();
+  output_buffer_sizes_.clear();
+}
+
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status DynamicSingleOp::ExecuteAsync(
+    const std::vector<GeTensorDesc> &input_desc, const std::vector<DataBuffer> &inputs,
+    std::vector<GeTensorDesc> &output_desc, std::vector<DataBuffer> &outputs) {
+  GE_CHECK_NOTNULL(op_desc_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  Status ret = ValidateArgs(input_desc, inputs);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  ret = InferShape(input_desc, output_desc);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  OpTask *task = SelectTask(input_desc);
+  if (task == nullptr) {
+    GELOGE(UNSUPPORTED, "No kernel of %s for shape [%s]", op_desc_->GetName().c_str(),
+           GetShapeKey(input_desc).c_str());
+    return UNSUPPORTED;
+  }
+
+  ret = AllocateOutputs(output_desc, outputs);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  std::vector<void *> io_addrs;
+  for (auto &input : inputs) {
+    io_addrs.emplace_back(input.data);
+  }
+  for (auto &output : outputs) {
+    io_addrs.emplace_back(output.data);
+  }
+  ret = task->UpdateIoAddr(io_addrs);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  return task->LaunchKernel(stream_);
+}
 }  // namespace ge
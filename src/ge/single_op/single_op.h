@@ -18,12 +18,15 @@
 #define GE_SINGLE_OP_SINGLE_OP_H_
 
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "common/ge_inner_error_codes.h"
 #include "framework/executor/ge_executor.h"
+#include "graph/op_desc.h"
 #include "runtime/stream.h"
 #include "task/op_task.h"
 
@@ -52,5 +55,59 @@ class SingleOp {
   std::vector<std::vector<uintptr_t *>> arg_table_;
   bool use_physical_addr_ = false;
 };
+
+class DynamicSingleOp {
+ public:
+  DynamicSingleOp() = default;
+  ~DynamicSingleOp();
+
+  DynamicSingleOp(const DynamicSingleOp &) = delete;
+  DynamicSingleOp &operator=(const DynamicSingleOp &) = delete;
+
+  ///
+  /// @ingroup ge
+  /// @brief infer output shapes from input shapes and launch the op
+  /// @param [in] input_desc descs of inputs with the actual shapes
+  /// @param [in] inputs input buffers
+  /// @param [out] output_desc inferred descs of outputs
+  /// @param [in|out] outputs output buffers, empty or null ones are allocated from the stream's memory pool and
+  ///                 stay valid until the next execution of this op, given ones must hold the inferred shape
+  /// @return Status result of function
+  ///
+  Status ExecuteAsync(const std::vector<GeTensorDesc> &input_desc, const std::vector<DataBuffer> &inputs,
+                      std::vector<GeTensorDesc> &output_desc, std::vector<DataBuffer> &outputs);
+
+  void SetStream(rtStream_t stream);
+
+  ///
+  /// @ingroup ge
+  /// @brief the input shapes, such as "1,3,8;16". A TBE kernel is compiled for static shapes, it is only
+  ///        selected for exactly the shapes it was built with
+  /// @param [in] tensor_desc tensor descs
+  /// @return shape key
+  ///
+  static std::string GetShapeKey(const std::vector<GeTensorDesc> &tensor_desc);
+
+ private:
+  Status ValidateArgs(const std::vector<GeTensorDesc> &input_desc, const std::vector<DataBuffer> &inputs);
+  Status InferShape(const std::vector<GeTensorDesc> &input_desc, std::vector<GeTensorDesc> &output_desc);
+  Status AllocateOutputs(const std::vector<GeTensorDesc> &output_desc, std::vector<DataBuffer> &outputs);
+  OpTask *SelectTask(const std::vector<GeTensorDesc> &input_desc);
+  void FreeOutputBuffers();
+
+  friend class SingleOpModel;
+  std::mutex mutex_;
+  rtStream_t stream_ = nullptr;
+  OpDescPtr op_desc_;
+  size_t num_inputs_ = 0;
+  size_t num_outputs_ = 0;
+  // TBE kernels keyed by the input shapes they are compiled for
+  std::map<std::string, std::unique_ptr<OpTask>> tbe_tasks_;
+  std::unique_ptr<OpTask> aicpu_task_;
+  // UpdateIoAddr patches only the addresses, the op def in the aicpu args keeps the shapes it is built for
+  std::string aicpu_shape_key_;
+  std::vector<uint8_t *> output_buffers_;
+  std::vector<size_t> output_buffer_sizes_;
+};
 }  // namespace ge
 #endif  // GE_SINGLE_OP_SINGLE_OP_H_
@@ -40,21 +40,10 @@ Status SingleOpManager::GetOpFromModel(const std::string &model_name,
     GELOGE(PARAM_INVALID, "single op is null");
     return PARAM_INVALID;
   }
-  uintptr_t resource_id;
-  // runtime uses NULL to denote a default stream for each device
-  if (stream == nullptr) {
-    // use device id as resource key instead
-    int32_t dev_id = 0;
-    auto rt_err = rtGetDevice(&dev_id);
-    if (rt_err != RT_ERROR_NONE) {
-      GELOGE(RT_FAILED, "Get current device id failed. ret = %d", static_cast<int>(rt_err));
-      return RT_FAILED;
-    }
-
-    GELOGI("GetOpFromModel with default stream. device id = %d", dev_id);
-    resource_id = static_cast<uintptr_t>(dev_id);
-  } else {
-    resource_id = reinterpret_cast<uintptr_t>(stream);
+  uintptr_t resource_id = 0;
+  auto ret = GetResourceId(stream, resource_id);
+  if (ret != SUCCESS) {
+    return ret;
   }
 
   GELOGI("GetOpFromModel in. model name = %s, resource id = 0x%lx",
@@ -66,6 +55,7 @@ Status SingleOpManager::GetOpFromModel(const std::string &model_name,
       GELOGE(MEMALLOC_FAILED, "GetResource failed");
       return MEMALLOC_FAILED;
   }
+  res->SetStream(stream);
 
   SingleOp *op = res->GetOperator(model_data.model_data);
   if (op != nullptr) {
@@ -75,7 +65,7 @@ Status SingleOpManager::GetOpFromModel(const std::string &model_name,
   }
 
   SingleOpModel model(model_name, model_data.model_data, model_data.model_len);
-  auto ret = model.Init();
+  ret = model.Init();
   if (ret != SUCCESS) {
     GELOGE(ret, "Init model failed. model = %s, ret = %u", model_name.c_str(), ret);
     return ret;
@@ -106,6 +96,71 @@ Status SingleOpManager::GetOpFromModel(const std::string &model_name,
   return SUCCESS;
 }
 
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY
+Status SingleOpManager::GetDynamicOpFromModel(const std::string &model_name,
+                                              const ModelData &model_data,
+                                              void *stream,
+                                              DynamicSingleOp **single_op) {
+  if (single_op == nullptr) {
+    GELOGE(PARAM_INVALID, "single op is null");
+    return PARAM_INVALID;
+  }
+  uintptr_t resource_id = 0;
+  auto ret = GetResourceId(stream, resource_id);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  GELOGI("GetDynamicOpFromModel in. model name = %s, resource id = 0x%lx",
+         model_name.c_str(),
+         static_cast<uint64_t>(resource_id));
+
+  StreamResource *res = GetResource(resource_id);
+  if (res == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "GetResource failed");
+    return MEMALLOC_FAILED;
+  }
+  res->SetStream(stream);
+
+  DynamicSingleOp *op = res->GetDynamicOperator(model_data.model_data);
+  if (op != nullptr) {
+    GELOGD("Got dynamic operator from stream cache");
+    *single_op = op;
+    return SUCCESS;
+  }
+
+  SingleOpModel model(model_name, model_data.model_data, model_data.model_len);
+  ret = model.Init();
+  if (ret != SUCCESS) {
+    GELOGE(ret, "Init model failed. model = %s, ret = %u", model_name.c_str(), ret);
+    return ret;
+  }
+
+  auto *new_op = new(std::nothrow)DynamicSingleOp();
+  if (new_op == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "new DynamicSingleOp failed");
+    return MEMALLOC_FAILED;
+  }
+
+  GELOGI("To build dynamic operator: %s", model_name.c_str());
+  ret = model.BuildDynamicOp(*res, *new_op);
+  if (ret != SUCCESS) {
+    GELOGE(ret, "Build dynamic op failed. op = %s, resource id = 0x%lx, ret = %u",
+           model_name.c_str(),
+           static_cast<uint64_t>(resource_id),
+           ret);
+    delete new_op;
+    new_op = nullptr;
+    return ret;
+  }
+
+  // stream is nullable
+  new_op->SetStream(stream);
+  res->CacheDynamicOperator(model_data.model_data, new_op);
+  *single_op = new_op;
+  return SUCCESS;
+}
+
 FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY
 Status SingleOpManager::ReleaseResource(void *stream) {
   auto resource_id = reinterpret_cast<uintptr_t>(stream);
@@ -121,6 +176,25 @@ Status SingleOpManager::ReleaseResource(void *stream) {
   return SUCCESS;
 }
 
+Status SingleOpManager::GetResourceId(void *stream, uintptr_t &resource_id) {
+  // runtime uses NULL to denote a default stream for each device
+  if (stream == nullptr) {
+    // use device id as resource key instead
+    int32_t dev_id = 0;
+    auto rt_err = rtGetDevice(&dev_id);
+    if (rt_err != RT_ERROR_NONE) {
+      GELOGE(RT_FAILED, "Get current device id failed. ret = %d", static_cast<int>(rt_err));
+      return RT_FAILED;
+    }
+
+    GELOGI("GetOpFromModel with default stream. device id = %d", dev_id);
+    resource_id = static_cast<uintptr_t>(dev_id);
+  } else {
+    resource_id = reinterpret_cast<uintptr_t>(stream);
+  }
+  return SUCCESS;
+}
+
 StreamResource *SingleOpManager::GetResource(uintptr_t resource_id) {
   std::lock_guard<std::mutex> lock(mutex_);
   auto it = stream_resources_.find(resource_id);
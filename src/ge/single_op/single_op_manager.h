@@ -36,9 +36,13 @@ class SingleOpManager {
 
   Status GetOpFromModel(const std::string &key, const ge::ModelData &model_data, void *stream, SingleOp **single_op);
 
+  Status GetDynamicOpFromModel(const std::string &key, const ge::ModelData &model_data, void *stream,
+                               DynamicSingleOp **single_op);
+
   Status ReleaseResource(void *stream);
 
  private:
+  static Status GetResourceId(void *stream, uintptr_t &resource_id);
   StreamResource *GetResource(uintptr_t resource_id);
   StreamResource *TryGetResource(uintptr_t resource_id);
 
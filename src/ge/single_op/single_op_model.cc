@@ -220,7 +220,9 @@ Status SingleOpModel::SetInputsAndOutputs(SingleOp &single_op) {
 Status SingleOpModel::BuildTaskList(SingleOp &single_op) {
   auto ge_model = model_helper_.GetGeModel();
   GE_CHECK_NOTNULL(ge_model);
-  auto tasks = ge_model->GetModelTaskDefPtr()->task();
+  auto model_task_def = ge_model->GetModelTaskDefPtr();
+  GE_CHECK_NOTNULL(model_task_def);
+  auto tasks = model_task_def->task();
   for (int i = 0; i < tasks.size(); ++i) {
     const TaskDef &task_def = tasks[i];
     GELOGI("[%s] Task[%d], type = %u, DebugString = %s", model_name_.c_str(), i, task_def.type(),
@@ -313,4 +315,110 @@ Status SingleOpModel::BuildOp(StreamResource &resource, SingleOp &single_op) {
   }
   return BuildTaskList(single_op);
 }
+
+Status SingleOpModel::BuildDynamicKernelTask(const domi::KernelDef &kernel_def, DynamicSingleOp &single_op) {
+  const auto &context = kernel_def.context();
+  auto iter = op_list_.find(context.op_index());
+  if (iter == op_list_.end()) {
+    GELOGE(INTERNAL_ERROR, "op desc not found. op index = %u", context.op_index());
+    return INTERNAL_ERROR;
+  }
+  if (single_op.op_desc_ == nullptr) {
+    single_op.op_desc_ = iter->second;
+  } else if (single_op.op_desc_ != iter->second) {
+    GELOGE(UNSUPPORTED, "Dynamic single op supports only one op, but got %s and %s",
+           single_op.op_desc_->GetName().c_str(), iter->second->GetName().c_str());
+    return UNSUPPORTED;
+  }
+
+  // both kernels are built for the shapes recorded in op desc
+  std::vector<GeTensorDesc> input_desc;
+  for (size_t i = 0; i < iter->second->GetInputsSize(); ++i) {
+    input_desc.emplace_back(iter->second->GetInputDesc(static_cast<uint32_t>(i)));
+  }
+  std::string shape_key = DynamicSingleOp::GetShapeKey(input_desc);
+
+  auto kernel_type = static_cast<cce::ccKernelType>(context.kernel_type());
+  if (kernel_type == cce::ccKernelType::AI_CPU) {
+    std::unique_ptr<AiCpuTask> aicpu_task(new (std::nothrow) AiCpuTask());
+    if (aicpu_task == nullptr) {
+      GELOGE(MEMALLOC_FAILED, "create aicpu op task failed");
+      return MEMALLOC_FAILED;
+    }
+    auto ret = aicpu_task->Init(kernel_def.so_name(), kernel_def.kernel_name(), kernel_def.args());
+    if (ret != SUCCESS) {
+      return ret;
+    }
+    single_op.aicpu_task_ = std::move(aicpu_task);
+    single_op.aicpu_shape_key_ = shape_key;
+    return SUCCESS;
+  }
+
+  if (kernel_type != cce::ccKernelType::TE) {
+    GELOGE(UNSUPPORTED, "Only TBE and AICPU kernel are supported, but got %u", context.kernel_type());
+    return UNSUPPORTED;
+  }
+
+  std::unique_ptr<TbeOpTask> tbe_task(new (std::nothrow) TbeOpTask());
+  if (tbe_task == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "create tbe op task failed");
+    return MEMALLOC_FAILED;
+  }
+  auto builder = TbeTaskBuilder(model_name_, iter->second, kernel_def);
+  auto ret = builder.BuildTask(*tbe_task, model_params_);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  GELOGI("[%s] cache tbe kernel %s for shape [%s]", model_name_.c_str(), tbe_task->GetStubName().c_str(),
+         shape_key.c_str());
+  single_op.tbe_tasks_[shape_key] = std::move(tbe_task);
+  return SUCCESS;
+}
+
+Status SingleOpModel::BuildDynamicTaskList(DynamicSingleOp &single_op) {
+  auto ge_model = model_helper_.GetGeModel();
+  GE_CHECK_NOTNULL(ge_model);
+  auto model_task_def = ge_model->GetModelTaskDefPtr();
+  GE_CHECK_NOTNULL(model_task_def);
+  auto tasks = model_task_def->task();
+  for (int i = 0; i < tasks.size(); ++i) {
+    const TaskDef &task_def = tasks[i];
+    auto task_type = static_cast<rtModelTaskType_t>(task_def.type());
+    if (task_type == RT_MODEL_TASK_KERNEL) {
+      auto ret = BuildDynamicKernelTask(task_def.kernel(), single_op);
+      if (ret != SUCCESS) {
+        return ret;
+      }
+    } else if (task_type == RT_MODEL_TASK_KERNEL_EX) {
+      GELOGD("BuildKernelExTask is not supported. modelName = %s", model_name_.c_str());
+      return UNSUPPORTED;
+    } else {
+      // skip
+      GELOGD("Skip task type: %d", static_cast<int>(task_type));
+    }
+  }
+
+  if (single_op.op_desc_ == nullptr) {
+    GELOGE(PARAM_INVALID, "[%s] no kernel task found", model_name_.c_str());
+    return PARAM_INVALID;
+  }
+  return SUCCESS;
+}
+
+Status SingleOpModel::BuildDynamicOp(StreamResource &resource, DynamicSingleOp &single_op) {
+  auto ret = InitModelMem(resource);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  ret = BuildDynamicTaskList(single_op);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  single_op.num_inputs_ = input_offset_list_.size();
+  single_op.num_outputs_ = output_offset_list_.size();
+  return SUCCESS;
+}
 }  // namespace ge
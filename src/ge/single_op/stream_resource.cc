@@ -19,6 +19,7 @@
 #include "common/ge_inner_error_codes.h"
 #include "framework/common/debug/ge_log.h"
 #include "framework/common/debug/log.h"
+#include "graph/manager/graph_mem_allocator.h"
 #include "runtime/rt.h"
 
 namespace ge {
@@ -29,19 +30,24 @@ StreamResource::~StreamResource() {
     it.second = nullptr;
   }
 
-  for (auto mem : memory_list_) {
-    if (mem != nullptr) {
-      auto rt_ret = rtFree(mem);
-      GE_IF_BOOL_EXEC(rt_ret != RT_ERROR_NONE, GELOGE(RT_FAILED, "rtFree failed"));
-    }
+  for (auto it : dynamic_op_map_) {
+    delete it.second;
+    it.second = nullptr;
   }
 
-  for (auto weight : weight_list_) {
-    if (weight != nullptr) {
-      auto rt_ret = rtFree(weight);
-      GE_IF_BOOL_EXEC(rt_ret != RT_ERROR_NONE, GELOGE(RT_FAILED, "rtFree failed"));
+  FreeMemory(memory_list_);
+  FreeMemory(weight_list_);
+}
+
+void StreamResource::FreeMemory(std::vector<uint8_t *> &allocated) {
+  CachingAllocator *caching_allocator = MemManager::CachingInstance(RT_MEMORY_HBM);
+  for (auto mem : allocated) {
+    if (mem != nullptr) {
+      auto ret = (caching_allocator == nullptr) ? FAILED : caching_allocator->Free(mem);
+      GE_IF_BOOL_EXEC(ret != SUCCESS, GELOGE(RT_FAILED, "Free memory failed"));
     }
   }
+  allocated.clear();
 }
 
 void StreamResource::CacheOperator(const void *key, SingleOp *single_op) {
@@ -57,24 +63,40 @@ SingleOp *StreamResource::GetOperator(const void *key) {
   return it->second;
 }
 
-uint8_t *StreamResource::DoMallocMemory(size_t size, size_t &max_allocated, std::vector<uint8_t *> &allocated) {
+void StreamResource::CacheDynamicOperator(const void *key, DynamicSingleOp *single_op) {
+  dynamic_op_map_[key] = single_op;
+}
+
+DynamicSingleOp *StreamResource::GetDynamicOperator(const void *key) {
+  auto it = dynamic_op_map_.find(key);
+  if (it == dynamic_op_map_.end()) {
+    return nullptr;
+  }
+
+  return it->second;
+}
+
+void StreamResource::SetStream(rtStream_t stream) { stream_ = stream; }
+
+uint8_t *StreamResource::DoMallocMemory(size_t size, size_t &max_allocated, std::vector<uint8_t *> &allocated,
+                                        rtStream_t stream) {
   if (size <= max_allocated && !allocated.empty()) {
     GELOGD("reuse last memory");
     return allocated.back();
   }
 
-  uint8_t *buffer = nullptr;
-  auto ret = rtMalloc(reinterpret_cast<void **>(&buffer), size, RT_MEMORY_HBM);
-  if (ret != RT_ERROR_NONE) {
-    GELOGE(RT_FAILED, "rtMalloc failed, size = %zu, ret = %d", size, ret);
+  CachingAllocator *caching_allocator = MemManager::CachingInstance(RT_MEMORY_HBM);
+  uint8_t *buffer = (caching_allocator == nullptr) ? nullptr : caching_allocator->Malloc(size, stream);
+  if (buffer == nullptr) {
+    GELOGE(RT_FAILED, "Malloc memory failed, size = %zu", size);
     return nullptr;
   }
 
-  ret = rtMemset(buffer, size, 0U, size);
+  auto ret = rtMemset(buffer, size, 0U, size);
   if (ret != RT_ERROR_NONE) {
     GELOGE(RT_FAILED, "rtMemset failed, ret = %d", ret);
-    auto rt_ret = rtFree(buffer);
-    GE_IF_BOOL_EXEC(rt_ret != RT_ERROR_NONE, GELOGE(RT_FAILED, "rtFree failed"));
+    auto free_ret = caching_allocator->Free(buffer);
+    GE_IF_BOOL_EXEC(free_ret != SUCCESS, GELOGE(RT_FAILED, "Free memory failed"));
     return nullptr;
   }
 
@@ -86,13 +108,13 @@ uint8_t *StreamResource::DoMallocMemory(size_t size, size_t &max_allocated, std:
 
 uint8_t *StreamResource::MallocMemory(size_t size) {
   GELOGD("To Malloc memory, size = %zu", size);
-  uint8_t *buffer = DoMallocMemory(size, max_memory_size_, memory_list_);
+  uint8_t *buffer = DoMallocMemory(size, max_memory_size_, memory_list_, stream_);
   return buffer;
 }
 
 uint8_t *StreamResource::MallocWeight(size_t size) {
   GELOGD("To Malloc weight, size = %zu", size);
-  uint8_t *buffer = DoMallocMemory(size, max_weight_size_, weight_list_);
+  uint8_t *buffer = DoMallocMemory(size, max_weight_size_, weight_list_, stream_);
   return buffer;
 }
 }  // namespace ge
@@ -41,17 +41,27 @@ class StreamResource {
 
   SingleOp *GetOperator(const void *key);
 
+  void CacheDynamicOperator(const void *key, DynamicSingleOp *single_op);
+
+  DynamicSingleOp *GetDynamicOperator(const void *key);
+
+  void SetStream(rtStream_t stream);
+
   uint8_t *MallocMemory(size_t size);
   uint8_t *MallocWeight(size_t size);
 
  private:
-  static uint8_t *DoMallocMemory(size_t size, size_t &max_allocated, std::vector<uint8_t *> &allocated);
+  static uint8_t *DoMallocMemory(size_t size, size_t &max_allocated, std::vector<uint8_t *> &allocated,
+                                 rtStream_t stream = nullptr);
+  static void FreeMemory(std::vector<uint8_t *> &allocated);
 
+  rtStream_t stream_ = nullptr;
   size_t max_memory_size_ = 0;
   size_t max_weight_size_ = 0;
   std::vector<uint8_t *> memory_list_;
   std::vector<uint8_t *> weight_list_;
   std::unordered_map<const void *, SingleOp *> op_map_;
+  std::unordered_map<const void *, DynamicSingleOp *> dynamic_op_map_;
 };
 }  // namespace ge
 
@@ -16,8 +16,11 @@
 
 #include "single_op/task/op_task.h"
 
+#include "aicpu/common/aicpu_task_struct.h"
 #include "runtime/rt.h"
 #include "framework/common/debug/ge_log.h"
+#include "graph/manager/graph_mem_allocator.h"
+#include "securec.h"
 
 namespace ge {
 void TbeOpTask::SetStubFunc(const std::string &name, const void *stub_func) {
@@ -71,4 +74,123 @@ Status TbeOpTask::LaunchKernel(rtStream_t stream) {
   GELOGD("Invoke rtKernelLaunch succeeded. task = %s", this->stub_name_.c_str());
   return SUCCESS;
 }
+
+Status TbeOpTask::UpdateIoAddr(const std::vector<void *> &io_addrs) {
+  // args: addr1, addr2, addr3 ...
+  if (args_ == nullptr || io_addrs.size() * sizeof(void *) > arg_size_) {
+    GELOGE(PARAM_INVALID, "Args of task %s can not hold %zu addresses, arg size = %zu", stub_name_.c_str(),
+           io_addrs.size(), arg_size_);
+    return PARAM_INVALID;
+  }
+
+  auto *args = reinterpret_cast<uintptr_t *>(args_);
+  for (size_t i = 0; i < io_addrs.size(); ++i) {
+    args[i] = reinterpret_cast<uintptr_t>(io_addrs[i]);
+  }
+  return SUCCESS;
+}
+
+AiCpuTask::~AiCpuTask() {
+  (void)WaitPendingLaunch();
+  if (args_ != nullptr) {
+    CachingAllocator *caching_allocator = MemManager::CachingInstance(RT_MEMORY_HBM);
+    if (caching_allocator == nullptr || caching_allocator->Free(reinterpret_cast<uint8_t *>(args_)) != SUCCESS) {
+      GELOGW("Free args of aicpu task %s failed.", kernel_name_.c_str());
+    }
+    args_ = nullptr;
+  }
+}
+
+Status AiCpuTask::Init(const std::string &so_name, const std::string &kernel_name, const std::string &args) {
+  if (args.size() < sizeof(aicpu::AicpuParamHead)) {
+    GELOGE(PARAM_INVALID, "Args size of aicpu task %s is invalid, size = %zu", kernel_name.c_str(), args.size());
+    return PARAM_INVALID;
+  }
+  so_name_ = so_name;
+  kernel_name_ = kernel_name;
+  arg_size_ = args.size();
+
+  host_args_.reset(new (std::nothrow) uint8_t[arg_size_]);
+  if (host_args_ == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "Malloc host args failed, size = %zu", arg_size_);
+    return MEMALLOC_FAILED;
+  }
+  errno_t sec_ret = memcpy_s(host_args_.get(), arg_size_, args.data(), arg_size_);
+  if (sec_ret != EOK) {
+    GELOGE(INTERNAL_ERROR, "memcpy failed, ret: %d", sec_ret);
+    return INTERNAL_ERROR;
+  }
+
+  CachingAllocator *caching_allocator = MemManager::CachingInstance(RT_MEMORY_HBM);
+  args_ = (caching_allocator == nullptr) ? nullptr : caching_allocator->Malloc(arg_size_);
+  if (args_ == nullptr) {
+    GELOGE(RT_FAILED, "Malloc args of aicpu task %s failed, size = %zu", kernel_name_.c_str(), arg_size_);
+    return RT_FAILED;
+  }
+  return SUCCESS;
+}
+
+Status AiCpuTask::UpdateIoAddr(const std::vector<void *> &io_addrs) {
+  if (host_args_ == nullptr) {
+    GELOGE(INTERNAL_ERROR, "Aicpu task %s is not initialized", kernel_name_.c_str());
+    return INTERNAL_ERROR;
+  }
+
+  // rtMemcpyAsync reads the pageable host_args_ when the stream gets to it, not when it is called
+  Status ret = WaitPendingLaunch();
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  // args: AicpuParamHead, addr1, addr2, addr3 ..., op def
+  size_t addrs_size = sizeof(uint64_t) * io_addrs.size();
+  if (sizeof(aicpu::AicpuParamHead) + addrs_size > arg_size_) {
+    GELOGE(PARAM_INVALID, "Args of aicpu task %s can not hold %zu addresses, arg size = %zu", kernel_name_.c_str(),
+           io_addrs.size(), arg_size_);
+    return PARAM_INVALID;
+  }
+  auto *io_addr = reinterpret_cast<uint64_t *>(host_args_.get() + sizeof(aicpu::AicpuParamHead));
+  for (size_t i = 0; i < io_addrs.size(); ++i) {
+    io_addr[i] = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(io_addrs[i]));
+  }
+  return SUCCESS;
+}
+
+Status AiCpuTask::WaitPendingLaunch() {
+  if (!launch_pending_) {
+    return SUCCESS;
+  }
+  auto ret = rtStreamSynchronize(pending_stream_);
+  launch_pending_ = false;
+  if (ret != RT_ERROR_NONE) {
+    GELOGE(RT_FAILED, "Invoke rtStreamSynchronize failed. ret = %d, task = %s", ret, kernel_name_.c_str());
+    return RT_FAILED;
+  }
+  return SUCCESS;
+}
+
+Status AiCpuTask::LaunchKernel(rtStream_t stream) {
+  // the copy is queued behind the previous launch of the kernel, which may still be reading the device args.
+  // host_args_ must stay untouched until the stream has done the copy, UpdateIoAddr waits for it
+  auto ret = rtMemcpyAsync(args_, arg_size_, host_args_.get(), arg_size_, RT_MEMCPY_HOST_TO_DEVICE, stream);
+  if (ret != RT_ERROR_NONE) {
+    GELOGE(RT_FAILED, "Invoke rtMemcpyAsync failed. ret = %d, task = %s", ret, kernel_name_.c_str());
+    return RT_FAILED;
+  }
+  launch_pending_ = true;
+  pending_stream_ = stream;
+
+  GELOGD("To invoke rtCpuKernelLaunch. task = %s", kernel_name_.c_str());
+  // blockDim is reserved parameter, set to 1
+  ret = rtCpuKernelLaunch(reinterpret_cast<const void *>(so_name_.c_str()),
+                               reinterpret_cast<const void *>(kernel_name_.c_str()), 1, args_,
+                               static_cast<uint32_t>(arg_size_), nullptr, stream);
+  if (ret != RT_ERROR_NONE) {
+    GELOGE(RT_FAILED, "Invoke rtCpuKernelLaunch failed. ret = %d, task = %s", ret, kernel_name_.c_str());
+    return RT_FAILED;
+  }
+
+  GELOGD("Invoke rtCpuKernelLaunch succeeded. task = %s", kernel_name_.c_str());
+  return SUCCESS;
+}
 }  // namespace ge
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "runtime/stream.h"
 #include "common/ge_inner_error_codes.h"
@@ -30,12 +31,16 @@ class OpTask {
   OpTask() = default;
   virtual ~OpTask() = default;
   virtual Status LaunchKernel(rtStream_t stream) = 0;
+
+  // write the addresses of inputs and outputs, in that order, into the kernel args
+  virtual Status UpdateIoAddr(const std::vector<void *> &io_addrs) = 0;
 };
 
 class TbeOpTask : public OpTask {
  public:
   ~TbeOpTask() override;
   Status LaunchKernel(rtStream_t stream) override;
+  Status UpdateIoAddr(const std::vector<void *> &io_addrs) override;
 
   void SetSmDesc(void *sm_desc);
   void SetStubFunc(const std::string &name, const void *stub_func);
@@ -52,6 +57,40 @@ class TbeOpTask : public OpTask {
   void *sm_desc_ = nullptr;
   std::string stub_name_;
 };
+
+class AiCpuTask : public OpTask {
+ public:
+  AiCpuTask() = default;
+  ~AiCpuTask() override;
+
+  ///
+  /// @ingroup ge
+  /// @brief keep a host copy of kernel args and malloc device memory for them
+  /// @param [in] so_name so which the kernel lives in
+  /// @param [in] kernel_name kernel name
+  /// @param [in] args kernel args, an AicpuParamHead followed by io addrs and the op def
+  /// @return Status result of function
+  ///
+  Status Init(const std::string &so_name, const std::string &kernel_name, const std::string &args);
+
+  Status LaunchKernel(rtStream_t stream) override;
+  Status UpdateIoAddr(const std::vector<void *> &io_addrs) override;
+
+  const std::string &GetKernelName() const { return kernel_name_; }
+
+ private:
+  Status WaitPendingLaunch();
+
+  std::string so_name_;
+  std::string kernel_name_;
+  // patched by UpdateIoAddr, copied to args_ on the stream of every launch
+  std::unique_ptr<uint8_t[]> host_args_;
+  void *args_ = nullptr;
+  size_t arg_size_ = 0;
+  // the copy of host_args_ queued by the last launch may not have been done yet, nullptr is the default stream
+  bool launch_pending_ = false;
+  rtStream_t pending_stream_ = nullptr;
+};
 }  // namespace ge
 
 #endif  // GE_SINGLE_OP_TASK_OP_TASK_H_
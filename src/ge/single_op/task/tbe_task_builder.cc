@@ -47,7 +47,7 @@ KernelHolder::KernelHolder(const char *stub_func, std::shared_ptr<ge::OpKernelBi
 
 KernelHolder::~KernelHolder() {
   if (bin_handle_ != nullptr) {
-    GE_CHK_RT(rtDevBinaryUnRegister(bin_handle_));
+    TBEHandleStore::GetInstance().UnRegisterBinary(bin_handle_);
   }
 }
 
@@ -59,7 +59,7 @@ KernelBinRegistry::~KernelBinRegistry() {
 }
 
 const char *KernelBinRegistry::GetUnique(const string &stub_func) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  WriteLockGuard lock(lock_);
   auto it = unique_stubs_.find(stub_func);
   if (it != unique_stubs_.end()) {
     return it->c_str();
@@ -70,7 +70,7 @@ const char *KernelBinRegistry::GetUnique(const string &stub_func) {
 }
 
 const char *KernelBinRegistry::GetStubFunc(const std::string &stub_name) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  ReadLockGuard lock(lock_);
   auto iter = registered_bins_.find(stub_name);
   if (iter != registered_bins_.end()) {
     return iter->second->stub_func_;
@@ -80,7 +80,7 @@ const char *KernelBinRegistry::GetStubFunc(const std::string &stub_name) {
 }
 
 bool KernelBinRegistry::AddKernel(const std::string &stub_name, const KernelHolder *holder) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  WriteLockGuard lock(lock_);
   auto ret = registered_bins_.emplace(stub_name, holder);
   return ret.second;
 }
@@ -89,35 +89,19 @@ TbeTaskBuilder::TbeTaskBuilder(const std::string &model_name, const OpDescPtr &o
                                const domi::KernelDef &kernel_def)
     : op_desc_(op_desc), kernel_def_(kernel_def), stub_name_(model_name + "/" + op_desc->GetName() + "_tvmbin") {}
 
-Status TbeTaskBuilder::DoRegisterBinary(const OpKernelBin &kernel_bin, void **bin_handle) const {
-  rtDevBinary_t binary;
-  binary.version = 0;
-  binary.data = kernel_bin.GetBinData();
-  binary.length = kernel_bin.GetBinDataSize();
-  binary.magic = RT_DEV_BINARY_MAGIC_ELF;
-  auto ret = rtDevBinaryRegister(&binary, bin_handle);
-  if (ret != RT_ERROR_NONE) {
-    GELOGE(RT_FAILED, "rtDevBinaryRegister failed, bin key = %s, rt ret = %d", stub_name_.c_str(),
-           static_cast<int>(ret));
-    return RT_FAILED;
-  }
-
-  return SUCCESS;
-}
-
-Status TbeTaskBuilder::DoRegisterMeta(void *bin_handle) {
+Status TbeTaskBuilder::DoRegisterBinary(const TBEKernelPtr &kernel_bin, void **bin_handle) const {
   std::string meta_data;
   (void)AttrUtils::GetStr(op_desc_, TVM_ATTR_NAME_METADATA, meta_data);
   GELOGI("TBE: meta data: %s", meta_data.empty() ? "null" : meta_data.c_str());
-  if (!meta_data.empty()) {
-    auto rt_ret = rtMetadataRegister(bin_handle, meta_data.c_str());
-    if (rt_ret != RT_ERROR_NONE) {
-      GELOGE(RT_FAILED, "rtMetadataRegister failed. bin key = %s, meta_data = %s, rt ret = %d", stub_name_.c_str(),
-             meta_data.c_str(), static_cast<int>(rt_ret));
-      return RT_FAILED;
-    }
+  // binaries identical to one registered by another model or op share its handle
+  void *handle = nullptr;
+  auto ret = TBEHandleStore::GetInstance().RegisterBinary(kernel_bin, RT_DEV_BINARY_MAGIC_ELF, meta_data, handle);
+  if (ret != SUCCESS) {
+    GELOGE(RT_FAILED, "Register binary failed, bin key = %s, ret = %u", stub_name_.c_str(), ret);
+    return RT_FAILED;
   }
 
+  *bin_handle = handle;
   return SUCCESS;
 }
 
@@ -132,7 +116,7 @@ Status TbeTaskBuilder::DoRegisterFunction(void *bin_handle, const char *stub_nam
   return SUCCESS;
 }
 
-Status TbeTaskBuilder::DoRegisterKernel(const ge::OpKernelBin &tbe_kernel, const char *bin_file_key,
+Status TbeTaskBuilder::DoRegisterKernel(const TBEKernelPtr &tbe_kernel, const char *bin_file_key,
                                         void **bin_handle) {
   std::string kernel_name;
   GetKernelName(op_desc_, kernel_name);
@@ -143,15 +127,9 @@ Status TbeTaskBuilder::DoRegisterKernel(const ge::OpKernelBin &tbe_kernel, const
     return ret;
   }
 
-  ret = DoRegisterMeta(handle);
-  if (ret != SUCCESS) {
-    GE_CHK_RT(rtDevBinaryUnRegister(handle));
-    return ret;
-  }
-
   ret = DoRegisterFunction(handle, bin_file_key, kernel_name.c_str());
   if (ret != SUCCESS) {
-    GE_CHK_RT(rtDevBinaryUnRegister(handle));
+    TBEHandleStore::GetInstance().UnRegisterBinary(handle);
     return ret;
   }
 
@@ -190,7 +168,7 @@ Status TbeTaskBuilder::RegisterKernel(TbeOpTask &task) {
     }
 
     void *bin_handle = nullptr;
-    auto ret = DoRegisterKernel(*tbe_kernel, stub_func, &bin_handle);
+    auto ret = DoRegisterKernel(tbe_kernel, stub_func, &bin_handle);
     if (ret == SUCCESS) {
       holder->SetBinHandle(bin_handle);
       if (!registry.AddKernel(stub_name_, holder)) {
@@ -23,6 +23,8 @@
 #include <set>
 #include <string>
 
+#include "common/tbe_kernel_store.h"
+#include "graph/load/new_model_manager/tbe_handle_store.h"
 #include "graph/op_desc.h"
 #include "single_op/single_op.h"
 #include "single_op/single_op_model.h"
@@ -58,9 +60,12 @@ class KernelBinRegistry {
   bool AddKernel(const std::string &stub_name, const KernelHolder *holder);
 
  private:
+  // holders release their binaries to TBEHandleStore, so the store is created first and destroyed last
+  KernelBinRegistry() { (void)TBEHandleStore::GetInstance(); }
+
   std::map<std::string, const KernelHolder *> registered_bins_;
   std::set<std::string> unique_stubs_;
-  std::mutex mutex_;
+  ReadWriteLock lock_;
 };
 
 class TbeTaskBuilder {
@@ -75,9 +80,8 @@ class TbeTaskBuilder {
   Status GetSmDesc(void **sm_desc, const SingleOpModelParam &param) const;
 
   Status RegisterKernel(TbeOpTask &task);
-  Status DoRegisterKernel(const OpKernelBin &kernel_bin, const char *bin_file_key, void **bin_handle);
-  Status DoRegisterBinary(const OpKernelBin &kernel_bin, void **bin_handle) const;
-  Status DoRegisterMeta(void *bin_handle);
+  Status DoRegisterKernel(const TBEKernelPtr &kernel_bin, const char *bin_file_key, void **bin_handle);
+  Status DoRegisterBinary(const TBEKernelPtr &kernel_bin, void **bin_handle) const;
 
   static Status DoRegisterFunction(void *bin_handle, const char *stub_name, const char *kernel_name);
 
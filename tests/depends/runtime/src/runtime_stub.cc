@@ -17,9 +17,64 @@
 #include <cce/dnn.h>
 #include <securec.h>
 
+#include <chrono>
+#include <thread>
+
+#include "runtime_stub.h"
+
 #define EVENT_LENTH 10
 
-rtError_t rtCtxSetCurrent(rtContext_t ctx) { return RT_ERROR_NONE; }
+namespace {
+const size_t kDefaultStubFreeMemory = 512UL * 1024UL * 1024UL;
+const size_t kDefaultStubTotalMemory = 1024UL * 1024UL * 1024UL;
+std::atomic<size_t> g_stub_free_memory{kDefaultStubFreeMemory};
+std::atomic<size_t> g_stub_total_memory{kDefaultStubTotalMemory};
+std::atomic<uint32_t> g_stub_model_execute_delay_us{0};
+std::atomic<int32_t> g_stub_model_execute_error{RT_ERROR_NONE};
+}  // namespace
+
+RuntimeStubCounters &GetRuntimeStubCounters() {
+  static RuntimeStubCounters counters;
+  return counters;
+}
+
+void ResetRuntimeStubCounters() {
+  RuntimeStubCounters &counters = GetRuntimeStubCounters();
+  counters.malloc_count = 0;
+  counters.free_count = 0;
+  counters.memcpy_count = 0;
+  counters.memcpy_async_count = 0;
+  counters.memcpy_async_bytes = 0;
+  counters.malloc_host_count = 0;
+  counters.free_host_count = 0;
+  counters.kernel_launch_count = 0;
+  counters.cpu_kernel_launch_count = 0;
+  counters.kernel_launch_ex_count = 0;
+  counters.bin_register_count = 0;
+  counters.bin_unregister_count = 0;
+  counters.ctx_set_current_count = 0;
+  counters.model_execute_count = 0;
+  counters.stream_synchronize_count = 0;
+  g_stub_free_memory = kDefaultStubFreeMemory;
+  g_stub_total_memory = kDefaultStubTotalMemory;
+  g_stub_model_execute_delay_us = 0;
+  g_stub_model_execute_error = RT_ERROR_NONE;
+}
+
+void SetRuntimeStubMemInfo(size_t free, size_t total) {
+  g_stub_free_memory = free;
+  g_stub_total_memory = total;
+}
+
+void SetRuntimeStubModelExecute(uint32_t delay_us, int32_t error) {
+  g_stub_model_execute_delay_us = delay_us;
+  g_stub_model_execute_error = error;
+}
+
+rtError_t rtCtxSetCurrent(rtContext_t ctx) {
+  GetRuntimeStubCounters().ctx_set_current_count++;
+  return RT_ERROR_NONE;
+}
 
 rtError_t rtGetStreamId(rtStream_t stream, int32_t *stream_id) {
   *stream_id = 0;
@@ -53,6 +108,7 @@ rtError_t rtEventDestroy(rtEvent_t event) {
 }
 
 rtError_t rtMalloc(void **dev_ptr, uint64_t size, rtMemType_t type) {
+  GetRuntimeStubCounters().malloc_count++;
   *dev_ptr = new uint8_t[size];
   return RT_ERROR_NONE;
 }
@@ -60,16 +116,19 @@ rtError_t rtMalloc(void **dev_ptr, uint64_t size, rtMemType_t type) {
 rtError_t rtMemset(void *dev_ptr, uint64_t dest_max, uint32_t value, uint64_t count) { return RT_ERROR_NONE; }
 
 rtError_t rtFree(void *dev_ptr) {
+  GetRuntimeStubCounters().free_count++;
   delete[](uint8_t *) dev_ptr;
   return RT_ERROR_NONE;
 }
 
 rtError_t rtMallocHost(void **host_ptr, uint64_t size) {
+  GetRuntimeStubCounters().malloc_host_count++;
   *host_ptr = new uint8_t[size];
   return RT_ERROR_NONE;
 }
 
 rtError_t rtFreeHost(void *host_ptr) {
+  GetRuntimeStubCounters().free_host_count++;
   delete[](uint8_t *) host_ptr;
   return RT_ERROR_NONE;
 }
@@ -88,9 +147,13 @@ rtError_t rtStreamDestroy(rtStream_t stream) {
 
 rtError_t rtSetDevice(int32_t device) { return RT_ERROR_NONE; }
 
-rtError_t rtStreamSynchronize(rtStream_t stream) { return RT_ERROR_NONE; }
+rtError_t rtStreamSynchronize(rtStream_t stream) {
+  GetRuntimeStubCounters().stream_synchronize_count++;
+  return RT_ERROR_NONE;
+}
 
 rtError_t rtMemcpy(void *dst, uint64_t dest_max, const void *src, uint64_t count, rtMemcpyKind_t kind) {
+  GetRuntimeStubCounters().memcpy_count++;
 #ifdef OTQT_UT
   if (dest_max == 12 && count == 12) {  // UTEST_kernelinfo_manager.all_success special treatment
     memcpy_s(dst, dest_max, src, count);
@@ -100,6 +163,8 @@ rtError_t rtMemcpy(void *dst, uint64_t dest_max, const void *src, uint64_t count
 }
 rtError_t rtMemcpyAsync(void *dst, uint64_t dest_max, const void *src, uint64_t count, rtMemcpyKind_t kind,
                         rtStream_t stream) {
+  GetRuntimeStubCounters().memcpy_async_count++;
+  GetRuntimeStubCounters().memcpy_async_bytes += count;
   return RT_ERROR_NONE;
 }
 
@@ -125,17 +190,29 @@ rtError_t rtFunctionRegister(void *bin_handle, const void *stub_func, const char
   return RT_ERROR_NONE;
 }
 
-rtError_t rtDevBinaryRegister(const rtDevBinary_t *bin, void **handle) { return RT_ERROR_NONE; }
+rtError_t rtDevBinaryRegister(const rtDevBinary_t *bin, void **handle) {
+  // fake handle, unique in the process and never dereferenced
+  static std::atomic<uintptr_t> next_handle{0x1000};
+  GetRuntimeStubCounters().bin_register_count++;
+  if (handle != nullptr) {
+    *handle = reinterpret_cast<void *>(next_handle++);
+  }
+  return RT_ERROR_NONE;
+}
 
 rtError_t rtKernelConfigTransArg(const void *ptr, uint64_t size, uint32_t flag, void **arg) { return RT_ERROR_NONE; }
 
 rtError_t rtKernelLaunch(const void *stub_func, uint32_t block_dim, void *args, uint32_t args_size, rtSmDesc_t *sm_desc,
                          rtStream_t stream) {
+  GetRuntimeStubCounters().kernel_launch_count++;
   return RT_ERROR_NONE;
 }
 rtError_t rtSetupArgument(const void *arg, uint32_t size, uint32_t offset) { return RT_ERROR_NONE; }
 rtError_t rtLaunch(const void *stub_func) { return RT_ERROR_NONE; }
-rtError_t rtDevBinaryUnRegister(void *handle) { return RT_ERROR_NONE; }
+rtError_t rtDevBinaryUnRegister(void *handle) {
+  GetRuntimeStubCounters().bin_unregister_count++;
+  return RT_ERROR_NONE;
+}
 rtError_t rtConfigureCall(uint32_t num_blocks, rtSmDesc_t *sm_desc, rtStream_t stream) { return RT_ERROR_NONE; }
 
 rtError_t rtSetProfDir(char *prof_dir) { return RT_ERROR_NONE; }
@@ -171,8 +248,8 @@ rtError_t rtKernelFusionStart(rtStream_t stream) { return RT_ERROR_NONE; }
 /// @return RT_ERROR_NONE for ok, errno for failed
 rtError_t rtKernelFusionEnd(rtStream_t stream) { return RT_ERROR_NONE; }
 rtError_t rtMemGetInfo(size_t *free, size_t *total) {
-  *free = 512UL * 1024UL * 1024UL;
-  *total = 1024UL * 1024UL * 1024UL;
+  *free = g_stub_free_memory;
+  *total = g_stub_total_memory;
   return RT_ERROR_NONE;
 }
 
@@ -195,7 +272,14 @@ rtError_t rtModelDestroy(rtModel_t model) {
 
 rtError_t rtModelBindStream(rtModel_t model, rtStream_t stream, uint32_t flag) { return RT_ERROR_NONE; }
 rtError_t rtModelUnbindStream(rtModel_t model, rtStream_t stream) { return RT_ERROR_NONE; }
-rtError_t rtModelExecute(rtModel_t model, rtStream_t stream, uint32_t flag) { return RT_ERROR_NONE; }
+rtError_t rtModelExecute(rtModel_t model, rtStream_t stream, uint32_t flag) {
+  GetRuntimeStubCounters().model_execute_count++;
+  uint32_t delay_us = g_stub_model_execute_delay_us;
+  if (delay_us != 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+  }
+  return static_cast<rtError_t>(g_stub_model_execute_error.load());
+}
 
 rtError_t rtGetFunctionByName(const char *stub_name, void **stub_func) {
   *(char **)stub_func = "func";
@@ -206,10 +290,14 @@ rtError_t rtQueryFunctionRegistered(const char *stub_name) { return RT_ERROR_NON
 
 rtError_t rtCtxCreate(rtContext_t *ctx, uint32_t flags, int32_t device) { return RT_ERROR_NONE; }
 
-rtError_t rtKernelLaunchEx(void *args, uint32_t args_size, uint32_t flags, rtStream_t stream_) { return RT_ERROR_NONE; }
+rtError_t rtKernelLaunchEx(void *args, uint32_t args_size, uint32_t flags, rtStream_t stream_) {
+  GetRuntimeStubCounters().kernel_launch_ex_count++;
+  return RT_ERROR_NONE;
+}
 
 rtError_t rtCpuKernelLaunch(const void *so_name, const void *kernel_name, uint32_t block_dim, const void *args,
                             uint32_t args_size, rtSmDesc_t *sm_desc, rtStream_t stream) {
+  GetRuntimeStubCounters().cpu_kernel_launch_count++;
   return RT_ERROR_NONE;
 }
 
@@ -274,6 +362,11 @@ rtError_t rtEventReset(rtEvent_t event, rtStream_t stream) { return RT_ERROR_NON
 
 rtError_t rtGetDevice(int32_t *device) { return RT_ERROR_NONE; }
 
+rtError_t rtGetDeviceIndexByPhyId(uint32_t phy_id, uint32_t *dev_index) {
+  *dev_index = phy_id;
+  return RT_ERROR_NONE;
+}
+
 rtError_t rtDatadumpInfoLoad(const void *dump_info, uint32_t length) { return RT_ERROR_NONE; }
 
 rtError_t rtKernelLaunchWithFlag(const void *stub_func, uint32_t block_dim, void *args, uint32_t args_size,
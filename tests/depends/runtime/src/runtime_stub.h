@@ -0,0 +1,53 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TESTS_DEPENDS_RUNTIME_SRC_RUNTIME_STUB_H_
+#define TESTS_DEPENDS_RUNTIME_SRC_RUNTIME_STUB_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// call counters of the runtime stub, tests reset them before the code under test runs
+struct RuntimeStubCounters {
+  std::atomic<uint64_t> malloc_count{0};
+  std::atomic<uint64_t> free_count{0};
+  std::atomic<uint64_t> memcpy_count{0};
+  std::atomic<uint64_t> memcpy_async_count{0};
+  std::atomic<uint64_t> memcpy_async_bytes{0};
+  std::atomic<uint64_t> malloc_host_count{0};
+  std::atomic<uint64_t> free_host_count{0};
+  std::atomic<uint64_t> kernel_launch_count{0};
+  std::atomic<uint64_t> cpu_kernel_launch_count{0};
+  std::atomic<uint64_t> kernel_launch_ex_count{0};
+  std::atomic<uint64_t> bin_register_count{0};
+  std::atomic<uint64_t> bin_unregister_count{0};
+  std::atomic<uint64_t> ctx_set_current_count{0};
+  std::atomic<uint64_t> model_execute_count{0};
+  std::atomic<uint64_t> stream_synchronize_count{0};
+};
+
+RuntimeStubCounters &GetRuntimeStubCounters();
+
+void ResetRuntimeStubCounters();
+
+// fake device memory reported by rtMemGetInfo, ResetRuntimeStubCounters restores 512M free of 1G total
+void SetRuntimeStubMemInfo(size_t free, size_t total);
+
+// rtModelExecute sleeps delay_us and returns error, ResetRuntimeStubCounters restores no delay and no error
+void SetRuntimeStubModelExecute(uint32_t delay_us, int32_t error);
+
+#endif  // TESTS_DEPENDS_RUNTIME_SRC_RUNTIME_STUB_H_
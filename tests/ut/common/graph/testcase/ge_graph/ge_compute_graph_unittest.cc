@@ -0,0 +1,203 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "external/graph/operator.h"
+#include "graph/compute_graph.h"
+#include "graph/op_desc.h"
+#include "graph_builder_utils.h"
+
+using namespace std;
+using namespace ge;
+
+namespace {
+// Data is registered with its IR names in this binary, a stand-in source keeps the names given by GraphBuilder
+const char *const kDataStubType = "DataStub";
+}  // namespace
+
+class UtestGeComputeGraph : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+
+  // source node keeps its output as it is
+  void SetSourceInferFunc(const NodePtr &node) {
+    auto counter = infer_count_;
+    node->GetOpDesc()->AddInferFunc([counter](Operator &op) {
+      (*counter)++;
+      return GRAPH_SUCCESS;
+    });
+  }
+
+  // output 0 is the same as input 0
+  void SetForwardInferFunc(const NodePtr &node) {
+    auto counter = infer_count_;
+    node->GetOpDesc()->AddInferFunc([counter](Operator &op) {
+      (*counter)++;
+      return op.UpdateOutputDesc("0", op.GetInputDesc(0));
+    });
+  }
+
+  // output 0 keeps the same shape whatever the input is, like a reshape to a const shape
+  void SetFixedInferFunc(const NodePtr &node) {
+    auto counter = infer_count_;
+    node->GetOpDesc()->AddInferFunc([counter](Operator &op) {
+      (*counter)++;
+      TensorDesc tensor_desc = op.GetInputDesc(0);
+      tensor_desc.SetShape(Shape(vector<int64_t>{1, 1, 224, 224}));
+      return op.UpdateOutputDesc("0", tensor_desc);
+    });
+  }
+
+  static void SetDataShape(const NodePtr &data, const vector<int64_t> &dims) {
+    GeTensorDesc tensor_desc = data->GetOpDesc()->GetOutputDesc(0);
+    tensor_desc.SetShape(GeShape(dims));
+    EXPECT_EQ(data->GetOpDesc()->UpdateOutputDesc(0, tensor_desc), GRAPH_SUCCESS);
+  }
+
+  static vector<int64_t> GetOutputDims(const NodePtr &node) {
+    return node->GetOpDesc()->GetOutputDesc(0).GetShape().GetDims();
+  }
+
+  shared_ptr<int> infer_count_ = make_shared<int>(0);
+};
+
+TEST_F(UtestGeComputeGraph, infer_shape_incremental_deep_chain) {
+  const int chain_len = 100;
+  ut::GraphBuilder builder("deep_chain");
+  auto data = builder.AddNode("data", kDataStubType, 0, 1);
+  SetSourceInferFunc(data);
+  auto prev = data;
+  // the chain is cut in the middle by a node with const output shape
+  NodePtr middle;
+  NodePtr last;
+  for (int i = 0; i < chain_len; ++i) {
+    auto node = builder.AddNode("relu" + to_string(i), "Relu", 1, 1);
+    if (i == chain_len / 2) {
+      SetFixedInferFunc(node);
+      middle = node;
+    } else {
+      SetForwardInferFunc(node);
+    }
+    builder.AddDataEdge(prev, 0, node, 0);
+    prev = node;
+    last = node;
+  }
+  auto graph = builder.GetGraph();
+
+  // nothing is dirty
+  EXPECT_EQ(graph->InferShapeIncremental({}), GRAPH_SUCCESS);
+  EXPECT_EQ(*infer_count_, 0);
+
+  // data and the chain before the const shape node
+  SetDataShape(data, {8, 1, 224, 224});
+  EXPECT_EQ(graph->InferShapeIncremental({}), GRAPH_SUCCESS);
+  EXPECT_EQ(*infer_count_, 1 + chain_len / 2 + 1);
+  EXPECT_EQ(middle->GetOpDesc()->GetInputDesc(0).GetShape().GetDims(), (vector<int64_t>{8, 1, 224, 224}));
+  EXPECT_EQ(GetOutputDims(middle), (vector<int64_t>{1, 1, 224, 224}));
+  EXPECT_EQ(GetOutputDims(last), (vector<int64_t>{1, 1, 224, 224}));
+  EXPECT_FALSE(data->GetOpDesc()->IsInferDirty());
+  EXPECT_FALSE(middle->GetOpDesc()->IsInferDirty());
+
+  // seed with unchanged shape only infers itself
+  *infer_count_ = 0;
+  EXPECT_EQ(graph->InferShapeIncremental({data}), GRAPH_SUCCESS);
+  EXPECT_EQ(*infer_count_, 1);
+
+  // seed after the const shape node runs to the end of chain
+  *infer_count_ = 0;
+  auto after_middle = middle->GetOutDataNodes().at(0);
+  GeTensorDesc tensor_desc = after_middle->GetOpDesc()->GetInputDesc(0);
+  tensor_desc.SetShape(GeShape(vector<int64_t>{2, 2}));
+  EXPECT_EQ(after_middle->GetOpDesc()->UpdateInputDesc(0, tensor_desc), GRAPH_SUCCESS);
+  EXPECT_EQ(graph->InferShapeIncremental({}), GRAPH_SUCCESS);
+  EXPECT_EQ(*infer_count_, chain_len - chain_len / 2 - 1);
+  EXPECT_EQ(GetOutputDims(last), (vector<int64_t>{2, 2}));
+}
+
+TEST_F(UtestGeComputeGraph, infer_shape_incremental_wide_fan_out) {
+  const int fan_out = 200;
+  ut::GraphBuilder builder("wide_fan_out");
+  auto data = builder.AddNode("data", kDataStubType, 0, 1);
+  SetSourceInferFunc(data);
+  auto other_data = builder.AddNode("other_data", kDataStubType, 0, 1);
+  SetSourceInferFunc(other_data);
+  vector<NodePtr> sinks;
+  for (int i = 0; i < fan_out; ++i) {
+    auto branch = builder.AddNode("branch" + to_string(i), "Relu", 1, 1);
+    // half of the branches drop the input shape
+    if (i % 2 == 0) {
+      SetForwardInferFunc(branch);
+    } else {
+      SetFixedInferFunc(branch);
+    }
+    builder.AddDataEdge(data, 0, branch, 0);
+    auto sink = builder.AddNode("sink" + to_string(i), "Relu", 1, 1);
+    SetForwardInferFunc(sink);
+    builder.AddDataEdge(branch, 0, sink, 0);
+    sinks.emplace_back(sink);
+  }
+  auto other_branch = builder.AddNode("other_branch", "Relu", 1, 1);
+  SetForwardInferFunc(other_branch);
+  builder.AddDataEdge(other_data, 0, other_branch, 0);
+  auto graph = builder.GetGraph();
+
+  SetDataShape(data, {4, 1, 224, 224});
+  EXPECT_EQ(graph->InferShapeIncremental({}), GRAPH_SUCCESS);
+  // data, all branches and the sinks of forwarding branches, nothing under other_data
+  EXPECT_EQ(*infer_count_, 1 + fan_out + fan_out / 2);
+  EXPECT_EQ(GetOutputDims(sinks[0]), (vector<int64_t>{4, 1, 224, 224}));
+  EXPECT_EQ(GetOutputDims(sinks[1]), (vector<int64_t>{1, 1, 224, 224}));
+
+  *infer_count_ = 0;
+  EXPECT_EQ(graph->InferShapeIncremental({other_data}), GRAPH_SUCCESS);
+  EXPECT_EQ(*infer_count_, 1);
+}
+
+TEST_F(UtestGeComputeGraph, infer_shape_incremental_invalid_seed) {
+  ut::GraphBuilder builder("graph");
+  auto data = builder.AddNode("data", kDataStubType, 0, 1);
+  auto graph = builder.GetGraph();
+  ut::GraphBuilder other_builder("other_graph");
+  auto other_data = other_builder.AddNode("data", kDataStubType, 0, 1);
+  EXPECT_EQ(graph->InferShapeIncremental({other_data}), GRAPH_PARAM_INVALID);
+  EXPECT_EQ(graph->InferShapeIncremental({nullptr}), GRAPH_PARAM_INVALID);
+}
+
+TEST_F(UtestGeComputeGraph, update_desc_marks_infer_dirty) {
+  auto op_desc = make_shared<OpDesc>("relu", "Relu");
+  GeTensorDesc tensor_desc(GeShape(vector<int64_t>{1, 2}), FORMAT_ND, DT_FLOAT);
+  op_desc->AddInputDesc("x", tensor_desc);
+  op_desc->AddOutputDesc("y", tensor_desc);
+  EXPECT_FALSE(op_desc->IsInferDirty());
+
+  EXPECT_EQ(op_desc->UpdateInputDesc("x", tensor_desc), GRAPH_SUCCESS);
+  EXPECT_FALSE(op_desc->IsInferDirty());
+  tensor_desc.SetDataType(DT_FLOAT16);
+  EXPECT_EQ(op_desc->UpdateInputDesc("x", tensor_desc), GRAPH_SUCCESS);
+  EXPECT_TRUE(op_desc->IsInferDirty());
+
+  op_desc->SetInferDirty(false);
+  tensor_desc.SetShape(GeShape(vector<int64_t>{3}));
+  EXPECT_EQ(op_desc->UpdateOutputDesc(0, tensor_desc), GRAPH_SUCCESS);
+  EXPECT_TRUE(op_desc->IsInferDirty());
+}
@@ -0,0 +1,205 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <dirent.h>
+#include <unistd.h>
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "graph/compute_graph.h"
+#include "graph/ge_local_context.h"
+#include "graph/utils/graph_utils.h"
+#include "graph_builder_utils.h"
+#include "proto/ge_ir.pb.h"
+
+namespace ge {
+namespace {
+const int kNodeNum = 2000;
+const int kDumpTimes = 10;
+
+ComputeGraphPtr BuildChainGraph() {
+  ut::GraphBuilder builder("dump_graph");
+  auto pre_node = builder.AddNode("data", "Data", 1, 1);
+  for (int i = 0; i < kNodeNum; ++i) {
+    auto node = builder.AddNode("relu_" + std::to_string(i), "Relu", 1, 1);
+    builder.AddDataEdge(pre_node, 0, node, 0);
+    pre_node = node;
+  }
+  return builder.GetGraph();
+}
+
+// the files named like prefix_*_suffix.ext in the current directory
+std::vector<std::string> FindDumpFiles(const std::string &prefix, const std::string &suffix_ext) {
+  std::vector<std::string> files;
+  DIR *dir = opendir(".");
+  if (dir == nullptr) {
+    return files;
+  }
+  struct dirent *entry = nullptr;
+  while ((entry = readdir(dir)) != nullptr) {
+    std::string name = entry->d_name;
+    if (name.compare(0, prefix.size(), prefix) == 0 && name.size() > suffix_ext.size() &&
+        name.compare(name.size() - suffix_ext.size(), suffix_ext.size(), suffix_ext) == 0) {
+      files.emplace_back(name);
+    }
+  }
+  closedir(dir);
+  return files;
+}
+
+void DumpTimes(const ComputeGraphPtr &graph, const std::string &suffix, int times = kDumpTimes) {
+  for (int i = 0; i < times; ++i) {
+    GraphUtils::DumpGEGraph(graph, suffix);
+  }
+}
+
+std::string ReadFile(const std::string &file) {
+  std::ifstream fs(file);
+  std::stringstream buffer;
+  buffer << fs.rdbuf();
+  return buffer.str();
+}
+
+// the index in the file named like ge_proto_00001_suffix.txt
+int GetFileIndex(const std::string &file) { return std::atoi(file.substr(std::string("ge_proto_").size()).c_str()); }
+}  // namespace
+
+class UtestGraphDumper : public testing::Test {
+ protected:
+  void SetUp() {
+    ASSERT_NE(getcwd(origin_dir_, PATH_MAX), nullptr);
+    char dump_dir[] = "/tmp/ge_graph_dumper_XXXXXX";
+    ASSERT_NE(mkdtemp(dump_dir), nullptr);
+    dump_dir_ = dump_dir;
+    ASSERT_EQ(chdir(dump_dir_.c_str()), 0);
+    setenv("DUMP_GE_GRAPH", "1", 1);
+    unsetenv("DUMP_GRAPH_LEVEL");
+    unsetenv("DUMP_GRAPH_MODE");
+    unsetenv("DUMP_GRAPH_FORMAT");
+  }
+
+  void TearDown() {
+    GraphUtils::FlushDumpGraph();
+    unsetenv("DUMP_GE_GRAPH");
+    unsetenv("DUMP_GRAPH_MODE");
+    unsetenv("DUMP_GRAPH_FORMAT");
+    for (const auto &file : FindDumpFiles("ge_", "")) {
+      (void)std::remove(file.c_str());
+    }
+    (void)chdir(origin_dir_);
+    (void)rmdir(dump_dir_.c_str());
+  }
+
+  char origin_dir_[PATH_MAX] = {0};
+  std::string dump_dir_;
+};
+
+TEST_F(UtestGraphDumper, async_dump_same_as_sync) {
+  auto graph = BuildChainGraph();
+  setenv("DUMP_GRAPH_MODE", "sync", 1);
+  DumpTimes(graph, "DumperSync");
+  // written before the dump returns
+  auto sync_files = FindDumpFiles("ge_proto_", "_DumperSync.txt");
+  ASSERT_EQ(sync_files.size(), kDumpTimes);
+
+  unsetenv("DUMP_GRAPH_MODE");
+  DumpTimes(graph, "DumperAsync");
+  GraphUtils::FlushDumpGraph();
+  auto files = FindDumpFiles("ge_proto_", "_DumperAsync.txt");
+  ASSERT_EQ(files.size(), kDumpTimes);
+  std::string sync_content = ReadFile(sync_files[0]);
+  EXPECT_FALSE(sync_content.empty());
+  for (const auto &file : files) {
+    EXPECT_EQ(ReadFile(file), sync_content);
+    ComputeGraph dumped_graph("");
+    ASSERT_TRUE(GraphUtils::LoadGEGraph(file.c_str(), dumped_graph));
+    EXPECT_EQ(dumped_graph.GetDirectNodesSize(), kNodeNum + 1);
+  }
+}
+
+TEST_F(UtestGraphDumper, dump_binary_format) {
+  auto graph = BuildChainGraph();
+  setenv("DUMP_GRAPH_FORMAT", "binary", 1);
+  GraphUtils::DumpGEGraph(graph, "DumperBinary");
+  GraphUtils::FlushDumpGraph();
+
+  auto files = FindDumpFiles("ge_proto_", "_DumperBinary.pb");
+  ASSERT_EQ(files.size(), 1);
+  std::ifstream fs(files[0], std::ifstream::in | std::ifstream::binary);
+  proto::ModelDef model_def;
+  ASSERT_TRUE(model_def.ParseFromIstream(&fs));
+  ASSERT_EQ(model_def.graph_size(), 1);
+  EXPECT_EQ(model_def.graph(0).op_size(), kNodeNum + 1);
+}
+
+TEST_F(UtestGraphDumper, dump_onnx) {
+  auto graph = BuildChainGraph();
+  GraphUtils::DumpGEGraphToOnnx(*graph, "DumperOnnx");
+  GraphUtils::FlushDumpGraph();
+
+  auto files = FindDumpFiles("ge_onnx_", "_DumperOnnx.pbtxt");
+  ASSERT_EQ(files.size(), 1);
+  ComputeGraph dumped_graph("");
+  ASSERT_TRUE(GraphUtils::LoadGEGraphFromOnnx(files[0].c_str(), dumped_graph));
+  EXPECT_EQ(dumped_graph.GetDirectNodesSize(), kNodeNum + 1);
+}
+
+TEST_F(UtestGraphDumper, remove_file_over_max_size) {
+  auto graph = BuildChainGraph();
+  // the option is thread local, it takes effect on the writer thread as well
+  GetThreadLocalContext().SetSessionOption({{"ge.maxDumpFileSize", "100"}});
+  GraphUtils::DumpGEGraph(graph, "DumperMaxSize");
+  GraphUtils::FlushDumpGraph();
+  GetThreadLocalContext().SetSessionOption({});
+  EXPECT_TRUE(FindDumpFiles("ge_proto_", "_DumperMaxSize.txt").empty());
+}
+
+TEST_F(UtestGraphDumper, stop_dump_over_max_file_num) {
+  auto graph = BuildChainGraph();
+  // the file index is counted for the process, find where it is
+  GraphUtils::DumpGEGraph(graph, "DumperMaxNumStart");
+  GraphUtils::FlushDumpGraph();
+  auto start_files = FindDumpFiles("ge_proto_", "_DumperMaxNumStart.txt");
+  ASSERT_EQ(start_files.size(), 1);
+  int start_index = GetFileIndex(start_files[0]);
+
+  const int max_file_num = start_index + 2;
+  GetThreadLocalContext().SetSessionOption({{"ge.maxDumpFileNum", std::to_string(max_file_num)}});
+  DumpTimes(graph, "DumperMaxNum", 4);
+  GraphUtils::FlushDumpGraph();
+  auto files = FindDumpFiles("ge_proto_", "_DumperMaxNum.txt");
+  std::sort(files.begin(), files.end());
+  ASSERT_EQ(files.size(), 2);
+  EXPECT_EQ(GetFileIndex(files[0]), start_index + 1);
+  EXPECT_EQ(GetFileIndex(files[1]), max_file_num);
+
+  // the limit is read on each dump, the files are written again without it
+  GetThreadLocalContext().SetSessionOption({});
+  GraphUtils::DumpGEGraph(graph, "DumperMaxNumEnd");
+  GraphUtils::FlushDumpGraph();
+  auto end_files = FindDumpFiles("ge_proto_", "_DumperMaxNumEnd.txt");
+  ASSERT_EQ(end_files.size(), 1);
+  EXPECT_EQ(GetFileIndex(end_files[0]), start_index + 5);
+}
+}  // namespace ge
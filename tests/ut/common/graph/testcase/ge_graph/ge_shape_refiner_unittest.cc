@@ -0,0 +1,200 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "external/graph/operator.h"
+#include "graph/operator_factory_impl.h"
+#include "graph/shape_refiner.h"
+#include "graph_builder_utils.h"
+
+using namespace std;
+using namespace ge;
+
+namespace {
+const char *const kDataStubType = "DataStub";
+const size_t kLargeNodeNum = 2000;
+
+// types of the large graph and their input numbers
+const vector<pair<string, int>> kStubOpTypes = {
+    {"RefinerConv2D", 2}, {"RefinerRelu", 1}, {"RefinerAdd", 2}, {"RefinerBiasAdd", 2}, {"RefinerCast", 1}};
+
+atomic<int> stub_op_created(0);
+
+// operator carrying its infer func itself, so that it is only found through the factory
+class StubOp : public Operator {
+ public:
+  StubOp(const string &name, const string &type, int input_num) : Operator(name, type) {
+    for (int i = 0; i < input_num; ++i) {
+      InputRegister("x" + to_string(i));
+    }
+    OutputRegister("y");
+    AttrRegister("data_format", string("NCHW"));
+    AttrRegister("strides", vector<int64_t>{1, 1, 1, 1});
+    AttrRegister("pads", vector<int64_t>{0, 0, 0, 0});
+    AttrRegister("alpha", 1.0f);
+    InferFuncRegister([](Operator &op) { return op.UpdateOutputDesc("y", op.GetInputDesc(0)); });
+    VerifierFuncRegister([](Operator &op) { return GRAPH_SUCCESS; });
+    stub_op_created++;
+  }
+};
+
+void RegisterStubOps() {
+  for (const auto &op_type : kStubOpTypes) {
+    auto type = op_type.first;
+    auto input_num = op_type.second;
+    // registered by a former test case of this binary if failed
+    (void)OperatorFactoryImpl::RegisterOperatorCreator(
+        type, [type, input_num](const string &name) { return StubOp(name, type, input_num); });
+  }
+}
+}  // namespace
+
+class UtestGeShapeRefiner : public testing::Test {
+ protected:
+  void SetUp() {
+    RegisterStubOps();
+    ShapeRefiner::ClearOpTypeFuncs();
+    stub_op_created = 0;
+  }
+
+  void TearDown() { ShapeRefiner::ClearOpTypeFuncs(); }
+
+  static NodePtr AddSource(ut::GraphBuilder &builder, const string &name) {
+    auto data = builder.AddNode(name, kDataStubType, 0, 1);
+    data->GetOpDesc()->AddInferFunc([](Operator &op) { return GRAPH_SUCCESS; });
+    return data;
+  }
+
+  // layered graph of stub ops, inputs come from recent nodes
+  static ComputeGraphPtr CreateStubOpGraph(const string &name, size_t node_num) {
+    ut::GraphBuilder builder(name);
+    vector<NodePtr> nodes;
+    nodes.emplace_back(AddSource(builder, "data"));
+    for (size_t i = 1; i < node_num; ++i) {
+      const auto &op_type = kStubOpTypes[i % kStubOpTypes.size()];
+      auto node = builder.AddNode(op_type.first + to_string(i), op_type.first, op_type.second, 1);
+      for (int j = 0; j < op_type.second; ++j) {
+        size_t src = (i > static_cast<size_t>(j) + 1) ? (i - 1 - j) : 0;
+        builder.AddDataEdge(nodes[src], 0, node, j);
+      }
+      nodes.emplace_back(node);
+    }
+    return builder.GetGraph();
+  }
+
+  static graphStatus InferGraph(const ComputeGraphPtr &graph, bool clear_per_node) {
+    for (const auto &node : graph->GetDirectNode()) {
+      if (clear_per_node) {
+        ShapeRefiner::ClearOpTypeFuncs();
+      }
+      auto ret = ShapeRefiner::InferShapeAndType(node);
+      if (ret != GRAPH_SUCCESS) {
+        return ret;
+      }
+    }
+    return GRAPH_SUCCESS;
+  }
+};
+
+TEST_F(UtestGeShapeRefiner, op_type_funcs_created_once) {
+  ut::GraphBuilder builder("graph");
+  auto data = AddSource(builder, "data");
+  auto prev = data;
+  for (int i = 0; i < 3; ++i) {
+    auto relu = builder.AddNode("relu" + to_string(i), "RefinerRelu", 1, 1);
+    builder.AddDataEdge(prev, 0, relu, 0);
+    prev = relu;
+  }
+  auto graph = builder.GetGraph();
+  GeTensorDesc tensor_desc = data->GetOpDesc()->GetOutputDesc(0);
+  tensor_desc.SetShape(GeShape(vector<int64_t>{8, 3, 16, 16}));
+  EXPECT_EQ(data->GetOpDesc()->UpdateOutputDesc(0, tensor_desc), GRAPH_SUCCESS);
+
+  EXPECT_EQ(InferGraph(graph, false), GRAPH_SUCCESS);
+  EXPECT_EQ(stub_op_created, 1);
+  EXPECT_EQ(prev->GetOpDesc()->GetOutputDesc(0).GetShape().GetDims(), (vector<int64_t>{8, 3, 16, 16}));
+  EXPECT_EQ(prev->GetOpDesc()->GetInputNameByIndex(0), "x0");
+  EXPECT_NE(prev->GetOpDesc()->GetVerifyFunc(), nullptr);
+
+  // funcs are bound to the nodes, the second run does not touch the factory
+  EXPECT_EQ(InferGraph(graph, false), GRAPH_SUCCESS);
+  EXPECT_EQ(stub_op_created, 1);
+}
+
+TEST_F(UtestGeShapeRefiner, unregistered_type_not_cached) {
+  EXPECT_EQ(ShapeRefiner::GetOpTypeFuncs("RefinerNotRegistered"), nullptr);
+  auto funcs = ShapeRefiner::GetOpTypeFuncs("RefinerConv2D");
+  ASSERT_NE(funcs, nullptr);
+  EXPECT_EQ(funcs->input_name_idx.size(), 2);
+  EXPECT_EQ(funcs->output_name_idx.size(), 1);
+  EXPECT_NE(funcs->infer_func, nullptr);
+  EXPECT_EQ(ShapeRefiner::GetOpTypeFuncs("RefinerConv2D"), funcs);
+  EXPECT_EQ(stub_op_created, 1);
+}
+
+TEST_F(UtestGeShapeRefiner, op_type_funcs_shared_by_threads) {
+  const int thread_num = 4;
+  vector<vector<OpTypeFuncsPtr>> results(thread_num);
+  vector<thread> threads;
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&results, i]() {
+      for (int round = 0; round < 100; ++round) {
+        for (const auto &op_type : kStubOpTypes) {
+          results[i].emplace_back(ShapeRefiner::GetOpTypeFuncs(op_type.first));
+        }
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  // all threads see the kept one, even if several of them created the type meanwhile
+  for (int i = 0; i < thread_num; ++i) {
+    for (size_t j = 0; j < results[i].size(); ++j) {
+      EXPECT_EQ(results[i][j], ShapeRefiner::GetOpTypeFuncs(kStubOpTypes[j % kStubOpTypes.size()].first));
+    }
+  }
+  EXPECT_LE(stub_op_created, thread_num * static_cast<int>(kStubOpTypes.size()));
+}
+
+TEST_F(UtestGeShapeRefiner, infer_2k_nodes_creates_operator_per_type) {
+  auto uncached_graph = CreateStubOpGraph("uncached_graph", kLargeNodeNum);
+  auto cached_graph = CreateStubOpGraph("cached_graph", kLargeNodeNum);
+
+  // clearing the table before each node creates an operator per node, as it was done before the table
+  EXPECT_EQ(InferGraph(uncached_graph, true), GRAPH_SUCCESS);
+  int uncached_created = stub_op_created;
+  ShapeRefiner::ClearOpTypeFuncs();
+  stub_op_created = 0;
+  EXPECT_EQ(InferGraph(cached_graph, false), GRAPH_SUCCESS);
+  int cached_created = stub_op_created;
+
+  EXPECT_EQ(uncached_created, kLargeNodeNum - 1);
+  EXPECT_EQ(cached_created, kStubOpTypes.size());
+  auto uncached_nodes = uncached_graph->GetDirectNode();
+  auto cached_nodes = cached_graph->GetDirectNode();
+  ASSERT_EQ(uncached_nodes.size(), cached_nodes.size());
+  for (size_t i = 0; i < cached_nodes.size(); ++i) {
+    EXPECT_EQ(uncached_nodes.at(i)->GetOpDesc()->GetOutputDesc(0).GetShape().GetDims(),
+              cached_nodes.at(i)->GetOpDesc()->GetOutputDesc(0).GetShape().GetDims());
+  }
+}
@@ -0,0 +1,221 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark_graphs.h"
+
+#include <random>
+#include <vector>
+
+#include "framework/common/types.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/ge_tensor.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/type_utils.h"
+
+namespace ge {
+namespace benchmark {
+namespace {
+const int64_t kImageChannel = 64;
+const int64_t kImageSize = 56;
+const int64_t kKernelSize = 3;
+const int64_t kSeqLen = 128;
+const int64_t kHiddenSize = 256;
+const int64_t kFfnSize = 1024;
+const int kMixedEngineWidth = 16;
+const uint32_t kMixedEngineSeed = 2020;
+
+class GraphMaker {
+ public:
+  explicit GraphMaker(const std::string &name) : graph_(std::make_shared<ComputeGraph>(name)) {}
+
+  NodePtr AddNode(const std::string &name, const std::string &type, const std::vector<NodePtr> &inputs,
+                  const std::vector<GeTensorDesc> &outputs) {
+    auto op_desc = std::make_shared<OpDesc>(name, type);
+    for (const auto &input : inputs) {
+      op_desc->AddInputDesc(input->GetOpDesc()->GetOutputDesc(0));
+    }
+    for (const auto &output : outputs) {
+      op_desc->AddOutputDesc(output);
+    }
+    auto node = graph_->AddNode(op_desc);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      (void)GraphUtils::AddEdge(inputs[i]->GetOutDataAnchor(0), node->GetInDataAnchor(static_cast<int>(i)));
+    }
+    return node;
+  }
+
+  NodePtr AddNode(const std::string &name, const std::string &type, const std::vector<NodePtr> &inputs,
+                  const GeTensorDesc &output) {
+    return AddNode(name, type, inputs, std::vector<GeTensorDesc>{output});
+  }
+
+  NodePtr AddData(const std::string &name, const GeTensorDesc &desc) {
+    auto node = AddNode(name, DATA, {}, desc);
+    node->GetOpDesc()->AddInputDesc(desc);
+    (void)AttrUtils::SetInt(node->GetOpDesc(), ATTR_NAME_INDEX, data_index_++);
+    return node;
+  }
+
+  NodePtr AddConst(const std::string &name, const GeTensorDesc &desc) {
+    auto node = AddNode(name, CONSTANT, {}, desc);
+    int64_t size = desc.GetShape().GetShapeSize() * GetSizeByDataType(desc.GetDataType());
+    std::vector<uint8_t> data(static_cast<size_t>(size), 0);
+    GeTensorPtr weight = std::make_shared<GeTensor>(desc, data);
+    (void)AttrUtils::SetTensor(node->GetOpDesc(), ATTR_NAME_WEIGHTS, weight);
+    return node;
+  }
+
+  ComputeGraphPtr Finish(const std::vector<NodePtr> &outputs) {
+    auto op_desc = std::make_shared<OpDesc>("net_output", NETOUTPUT);
+    for (const auto &output : outputs) {
+      op_desc->AddInputDesc(output->GetOpDesc()->GetOutputDesc(0));
+    }
+    auto net_output = graph_->AddNode(op_desc);
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      (void)GraphUtils::AddEdge(outputs[i]->GetOutDataAnchor(0), net_output->GetInDataAnchor(static_cast<int>(i)));
+    }
+    (void)graph_->TopologicalSorting();
+    return graph_;
+  }
+
+ private:
+  ComputeGraphPtr graph_;
+  int64_t data_index_ = 0;
+};
+
+GeTensorDesc TensorDesc(const std::vector<int64_t> &dims, Format format = FORMAT_ND, DataType data_type = DT_FLOAT) {
+  GeTensorDesc desc(GeShape(dims), format, data_type);
+  desc.SetOriginShape(GeShape(dims));
+  desc.SetOriginFormat(format);
+  desc.SetOriginDataType(data_type);
+  return desc;
+}
+}  // namespace
+
+ComputeGraphPtr BuildResNetLikeGraph(int block_num) {
+  GraphMaker maker("resnet_like");
+  auto image = TensorDesc({1, kImageChannel, kImageSize, kImageSize}, FORMAT_NCHW);
+  auto filter = TensorDesc({kImageChannel, kImageChannel, kKernelSize, kKernelSize}, FORMAT_NCHW);
+
+  auto input = maker.AddData("input", image);
+  auto conv = maker.AddNode("conv_stem", "Conv2D", {input, maker.AddConst("filter_stem", filter)}, image);
+  auto out = maker.AddNode("relu_stem", "Relu", {conv}, image);
+  for (int i = 0; i < block_num; ++i) {
+    std::string id = std::to_string(i);
+    auto conv1 = maker.AddNode("conv1_" + id, "Conv2D", {out, maker.AddConst("filter1_" + id, filter)}, image);
+    auto relu1 = maker.AddNode("relu1_" + id, "Relu", {conv1}, image);
+    auto conv2 = maker.AddNode("conv2_" + id, "Conv2D", {relu1, maker.AddConst("filter2_" + id, filter)}, image);
+    auto add = maker.AddNode("add_" + id, "Add", {conv2, out}, image);
+    out = maker.AddNode("relu2_" + id, "Relu", {add}, image);
+  }
+  return maker.Finish({out});
+}
+
+ComputeGraphPtr BuildTransformerLikeGraph(int layer_num) {
+  GraphMaker maker("transformer_like");
+  auto hidden = TensorDesc({kSeqLen, kHiddenSize});
+  auto scores = TensorDesc({kSeqLen, kSeqLen});
+  auto ffn = TensorDesc({kSeqLen, kFfnSize});
+  auto weight = TensorDesc({kHiddenSize, kHiddenSize});
+
+  auto out = maker.AddData("input", hidden);
+  for (int i = 0; i < layer_num; ++i) {
+    std::string id = std::to_string(i);
+    auto query = maker.AddNode("query_" + id, "MatMul", {out, maker.AddConst("wq_" + id, weight)}, hidden);
+    auto key = maker.AddNode("key_" + id, "MatMul", {out, maker.AddConst("wk_" + id, weight)}, hidden);
+    auto value = maker.AddNode("value_" + id, "MatMul", {out, maker.AddConst("wv_" + id, weight)}, hidden);
+    auto score = maker.AddNode("score_" + id, "BatchMatMul", {query, key}, scores);
+    auto prob = maker.AddNode("softmax_" + id, "Softmax", {score}, scores);
+    auto context = maker.AddNode("context_" + id, "BatchMatMul", {prob, value}, hidden);
+    auto proj = maker.AddNode("proj_" + id, "MatMul", {context, maker.AddConst("wo_" + id, weight)}, hidden);
+    auto add1 = maker.AddNode("add1_" + id, "Add", {proj, out}, hidden);
+    auto norm1 = maker.AddNode("norm1_" + id, "LayerNorm", {add1}, hidden);
+    auto up = maker.AddNode("ffn_up_" + id, "MatMul",
+                            {norm1, maker.AddConst("w_up_" + id, TensorDesc({kHiddenSize, kFfnSize}))}, ffn);
+    auto act = maker.AddNode("ffn_relu_" + id, "Relu", {up}, ffn);
+    auto down = maker.AddNode("ffn_down_" + id, "MatMul",
+                              {act, maker.AddConst("w_down_" + id, TensorDesc({kFfnSize, kHiddenSize}))}, hidden);
+    auto add2 = maker.AddNode("add2_" + id, "Add", {down, norm1}, hidden);
+    out = maker.AddNode("norm2_" + id, "LayerNorm", {add2}, hidden);
+  }
+  return maker.Finish({out});
+}
+
+ComputeGraphPtr BuildControlFlowGraph(int branch_num) {
+  GraphMaker maker("control_flow");
+  auto feature = TensorDesc({1, kImageChannel, kImageSize, kImageSize}, FORMAT_NCHW);
+  auto input = maker.AddData("input", feature);
+  auto pred = maker.AddData("pred", TensorDesc({}, FORMAT_ND, DT_BOOL));
+  std::vector<NodePtr> merges;
+  for (int i = 0; i < branch_num; ++i) {
+    std::string id = std::to_string(i);
+    auto switch_node = maker.AddNode("switch_" + id, SWITCH, {input, pred}, {feature, feature});
+    auto on_false = maker.AddNode("relu_" + id, "Relu", {}, feature);
+    auto on_true = maker.AddNode("sigmoid_" + id, "Sigmoid", {}, feature);
+    on_false->GetOpDesc()->AddInputDesc(feature);
+    on_true->GetOpDesc()->AddInputDesc(feature);
+    (void)GraphUtils::AddEdge(switch_node->GetOutDataAnchor(0), on_false->GetInDataAnchor(0));
+    (void)GraphUtils::AddEdge(switch_node->GetOutDataAnchor(1), on_true->GetInDataAnchor(0));
+    auto merge = maker.AddNode("merge_" + id, MERGE, {on_false, on_true},
+                               {feature, TensorDesc({}, FORMAT_ND, DT_INT32)});
+    merges.emplace_back(merge);
+  }
+  auto sum = maker.AddNode("sum", ADDN, merges, feature);
+  return maker.Finish({sum});
+}
+
+ComputeGraphPtr BuildMixedEngineGraph(int layer_num) {
+  GraphMaker maker("mixed_engine");
+  auto feature = TensorDesc({kSeqLen, kHiddenSize});
+  std::mt19937 random_engine(kMixedEngineSeed);
+  std::vector<NodePtr> nodes;
+  for (int i = 0; i < kMixedEngineWidth; ++i) {
+    nodes.emplace_back(maker.AddData("input_" + std::to_string(i), feature));
+  }
+  for (int layer = 0; layer < layer_num; ++layer) {
+    size_t layer_begin = nodes.size();
+    for (int i = 0; i < kMixedEngineWidth; ++i) {
+      // most inputs come from the last two layers, one in twenty from anywhere above
+      size_t window = std::min<size_t>(layer_begin, 2 * kMixedEngineWidth);
+      NodePtr left = nodes[layer_begin - 1 - random_engine() % window];
+      NodePtr right = (random_engine() % 20 == 0) ? nodes[random_engine() % layer_begin]
+                                                   : nodes[layer_begin - 1 - random_engine() % window];
+      bool on_aicpu = (random_engine() % 4 == 0);
+      std::string name = (on_aicpu ? "where_" : "add_") + std::to_string(layer) + "_" + std::to_string(i);
+      nodes.emplace_back(maker.AddNode(name, on_aicpu ? "Where" : "Add", {left, right}, feature));
+    }
+  }
+  return maker.Finish(std::vector<NodePtr>(nodes.end() - kMixedEngineWidth, nodes.end()));
+}
+
+ComputeGraphPtr LoadDumpedGraph(const std::string &file_path) {
+  auto graph = std::make_shared<ComputeGraph>("");
+  if (!GraphUtils::LoadGEGraph(file_path.c_str(), *graph)) {
+    return nullptr;
+  }
+  return graph;
+}
+
+std::set<std::string> GetOpTypes(const ComputeGraphPtr &graph) {
+  std::set<std::string> op_types;
+  for (const auto &node : graph->GetAllNodes()) {
+    op_types.insert(node->GetType());
+  }
+  return op_types;
+}
+}  // namespace benchmark
+}  // namespace ge
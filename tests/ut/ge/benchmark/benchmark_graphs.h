@@ -0,0 +1,65 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_UT_BENCHMARK_BENCHMARK_GRAPHS_H_
+#define GE_UT_BENCHMARK_BENCHMARK_GRAPHS_H_
+
+#include <set>
+#include <string>
+
+#include "graph/compute_graph.h"
+
+namespace ge {
+namespace benchmark {
+///
+/// Data -> Conv2D, then residual blocks of Conv2D -> Relu -> Conv2D -> Add(skip) -> Relu, with the filters in Const.
+/// @param [in] block_num number of residual blocks
+///
+ComputeGraphPtr BuildResNetLikeGraph(int block_num);
+
+///
+/// Data, then layers of self attention: MatMul q/k/v -> BatchMatMul -> Softmax -> BatchMatMul -> MatMul -> Add
+/// (residual) -> LayerNorm -> MatMul -> Relu -> MatMul -> Add (residual) -> LayerNorm, with the weights in Const.
+/// @param [in] layer_num number of layers
+///
+ComputeGraphPtr BuildTransformerLikeGraph(int layer_num);
+
+///
+/// Data and a predicate, then branch_num Switch -> Relu/Sigmoid -> Merge conditions side by side,
+/// whose outputs are summed up by AddN.
+/// @param [in] branch_num number of conditions
+///
+ComputeGraphPtr BuildControlFlowGraph(int branch_num);
+
+///
+/// Data, then layers of Add on aicore and Where on aicpu taking the outputs of recent layers and, now and then, of a
+/// layer far above, so that the partition merges clusters over long paths.
+/// @param [in] layer_num number of layers, each of kMixedEngineWidth nodes
+///
+ComputeGraphPtr BuildMixedEngineGraph(int layer_num);
+
+///
+/// Load a graph dumped by GraphUtils::DumpGEGraph, the ge_proto_*.txt files.
+/// @return nullptr if the file can not be parsed
+///
+ComputeGraphPtr LoadDumpedGraph(const std::string &file_path);
+
+// the types of all the nodes in the graph, which the stub kernel store has to support
+std::set<std::string> GetOpTypes(const ComputeGraphPtr &graph);
+}  // namespace benchmark
+}  // namespace ge
+
+#endif  // GE_UT_BENCHMARK_BENCHMARK_GRAPHS_H_
@@ -0,0 +1,575 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+///
+/// Replays the compile of graphs through GraphManager::PreRun, with stub engines and kernel stores in place
+/// of the plugins and the runtime stub in place of the device, so that the compile time of GE itself can be
+/// tracked without the hardware. Every run is done in a child process, to measure its peak RSS on its own.
+///
+/// usage: ge_compile_replay_benchmark [--graph=<ge_proto dump>]...
+///            [--synthetic=resnet,transformer,control_flow,mixed_engine] [--scale=<n>] [--repeat=<n>]
+///            [--baseline=<json>] [--output=<json>]
+///
+/// It exits with 1 if a result is worse than the baseline beyond the tolerance, see compile_replay_baseline.json.
+///
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define protected public
+#define private public
+#include "engine_manager/dnnengine_manager.h"
+#include "graph/manager/graph_manager.h"
+#include "init/gelib.h"
+#include "opskernel_manager/ops_kernel_manager.h"
+#undef private
+#undef protected
+
+#include "benchmark/benchmark_graphs.h"
+#include "common/debug/log.h"
+#include "common/opskernel/ops_kernel_info_store.h"
+#include "framework/common/scope_guard.h"
+#include "framework/common/types.h"
+#include "framework/engine/dnnengine.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/manager/graph_var_manager.h"
+#include "graph/operator_factory_impl.h"
+#include "graph/passes/pass_profiler.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/tensor_utils.h"
+#include "nlohmann/json.hpp"
+
+using Json = nlohmann::json;
+
+namespace ge {
+namespace benchmark {
+namespace {
+const char *const kGeLocalEngine = "DNN_VM_GE_LOCAL";
+const char *const kAicoreEngine = "AIcoreEngine";
+const char *const kAicpuEngine = "aicpu_kernel";
+const char *const kRtsEngine = "DNN_VM_RTS";
+const char *const kScheduler = "TS_1";
+const int64_t kMemAlignSize = 32;
+const GraphId kGraphId = 1;
+const uint64_t kSessionId = 0;
+const int kDefaultScale = 16;
+const int kDefaultRepeat = 3;
+
+// the ops placed on ge local, which get no task
+const std::set<std::string> kGeLocalOps = {DATA,     CONSTANT,       CONSTANTOP, VARIABLE, NETOUTPUT,
+                                           NOOP,     CONTROLTRIGGER, SHAPE,      RESHAPE,  EXPANDDIMS};
+// the ops added by GE for the control flow and the multi stream
+const std::set<std::string> kRtsOps = {STREAMSWITCH, STREAMACTIVE, STREAMMERGE, MEMCPYASYNC,
+                                       SEND,         RECV,         ENTER,       LOOPCOND,    ENDGRAPH};
+// the ops placed on aicpu, the partition splits the graph at them
+const std::set<std::string> kAicpuOps = {"Where"};
+// the ops added by GE which are computed on the device
+const std::set<std::string> kInsertedAicoreOps = {CAST, TRANSDATA, ATOMICADDRCLEAN, IDENTITY, MERGE, SWITCH};
+// the ops with a workspace as large as the output, the real kernels of them take scratch memory
+const std::set<std::string> kWorkspaceOps = {"Softmax", "LayerNorm", "BatchMatMul", "Conv2D"};
+
+class StubEngine : public DNNEngine {
+ public:
+  explicit StubEngine(const std::string &name) : name_(name) {}
+
+  Status Initialize(const std::map<std::string, std::string> &options) override { return SUCCESS; }
+
+  Status Finalize() override { return SUCCESS; }
+
+  void GetAttributes(DNNEngineAttribute &attr) const override {
+    attr.engine_name = name_;
+    attr.compute_cost = 0;
+    attr.runtime_type = DEVICE;
+    attr.engine_input_format = FORMAT_RESERVED;
+    attr.engine_output_format = FORMAT_RESERVED;
+  }
+
+ private:
+  std::string name_;
+};
+
+// supports the ops of its types, sizes the outputs by their shapes and generates one task for each op
+class StubOpsKernelInfoStore : public OpsKernelInfoStore {
+ public:
+  StubOpsKernelInfoStore(const std::string &engine, const std::set<std::string> &op_types, bool has_task)
+      : engine_(engine), op_types_(op_types), has_task_(has_task) {}
+
+  Status Initialize(const std::map<std::string, std::string> &options) override { return SUCCESS; }
+
+  Status Finalize() override { return SUCCESS; }
+
+  void GetAllOpsKernelInfo(std::map<std::string, OpInfo> &infos) const override {
+    for (const auto &op_type : op_types_) {
+      OpInfo op_info{};
+      op_info.engine = engine_;
+      infos.emplace(op_type, op_info);
+    }
+  }
+
+  bool CheckSupported(const OpDescPtr &op_desc, std::string &un_supported_reason) const override { return true; }
+
+  Status CalcOpRunningParam(Node &node) override {
+    auto op_desc = node.GetOpDesc();
+    int64_t total_size = 0;
+    for (size_t i = 0; i < op_desc->GetOutputsSize(); ++i) {
+      auto output_desc = op_desc->MutableOutputDesc(static_cast<uint32_t>(i));
+      int64_t size = std::max<int64_t>(output_desc->GetShape().GetShapeSize(), 1) *
+                     GetSizeByDataType(output_desc->GetDataType());
+      size = (size + kMemAlignSize - 1) / kMemAlignSize * kMemAlignSize;
+      TensorUtils::SetSize(*output_desc, size);
+      total_size += size;
+    }
+    if (kWorkspaceOps.count(op_desc->GetType()) > 0) {
+      op_desc->SetWorkspaceBytes({total_size});
+    }
+    return SUCCESS;
+  }
+
+  Status GenerateTask(const Node &node, RunContext &context, std::vector<domi::TaskDef> &tasks) override {
+    if (!has_task_) {
+      return SUCCESS;
+    }
+    domi::TaskDef task_def;
+    task_def.set_type(RT_MODEL_TASK_KERNEL);
+    task_def.set_stream_id(static_cast<uint32_t>(node.GetOpDesc()->GetStreamId()));
+    tasks.emplace_back(task_def);
+    return SUCCESS;
+  }
+
+ private:
+  std::string engine_;
+  std::set<std::string> op_types_;
+  bool has_task_;
+};
+
+// the options of GELib and GraphManager
+std::map<std::string, std::string> GetOptions() { return {{OPTION_GRAPH_RUN_MODE, "1"}}; }
+
+///
+/// Register the stub engines and kernel stores to GELib, the ops of op_types not in the other stores are
+/// placed on aicore.
+///
+Status InstallStubs(const std::set<std::string> &op_types) {
+  auto instance = GELib::GetInstance();
+  if (instance == nullptr || !instance->InitFlag()) {
+    return GE_CLI_GE_NOT_INITIALIZED;
+  }
+  std::set<std::string> aicore_ops = kInsertedAicoreOps;
+  for (const auto &op_type : op_types) {
+    if (kGeLocalOps.count(op_type) == 0 && kRtsOps.count(op_type) == 0 && kAicpuOps.count(op_type) == 0) {
+      aicore_ops.insert(op_type);
+    }
+  }
+  struct StubConf {
+    std::string engine;
+    std::set<std::string> op_types;
+    bool skip_assign_stream;
+    bool attach;
+  };
+  std::vector<StubConf> stub_confs = {{kGeLocalEngine, kGeLocalOps, true, true},
+                                      {kAicoreEngine, aicore_ops, false, false},
+                                      {kAicpuEngine, kAicpuOps, false, false},
+                                      {kRtsEngine, kRtsOps, false, true}};
+
+  DNNEngineManager &engine_manager = instance->DNNEngineManagerObj();
+  OpsKernelManager &ops_kernel_manager = instance->OpsKernelManagerObj();
+  SchedulerConf scheduler;
+  scheduler.id = kScheduler;
+  scheduler.name = kScheduler;
+  for (const auto &stub_conf : stub_confs) {
+    auto engine = std::make_shared<StubEngine>(stub_conf.engine);
+    auto engine_conf = std::make_shared<EngineConf>();
+    auto store = std::make_shared<StubOpsKernelInfoStore>(stub_conf.engine, stub_conf.op_types,
+                                                          stub_conf.engine != kGeLocalEngine);
+    DNNEngineAttribute attr;
+    engine->GetAttributes(attr);
+    engine_manager.engines_map_[stub_conf.engine] = engine;
+    engine_manager.engines_attrs_map_[stub_conf.engine] = attr;
+    engine_conf->id = stub_conf.engine;
+    engine_conf->name = stub_conf.engine;
+    engine_conf->skip_assign_stream = stub_conf.skip_assign_stream;
+    engine_conf->attach = stub_conf.attach;
+    engine_conf->scheduler_id = kScheduler;
+    scheduler.cal_engines[stub_conf.engine] = engine_conf;
+    ops_kernel_manager.ops_kernel_store_[stub_conf.engine] = store;
+  }
+  engine_manager.schedulers_[kScheduler] = scheduler;
+  engine_manager.ClearPlacementCache();
+  ops_kernel_manager.InitOpsKernelInfo();
+  return SUCCESS;
+}
+
+// the op protos are not linked, the ops keep the shapes they are built or dumped with
+void RegisterKeepShapeInferFuncs(const std::set<std::string> &op_types) {
+  for (const auto &op_type : op_types) {
+    if (OperatorFactoryImpl::GetInferShapeFunc(op_type) == nullptr) {
+      (void)OperatorFactoryImpl::RegisterInferShapeFunc(op_type, [](Operator &op) { return GRAPH_SUCCESS; });
+    }
+  }
+}
+
+// the inputs of the graph in the order of the indexes of Data, only the descs are used by the compile
+std::vector<GeTensor> BuildInputs(const ComputeGraphPtr &graph) {
+  std::map<int64_t, GeTensorDesc> index_to_desc;
+  for (const auto &node : graph->GetDirectNode()) {
+    int64_t index = 0;
+    if (node->GetType() == DATA && AttrUtils::GetInt(node->GetOpDesc(), ATTR_NAME_INDEX, index)) {
+      index_to_desc[index] = node->GetOpDesc()->GetOutputDesc(0);
+    }
+  }
+  std::vector<GeTensor> inputs;
+  for (const auto &item : index_to_desc) {
+    inputs.emplace_back(item.second);
+  }
+  return inputs;
+}
+
+struct BenchmarkCase {
+  std::string name;
+  std::function<ComputeGraphPtr()> build_graph;
+};
+
+///
+/// Compile the graph of the case once, in the child process.
+/// @return the result with total_us, stages, memory_size, weight_size, task_count and node_count
+///
+Status CompileOnce(const BenchmarkCase &benchmark_case, Json &result) {
+  auto graph = benchmark_case.build_graph();
+  if (graph == nullptr) {
+    std::cerr << "Build the graph of " << benchmark_case.name << " failed." << std::endl;
+    return FAILED;
+  }
+  auto op_types = GetOpTypes(graph);
+  RegisterKeepShapeInferFuncs(op_types);
+  auto options = GetOptions();
+  GE_CHK_STATUS_RET(GELib::Initialize(options), "Initialize GELib failed.");
+  GE_CHK_STATUS_RET(InstallStubs(op_types), "Install the stub engines failed.");
+  GraphManager graph_manager;
+  GE_CHK_STATUS_RET(graph_manager.Initialize(options), "Initialize GraphManager failed.");
+  GE_MAKE_GUARD(graph_manager, [&graph_manager] { (void)graph_manager.Finalize(); });
+  // what InnerSession does, the Const and Variable nodes take their memory from the VarManager
+  GE_CHK_STATUS_RET(VarManager::Instance(kSessionId)->Init(static_cast<uint32_t>(SessionVersion::ClOUD_VERSION),
+                                                           kSessionId, 0, 0),
+                    "Initialize VarManager failed.");
+  GE_CHK_STATUS_RET(graph_manager.AddGraph(kGraphId, GraphUtils::CreateGraphFromComputeGraph(graph)),
+                    "Add graph failed.");
+  GraphNodePtr graph_node = nullptr;
+  GE_CHK_STATUS_RET(graph_manager.GetGraphNode(kGraphId, graph_node), "Get graph node failed.");
+
+  result["node_count"] = graph->GetAllNodesSize();
+  std::vector<GeTensor> inputs = BuildInputs(graph);
+  std::vector<GeModelPtr> ge_models;
+  GeModelPtr ge_model = nullptr;
+  auto start = std::chrono::steady_clock::now();
+  Status ret = graph_manager.PreRun(graph_node, inputs, ge_models, ge_model, kSessionId);
+  auto cost = std::chrono::steady_clock::now() - start;
+  if (ret != SUCCESS || ge_model == nullptr) {
+    std::cerr << "PreRun of " << benchmark_case.name << " failed, ret " << ret << "." << std::endl;
+    return FAILED;
+  }
+  result["total_us"] = std::chrono::duration_cast<std::chrono::microseconds>(cost).count();
+
+  PassProfilerPtr profiler = nullptr;
+  (void)graph_manager.GetPassProfiler(kGraphId, profiler);
+  result["stages"] = Json::object();
+  if (profiler != nullptr) {
+    for (const auto &stage : profiler->GetStageStats()) {
+      result["stages"][stage.name] = stage.cost_us;
+    }
+  }
+  int64_t memory_size = 0;
+  int64_t weight_size = 0;
+  (void)AttrUtils::GetInt(ge_model, ATTR_MODEL_MEMORY_SIZE, memory_size);
+  (void)AttrUtils::GetInt(ge_model, ATTR_MODEL_WEIGHT_SIZE, weight_size);
+  result["memory_size"] = memory_size;
+  result["weight_size"] = weight_size;
+  auto model_task_def = ge_model->GetModelTaskDefPtr();
+  result["task_count"] = (model_task_def == nullptr) ? 0 : model_task_def->task_size();
+  return SUCCESS;
+}
+
+///
+/// Compile the case in a child process, whose peak RSS is the one of the compile only.
+///
+Status RunInChild(const BenchmarkCase &benchmark_case, Json &result) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return FAILED;
+  }
+  pid_t pid = fork();
+  if (pid < 0) {
+    close(fds[0]);
+    close(fds[1]);
+    return FAILED;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    Json child_result;
+    Status ret = CompileOnce(benchmark_case, child_result);
+    std::string output = (ret == SUCCESS) ? child_result.dump() : "";
+    size_t written = 0;
+    while (written < output.size()) {
+      ssize_t size = write(fds[1], output.data() + written, output.size() - written);
+      if (size <= 0) {
+        break;
+      }
+      written += static_cast<size_t>(size);
+    }
+    close(fds[1]);
+    // skip the destructors of the GE singletons, the child has done its work
+    _exit(ret == SUCCESS ? 0 : 1);
+  }
+
+  close(fds[1]);
+  std::string output;
+  char buffer[4096];
+  ssize_t size = 0;
+  while ((size = read(fds[0], buffer, sizeof(buffer))) > 0) {
+    output.append(buffer, static_cast<size_t>(size));
+  }
+  close(fds[0]);
+  int status = 0;
+  struct rusage usage {};
+  if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || output.empty()) {
+    return FAILED;
+  }
+  result = Json::parse(output);
+  result["peak_rss_kb"] = usage.ru_maxrss;
+  return SUCCESS;
+}
+
+template <typename T>
+T Median(std::vector<T> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+///
+/// Run the case repeat times, the timings and the RSS are the medians, the plan is the same in every run.
+///
+Status RunCase(const BenchmarkCase &benchmark_case, int repeat, Json &result) {
+  std::vector<Json> runs;
+  for (int i = 0; i < repeat; ++i) {
+    Json run;
+    if (RunInChild(benchmark_case, run) != SUCCESS) {
+      std::cerr << "Run " << benchmark_case.name << " failed." << std::endl;
+      return FAILED;
+    }
+    runs.emplace_back(run);
+  }
+  result = runs[0];
+  for (const auto &key : {"total_us", "peak_rss_kb"}) {
+    std::vector<int64_t> values;
+    for (const auto &run : runs) {
+      values.emplace_back(run[key].get<int64_t>());
+    }
+    result[key] = Median(values);
+  }
+  for (auto &stage : result["stages"].items()) {
+    std::vector<int64_t> values;
+    for (const auto &run : runs) {
+      values.emplace_back(run["stages"].value(stage.key(), 0L));
+    }
+    stage.value() = Median(values);
+  }
+  return SUCCESS;
+}
+
+// a worse value is larger, it is a regression when it is above the baseline by more than the tolerance
+bool CheckMetric(const std::string &case_name, const std::string &metric, int64_t baseline, int64_t current,
+                 double tolerance, int64_t floor) {
+  double limit = static_cast<double>(baseline) * (1.0 + tolerance);
+  bool regressed = (static_cast<double>(current) > limit) && (current - baseline > floor);
+  if (regressed) {
+    std::cout << "REGRESSION " << case_name << " " << metric << ": baseline " << baseline << ", current " << current
+              << ", tolerance " << tolerance << std::endl;
+  }
+  return !regressed;
+}
+
+///
+/// Compare the results with the baseline, whose tolerances are relative to the baseline values:
+/// time for total_us and the stages, peak_rss for peak_rss_kb, plan for memory_size and task_count.
+/// The timings less than time_floor_us above the baseline are never regressions, they are in the noise.
+///
+bool CompareWithBaseline(const Json &results, const Json &baseline) {
+  const Json tolerance = baseline.value("tolerance", Json::object());
+  double time_tolerance = tolerance.value("time", 0.5);
+  double rss_tolerance = tolerance.value("peak_rss", 0.2);
+  double plan_tolerance = tolerance.value("plan", 0.0);
+  int64_t time_floor = tolerance.value("time_floor_us", 1000L);
+  const Json baseline_cases = baseline.value("cases", Json::object());
+  bool passed = true;
+  for (const auto &item : results.items()) {
+    const std::string &name = item.key();
+    const Json &current = item.value();
+    if (baseline_cases.count(name) == 0) {
+      std::cout << "No baseline of " << name << ", skip." << std::endl;
+      continue;
+    }
+    const Json &base = baseline_cases[name];
+    passed &= CheckMetric(name, "total_us", base.value("total_us", 0L), current["total_us"], time_tolerance,
+                          time_floor);
+    for (const auto &stage : current["stages"].items()) {
+      if (base["stages"].count(stage.key()) > 0) {
+        passed &= CheckMetric(name, stage.key(), base["stages"][stage.key()], stage.value(), time_tolerance,
+                              time_floor);
+      }
+    }
+    passed &= CheckMetric(name, "peak_rss_kb", base.value("peak_rss_kb", 0L), current["peak_rss_kb"],
+                          rss_tolerance, 0);
+    for (const auto &metric : {"memory_size", "task_count"}) {
+      passed &= CheckMetric(name, metric, base.value(metric, 0L), current[metric], plan_tolerance, 0);
+    }
+  }
+  return passed;
+}
+
+bool ParseArg(const std::string &arg, const std::string &flag, std::string &value) {
+  std::string prefix = "--" + flag + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0) {
+    return false;
+  }
+  value = arg.substr(prefix.size());
+  return true;
+}
+
+std::vector<std::string> Split(const std::string &str, char delim) {
+  std::vector<std::string> items;
+  std::istringstream stream(str);
+  std::string item;
+  while (std::getline(stream, item, delim)) {
+    if (!item.empty()) {
+      items.emplace_back(item);
+    }
+  }
+  return items;
+}
+
+std::string BaseName(const std::string &path) {
+  auto pos = path.find_last_of('/');
+  return (pos == std::string::npos) ? path : path.substr(pos + 1);
+}
+}  // namespace
+
+int Main(int argc, char **argv) {
+  std::vector<std::string> graph_files;
+  std::vector<std::string> synthetics;
+  std::string baseline_file;
+  std::string output_file;
+  int scale = kDefaultScale;
+  int repeat = kDefaultRepeat;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    std::string value;
+    if (ParseArg(arg, "graph", value)) {
+      graph_files.emplace_back(value);
+    } else if (ParseArg(arg, "synthetic", value)) {
+      auto names = Split(value, ',');
+      synthetics.insert(synthetics.end(), names.begin(), names.end());
+    } else if (ParseArg(arg, "scale", value)) {
+      scale = std::max(std::atoi(value.c_str()), 1);
+    } else if (ParseArg(arg, "repeat", value)) {
+      repeat = std::max(std::atoi(value.c_str()), 1);
+    } else if (ParseArg(arg, "baseline", value)) {
+      baseline_file = value;
+    } else if (ParseArg(arg, "output", value)) {
+      output_file = value;
+    } else {
+      std::cerr << "Unknown argument " << arg << std::endl;
+      return 1;
+    }
+  }
+  if (graph_files.empty() && synthetics.empty()) {
+    synthetics = {"resnet", "transformer", "control_flow", "mixed_engine"};
+  }
+
+  std::vector<BenchmarkCase> cases;
+  for (const auto &synthetic : synthetics) {
+    std::string name = synthetic + "_" + std::to_string(scale);
+    if (synthetic == "resnet") {
+      cases.push_back({name, [scale]() { return BuildResNetLikeGraph(scale); }});
+    } else if (synthetic == "transformer") {
+      cases.push_back({name, [scale]() { return BuildTransformerLikeGraph(scale); }});
+    } else if (synthetic == "control_flow") {
+      cases.push_back({name, [scale]() { return BuildControlFlowGraph(scale); }});
+    } else if (synthetic == "mixed_engine") {
+      cases.push_back({name, [scale]() { return BuildMixedEngineGraph(scale); }});
+    } else {
+      std::cerr << "Unknown synthetic graph " << synthetic << std::endl;
+      return 1;
+    }
+  }
+  for (const auto &graph_file : graph_files) {
+    cases.push_back({BaseName(graph_file), [graph_file]() { return LoadDumpedGraph(graph_file); }});
+  }
+
+  // the pass profiler collects the stage timings
+  setenv("GE_PASS_PROFILING", "1", 1);
+  Json results = Json::object();
+  for (const auto &benchmark_case : cases) {
+    Json result;
+    if (RunCase(benchmark_case, repeat, result) != SUCCESS) {
+      return 1;
+    }
+    std::cout << benchmark_case.name << ": " << result.dump() << std::endl;
+    results[benchmark_case.name] = result;
+  }
+
+  if (!output_file.empty()) {
+    // in the layout of the baseline, the tolerances are added by hand
+    Json report;
+    report["cases"] = results;
+    std::ofstream output(output_file);
+    output << report.dump(2) << std::endl;
+  }
+  if (baseline_file.empty()) {
+    return 0;
+  }
+  std::ifstream baseline_stream(baseline_file);
+  if (!baseline_stream.is_open()) {
+    std::cerr << "Open baseline " << baseline_file << " failed." << std::endl;
+    return 1;
+  }
+  Json baseline;
+  try {
+    baseline_stream >> baseline;
+  } catch (const Json::exception &e) {
+    std::cerr << "Parse baseline " << baseline_file << " failed: " << e.what() << std::endl;
+    return 1;
+  }
+  return CompareWithBaseline(results, baseline) ? 0 : 1;
+}
+}  // namespace benchmark
+}  // namespace ge
+
+int main(int argc, char **argv) { return ge::benchmark::Main(argc, argv); }
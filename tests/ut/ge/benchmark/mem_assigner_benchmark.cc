@@ -0,0 +1,495 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+///
+/// Benchmarks the memory assigners on synthetic graphs: chains, diamonds, long lived skip connections, many
+/// workspaces and atomic nodes. For every graph and assigner it reports the planning time, the total memory, the
+/// lower bound given by the peak of the live bytes and the fragmentation, which is the part of the total above the
+/// lower bound. The total memory is checked against kBaselines, a plan above it fails the test, so does a plan which
+/// puts two buffers alive at the same time on overlapping addresses.
+///
+/// The planning time depends on the machine, it is measured and checked against kBaselines only if
+/// GE_MEM_ASSIGNER_BENCHMARK_TIMING is set to 1, which is meant for the benchmark runs and not for the UT.
+/// Set GE_MEM_ASSIGNER_BENCHMARK_OUTPUT to a file path to get the results in json as well.
+///
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "framework/common/types.h"
+#include "framework/memory/memory_assigner.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/manager/graph_var_manager.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/tensor_utils.h"
+#include "nlohmann/json.hpp"
+#include "omg/omg_inner_types.h"
+
+#include "graph/build/memory/binary_block_mem_assigner.h"
+#include "graph/build/memory/hybrid_mem_assigner.h"
+#include "graph/build/memory/max_block_mem_assigner.h"
+
+namespace ge {
+namespace benchmark {
+namespace {
+const int64_t kSizeUnit = 512;
+const int kRepeat = 3;
+// the total memory is deterministic, any growth of it is a regression
+const double kMemSizeTolerance = 0.0;
+// the timings are of a debug build on a slow machine, only the gross slowdowns are regressions
+const double kPlanTimeTolerance = 2.0;
+const int64_t kPlanTimeFloorUs = 20000;
+const char *const kOutputEnv = "GE_MEM_ASSIGNER_BENCHMARK_OUTPUT";
+const char *const kTimingEnv = "GE_MEM_ASSIGNER_BENCHMARK_TIMING";
+
+struct MemAssignerBaseline {
+  const char *case_name;
+  const char *assigner;
+  int64_t total_size;
+  int64_t plan_us;
+};
+
+// the results of the assigners at the time they were last tuned, update them along with any change of the plans
+const MemAssignerBaseline kBaselines[] = {
+    {"chain_256", "binary", 27648, 9029},
+    {"chain_256", "max", 21504, 13060},
+    {"chain_256", "hybrid", 21504, 16969},
+    {"chain_256", "graph", 21504, 18534},
+    {"chain_2048", "binary", 27648, 292015},
+    {"chain_2048", "max", 21504, 291337},
+    {"chain_2048", "hybrid", 21504, 627014},
+    {"chain_2048", "graph", 21504, 612251},
+    {"diamond_128", "binary", 19456, 27472},
+    {"diamond_128", "max", 13312, 29821},
+    {"diamond_128", "hybrid", 13312, 53539},
+    {"diamond_128", "graph", 13312, 58312},
+    {"skip_32x8", "binary", 49664, 12037},
+    {"skip_32x8", "max", 41472, 12744},
+    {"skip_32x8", "hybrid", 41472, 24118},
+    {"skip_32x8", "graph", 41472, 26517},
+    {"workspace_256", "binary", 4708864, 18677},
+    {"workspace_256", "max", 5339136, 17326},
+    {"workspace_256", "hybrid", 4708864, 34442},
+    {"workspace_256", "graph", 4708864, 38141},
+    {"atomic_256", "binary", 27648, 11779},
+    {"atomic_256", "max", 21504, 11713},
+    {"atomic_256", "hybrid", 21504, 23299},
+    {"atomic_256", "graph", 250880, 25203},
+};
+
+struct MemAssignerResult {
+  std::string case_name;
+  std::string assigner;
+  int64_t plan_us = 0;
+  int64_t total_size = 0;
+  int64_t lower_bound = 0;
+  double fragmentation = 0.0;
+};
+
+// an output or a workspace, alive from the step of start to the step of end of the topological order
+struct LiveBuffer {
+  NodePtr node;
+  bool is_workspace;
+  size_t index;
+  int64_t size;
+  size_t start;
+  size_t end;
+};
+
+bool IsTimingEnabled() {
+  const char *timing = std::getenv(kTimingEnv);
+  return (timing != nullptr) && (std::string(timing) == "1");
+}
+
+int64_t AlignSize(int64_t size) { return (size + kMemAlignSize - 1) / kMemAlignSize * kMemAlignSize; }
+
+// sizes from 1 to period units, in an order which is not monotonic
+int64_t VariedSize(int i, int period) { return kSizeUnit * (1 + (i * 7) % period); }
+
+class MemGraphMaker {
+ public:
+  explicit MemGraphMaker(const std::string &name) : graph_(std::make_shared<ComputeGraph>(name)) {}
+
+  NodePtr AddNode(const std::string &name, const std::string &type, const std::vector<NodePtr> &inputs,
+                  int64_t output_size, const std::vector<int64_t> &workspaces = {}) {
+    auto op_desc = std::make_shared<OpDesc>(name, type);
+    for (const auto &input : inputs) {
+      op_desc->AddInputDesc(input->GetOpDesc()->GetOutputDesc(0));
+    }
+    GeTensorDesc output_desc;
+    TensorUtils::SetSize(output_desc, static_cast<uint32_t>(output_size));
+    op_desc->AddOutputDesc(output_desc);
+    op_desc->SetWorkspaceBytes(workspaces);
+    op_desc->SetStreamId(0);
+    auto node = graph_->AddNode(op_desc);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      (void)GraphUtils::AddEdge(inputs[i]->GetOutDataAnchor(0), node->GetInDataAnchor(static_cast<int>(i)));
+    }
+    return node;
+  }
+
+  NodePtr AddData(int64_t size) {
+    auto node = AddNode("data", DATA, {}, size);
+    node->GetOpDesc()->AddInputDesc(node->GetOpDesc()->GetOutputDesc(0));
+    return node;
+  }
+
+  // the outputs of NetOutput take no memory of their own
+  ComputeGraphPtr Finish(const std::vector<NodePtr> &outputs) {
+    auto op_desc = std::make_shared<OpDesc>("net_output", NETOUTPUT);
+    for (const auto &output : outputs) {
+      GeTensorDesc desc = output->GetOpDesc()->GetOutputDesc(0);
+      op_desc->AddInputDesc(desc);
+      TensorUtils::SetSize(desc, 0);
+      op_desc->AddOutputDesc(desc);
+    }
+    op_desc->SetStreamId(0);
+    auto net_output = graph_->AddNode(op_desc);
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      (void)GraphUtils::AddEdge(outputs[i]->GetOutDataAnchor(0), net_output->GetInDataAnchor(static_cast<int>(i)));
+    }
+    (void)graph_->TopologicalSorting();
+    return graph_;
+  }
+
+ private:
+  ComputeGraphPtr graph_;
+};
+
+///
+/// Data -> op_num ops in a chain, with varied output sizes.
+///
+ComputeGraphPtr BuildChainGraph(int op_num) {
+  MemGraphMaker maker("chain");
+  auto out = maker.AddData(kSizeUnit);
+  for (int i = 0; i < op_num; ++i) {
+    out = maker.AddNode("op_" + std::to_string(i), "Relu", {out}, VariedSize(i, 16));
+  }
+  return maker.Finish({out});
+}
+
+///
+/// diamond_num diamonds in a chain, each of them forks to two branches of different sizes and joins them.
+///
+ComputeGraphPtr BuildDiamondGraph(int diamond_num) {
+  MemGraphMaker maker("diamond");
+  auto out = maker.AddData(kSizeUnit);
+  for (int i = 0; i < diamond_num; ++i) {
+    std::string id = std::to_string(i);
+    auto left = maker.AddNode("left_" + id, "Relu", {out}, VariedSize(i, 8));
+    auto left2 = maker.AddNode("left2_" + id, "Relu", {left}, VariedSize(i + 3, 8));
+    auto right = maker.AddNode("right_" + id, "Sigmoid", {out}, VariedSize(i + 5, 8));
+    out = maker.AddNode("join_" + id, "Add", {left2, right}, VariedSize(i + 1, 8));
+  }
+  return maker.Finish({out});
+}
+
+///
+/// block_num residual blocks of depth ops, the input of each block stays alive to the end of it. The output of the
+/// first block also lives to the end of the graph.
+///
+ComputeGraphPtr BuildSkipGraph(int block_num, int depth) {
+  MemGraphMaker maker("skip");
+  auto out = maker.AddData(kSizeUnit);
+  NodePtr first_block = nullptr;
+  for (int i = 0; i < block_num; ++i) {
+    std::string id = std::to_string(i);
+    auto head = out;
+    for (int j = 0; j < depth; ++j) {
+      out = maker.AddNode("conv_" + id + "_" + std::to_string(j), "Conv2D", {out}, VariedSize(i + j, 4) * 4);
+    }
+    out = maker.AddNode("add_" + id, "Add", {out, head}, kSizeUnit * 16);
+    if (first_block == nullptr) {
+      first_block = out;
+    }
+  }
+  out = maker.AddNode("add_first", "Add", {out, first_block}, kSizeUnit * 16);
+  return maker.Finish({out});
+}
+
+///
+/// Data -> op_num ops in a chain, each with one to three workspaces larger than its output.
+///
+ComputeGraphPtr BuildWorkspaceGraph(int op_num) {
+  MemGraphMaker maker("workspace");
+  auto out = maker.AddData(kSizeUnit);
+  for (int i = 0; i < op_num; ++i) {
+    std::vector<int64_t> workspaces;
+    for (int j = 0; j <= i % 3; ++j) {
+      workspaces.emplace_back(VariedSize(i + j, 32) * 2);
+    }
+    out = maker.AddNode("op_" + std::to_string(i), "BatchMatMul", {out}, VariedSize(i, 8), workspaces);
+  }
+  return maker.Finish({out});
+}
+
+///
+/// Data -> op_num ops in a chain, every fourth one writes its output atomically, which needs the output cleaned by
+/// AtomicAddrClean before.
+///
+ComputeGraphPtr BuildAtomicGraph(int op_num) {
+  MemGraphMaker maker("atomic");
+  auto op_desc = std::make_shared<OpDesc>("atomic_clean", ATOMICADDRCLEAN);
+  op_desc->SetStreamId(0);
+  auto out = maker.AddData(kSizeUnit);
+  auto graph = out->GetOwnerComputeGraph();
+  (void)graph->AddNode(op_desc);
+  for (int i = 0; i < op_num; ++i) {
+    out = maker.AddNode("op_" + std::to_string(i), "ReduceSum", {out}, VariedSize(i, 16));
+    if (i % 4 == 0) {
+      (void)AttrUtils::SetBool(out->GetOpDesc(), ATOMIC_ATTR_IS_ATOMIC_NODE, true);
+      (void)AttrUtils::SetListInt(out->GetOpDesc(), ATOMIC_ATTR_OUTPUT_INDEX, std::vector<int64_t>{0});
+    }
+  }
+  return maker.Finish({out});
+}
+
+///
+/// The buffers the assigners have to place, with their live ranges: an output lives from its node to its last
+/// reader, to the end of the graph if it is an output of the graph. A workspace lives during its node only.
+///
+std::vector<LiveBuffer> GetLiveBuffers(const ComputeGraphPtr &graph) {
+  std::map<NodePtr, size_t> steps;
+  for (const auto &node : graph->GetDirectNode()) {
+    steps.emplace(node, steps.size());
+  }
+  size_t last_step = steps.empty() ? 0 : steps.size() - 1;
+  std::vector<LiveBuffer> buffers;
+  for (const auto &node : graph->GetDirectNode()) {
+    auto op_desc = node->GetOpDesc();
+    size_t step = steps[node];
+    if (op_desc->GetType() != NETOUTPUT) {
+      for (size_t i = 0; i < op_desc->GetOutputsSize(); ++i) {
+        uint32_t size = 0;
+        (void)TensorUtils::GetSize(op_desc->GetOutputDesc(static_cast<uint32_t>(i)), size);
+        if (size == 0) {
+          continue;
+        }
+        size_t end = step;
+        for (const auto &peer : node->GetOutDataAnchor(static_cast<int>(i))->GetPeerInDataAnchors()) {
+          auto reader = peer->GetOwnerNode();
+          end = std::max(end, (reader->GetType() == NETOUTPUT) ? last_step : steps[reader]);
+        }
+        buffers.push_back({node, false, i, AlignSize(size), step, end});
+      }
+    }
+    auto workspaces = op_desc->GetWorkspaceBytes();
+    for (size_t i = 0; i < workspaces.size(); ++i) {
+      if (workspaces[i] > 0) {
+        buffers.push_back({node, true, i, AlignSize(workspaces[i]), step, step});
+      }
+    }
+  }
+  return buffers;
+}
+
+// no plan can be smaller than the bytes alive at the same time
+int64_t GetPeakLiveBytes(const std::vector<LiveBuffer> &buffers) {
+  std::map<size_t, int64_t> deltas;
+  for (const auto &buffer : buffers) {
+    deltas[buffer.start] += buffer.size;
+    deltas[buffer.end + 1] -= buffer.size;
+  }
+  int64_t live = 0;
+  int64_t peak = 0;
+  for (const auto &delta : deltas) {
+    live += delta.second;
+    peak = std::max(peak, live);
+  }
+  return peak;
+}
+
+int64_t GetOffset(const LiveBuffer &buffer) {
+  auto offsets = buffer.is_workspace ? buffer.node->GetOpDesc()->GetWorkspace()
+                                     : buffer.node->GetOpDesc()->GetOutputOffset();
+  return (buffer.index < offsets.size()) ? offsets[buffer.index] : kInvalidOffset;
+}
+
+std::string BufferName(const LiveBuffer &buffer) {
+  return buffer.node->GetName() + (buffer.is_workspace ? ":workspace" : ":output") + std::to_string(buffer.index);
+}
+
+// every buffer is placed, and the buffers alive at the same time do not share any byte
+void CheckNoOverlap(const std::string &name, const std::vector<LiveBuffer> &buffers) {
+  std::vector<int64_t> offsets;
+  for (const auto &buffer : buffers) {
+    offsets.emplace_back(GetOffset(buffer));
+    ASSERT_NE(offsets.back(), kInvalidOffset) << name << " " << BufferName(buffer) << " is not placed";
+  }
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    for (size_t j = i + 1; j < buffers.size(); ++j) {
+      bool live_together = (buffers[i].start <= buffers[j].end) && (buffers[j].start <= buffers[i].end);
+      bool overlap = (offsets[i] < offsets[j] + buffers[j].size) && (offsets[j] < offsets[i] + buffers[i].size);
+      ASSERT_FALSE(live_together && overlap) << name << " " << BufferName(buffers[i]) << " and "
+                                             << BufferName(buffers[j]) << " overlap";
+    }
+  }
+}
+
+Status RunAssigner(const std::string &assigner, const ComputeGraphPtr &graph, int64_t &total_size) {
+  size_t mem_offset = 0;
+  Status ret = SUCCESS;
+  if (assigner == "binary") {
+    BinaryBlockMemAssigner block_assigner(graph);
+    ret = block_assigner.Assign();
+    mem_offset = block_assigner.GetMemOffset();
+  } else if (assigner == "max") {
+    MaxBlockMemAssigner block_assigner(graph);
+    ret = block_assigner.Assign();
+    mem_offset = block_assigner.GetMemOffset();
+  } else if (assigner == "hybrid") {
+    HybridMemAssigner hybrid_assigner(graph);
+    ret = hybrid_assigner.Assign();
+    mem_offset = hybrid_assigner.GetMemOffset();
+  } else {
+    // what ModelBuilder runs, the hybrid plan and the reassignment of the atomic and continuous memory after
+    MemoryAssigner memory_assigner(graph);
+    ret = memory_assigner.AssignMemory(false, mem_offset);
+  }
+  total_size = static_cast<int64_t>(mem_offset);
+  return ret;
+}
+
+const MemAssignerBaseline *FindBaseline(const std::string &case_name, const std::string &assigner) {
+  for (const auto &baseline : kBaselines) {
+    if (case_name == baseline.case_name && assigner == baseline.assigner) {
+      return &baseline;
+    }
+  }
+  return nullptr;
+}
+
+void ReportResult(const MemAssignerResult &result) {
+  if (IsTimingEnabled()) {
+    std::cout << "[MemAssignerBenchmark] " << result.case_name << " " << result.assigner
+              << ": plan_us=" << result.plan_us << " total_size=" << result.total_size
+              << " lower_bound=" << result.lower_bound << " fragmentation=" << result.fragmentation << std::endl;
+  }
+  const char *output_file = std::getenv(kOutputEnv);
+  if (output_file == nullptr) {
+    return;
+  }
+  nlohmann::json report = nlohmann::json::object();
+  std::ifstream input(output_file);
+  if (input.is_open()) {
+    try {
+      input >> report;
+    } catch (const nlohmann::json::exception &) {
+      report = nlohmann::json::object();
+    }
+  }
+  input.close();
+  nlohmann::json &item = report[result.case_name][result.assigner];
+  item["plan_us"] = result.plan_us;
+  item["total_size"] = result.total_size;
+  item["lower_bound"] = result.lower_bound;
+  item["fragmentation"] = result.fragmentation;
+  std::ofstream output(output_file);
+  output << report.dump(2) << std::endl;
+}
+}  // namespace
+
+class UtestMemAssignerBenchmark : public testing::Test {
+ protected:
+  void SetUp() {
+    // ReAssignMemory checks the plan against the graph memory limit
+    (void)VarManager::Instance(0)->SetMemoryMallocSize({});
+  }
+
+  void TearDown() { domi::GetContext().out_nodes_map.clear(); }
+
+  ///
+  /// Plan the graphs of build_graph with all the assigners, a fresh graph for each run as the plans are written
+  /// into the op descs. With the timing on, the planning time is the median of kRepeat runs.
+  ///
+  void RunCase(const std::string &case_name, const std::function<ComputeGraphPtr()> &build_graph) {
+    bool timing = IsTimingEnabled();
+    int repeat = timing ? kRepeat : 1;
+    for (const std::string assigner : {"binary", "max", "hybrid", "graph"}) {
+      MemAssignerResult result;
+      result.case_name = case_name;
+      result.assigner = assigner;
+      std::vector<int64_t> plan_us;
+      std::vector<LiveBuffer> buffers;
+      for (int i = 0; i < repeat; ++i) {
+        auto graph = build_graph();
+        buffers = GetLiveBuffers(graph);
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_EQ(RunAssigner(assigner, graph, result.total_size), SUCCESS) << case_name << " " << assigner;
+        auto cost = std::chrono::steady_clock::now() - start;
+        plan_us.emplace_back(std::chrono::duration_cast<std::chrono::microseconds>(cost).count());
+      }
+      std::sort(plan_us.begin(), plan_us.end());
+      result.plan_us = plan_us[plan_us.size() / 2];
+      result.lower_bound = GetPeakLiveBytes(buffers);
+      result.fragmentation = (result.total_size == 0) ? 0.0
+          : static_cast<double>(result.total_size - result.lower_bound) / static_cast<double>(result.total_size);
+      ReportResult(result);
+
+      // the buffers of the last run, whose plan is still in the op descs
+      CheckNoOverlap(case_name + " " + assigner, buffers);
+      EXPECT_GE(result.total_size, result.lower_bound) << case_name << " " << assigner;
+      auto baseline = FindBaseline(case_name, assigner);
+      if (baseline == nullptr) {
+        ADD_FAILURE() << "No baseline of " << case_name << " " << assigner << ", add {\"" << case_name << "\", \""
+                      << assigner << "\", " << result.total_size << ", " << result.plan_us << "} to kBaselines";
+        continue;
+      }
+      EXPECT_LE(result.total_size, static_cast<int64_t>(baseline->total_size * (1.0 + kMemSizeTolerance)))
+          << case_name << " " << assigner << " plans more memory than the baseline";
+      if (timing) {
+        EXPECT_TRUE(result.plan_us <= baseline->plan_us * (1.0 + kPlanTimeTolerance) ||
+                    result.plan_us - baseline->plan_us <= kPlanTimeFloorUs)
+            << case_name << " " << assigner << " plans in " << result.plan_us << "us, the baseline is "
+            << baseline->plan_us << "us";
+      }
+    }
+  }
+};
+
+TEST_F(UtestMemAssignerBenchmark, chain) {
+  RunCase("chain_256", []() { return BuildChainGraph(256); });
+  RunCase("chain_2048", []() { return BuildChainGraph(2048); });
+}
+
+TEST_F(UtestMemAssignerBenchmark, diamond) {
+  RunCase("diamond_128", []() { return BuildDiamondGraph(128); });
+}
+
+TEST_F(UtestMemAssignerBenchmark, skip_connection) {
+  RunCase("skip_32x8", []() { return BuildSkipGraph(32, 8); });
+}
+
+TEST_F(UtestMemAssignerBenchmark, workspace) {
+  RunCase("workspace_256", []() { return BuildWorkspaceGraph(256); });
+}
+
+TEST_F(UtestMemAssignerBenchmark, atomic_clean) {
+  RunCase("atomic_256", []() { return BuildAtomicGraph(256); });
+}
+}  // namespace benchmark
+}  // namespace ge
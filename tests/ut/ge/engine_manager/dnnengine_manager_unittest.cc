@@ -0,0 +1,277 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#define protected public
+#define private public
+#include "engine_manager/dnnengine_manager.h"
+#include "opskernel_manager/ops_kernel_manager.h"
+#undef private
+#undef protected
+
+#include "common/opskernel/ops_kernel_info_store.h"
+#include "common/thread_pool.h"
+#include "graph/ge_local_context.h"
+
+using namespace std;
+
+namespace ge {
+namespace {
+const char *const kAicoreStore = "StubAicoreStore";
+const char *const kAicpuStore = "StubAicpuStore";
+const char *const kAicoreEngine = "AIcoreEngine";
+const char *const kAicpuEngine = "DNN_VM_AICPU";
+const vector<string> kStubOpTypes = {"Conv2D", "Relu", "Add", "Cast", "Reshape"};
+const char *const kStubOptionKey = "ge.stubPlaceOption";
+
+// supports the ops of its data type only, and counts how many ops it checked
+class StubOpsKernelInfoStore : public OpsKernelInfoStore {
+ public:
+  StubOpsKernelInfoStore(const string &engine, DataType data_type) : engine_(engine), data_type_(data_type) {}
+
+  Status Initialize(const map<string, string> &options) override { return SUCCESS; }
+
+  Status Finalize() override { return SUCCESS; }
+
+  void GetAllOpsKernelInfo(map<string, OpInfo> &infos) const override {
+    for (const auto &op_type : kStubOpTypes) {
+      OpInfo op_info{};
+      op_info.engine = engine_;
+      infos.emplace(op_type, op_info);
+    }
+  }
+
+  bool CheckSupported(const OpDescPtr &op_desc, string &un_supported_reason) const override {
+    check_count_++;
+    string option;
+    (void)GetThreadLocalContext().GetOption(kStubOptionKey, option);
+    {
+      lock_guard<mutex> lock(option_mutex_);
+      seen_options_.insert(option);
+    }
+    // the real stores look into op info files and attrs, which costs much more than this
+    string reason;
+    for (const auto &attr : op_desc->GetAllAttrs()) {
+      reason += attr.first;
+    }
+    for (const auto &input_desc : op_desc->GetAllInputsDescPtr()) {
+      if ((data_type_ != DT_UNDEFINED) && (input_desc->GetDataType() != data_type_)) {
+        un_supported_reason = "data type is not supported, attrs are " + reason;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  Status CalcOpRunningParam(Node &node) override { return SUCCESS; }
+
+  Status GenerateTask(const Node &node, RunContext &context, vector<domi::TaskDef> &tasks) override {
+    return SUCCESS;
+  }
+
+  mutable atomic<int> check_count_{0};
+  // the values of kStubOptionKey seen in the thread local contexts of the checks
+  mutable mutex option_mutex_;
+  mutable set<string> seen_options_;
+
+ private:
+  string engine_;
+  DataType data_type_;
+};
+}  // namespace
+
+class UtestDNNEngineManager : public testing::Test {
+ protected:
+  void SetUp() {
+    aicore_store_ = make_shared<StubOpsKernelInfoStore>(kAicoreEngine, DT_FLOAT16);
+    aicpu_store_ = make_shared<StubOpsKernelInfoStore>(kAicpuEngine, DT_UNDEFINED);
+    ops_kernel_manager_.ops_kernel_store_.emplace(kAicoreStore, aicore_store_);
+    ops_kernel_manager_.ops_kernel_store_.emplace(kAicpuStore, aicpu_store_);
+    // aicore is tried first, as the real stores are ordered by priority
+    for (const auto &op_type : kStubOpTypes) {
+      OpInfo aicore_info{};
+      aicore_info.engine = kAicoreEngine;
+      aicore_info.opKernelLib = kAicoreStore;
+      OpInfo aicpu_info{};
+      aicpu_info.engine = kAicpuEngine;
+      aicpu_info.opKernelLib = kAicpuStore;
+      ops_kernel_manager_.ops_kernel_info_[op_type] = {aicore_info, aicpu_info};
+    }
+  }
+
+  void TearDown() {}
+
+  int GetCheckCount() const { return aicore_store_->check_count_ + aicpu_store_->check_count_; }
+
+  void ResetCheckCount() {
+    aicore_store_->check_count_ = 0;
+    aicpu_store_->check_count_ = 0;
+  }
+
+  // ops of the stub types with data type and rank varying by index
+  static vector<OpDescPtr> CreateOpDescs(size_t op_num, size_t rank_num) {
+    vector<OpDescPtr> op_descs;
+    for (size_t i = 0; i < op_num; ++i) {
+      const string &op_type = kStubOpTypes[i % kStubOpTypes.size()];
+      auto op_desc = make_shared<OpDesc>(op_type + to_string(i), op_type);
+      DataType data_type = ((i / kStubOpTypes.size()) % 2 == 0) ? DT_FLOAT16 : DT_FLOAT;
+      vector<int64_t> dims((i / (2 * kStubOpTypes.size())) % rank_num + 1, 4);
+      GeTensorDesc tensor_desc(GeShape(dims), FORMAT_ND, data_type);
+      op_desc->AddInputDesc(tensor_desc);
+      op_desc->AddOutputDesc(tensor_desc);
+      op_descs.emplace_back(op_desc);
+    }
+    return op_descs;
+  }
+
+  OpsKernelManager ops_kernel_manager_;
+  DNNEngineManager engine_manager_;
+  shared_ptr<StubOpsKernelInfoStore> aicore_store_;
+  shared_ptr<StubOpsKernelInfoStore> aicpu_store_;
+};
+
+TEST_F(UtestDNNEngineManager, placement_cached_by_signature) {
+  auto op_descs = CreateOpDescs(1000, 1);
+  auto uncached_op_descs = CreateOpDescs(1000, 1);
+
+  vector<string> engine_names;
+  EXPECT_EQ(engine_manager_.GetDNNEngineNames(op_descs, "", false, ops_kernel_manager_, engine_names), SUCCESS);
+  // float16 ops are checked by aicore only, float ones by aicore and then aicpu
+  EXPECT_EQ(GetCheckCount(), kStubOpTypes.size() * 3);
+
+  ResetCheckCount();
+  for (size_t i = 0; i < uncached_op_descs.size(); ++i) {
+    string engine_name = engine_manager_.CheckSupportedEngine(uncached_op_descs[i], "", ops_kernel_manager_);
+    EXPECT_EQ(engine_name, engine_names[i]);
+    EXPECT_EQ(op_descs[i]->GetOpEngineName(), uncached_op_descs[i]->GetOpEngineName());
+    EXPECT_EQ(op_descs[i]->GetOpKernelLibName(), uncached_op_descs[i]->GetOpKernelLibName());
+  }
+  EXPECT_EQ(GetCheckCount(), 1500);
+  EXPECT_EQ(engine_names[0], kAicoreEngine);
+  EXPECT_EQ(op_descs[kStubOpTypes.size()]->GetOpKernelLibName(), kAicpuStore);
+
+  // single op of a known signature hits the cache
+  ResetCheckCount();
+  auto op_desc = CreateOpDescs(1, 1)[0];
+  EXPECT_EQ(engine_manager_.GetDNNEngineName(op_desc, "", ops_kernel_manager_), kAicoreEngine);
+  EXPECT_EQ(op_desc->GetOpKernelLibName(), kAicoreStore);
+  EXPECT_EQ(GetCheckCount(), 0);
+
+  engine_manager_.ClearPlacementCache();
+  EXPECT_EQ(engine_manager_.GetDNNEngineName(op_desc, "", ops_kernel_manager_), kAicoreEngine);
+  EXPECT_EQ(GetCheckCount(), 1);
+}
+
+TEST_F(UtestDNNEngineManager, placement_keyed_by_core_type) {
+  auto op_desc = CreateOpDescs(1, 1)[0];
+  EXPECT_EQ(engine_manager_.GetDNNEngineName(op_desc, "", ops_kernel_manager_), kAicoreEngine);
+  // aicore engine is excluded under vector core, the cached placement is not used
+  EXPECT_EQ(engine_manager_.GetDNNEngineName(op_desc, "VectorEngine", ops_kernel_manager_), kAicpuEngine);
+  EXPECT_EQ(op_desc->GetOpKernelLibName(), kAicpuStore);
+  EXPECT_EQ(engine_manager_.GetDNNEngineName(op_desc, "", ops_kernel_manager_), kAicoreEngine);
+  EXPECT_EQ(op_desc->GetOpKernelLibName(), kAicoreStore);
+}
+
+TEST_F(UtestDNNEngineManager, unsupported_op_not_cached) {
+  auto unknown_op = make_shared<OpDesc>("unknown", "StubUnknownType");
+  auto op_descs = CreateOpDescs(10, 1);
+  op_descs.insert(op_descs.begin() + 5, unknown_op);
+  vector<string> engine_names;
+  EXPECT_EQ(engine_manager_.GetDNNEngineNames(op_descs, "", false, ops_kernel_manager_, engine_names), SUCCESS);
+  ASSERT_EQ(engine_names.size(), 11);
+  EXPECT_TRUE(engine_names[5].empty());
+  EXPECT_FALSE(engine_names[4].empty());
+  EXPECT_FALSE(engine_names[6].empty());
+  EXPECT_EQ(engine_manager_.placement_cache_.size(), kStubOpTypes.size() * 2);
+
+  op_descs.emplace_back(nullptr);
+  EXPECT_NE(engine_manager_.GetDNNEngineNames(op_descs, "", false, ops_kernel_manager_, engine_names), SUCCESS);
+}
+
+TEST_F(UtestDNNEngineManager, parallel_placement_same_as_serial) {
+  // 5 types, 2 data types and 4 ranks, so that the first ops are placed on the pool
+  auto op_descs = CreateOpDescs(400, 4);
+  auto serial_op_descs = CreateOpDescs(400, 4);
+  vector<string> engine_names;
+  EXPECT_EQ(engine_manager_.GetDNNEngineNames(op_descs, "", true, ops_kernel_manager_, engine_names), SUCCESS);
+  EXPECT_EQ(GetCheckCount(), kStubOpTypes.size() * 4 * 3);
+  for (size_t i = 0; i < serial_op_descs.size(); ++i) {
+    EXPECT_EQ(engine_manager_.CheckSupportedEngine(serial_op_descs[i], "", ops_kernel_manager_), engine_names[i]);
+    EXPECT_EQ(op_descs[i]->GetOpKernelLibName(), serial_op_descs[i]->GetOpKernelLibName());
+  }
+}
+
+TEST_F(UtestDNNEngineManager, parallel_placement_takes_caller_context) {
+  GEThreadLocalContext saved_context = GetThreadLocalContext();
+  GetThreadLocalContext().SetSessionOption({{kStubOptionKey, "caller"}});
+
+  vector<string> engine_names;
+  auto op_descs = CreateOpDescs(400, 4);
+  EXPECT_EQ(engine_manager_.GetDNNEngineNames(op_descs, "", true, ops_kernel_manager_, engine_names), SUCCESS);
+  EXPECT_EQ(aicore_store_->seen_options_, set<string>({"caller"}));
+  EXPECT_EQ(aicpu_store_->seen_options_, set<string>({"caller"}));
+  ThreadPool *place_pool = engine_manager_.place_pool_.get();
+  ASSERT_NE(place_pool, nullptr);
+
+  // the pool is kept for the next placement, whose workers take the new context
+  GetThreadLocalContext().SetSessionOption({{kStubOptionKey, "next"}});
+  aicore_store_->seen_options_.clear();
+  engine_manager_.ClearPlacementCache();
+  EXPECT_EQ(engine_manager_.GetDNNEngineNames(op_descs, "", true, ops_kernel_manager_, engine_names), SUCCESS);
+  EXPECT_EQ(aicore_store_->seen_options_, set<string>({"next"}));
+  EXPECT_EQ(engine_manager_.place_pool_.get(), place_pool);
+  GetThreadLocalContext() = saved_context;
+}
+
+TEST_F(UtestDNNEngineManager, serial_placement_by_default) {
+  auto op_descs = CreateOpDescs(400, 4);
+  vector<string> engine_names;
+  EXPECT_EQ(engine_manager_.GetDNNEngineNames(op_descs, "", false, ops_kernel_manager_, engine_names), SUCCESS);
+  EXPECT_EQ(engine_manager_.place_pool_, nullptr);
+  EXPECT_EQ(GetCheckCount(), kStubOpTypes.size() * 4 * 3);
+}
+
+TEST_F(UtestDNNEngineManager, place_20k_ops_same_as_per_op) {
+  const size_t op_num = 20000;
+  auto uncached_op_descs = CreateOpDescs(op_num, 4);
+  auto cached_op_descs = CreateOpDescs(op_num, 4);
+
+  // each op checked by itself, as it was done before the cache
+  for (const auto &op_desc : uncached_op_descs) {
+    EXPECT_FALSE(engine_manager_.CheckSupportedEngine(op_desc, "", ops_kernel_manager_).empty());
+  }
+  // float16 ops are checked by aicore only, float ones by aicore and then aicpu
+  EXPECT_EQ(GetCheckCount(), op_num * 3 / 2);
+  ResetCheckCount();
+  vector<string> engine_names;
+  EXPECT_EQ(engine_manager_.GetDNNEngineNames(cached_op_descs, "", true, ops_kernel_manager_, engine_names),
+            SUCCESS);
+
+  EXPECT_EQ(GetCheckCount(), kStubOpTypes.size() * 4 * 3);
+  for (size_t i = 0; i < op_num; ++i) {
+    EXPECT_EQ(uncached_op_descs[i]->GetOpEngineName(), engine_names[i]);
+    EXPECT_EQ(uncached_op_descs[i]->GetOpKernelLibName(), cached_op_descs[i]->GetOpKernelLibName());
+  }
+}
+}  // namespace ge
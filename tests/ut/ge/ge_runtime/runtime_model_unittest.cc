@@ -0,0 +1,163 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "tests/depends/runtime/src/runtime_stub.h"
+
+#define protected public
+#define private public
+#include "ge_runtime/runtime_model.h"
+#undef protected
+#undef private
+
+#include "runtime/stream.h"
+
+namespace ge {
+namespace model_runner {
+namespace {
+const uint32_t kElementNum = 3 * 1000 * 1000;
+const uint32_t kRunTimes = 3;
+}  // namespace
+
+class UtestRuntimeModel : public testing::Test {
+ protected:
+  void SetUp() { ResetRuntimeStubCounters(); }
+
+  void TearDown() {}
+
+  static std::shared_ptr<OpInfo> CreateDataInfo(uint32_t input_type, uint32_t output_type, uint32_t output_format,
+                                                uint32_t output_size, std::vector<uint8_t> &device_mem) {
+    auto data_info = std::make_shared<OpInfo>();
+    data_info->index = 0;
+    data_info->name = "data";
+    data_info->type = "Data";
+    TensorInfo input_tensor;
+    input_tensor.dims = {1, 3, 1000, 1000};
+    input_tensor.datatype = input_type;
+    input_tensor.format = FORMAT_NCHW;
+    input_tensor.real_dim_cnt = 4;
+    input_tensor.size = 0;
+    input_tensor.is_output = false;
+    TensorInfo output_tensor = input_tensor;
+    output_tensor.datatype = output_type;
+    output_tensor.format = output_format;
+    output_tensor.size = output_size;
+    data_info->input_tensors.emplace_back(input_tensor);
+    data_info->output_tensors.emplace_back(output_tensor);
+    device_mem.resize(output_size);
+    data_info->output_addrs.emplace_back(reinterpret_cast<uintptr_t>(device_mem.data()));
+    return data_info;
+  }
+
+  static InputData CreateInputData(std::vector<uint8_t> &host_mem) {
+    InputData input_data;
+    input_data.model_id = 1;
+    input_data.blobs.emplace_back(DataBuffer(host_mem.data(), static_cast<uint32_t>(host_mem.size()), false));
+    return input_data;
+  }
+
+  static void CheckSteadyState(RuntimeModel &model, const InputData &input_data, uint64_t bytes_per_run) {
+    // the first run allocates the staging buffers
+    EXPECT_TRUE(model.CopyInputData(input_data));
+    EXPECT_GT(GetRuntimeStubCounters().malloc_host_count, 0);
+    EXPECT_EQ(GetRuntimeStubCounters().memcpy_async_bytes, bytes_per_run);
+
+    ResetRuntimeStubCounters();
+    for (uint32_t i = 0; i < kRunTimes; ++i) {
+      EXPECT_TRUE(model.CopyInputData(input_data));
+    }
+    EXPECT_EQ(GetRuntimeStubCounters().malloc_host_count, 0);
+    EXPECT_EQ(GetRuntimeStubCounters().free_host_count, 0);
+    EXPECT_EQ(GetRuntimeStubCounters().memcpy_count, 0);
+    EXPECT_EQ(GetRuntimeStubCounters().memcpy_async_bytes, bytes_per_run * kRunTimes);
+  }
+};
+
+TEST_F(UtestRuntimeModel, copy_host_data_by_staging_ring) {
+  uint32_t size = kElementNum * sizeof(float);
+  std::vector<uint8_t> device_mem;
+  std::vector<uint8_t> host_mem(size, 1);
+  RuntimeModel model;
+  ASSERT_EQ(rtStreamCreate(&model.rt_model_stream_, 0), RT_ERROR_NONE);
+  model.data_info_list_.emplace_back(CreateDataInfo(DT_FLOAT, DT_FLOAT, FORMAT_NCHW, size, device_mem));
+
+  auto input_data = CreateInputData(host_mem);
+  CheckSteadyState(model, input_data, size);
+  // the input is larger than a slot, it is copied by several chunks
+  uint32_t chunk_num = (size + model.staging_ring_.GetSlotSize() - 1) / model.staging_ring_.GetSlotSize();
+  EXPECT_GT(chunk_num, 1);
+  EXPECT_EQ(GetRuntimeStubCounters().memcpy_async_count, chunk_num * kRunTimes);
+}
+
+TEST_F(UtestRuntimeModel, copy_cast_data_by_chunk) {
+  uint32_t size = kElementNum * sizeof(uint16_t);
+  std::vector<uint8_t> device_mem;
+  std::vector<uint8_t> host_mem(kElementNum * sizeof(float), 0);
+  RuntimeModel model;
+  ASSERT_EQ(rtStreamCreate(&model.rt_model_stream_, 0), RT_ERROR_NONE);
+  model.data_info_list_.emplace_back(CreateDataInfo(DT_FLOAT, DT_FLOAT16, FORMAT_NCHW, size, device_mem));
+
+  auto input_data = CreateInputData(host_mem);
+  CheckSteadyState(model, input_data, size);
+  // the full chunks share one pair of descs, the tail has its own
+  EXPECT_EQ(model.chunk_tensor_desc_list_["data"].size(), 2);
+  EXPECT_FALSE(model.trans_staging_.IsInited());
+}
+
+TEST_F(UtestRuntimeModel, copy_trans_data_by_whole) {
+  // NCHW to NC1HWC0 moves the elements across the tensor, it is converted as a whole
+  uint32_t size = 1 * 1 * 1000 * 1000 * 16 * sizeof(uint16_t);
+  std::vector<uint8_t> device_mem;
+  std::vector<uint8_t> host_mem(kElementNum * sizeof(float), 0);
+  RuntimeModel model;
+  ASSERT_EQ(rtStreamCreate(&model.rt_model_stream_, 0), RT_ERROR_NONE);
+  model.data_info_list_.emplace_back(CreateDataInfo(DT_FLOAT, DT_FLOAT16, FORMAT_NC1HWC0, size, device_mem));
+
+  auto input_data = CreateInputData(host_mem);
+  CheckSteadyState(model, input_data, size);
+  EXPECT_EQ(GetRuntimeStubCounters().memcpy_async_count, kRunTimes);
+  EXPECT_TRUE(model.trans_staging_.IsInited());
+  EXPECT_EQ(model.trans_staging_.GetSlotSize(), size);
+}
+
+TEST_F(UtestRuntimeModel, staging_ring_release) {
+  StagingRing ring;
+  void *buffer = nullptr;
+  EXPECT_FALSE(ring.Acquire(buffer));
+  EXPECT_FALSE(ring.Init(0, 1024));
+  ASSERT_TRUE(ring.Init(2, 1024));
+  EXPECT_EQ(GetRuntimeStubCounters().malloc_host_count, 2);
+
+  ASSERT_TRUE(ring.Acquire(buffer));
+  EXPECT_NE(buffer, nullptr);
+  std::vector<uint8_t> device_mem(2048);
+  EXPECT_FALSE(ring.Submit(device_mem.data(), device_mem.size(), 2048, nullptr));
+  EXPECT_TRUE(ring.Submit(device_mem.data(), device_mem.size(), 1024, nullptr));
+  void *next_buffer = nullptr;
+  ASSERT_TRUE(ring.Acquire(next_buffer));
+  EXPECT_NE(next_buffer, buffer);
+  EXPECT_TRUE(ring.Synchronize());
+
+  ring.Release();
+  EXPECT_FALSE(ring.IsInited());
+  EXPECT_EQ(GetRuntimeStubCounters().free_host_count, 2);
+}
+}  // namespace model_runner
+}  // namespace ge
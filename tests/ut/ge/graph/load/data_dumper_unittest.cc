@@ -16,6 +16,10 @@
 
 #include <gtest/gtest.h>
 
+#include "external/ge/ge_api_types.h"
+#include "graph/utils/tensor_utils.h"
+#include "proto/op_mapping_info.pb.h"
+
 #define private public
 #define protected public
 #include "graph/load/new_model_manager/data_dumper.h"
@@ -31,6 +35,43 @@ class UtestDataDumper : public testing::Test {
   void SetUp() {}
 
   void TearDown() {}
+
+  // every output is 64 bytes, placed one after another
+  static OpDescPtr CreateOp(const std::string &name, const std::string &type, size_t output_num = 1) {
+    static int64_t offset = 0;
+    OpDescPtr op_desc = std::make_shared<OpDesc>(name, type);
+    std::vector<int64_t> output_offset;
+    for (size_t i = 0; i < output_num; ++i) {
+      GeTensorDesc tensor_desc(GeShape({16}), FORMAT_ND, DT_FLOAT);
+      TensorUtils::SetSize(tensor_desc, 64);
+      op_desc->AddOutputDesc(tensor_desc);
+      output_offset.emplace_back(offset);
+      offset += 64;
+    }
+    op_desc->SetOutputOffset(output_offset);
+    return op_desc;
+  }
+
+  static void InitDumper(DataDumper &data_dumper, const std::map<std::string, std::string> &options) {
+    static uint8_t mem_base[4096];
+    RuntimeParam runtime_param;
+    runtime_param.mem_base = mem_base;
+    runtime_param.mem_size = sizeof(mem_base);
+    data_dumper.SetModelName("test");
+    data_dumper.SetModelId(2333);
+    data_dumper.SetMemory(runtime_param);
+    EXPECT_EQ(data_dumper.SetDumpFilter(options), SUCCESS);
+  }
+
+  static std::vector<std::string> GetDumpOpNames(DataDumper &data_dumper) {
+    aicpu::dump::OpMappingInfo op_mapping_info;
+    EXPECT_EQ(data_dumper.BuildOpMappingInfo(op_mapping_info), SUCCESS);
+    std::vector<std::string> names;
+    for (const auto &task : op_mapping_info.task()) {
+      names.emplace_back(task.op().op_name());
+    }
+    return names;
+  }
 };
 
 std::vector<void *> stub_get_output_addrs(const RuntimeParam &model_param, ConstOpDescPtr op_desc) {
@@ -60,4 +101,108 @@ TEST_F(UtestDataDumper, UnloadDumpInfo_success) {
   Status ret = data_dumper.UnloadDumpInfo();
   EXPECT_EQ(ret, SUCCESS);
 }
+
+TEST_F(UtestDataDumper, dump_filter_by_op_name_and_type) {
+  DataDumper data_dumper;
+  InitDumper(data_dumper, {{OPTION_EXEC_DUMP_OP_NAME, "^layer1/"}, {OPTION_EXEC_DUMP_OP_TYPE, "Conv2D, MatMul"}});
+  data_dumper.SaveDumpTask(0, CreateOp("layer1/conv", "Conv2D"), 0);
+  data_dumper.SaveDumpTask(1, CreateOp("layer1/relu", "Relu"), 0);
+  data_dumper.SaveDumpTask(2, CreateOp("layer2/conv", "Conv2D"), 0);
+  data_dumper.SaveDumpTask(3, CreateOp("layer1/fc", "MatMul"), 0);
+
+  std::vector<std::string> names = GetDumpOpNames(data_dumper);
+  ASSERT_EQ(names.size(), 2);
+  EXPECT_EQ(names[0], "layer1/conv");
+  EXPECT_EQ(names[1], "layer1/fc");
+}
+
+TEST_F(UtestDataDumper, dump_filter_by_index) {
+  DataDumper data_dumper;
+  InitDumper(data_dumper, {{OPTION_EXEC_DUMP_INPUT_INDEX, "1"}, {OPTION_EXEC_DUMP_OUTPUT_INDEX, "0,2"}});
+  OpDescPtr data_0 = CreateOp("data_0", "Data");
+  OpDescPtr data_1 = CreateOp("data_1", "Data");
+  data_dumper.input_map_.insert({"add", {data_0, 0, 0}});
+  data_dumper.input_map_.insert({"add", {data_1, 1, 0}});
+  data_dumper.SaveDumpTask(0, CreateOp("add", "Add", 3), sizeof(void *) * 2);
+
+  aicpu::dump::OpMappingInfo op_mapping_info;
+  EXPECT_EQ(data_dumper.BuildOpMappingInfo(op_mapping_info), SUCCESS);
+  ASSERT_EQ(op_mapping_info.task_size(), 2);
+  EXPECT_EQ(op_mapping_info.task(0).op().op_name(), "add");
+  EXPECT_EQ(op_mapping_info.task(0).output_size(), 2);
+  EXPECT_EQ(op_mapping_info.task(1).op().op_name(), "data_1");
+}
+
+TEST_F(UtestDataDumper, dump_filter_by_iteration) {
+  DataDumper data_dumper;
+  InitDumper(data_dumper, {{OPTION_EXEC_DUMP_STEP, "2-6"}, {OPTION_EXEC_DUMP_INTERVAL, "2"}});
+  data_dumper.SaveDumpTask(0, CreateOp("conv", "Conv2D"), 0);
+
+  EXPECT_EQ(data_dumper.LoadDumpInfo(), SUCCESS);
+  EXPECT_FALSE(data_dumper.load_flag_);
+  EXPECT_FALSE(data_dumper.load_proto_.empty());
+
+  std::vector<bool> loaded;
+  for (int i = 1; i <= 8; ++i) {
+    EXPECT_EQ(data_dumper.OnIterationEnd(), SUCCESS);
+    loaded.emplace_back(data_dumper.load_flag_);
+  }
+  // iteration 1 to 8
+  std::vector<bool> expect_loaded = {false, true, false, true, false, true, false, false};
+  EXPECT_EQ(loaded, expect_loaded);
+}
+
+TEST_F(UtestDataDumper, dump_filter_by_max_bytes) {
+  DataDumper data_dumper;
+  InitDumper(data_dumper, {{OPTION_EXEC_DUMP_MAX_BYTES, "256"}});
+  data_dumper.SaveDumpTask(0, CreateOp("conv", "Conv2D"), 0);
+  data_dumper.SaveDumpTask(1, CreateOp("relu", "Relu"), 0);
+  data_dumper.SaveDumpTask(2, CreateOp("split", "Split", 4), 0);
+
+  // split does not fit into the budget
+  std::vector<std::string> names = GetDumpOpNames(data_dumper);
+  ASSERT_EQ(names.size(), 2);
+  EXPECT_EQ(data_dumper.iteration_dump_bytes_, 128);
+
+  // two iterations fit
+  EXPECT_EQ(data_dumper.LoadDumpInfo(), SUCCESS);
+  EXPECT_TRUE(data_dumper.load_flag_);
+  EXPECT_EQ(data_dumper.OnIterationEnd(), SUCCESS);
+  EXPECT_TRUE(data_dumper.load_flag_);
+  EXPECT_EQ(data_dumper.OnIterationEnd(), SUCCESS);
+  EXPECT_FALSE(data_dumper.load_flag_);
+}
+
+TEST_F(UtestDataDumper, dump_filter_invalid_option) {
+  DumpFilter dump_filter;
+  EXPECT_EQ(dump_filter.Init({{OPTION_EXEC_DUMP_OP_NAME, "conv("}}), PARAM_INVALID);
+  EXPECT_EQ(dump_filter.Init({{OPTION_EXEC_DUMP_STEP, "6-2"}}), PARAM_INVALID);
+  EXPECT_EQ(dump_filter.Init({{OPTION_EXEC_DUMP_STEP, "a"}}), PARAM_INVALID);
+  EXPECT_EQ(dump_filter.Init({{OPTION_EXEC_DUMP_INTERVAL, "0"}}), PARAM_INVALID);
+  EXPECT_EQ(dump_filter.Init({{OPTION_EXEC_DUMP_OUTPUT_INDEX, "0,-1"}}), PARAM_INVALID);
+  EXPECT_EQ(dump_filter.Init({{OPTION_EXEC_DUMP_MAX_BYTES, "1G"}}), PARAM_INVALID);
+
+  // the valid options before the invalid one do not take effect either
+  EXPECT_EQ(dump_filter.Init({{OPTION_EXEC_DUMP_INPUT_INDEX, "1"},
+                              {OPTION_EXEC_DUMP_OP_NAME, "conv"},
+                              {OPTION_EXEC_DUMP_OUTPUT_INDEX, "0"},
+                              {OPTION_EXEC_DUMP_STEP, "x-y"}}),
+            PARAM_INVALID);
+  EXPECT_TRUE(dump_filter.IsOpNeedDump(std::make_shared<OpDesc>("relu", "Relu")));
+  EXPECT_TRUE(dump_filter.IsInputNeedDump(0));
+  EXPECT_TRUE(dump_filter.IsOutputNeedDump(1));
+
+  // an invalid init drops the filter of the last valid one
+  DumpFilter valid_filter;
+  EXPECT_EQ(valid_filter.Init({{OPTION_EXEC_DUMP_OP_TYPE, "Conv2D"}}), SUCCESS);
+  EXPECT_FALSE(valid_filter.IsOpNeedDump(std::make_shared<OpDesc>("relu", "Relu")));
+  EXPECT_EQ(valid_filter.Init({{OPTION_EXEC_DUMP_INTERVAL, "0"}}), PARAM_INVALID);
+  EXPECT_TRUE(valid_filter.IsOpNeedDump(std::make_shared<OpDesc>("relu", "Relu")));
+
+  DumpFilter default_filter;
+  EXPECT_EQ(default_filter.Init({}), SUCCESS);
+  EXPECT_TRUE(default_filter.IsOpNeedDump(std::make_shared<OpDesc>("any", "Any")));
+  EXPECT_TRUE(default_filter.IsOutputNeedDump(3));
+  EXPECT_TRUE(default_filter.IsIterationNeedDump(12345));
+}
 }  // namespace ge
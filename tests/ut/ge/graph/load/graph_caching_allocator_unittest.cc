@@ -0,0 +1,198 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "runtime/rt.h"
+#include "tests/depends/runtime/src/runtime_stub.h"
+
+#define protected public
+#define private public
+#include "graph/manager/graph_caching_allocator.h"
+#include "graph/load/new_model_manager/task_info/kernel_task_info.h"
+#include "graph/manager/graph_mem_allocator.h"
+#include "single_op/stream_resource.h"
+#undef protected
+#undef private
+
+namespace ge {
+class UtestGraphCachingAllocator : public testing::Test {
+ protected:
+  void SetUp() {
+    MemManager::CachingInstance(RT_MEMORY_HBM)->EmptyCache();
+    ResetRuntimeStubCounters();
+  }
+
+  void TearDown() { MemManager::CachingInstance(RT_MEMORY_HBM)->EmptyCache(); }
+};
+
+TEST_F(UtestGraphCachingAllocator, round_size) {
+  EXPECT_EQ(CachingAllocator::RoundSize(0), kSmallRoundSize);
+  EXPECT_EQ(CachingAllocator::RoundSize(1), kSmallRoundSize);
+  EXPECT_EQ(CachingAllocator::RoundSize(513), 2 * kSmallRoundSize);
+  EXPECT_EQ(CachingAllocator::RoundSize(kLargeBlockThreshold), kLargeRoundSize);
+  EXPECT_EQ(CachingAllocator::RoundSize(kLargeRoundSize + 1), 2 * kLargeRoundSize);
+}
+
+TEST_F(UtestGraphCachingAllocator, reuse_freed_block) {
+  CachingAllocator allocator(RT_MEMORY_HBM);
+  allocator.SetBypass(false);
+
+  uint8_t *first = allocator.Malloc(1000);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(allocator.Free(first), SUCCESS);
+
+  // same bin, served from the cache
+  uint8_t *second = allocator.Malloc(900);
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(allocator.Free(second), SUCCESS);
+
+  // far bigger than the cached block, goes to runtime
+  uint8_t *third = allocator.Malloc(10000);
+  EXPECT_NE(third, first);
+  EXPECT_EQ(allocator.Free(third), SUCCESS);
+
+  MemoryStatistics statistics = allocator.GetStatistics();
+  EXPECT_EQ(statistics.rt_malloc_count, 2);
+  EXPECT_EQ(statistics.cache_hit_count, 1);
+  EXPECT_EQ(statistics.cache_miss_count, 2);
+  EXPECT_EQ(GetRuntimeStubCounters().malloc_count, 2);
+}
+
+TEST_F(UtestGraphCachingAllocator, free_list_per_stream) {
+  CachingAllocator allocator(RT_MEMORY_HBM);
+  allocator.SetBypass(false);
+  rtStream_t stream_a = reinterpret_cast<rtStream_t>(0x1000);
+  rtStream_t stream_b = reinterpret_cast<rtStream_t>(0x2000);
+
+  uint8_t *addr_a = allocator.Malloc(4096, stream_a);
+  ASSERT_NE(addr_a, nullptr);
+  EXPECT_EQ(allocator.Free(addr_a), SUCCESS);
+
+  uint8_t *addr_b = allocator.Malloc(4096, stream_b);
+  EXPECT_NE(addr_b, addr_a);
+  EXPECT_EQ(allocator.Malloc(4096, stream_a), addr_a);
+  EXPECT_EQ(allocator.GetStatistics().rt_malloc_count, 2);
+}
+
+TEST_F(UtestGraphCachingAllocator, statistics_and_empty_cache) {
+  CachingAllocator allocator(RT_MEMORY_HBM);
+  allocator.SetBypass(false);
+
+  uint8_t *small = allocator.Malloc(100);
+  uint8_t *large = allocator.Malloc(kLargeBlockThreshold + 1);
+  MemoryStatistics statistics = allocator.GetStatistics();
+  EXPECT_EQ(statistics.allocated_bytes, kSmallRoundSize + kLargeRoundSize);
+  EXPECT_EQ(statistics.requested_bytes, 100 + kLargeBlockThreshold + 1);
+  EXPECT_EQ(statistics.reserved_bytes, kSmallRoundSize + kLargeRoundSize);
+  EXPECT_GT(statistics.Fragmentation(), 0.0);
+  EXPECT_LT(statistics.Fragmentation(), 1.0);
+
+  EXPECT_EQ(allocator.Free(small), SUCCESS);
+  EXPECT_EQ(allocator.Free(large), SUCCESS);
+  statistics = allocator.GetStatistics();
+  EXPECT_EQ(statistics.allocated_bytes, 0);
+  EXPECT_EQ(statistics.reserved_bytes, kSmallRoundSize + kLargeRoundSize);
+  EXPECT_EQ(statistics.peak_allocated_bytes, kSmallRoundSize + kLargeRoundSize);
+  EXPECT_EQ(statistics.Fragmentation(), 1.0);
+
+  allocator.EmptyCache();
+  statistics = allocator.GetStatistics();
+  EXPECT_EQ(statistics.reserved_bytes, 0);
+  EXPECT_EQ(statistics.rt_free_count, 2);
+  EXPECT_EQ(statistics.Fragmentation(), 0.0);
+  EXPECT_EQ(GetRuntimeStubCounters().free_count, 2);
+}
+
+TEST_F(UtestGraphCachingAllocator, bypass_cache) {
+  CachingAllocator allocator(RT_MEMORY_HBM);
+  allocator.SetBypass(true);
+
+  for (int i = 0; i < 3; ++i) {
+    uint8_t *addr = allocator.Malloc(1024);
+    ASSERT_NE(addr, nullptr);
+    EXPECT_EQ(allocator.Free(addr), SUCCESS);
+  }
+  MemoryStatistics statistics = allocator.GetStatistics();
+  EXPECT_EQ(statistics.rt_malloc_count, 3);
+  EXPECT_EQ(statistics.rt_free_count, 3);
+  EXPECT_EQ(statistics.reserved_bytes, 0);
+}
+
+TEST_F(UtestGraphCachingAllocator, free_unknown_memory) {
+  CachingAllocator allocator(RT_MEMORY_HBM);
+  EXPECT_EQ(allocator.Free(nullptr), PARAM_INVALID);
+
+  void *addr = nullptr;
+  ASSERT_EQ(rtMalloc(&addr, 64, RT_MEMORY_HBM), RT_ERROR_NONE);
+  EXPECT_EQ(allocator.Free(static_cast<uint8_t *>(addr)), SUCCESS);
+  EXPECT_EQ(GetRuntimeStubCounters().free_count, 1);
+}
+
+TEST_F(UtestGraphCachingAllocator, repeated_model_load_unload) {
+  MemoryAllocator memory_allocator(RT_MEMORY_HBM);
+  const uint64_t feature_map_size = 16 * 1024 * 1024;
+  const uint64_t weight_size = 3 * 1024 * 1024;
+
+  for (int i = 0; i < 10; ++i) {
+    uint8_t *mem_base = memory_allocator.MallocMemory(feature_map_size);
+    uint8_t *weights_mem_base = memory_allocator.MallocMemory(weight_size);
+    ASSERT_NE(mem_base, nullptr);
+    ASSERT_NE(weights_mem_base, nullptr);
+    EXPECT_EQ(memory_allocator.FreeMemory(mem_base), SUCCESS);
+    EXPECT_EQ(memory_allocator.FreeMemory(weights_mem_base), SUCCESS);
+  }
+
+  // only the first load reaches runtime
+  EXPECT_EQ(GetRuntimeStubCounters().malloc_count, 2);
+  EXPECT_EQ(GetRuntimeStubCounters().free_count, 0);
+}
+
+TEST_F(UtestGraphCachingAllocator, repeated_single_op_resource) {
+  rtStream_t stream = reinterpret_cast<rtStream_t>(0x3000);
+  for (int i = 0; i < 10; ++i) {
+    StreamResource res;
+    res.SetStream(stream);
+    ASSERT_NE(res.MallocMemory(2048), nullptr);
+    ASSERT_NE(res.MallocWeight(512), nullptr);
+  }
+
+  EXPECT_EQ(GetRuntimeStubCounters().malloc_count, 2);
+}
+
+TEST_F(UtestGraphCachingAllocator, repeated_kernel_task_args) {
+  const uint32_t args_size = 256;
+  CachingAllocator *caching_allocator = MemManager::CachingInstance(RT_MEMORY_HBM);
+  uint64_t hit_count = caching_allocator->GetStatistics().cache_hit_count;
+  uint8_t *first_args = nullptr;
+  for (int i = 0; i < 10; ++i) {
+    // every load creates its own streams
+    KernelTaskInfo kernel_task_info;
+    kernel_task_info.stream_ = reinterpret_cast<rtStream_t>(0x4000 + i * 0x100);
+    ASSERT_EQ(kernel_task_info.MallocArgs(args_size), SUCCESS);
+    ASSERT_NE(kernel_task_info.args_, nullptr);
+    if (first_args == nullptr) {
+      first_args = static_cast<uint8_t *>(kernel_task_info.args_);
+    }
+    EXPECT_EQ(kernel_task_info.args_, first_args);
+    kernel_task_info.FreeArgs();
+    EXPECT_EQ(kernel_task_info.args_, nullptr);
+  }
+
+  EXPECT_EQ(GetRuntimeStubCounters().malloc_count, 1);
+  EXPECT_EQ(caching_allocator->GetStatistics().cache_hit_count - hit_count, 9);
+}
+}  // namespace ge
@@ -0,0 +1,209 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/ge/ge_util.h"
+#include "common/helper/model_helper.h"
+#include "common/model_parser/base.h"
+#include "common/tbe_kernel_store.h"
+#include "framework/common/types.h"
+#include "graph/utils/graph_utils.h"
+#include "model/ge_model.h"
+
+using namespace std;
+
+namespace ge {
+namespace {
+const char *const kModelFile = "./ut_model_helper_lazy_load.om";
+const char *const kKernelName = "te_conv2d_kernel";
+const size_t kLargeWeightSize = 256 * 1024 * 1024;
+const int kLargeTaskNum = 20000;
+}  // namespace
+
+class UtestModelHelper : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() { (void)remove(kModelFile); }
+
+  static size_t GetResidentBytes() {
+    ifstream statm("/proc/self/statm");
+    size_t total_pages = 0;
+    size_t resident_pages = 0;
+    statm >> total_pages >> resident_pages;
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  }
+
+  static void SaveModel(size_t weight_size, int task_num) {
+    auto compute_graph = make_shared<ComputeGraph>("lazy_load_graph");
+    auto op_desc = make_shared<OpDesc>("data", DATA);
+    op_desc->AddOutputDesc(GeTensorDesc(GeShape(vector<int64_t>{1, 3, 224, 224})));
+    (void)compute_graph->AddNode(op_desc);
+
+    auto ge_model = MakeShared<GeModel>();
+    ASSERT_NE(ge_model, nullptr);
+    ge_model->SetName("lazy_load_model");
+    ge_model->SetGraph(GraphUtils::CreateGraphFromComputeGraph(compute_graph));
+    Buffer weight(weight_size);
+    for (size_t i = 0; i < weight_size; i += 4096) {
+      weight.GetData()[i] = static_cast<uint8_t>(i / 4096);
+    }
+    ge_model->SetWeight(weight);
+
+    auto task_def = MakeShared<domi::ModelTaskDef>();
+    ASSERT_NE(task_def, nullptr);
+    task_def->set_stream_num(1);
+    for (int i = 0; i < task_num; ++i) {
+      auto task = task_def->add_task();
+      task->set_type(i % 8);
+      task->set_stream_id(0);
+    }
+    ge_model->SetModelTaskDef(task_def);
+
+    TBEKernelStore kernel_store;
+    string kernel_content = "kernel bin of conv2d";
+    kernel_store.AddTBEKernel(
+        make_shared<OpKernelBin>(kKernelName, vector<char>(kernel_content.begin(), kernel_content.end())));
+    ASSERT_TRUE(kernel_store.Build());
+    ge_model->SetTBEKernelStore(kernel_store);
+
+    ModelHelper model_helper;
+    ASSERT_EQ(model_helper.SaveToOmModel(ge_model, SaveParam(), kModelFile), SUCCESS);
+  }
+};
+
+TEST_F(UtestModelHelper, lazy_load_same_as_eager) {
+  SaveModel(64 * 1024, 100);
+
+  ModelData model_data;
+  ASSERT_EQ(ModelParserBase::LoadFromFile(kModelFile, "", 0, model_data), SUCCESS);
+  ModelHelper eager_helper;
+  ASSERT_EQ(eager_helper.LoadModel(model_data), SUCCESS);
+  auto eager_model = eager_helper.GetGeModel();
+
+  auto model_file = MakeShared<MappedModelFile>();
+  ASSERT_NE(model_file, nullptr);
+  ASSERT_EQ(model_file->Map(kModelFile, 0), SUCCESS);
+  ModelHelper lazy_helper;
+  ASSERT_EQ(lazy_helper.LoadModelLazily(model_file->GetModelData(), model_file), SUCCESS);
+  auto lazy_model = lazy_helper.GetGeModel();
+  const ModelData &mapped_data = model_file->GetModelData();
+  const uint8_t *mapped_begin = static_cast<const uint8_t *>(mapped_data.model_data);
+  model_file = nullptr;
+
+  // the lazy model keeps the mapping, its weights are a view into the file
+  EXPECT_EQ(lazy_model->GetName(), eager_model->GetName());
+  ASSERT_EQ(lazy_model->GetWeightSize(), eager_model->GetWeightSize());
+  EXPECT_GE(lazy_model->GetWeightData(), mapped_begin);
+  EXPECT_LT(lazy_model->GetWeightData(), mapped_begin + mapped_data.model_len);
+  EXPECT_EQ(memcmp(lazy_model->GetWeightData(), eager_model->GetWeightData(), eager_model->GetWeightSize()), 0);
+  EXPECT_EQ(lazy_model->GetWeight().GetSize(), eager_model->GetWeightSize());
+
+  auto lazy_task = lazy_model->GetModelTaskDefPtr();
+  ASSERT_NE(lazy_task, nullptr);
+  EXPECT_EQ(lazy_task->task_size(), 100);
+  EXPECT_EQ(lazy_task->SerializeAsString(), eager_model->GetModelTaskDefPtr()->SerializeAsString());
+  EXPECT_EQ(lazy_model->GetModelTaskDefPtr(), lazy_task);
+
+  EXPECT_NE(lazy_model->GetTBEKernelStore().FindTBEKernel(kKernelName), nullptr);
+  EXPECT_NE(eager_model->GetTBEKernelStore().FindTBEKernel(kKernelName), nullptr);
+
+  delete[] static_cast<char *>(model_data.model_data);
+}
+
+TEST_F(UtestModelHelper, lazy_load_invalid_file) {
+  MappedModelFile model_file;
+  EXPECT_NE(model_file.Map("./not_exist_model.om", 0), SUCCESS);
+  EXPECT_EQ(model_file.GetModelData().model_data, nullptr);
+
+  ModelHelper model_helper;
+  EXPECT_NE(model_helper.LoadModelLazily(model_file.GetModelData(), nullptr), SUCCESS);
+}
+
+TEST_F(UtestModelHelper, lazy_load_weight_copied_once) {
+  SaveModel(64 * 1024, 10);
+  MappedModelFile model_file;
+  ASSERT_EQ(model_file.Map(kModelFile, 0), SUCCESS);
+  auto owner = MakeShared<int>(0);
+  ModelHelper lazy_helper;
+  ASSERT_EQ(lazy_helper.LoadModelLazily(model_file.GetModelData(), owner), SUCCESS);
+  auto lazy_model = lazy_helper.GetGeModel();
+  const uint8_t *view = lazy_model->GetWeightData();
+
+  // the first get copies the view, the later ones share the copy
+  Buffer first = lazy_model->GetWeight();
+  Buffer second = lazy_model->GetWeight();
+  ASSERT_EQ(first.GetSize(), 64 * 1024);
+  EXPECT_NE(first.GetData(), view);
+  EXPECT_EQ(second.GetData(), first.GetData());
+  EXPECT_EQ(lazy_model->GetWeightData(), first.GetData());
+  EXPECT_EQ(lazy_model->GetWeightSize(), first.GetSize());
+  EXPECT_EQ(memcmp(first.GetData(), view, first.GetSize()), 0);
+}
+
+TEST_F(UtestModelHelper, lazy_load_broken_task_def) {
+  const uint8_t broken[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+  GeModel ge_model;
+  ge_model.SetModelTaskDefData(broken, sizeof(broken));
+  EXPECT_EQ(ge_model.LoadModelTaskDef(), INTERNAL_ERROR);
+  EXPECT_EQ(ge_model.GetModelTaskDefPtr(), nullptr);
+
+  // a set task def replaces the broken partition
+  ge_model.SetModelTaskDef(MakeShared<domi::ModelTaskDef>());
+  EXPECT_EQ(ge_model.LoadModelTaskDef(), SUCCESS);
+  EXPECT_NE(ge_model.GetModelTaskDefPtr(), nullptr);
+}
+
+TEST_F(UtestModelHelper, lazy_load_256m_weights_not_resident) {
+  SaveModel(kLargeWeightSize, kLargeTaskNum);
+
+  size_t rss_begin = GetResidentBytes();
+  ModelData model_data;
+  ASSERT_EQ(ModelParserBase::LoadFromFile(kModelFile, "", 0, model_data), SUCCESS);
+  auto eager_helper = MakeShared<ModelHelper>();
+  ASSERT_NE(eager_helper, nullptr);
+  ASSERT_EQ(eager_helper->LoadModel(model_data), SUCCESS);
+  size_t eager_rss = GetResidentBytes() - rss_begin;
+  EXPECT_EQ(eager_helper->GetGeModel()->GetModelTaskDefPtr()->task_size(), kLargeTaskNum);
+  eager_helper = nullptr;
+  delete[] static_cast<char *>(model_data.model_data);
+
+  rss_begin = GetResidentBytes();
+  auto model_file = MakeShared<MappedModelFile>();
+  ASSERT_NE(model_file, nullptr);
+  ASSERT_EQ(model_file->Map(kModelFile, 0), SUCCESS);
+  ModelHelper lazy_helper;
+  ASSERT_EQ(lazy_helper.LoadModelLazily(model_file->GetModelData(), model_file), SUCCESS);
+  size_t lazy_rss = GetResidentBytes() - rss_begin;
+  auto lazy_model = lazy_helper.GetGeModel();
+  EXPECT_EQ(lazy_model->GetWeightSize(), kLargeWeightSize);
+  EXPECT_EQ(lazy_model->GetWeightData()[4096], 1);
+  EXPECT_EQ(lazy_model->GetModelTaskDefPtr()->task_size(), kLargeTaskNum);
+
+  // the eager load holds the file and a copy of the weights, the lazy one only the pages it parsed
+  EXPECT_GT(eager_rss, kLargeWeightSize);
+  EXPECT_LT(lazy_rss, kLargeWeightSize / 16);
+}
+}  // namespace ge
@@ -0,0 +1,262 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "graph/utils/tensor_utils.h"
+#include "runtime/base.h"
+#include "tests/depends/runtime/src/runtime_stub.h"
+
+#define protected public
+#define private public
+#include "graph/load/new_model_manager/davinci_model.h"
+#include "graph/load/new_model_manager/model_manager.h"
+#include "graph/load/new_model_manager/model_metrics.h"
+#undef protected
+#undef private
+
+namespace ge {
+namespace {
+const uint32_t kModelId = 1;
+const uint32_t kTensorSize = 64;
+const int64_t kOutputOffset = 128;
+const size_t kModelMemSize = 1024;
+const uint32_t kExecuteDelayUs = 2000;
+
+// counts the results of the executions
+class MetricsListener : public ModelListener {
+ public:
+  Status OnComputeDone(uint32_t model_id, uint32_t data_index, uint32_t result_code) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++done_count_;
+    if (result_code != SUCCESS) {
+      ++fail_count_;
+    }
+    cond_.notify_all();
+    return SUCCESS;
+  }
+
+  bool WaitDone(uint32_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cond_.wait_for(lock, std::chrono::seconds(10), [&] { return done_count_ >= count; });
+  }
+
+  uint32_t GetFailCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fail_count_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  uint32_t done_count_ = 0;
+  uint32_t fail_count_ = 0;
+};
+
+GeTensorDesc CreateTensorDesc() {
+  GeTensorDesc desc(GeShape({kTensorSize / sizeof(float)}), FORMAT_ND, DT_FLOAT);
+  TensorUtils::SetSize(desc, kTensorSize);
+  return desc;
+}
+}  // namespace
+
+class UtestModelMetrics : public testing::Test {
+ protected:
+  void SetUp() {
+    ResetRuntimeStubCounters();
+    memory_.resize(kModelMemSize);
+  }
+
+  void TearDown() { ResetRuntimeStubCounters(); }
+
+  // Data -> NetOutput, which copies one tensor in and one tensor out
+  std::shared_ptr<DavinciModel> CreateModel(const std::shared_ptr<ModelListener> &listener) {
+    auto model = std::make_shared<DavinciModel>(0, listener);
+    model->SetId(kModelId);
+    model->mem_base_ = memory_.data();
+    model->runtime_param_.mem_size = kModelMemSize;
+
+    auto data = std::make_shared<OpDesc>("data", "Data");
+    data->AddInputDesc(CreateTensorDesc());
+    data->AddOutputDesc(CreateTensorDesc());
+    data->SetOutputOffset({0});
+    model->data_op_list_.push_back(data);
+
+    auto net_output = std::make_shared<OpDesc>("net_output", "NetOutput");
+    net_output->AddInputDesc(CreateTensorDesc());
+    net_output->SetInputOffset({kOutputOffset});
+    model->output_op_list_.push_back(net_output);
+
+    model->data_inputer_ = new DataInputer();
+    return model;
+  }
+
+  void RunModel(ModelManager &manager, uint32_t run_num) {
+    std::vector<uint8_t> input(kTensorSize);
+    std::vector<uint8_t> output(kTensorSize);
+    for (uint32_t i = 0; i < run_num; ++i) {
+      InputData input_data;
+      input_data.index = i;
+      input_data.model_id = kModelId;
+      input_data.blobs.push_back({input.data(), kTensorSize, false});
+      OutputData output_data;
+      output_data.blobs.push_back({output.data(), kTensorSize, false});
+      EXPECT_EQ(manager.DataInput(input_data, output_data), SUCCESS);
+    }
+  }
+
+  std::vector<uint8_t> memory_;
+};
+
+TEST_F(UtestModelMetrics, bucket_index) {
+  for (uint64_t value = 0; value < LatencyHistogram::kSubBucketNum; ++value) {
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(value), value);
+    EXPECT_EQ(LatencyHistogram::GetBucketUpperBound(value), value);
+  }
+  // every value is in a bucket whose upper bound is at most 1/16 above it
+  uint32_t last_index = 0;
+  for (uint64_t value = LatencyHistogram::kSubBucketNum; value < 1000000; value += value / 7 + 1) {
+    uint32_t index = LatencyHistogram::GetBucketIndex(value);
+    uint64_t upper_bound = LatencyHistogram::GetBucketUpperBound(index);
+    EXPECT_GE(index, last_index);
+    EXPECT_GE(upper_bound, value);
+    EXPECT_LE(upper_bound - value, value / LatencyHistogram::kSubBucketNum);
+    if (index > 0) {
+      EXPECT_LT(LatencyHistogram::GetBucketUpperBound(index - 1), value);
+    }
+    last_index = index;
+  }
+  EXPECT_EQ(LatencyHistogram::GetBucketIndex(UINT64_MAX), LatencyHistogram::kBucketNum - 1);
+}
+
+TEST_F(UtestModelMetrics, percentiles) {
+  LatencyHistogram histogram;
+  LatencyStats empty = histogram.Snapshot(false);
+  EXPECT_EQ(empty.count, 0);
+  EXPECT_EQ(empty.p50_us, 0);
+  EXPECT_EQ(empty.p999_us, 0);
+
+  const uint64_t value_num = 10000;
+  for (uint64_t value = 1; value <= value_num; ++value) {
+    histogram.Record(value);
+  }
+  LatencyStats stats = histogram.Snapshot(false);
+  EXPECT_EQ(stats.count, value_num);
+  EXPECT_EQ(stats.sum_us, value_num * (value_num + 1) / 2);
+  EXPECT_EQ(stats.max_us, value_num);
+  EXPECT_GE(stats.p50_us, 5000);
+  EXPECT_LE(stats.p50_us, 5000 + 5000 / LatencyHistogram::kSubBucketNum);
+  EXPECT_GE(stats.p99_us, 9900);
+  EXPECT_LE(stats.p50_us, stats.p90_us);
+  EXPECT_LE(stats.p90_us, stats.p99_us);
+  EXPECT_LE(stats.p99_us, stats.p999_us);
+  EXPECT_LE(stats.p999_us, stats.max_us);
+
+  // a snapshot with reset takes the values, the next one starts from zero
+  LatencyStats taken = histogram.Snapshot(true);
+  EXPECT_EQ(taken.count, value_num);
+  EXPECT_EQ(taken.p99_us, stats.p99_us);
+  LatencyStats after_reset = histogram.Snapshot(false);
+  EXPECT_EQ(after_reset.count, 0);
+  EXPECT_EQ(after_reset.sum_us, 0);
+  EXPECT_EQ(after_reset.max_us, 0);
+}
+
+TEST_F(UtestModelMetrics, concurrent_record) {
+  ModelMetrics metrics;
+  const int thread_num = 4;
+  const uint64_t record_num = 10000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&metrics, i, record_num] {
+      for (uint64_t value = 0; value < record_num; ++value) {
+        metrics.RecordStage(kModelRunExecute, value * (i + 1));
+        metrics.AddRun(value % 10 != 0);
+        metrics.AddInputBytes(2);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ModelMetricsInfo info = metrics.Snapshot(false);
+  EXPECT_EQ(info.run_count, thread_num * record_num);
+  EXPECT_EQ(info.fail_count, thread_num * record_num / 10);
+  EXPECT_EQ(info.input_bytes, 2 * thread_num * record_num);
+  EXPECT_EQ(info.stages[kModelRunExecute].count, thread_num * record_num);
+  EXPECT_EQ(info.stages[kModelRunExecute].max_us, (record_num - 1) * thread_num);
+  EXPECT_EQ(info.stages[kModelRunQueueWait].count, 0);
+  EXPECT_EQ(ModelMetrics::GetStageName(kModelRunStreamSync), "stream_sync");
+}
+
+TEST_F(UtestModelMetrics, model_run_metrics) {
+  auto listener = std::make_shared<MetricsListener>();
+  ModelManager manager;
+  std::shared_ptr<DavinciModel> model = CreateModel(listener);
+  manager.model_map_[kModelId] = model;
+  ModelMetricsInfo metrics;
+  EXPECT_EQ(manager.GetModelMetrics(kModelId + 1, metrics), PARAM_INVALID);
+
+  SetRuntimeStubModelExecute(kExecuteDelayUs, RT_ERROR_NONE);
+  ASSERT_EQ(model->ModelRunStart(), SUCCESS);
+  const uint32_t run_num = 8;
+  RunModel(manager, run_num);
+  ASSERT_TRUE(listener->WaitDone(run_num));
+  EXPECT_EQ(GetRuntimeStubCounters().model_execute_count, run_num);
+
+  ASSERT_EQ(manager.GetModelMetrics(kModelId, metrics), SUCCESS);
+  EXPECT_EQ(metrics.run_count, run_num);
+  EXPECT_EQ(metrics.fail_count, 0);
+  EXPECT_EQ(metrics.input_bytes, run_num * kTensorSize);
+  EXPECT_EQ(metrics.output_bytes, run_num * kTensorSize);
+  for (const auto &stage : metrics.stages) {
+    EXPECT_EQ(stage.count, run_num);
+    EXPECT_LE(stage.p50_us, stage.p90_us);
+    EXPECT_LE(stage.p90_us, stage.p99_us);
+    EXPECT_LE(stage.p99_us, stage.p999_us);
+    EXPECT_LE(stage.p999_us, stage.max_us);
+  }
+  EXPECT_GE(metrics.stages[kModelRunExecute].p50_us, kExecuteDelayUs);
+
+  // the failed executions are counted, and do not reach the later stages
+  SetRuntimeStubModelExecute(0, RT_ERROR_INVALID_VALUE);
+  ASSERT_EQ(manager.GetModelMetrics(kModelId, metrics, true), SUCCESS);
+  const uint32_t fail_num = 3;
+  RunModel(manager, fail_num);
+  ASSERT_TRUE(listener->WaitDone(run_num + fail_num));
+  EXPECT_EQ(listener->GetFailCount(), fail_num);
+
+  ASSERT_EQ(manager.GetModelMetrics(kModelId, metrics), SUCCESS);
+  EXPECT_EQ(metrics.run_count, fail_num);
+  EXPECT_EQ(metrics.fail_count, fail_num);
+  EXPECT_EQ(metrics.input_bytes, fail_num * kTensorSize);
+  EXPECT_EQ(metrics.output_bytes, 0);
+  EXPECT_EQ(metrics.stages[kModelRunQueueWait].count, fail_num);
+  EXPECT_EQ(metrics.stages[kModelRunInputCopy].count, fail_num);
+  EXPECT_EQ(metrics.stages[kModelRunExecute].count, 0);
+  EXPECT_EQ(metrics.stages[kModelRunStreamSync].count, 0);
+  EXPECT_EQ(metrics.stages[kModelRunOutputReturn].count, 0);
+
+  EXPECT_EQ(model->ModelRunStop(), SUCCESS);
+  manager.model_map_.clear();
+}
+}  // namespace ge
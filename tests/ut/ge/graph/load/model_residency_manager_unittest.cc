@@ -0,0 +1,203 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/debug/ge_attr_define.h"
+#include "graph/utils/attr_utils.h"
+#include "tests/depends/runtime/src/runtime_stub.h"
+
+#define protected public
+#define private public
+#include "graph/manager/graph_manager.h"
+#include "graph/manager/graph_var_manager.h"
+#include "graph/manager/model_residency_manager.h"
+#undef protected
+#undef private
+
+namespace ge {
+namespace {
+const uint64_t kMemorySizeMB = 1024 * 1024;
+}  // namespace
+
+class UtestModelResidencyManager : public testing::Test {
+ protected:
+  void SetUp() { ResetRuntimeStubCounters(); }
+
+  void TearDown() { ResetRuntimeStubCounters(); }
+
+  GeModelPtr CreateModel(uint32_t model_id, uint64_t memory_size, uint64_t weight_size, uint64_t var_size = 0) {
+    GeModelPtr ge_model = std::make_shared<GeModel>();
+    (void)AttrUtils::SetInt(ge_model, ATTR_MODEL_MEMORY_SIZE, static_cast<int64_t>(memory_size));
+    (void)AttrUtils::SetInt(ge_model, ATTR_MODEL_WEIGHT_SIZE, static_cast<int64_t>(weight_size));
+    (void)AttrUtils::SetInt(ge_model, ATTR_MODEL_VAR_SIZE, static_cast<int64_t>(var_size));
+    ge_model->SetModelId(model_id);
+    return ge_model;
+  }
+
+  GraphNodePtr AddLoadedGraph(GraphManager &graph_manager, GraphId graph_id, uint64_t memory_size) {
+    GraphNodePtr graph_node = std::make_shared<GraphNode>(graph_id);
+    GeModelPtr ge_model = CreateModel(graph_id + 100, memory_size, 0);
+    graph_node->SetGeModel(ge_model);
+    graph_node->SetLoadFlag(true);
+    graph_manager.graph_map_[graph_id] = graph_node;
+    graph_manager.residency_manager_.OnModelLoaded(graph_id, ge_model);
+    return graph_node;
+  }
+
+  // GraphLoader::GetMemoryInfo reports free + use max memory size - total
+  void SetFreeMemory(uint64_t free_size) {
+    size_t use_max_memory_size = VarManager::Instance(0)->GetUseMaxMemorySize();
+    SetRuntimeStubMemInfo(free_size, use_max_memory_size);
+  }
+};
+
+TEST_F(UtestModelResidencyManager, footprint) {
+  GeModelPtr ge_model = CreateModel(1, 3 * kMemorySizeMB, 2 * kMemorySizeMB, kMemorySizeMB);
+  // the var memory stays with the session when the model is unloaded
+  EXPECT_EQ(ModelResidencyManager::GetModelFootprint(ge_model), 5 * kMemorySizeMB);
+  EXPECT_EQ(ModelResidencyManager::GetModelFootprint(nullptr), 0);
+
+  ModelResidencyManager residency_manager;
+  residency_manager.OnModelLoaded(1, ge_model);
+  std::vector<ModelResidency> models = residency_manager.GetResidentModels();
+  ASSERT_EQ(models.size(), 1);
+  EXPECT_EQ(models[0].model_id, 1);
+  EXPECT_EQ(models[0].feature_map_size, 3 * kMemorySizeMB);
+  EXPECT_EQ(models[0].weight_size, 2 * kMemorySizeMB);
+  EXPECT_EQ(models[0].var_size, kMemorySizeMB);
+
+  residency_manager.OnModelUnloaded(1);
+  EXPECT_TRUE(residency_manager.GetResidentModels().empty());
+}
+
+TEST_F(UtestModelResidencyManager, select_victims_lru) {
+  ModelResidencyManager residency_manager;
+  residency_manager.OnModelLoaded(1, CreateModel(1, 10 * kMemorySizeMB, 0));
+  residency_manager.OnModelLoaded(2, CreateModel(2, 10 * kMemorySizeMB, 0));
+  residency_manager.OnModelLoaded(3, CreateModel(3, 10 * kMemorySizeMB, 0));
+  // graph 1 becomes the most recently used one
+  residency_manager.Touch(1);
+
+  std::vector<ModelResidency> victims;
+  EXPECT_TRUE(residency_manager.SelectVictims(4, 20 * kMemorySizeMB, 25 * kMemorySizeMB, victims));
+  EXPECT_TRUE(victims.empty());
+
+  EXPECT_TRUE(residency_manager.SelectVictims(4, 20 * kMemorySizeMB, 5 * kMemorySizeMB, victims));
+  ASSERT_EQ(victims.size(), 2);
+  EXPECT_EQ(victims[0].graph_id, 2);
+  EXPECT_EQ(victims[1].graph_id, 3);
+
+  // the loading graph itself is never a victim
+  EXPECT_TRUE(residency_manager.SelectVictims(2, 8 * kMemorySizeMB, 0, victims));
+  ASSERT_EQ(victims.size(), 1);
+  EXPECT_EQ(victims[0].graph_id, 3);
+}
+
+TEST_F(UtestModelResidencyManager, select_victims_ignores_var_size) {
+  ModelResidencyManager residency_manager;
+  residency_manager.OnModelLoaded(1, CreateModel(1, 10 * kMemorySizeMB, 0, 100 * kMemorySizeMB));
+  residency_manager.OnModelLoaded(2, CreateModel(2, 10 * kMemorySizeMB, 0, 100 * kMemorySizeMB));
+  residency_manager.OnModelLoaded(3, CreateModel(3, 10 * kMemorySizeMB, 0, 100 * kMemorySizeMB));
+
+  // unloading one model frees its 10M feature map only, not the 100M var memory
+  std::vector<ModelResidency> victims;
+  EXPECT_TRUE(residency_manager.SelectVictims(4, 20 * kMemorySizeMB, 5 * kMemorySizeMB, victims));
+  ASSERT_EQ(victims.size(), 2);
+  EXPECT_EQ(victims[0].graph_id, 1);
+  EXPECT_EQ(victims[1].graph_id, 2);
+
+  EXPECT_FALSE(residency_manager.SelectVictims(4, 50 * kMemorySizeMB, 5 * kMemorySizeMB, victims));
+  EXPECT_EQ(victims.size(), 3);
+
+  residency_manager.RecordEviction(victims[0]);
+  EXPECT_EQ(residency_manager.GetStatistics().evicted_bytes, 10 * kMemorySizeMB);
+}
+
+TEST_F(UtestModelResidencyManager, pinned_graphs_never_selected) {
+  ModelResidencyManager residency_manager;
+  EXPECT_EQ(residency_manager.ParsePinnedGraphs("1, 3"), SUCCESS);
+  EXPECT_TRUE(residency_manager.IsPinned(1));
+  EXPECT_FALSE(residency_manager.IsPinned(2));
+  EXPECT_TRUE(residency_manager.IsPinned(3));
+  EXPECT_EQ(residency_manager.ParsePinnedGraphs("1,a"), PARAM_INVALID);
+
+  residency_manager.OnModelLoaded(1, CreateModel(1, 10 * kMemorySizeMB, 0));
+  residency_manager.OnModelLoaded(2, CreateModel(2, 10 * kMemorySizeMB, 0));
+  residency_manager.OnModelLoaded(3, CreateModel(3, 10 * kMemorySizeMB, 0));
+
+  std::vector<ModelResidency> victims;
+  EXPECT_FALSE(residency_manager.SelectVictims(4, 20 * kMemorySizeMB, 0, victims));
+  ASSERT_EQ(victims.size(), 1);
+  EXPECT_EQ(victims[0].graph_id, 2);
+  EXPECT_EQ(residency_manager.GetStatistics().insufficient_count, 1);
+
+  residency_manager.SetPinned(3, false);
+  EXPECT_TRUE(residency_manager.SelectVictims(4, 20 * kMemorySizeMB, 0, victims));
+  EXPECT_EQ(victims.size(), 2);
+}
+
+TEST_F(UtestModelResidencyManager, check_and_release_memory_evicts_lru_only) {
+  GraphManager graph_manager;
+  GraphNodePtr graph_1 = AddLoadedGraph(graph_manager, 1, 10 * kMemorySizeMB);
+  GraphNodePtr graph_2 = AddLoadedGraph(graph_manager, 2, 10 * kMemorySizeMB);
+  GraphNodePtr graph_3 = AddLoadedGraph(graph_manager, 3, 10 * kMemorySizeMB);
+  graph_manager.residency_manager_.Touch(1);
+
+  GraphNodePtr graph_4 = std::make_shared<GraphNode>(4);
+  GeModelPtr ge_model = CreateModel(104, 12 * kMemorySizeMB, 4 * kMemorySizeMB);
+  SetFreeMemory(8 * kMemorySizeMB);
+  EXPECT_EQ(graph_manager.CheckAndReleaseMemory(ge_model, graph_4), SUCCESS);
+
+  // graph 2 is the least recently used, unloading it alone makes room
+  EXPECT_TRUE(graph_1->GetLoadFlag());
+  EXPECT_FALSE(graph_2->GetLoadFlag());
+  EXPECT_TRUE(graph_3->GetLoadFlag());
+  ResidencyStatistics statistics = graph_manager.GetResidencyStatistics();
+  EXPECT_EQ(statistics.eviction_count, 1);
+  EXPECT_EQ(statistics.evicted_bytes, 10 * kMemorySizeMB);
+  EXPECT_EQ(graph_manager.residency_manager_.GetResidentModels().size(), 2);
+}
+
+TEST_F(UtestModelResidencyManager, check_and_release_memory_honours_pinned) {
+  GraphManager graph_manager;
+  GraphNodePtr graph_1 = AddLoadedGraph(graph_manager, 1, 10 * kMemorySizeMB);
+  GraphNodePtr graph_2 = AddLoadedGraph(graph_manager, 2, 10 * kMemorySizeMB);
+  graph_manager.SetGraphPinned(1, true);
+
+  GraphNodePtr graph_3 = std::make_shared<GraphNode>(3);
+  GeModelPtr ge_model = CreateModel(103, 30 * kMemorySizeMB, 0);
+  SetFreeMemory(kMemorySizeMB);
+  EXPECT_EQ(graph_manager.CheckAndReleaseMemory(ge_model, graph_3), SUCCESS);
+
+  EXPECT_TRUE(graph_1->GetLoadFlag());
+  EXPECT_FALSE(graph_2->GetLoadFlag());
+  ResidencyStatistics statistics = graph_manager.GetResidencyStatistics();
+  EXPECT_EQ(statistics.eviction_count, 1);
+  EXPECT_EQ(statistics.insufficient_count, 1);
+}
+
+TEST_F(UtestModelResidencyManager, check_and_release_memory_enough_memory) {
+  GraphManager graph_manager;
+  GraphNodePtr graph_1 = AddLoadedGraph(graph_manager, 1, 10 * kMemorySizeMB);
+
+  GraphNodePtr graph_2 = std::make_shared<GraphNode>(2);
+  SetFreeMemory(64 * kMemorySizeMB);
+  EXPECT_EQ(graph_manager.CheckAndReleaseMemory(CreateModel(102, 10 * kMemorySizeMB, 0), graph_2), SUCCESS);
+  EXPECT_TRUE(graph_1->GetLoadFlag());
+  EXPECT_EQ(graph_manager.GetResidencyStatistics().eviction_count, 0);
+}
+}  // namespace ge
@@ -15,7 +15,11 @@
  */
 
 #include <gtest/gtest.h>
+#include <future>
+
 #include "common/debug/log.h"
+#include "common/thread_pool.h"
+#include "tests/depends/runtime/src/runtime_stub.h"
 #include "common/debug/memory_dumper.h"
 #include "common/types.h"
 
@@ -71,6 +75,39 @@ class UtestModelManagerDavinciModel : public testing::Test {
   void SetUp() {}
 
   void TearDown() {}
+
+  // fusion start tasks only take a stream from the model on init
+  static void CreateFusionStartTasks(ModelTaskDef &model_task_def, int task_num) {
+    for (int i = 0; i < task_num; ++i) {
+      TaskDef *task = model_task_def.add_task();
+      task->set_type(RT_MODEL_TASK_FUSION_START);
+      task->set_stream_id(i % 2);
+    }
+  }
+
+  // a pool per load and a context bind per task, as it was done before the shared pool, used as reference
+  static Status InitTaskInfoPerTask(DavinciModel &model, ModelTaskDef &model_task_def) {
+    model.task_list_.resize(model_task_def.task_size());
+    std::vector<std::future<Status>> futures(model_task_def.task_size());
+    ThreadPool executor(16);
+    rtContext_t ctx = nullptr;
+    (void)rtCtxGetCurrent(&ctx);
+    for (int32_t i = 0; i < model_task_def.task_size(); ++i) {
+      futures[i] = executor.commit(
+          [](const TaskDef &task, DavinciModel *model, rtContext_t ctx, int32_t idx) -> Status {
+            (void)rtCtxSetCurrent(ctx);
+            model->task_list_[idx] = TaskInfoFactory::Instance().Create(static_cast<rtModelTaskType_t>(task.type()));
+            return (model->task_list_[idx] == nullptr) ? FAILED : model->task_list_[idx]->Init(task, model);
+          },
+          model_task_def.task(i), &model, ctx, i);
+    }
+    Status ret = SUCCESS;
+    for (auto &future : futures) {
+      Status task_ret = future.get();
+      ret = (ret == SUCCESS) ? task_ret : ret;
+    }
+    return ret;
+  }
 };
 
 class DModelListener : public ge::ModelListener {
@@ -1438,4 +1475,75 @@ TEST_F(UtestModelManagerDavinciModel, init_tbe_handle_ge_registered) {
   EXPECT_EQ(it->second, 3);
   DavinciModel::tvm_bin_kernel_.clear();
 }
+
+TEST_F(UtestModelManagerDavinciModel, init_task_info_by_chunks) {
+  DavinciModel model(0, g_label_call_back);
+  model.stream_list_ = {reinterpret_cast<rtStream_t>(1), reinterpret_cast<rtStream_t>(2)};
+  ModelTaskDef model_task_def;
+  CreateFusionStartTasks(model_task_def, 10000);
+
+  ResetRuntimeStubCounters();
+  EXPECT_EQ(model.InitTaskInfo(model_task_def), SUCCESS);
+  ASSERT_EQ(model.task_list_.size(), 10000);
+  for (size_t i = 0; i < model.task_list_.size(); ++i) {
+    ASSERT_NE(model.task_list_[i], nullptr);
+    EXPECT_EQ(model.task_list_[i]->stream_, model.stream_list_[i % 2]);
+  }
+  // one bind per chunk instead of one per task
+  EXPECT_GT(GetRuntimeStubCounters().ctx_set_current_count, 1);
+  EXPECT_LE(GetRuntimeStubCounters().ctx_set_current_count, 16);
+
+  // a small model is inited on the current thread, which is bound already
+  DavinciModel small_model(0, g_label_call_back);
+  small_model.stream_list_ = model.stream_list_;
+  ModelTaskDef small_task_def;
+  CreateFusionStartTasks(small_task_def, 10);
+  ResetRuntimeStubCounters();
+  EXPECT_EQ(small_model.InitTaskInfo(small_task_def), SUCCESS);
+  EXPECT_EQ(small_model.task_list_.size(), 10);
+  EXPECT_EQ(GetRuntimeStubCounters().ctx_set_current_count, 0);
+  model.stream_list_.clear();
+  small_model.stream_list_.clear();
+}
+
+TEST_F(UtestModelManagerDavinciModel, init_task_info_chunk_failed) {
+  DavinciModel model(0, g_label_call_back);
+  model.stream_list_ = {reinterpret_cast<rtStream_t>(1), reinterpret_cast<rtStream_t>(2)};
+  ModelTaskDef model_task_def;
+  CreateFusionStartTasks(model_task_def, 10000);
+  model_task_def.mutable_task(7777)->set_stream_id(5);
+  EXPECT_NE(model.InitTaskInfo(model_task_def), SUCCESS);
+  model.stream_list_.clear();
+}
+
+TEST_F(UtestModelManagerDavinciModel, init_task_info_100k_tasks_same_as_per_task) {
+  const int task_num = 100000;
+  ModelTaskDef model_task_def;
+  CreateFusionStartTasks(model_task_def, task_num);
+  DavinciModel reference(0, g_label_call_back);
+  reference.stream_list_ = {reinterpret_cast<rtStream_t>(1), reinterpret_cast<rtStream_t>(2)};
+  DavinciModel model(0, g_label_call_back);
+  model.stream_list_ = reference.stream_list_;
+
+  ResetRuntimeStubCounters();
+  EXPECT_EQ(InitTaskInfoPerTask(reference, model_task_def), SUCCESS);
+  uint64_t per_task_binds = GetRuntimeStubCounters().ctx_set_current_count;
+  ResetRuntimeStubCounters();
+  EXPECT_EQ(model.InitTaskInfo(model_task_def), SUCCESS);
+  uint64_t chunk_binds = GetRuntimeStubCounters().ctx_set_current_count;
+
+  // one bind per task before, one per chunk now
+  EXPECT_EQ(per_task_binds, task_num);
+  EXPECT_GT(chunk_binds, 1);
+  EXPECT_LE(chunk_binds, 16);
+  ASSERT_EQ(model.task_list_.size(), reference.task_list_.size());
+  for (size_t i = 0; i < model.task_list_.size(); ++i) {
+    ASSERT_NE(model.task_list_[i], nullptr);
+    ASSERT_NE(reference.task_list_[i], nullptr);
+    EXPECT_EQ(model.task_list_[i]->stream_, reference.task_list_[i]->stream_);
+  }
+
+  reference.stream_list_.clear();
+  model.stream_list_.clear();
+}
 }  // namespace ge
@@ -15,6 +15,10 @@
  */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+#include "tests/depends/runtime/src/runtime_stub.h"
 
 #define protected public
 #define private public
@@ -29,11 +33,21 @@ class UtestTBEHandleStore : public testing::Test {
   void SetUp() {
     TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
     kernel_store.kernels_.clear();
+    kernel_store.binaries_.clear();
+    kernel_store.binary_hashes_.clear();
+    ResetRuntimeStubCounters();
   }
 
   void TearDown() {
     TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
     kernel_store.kernels_.clear();
+    kernel_store.binaries_.clear();
+    kernel_store.binary_hashes_.clear();
+  }
+
+  static std::shared_ptr<OpKernelBin> CreateKernel(const std::string &name, const std::string &content) {
+    std::vector<char> data(content.begin(), content.end());
+    return std::make_shared<OpKernelBin>(name, std::move(data));
   }
 };
 
@@ -134,4 +148,159 @@ TEST_F(UtestTBEHandleStore, test_tbe_handle_info) {
   info.used_inc();
   EXPECT_EQ(info.used_num(), std::numeric_limits<uint32_t>::max());
 }
+
+TEST_F(UtestTBEHandleStore, test_register_same_binary_once) {
+  TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
+  // same content from two models, names differ
+  std::shared_ptr<OpKernelBin> kernel1 = CreateKernel("model1_conv", "kernel_binary_content");
+  std::shared_ptr<OpKernelBin> kernel2 = CreateKernel("model2_conv", "kernel_binary_content");
+
+  void *handle1 = nullptr;
+  void *handle2 = nullptr;
+  EXPECT_EQ(kernel_store.RegisterBinary(kernel1, RT_DEV_BINARY_MAGIC_ELF, "meta", handle1), SUCCESS);
+  EXPECT_EQ(kernel_store.RegisterBinary(kernel2, RT_DEV_BINARY_MAGIC_ELF, "meta", handle2), SUCCESS);
+  EXPECT_NE(handle1, nullptr);
+  EXPECT_EQ(handle1, handle2);
+  EXPECT_EQ(kernel_store.binaries_.size(), 1);
+  EXPECT_EQ(GetRuntimeStubCounters().bin_register_count, 1);
+
+  // unregistered from runtime after the last user releases it
+  kernel_store.UnRegisterBinary(handle1);
+  EXPECT_EQ(GetRuntimeStubCounters().bin_unregister_count, 0);
+  kernel_store.UnRegisterBinary(handle2);
+  EXPECT_EQ(GetRuntimeStubCounters().bin_unregister_count, 1);
+  EXPECT_TRUE(kernel_store.binaries_.empty());
+  EXPECT_TRUE(kernel_store.binary_hashes_.empty());
+}
+
+TEST_F(UtestTBEHandleStore, test_register_different_binary) {
+  TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
+  std::shared_ptr<OpKernelBin> kernel1 = CreateKernel("conv", "kernel_binary_content");
+  std::shared_ptr<OpKernelBin> kernel2 = CreateKernel("relu", "other_binary_content");
+
+  void *handle1 = nullptr;
+  void *handle2 = nullptr;
+  void *handle3 = nullptr;
+  void *handle4 = nullptr;
+  EXPECT_EQ(kernel_store.RegisterBinary(kernel1, RT_DEV_BINARY_MAGIC_ELF, "", handle1), SUCCESS);
+  EXPECT_EQ(kernel_store.RegisterBinary(kernel2, RT_DEV_BINARY_MAGIC_ELF, "", handle2), SUCCESS);
+  // same content with other meta data or magic is another binary
+  EXPECT_EQ(kernel_store.RegisterBinary(kernel1, RT_DEV_BINARY_MAGIC_ELF, "meta", handle3), SUCCESS);
+  EXPECT_EQ(kernel_store.RegisterBinary(kernel1, RT_DEV_BINARY_MAGIC_ELF_AICPU, "", handle4), SUCCESS);
+  EXPECT_NE(handle1, handle2);
+  EXPECT_NE(handle1, handle3);
+  EXPECT_NE(handle1, handle4);
+  EXPECT_EQ(kernel_store.binaries_.size(), 4);
+  EXPECT_EQ(GetRuntimeStubCounters().bin_register_count, 4);
+
+  void *handle = nullptr;
+  EXPECT_EQ(kernel_store.RegisterBinary(nullptr, RT_DEV_BINARY_MAGIC_ELF, "", handle), PARAM_INVALID);
+}
+
+TEST_F(UtestTBEHandleStore, test_erase_handle_release_binary) {
+  TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
+  std::shared_ptr<OpKernelBin> kernel = CreateKernel("conv", "kernel_binary_content");
+
+  void *handle = nullptr;
+  EXPECT_EQ(kernel_store.RegisterBinary(kernel, RT_DEV_BINARY_MAGIC_ELF, "", handle), SUCCESS);
+  kernel_store.StoreTBEHandle("conv", handle, kernel);
+  kernel_store.ReferTBEHandle("conv");
+
+  std::map<std::string, uint32_t> names = {{"conv", 1}};
+  kernel_store.EraseTBEHandle(names);
+  EXPECT_EQ(kernel_store.binaries_.size(), 1);
+  kernel_store.EraseTBEHandle(names);
+  EXPECT_TRUE(kernel_store.kernels_.empty());
+  EXPECT_TRUE(kernel_store.binaries_.empty());
+  EXPECT_EQ(GetRuntimeStubCounters().bin_unregister_count, 1);
+}
+
+// models loading in parallel miss the same name together, the binary is still registered and released once
+TEST_F(UtestTBEHandleStore, test_parallel_register_tbe_handle) {
+  TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
+  const size_t kThreadNum = 8;
+  const size_t kLoopNum = 100;
+  std::shared_ptr<OpKernelBin> kernel = CreateKernel("conv", "kernel_binary_content");
+
+  std::atomic<size_t> wrong_num(0);
+  std::vector<void *> handles(kThreadNum, nullptr);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([&kernel_store, &kernel, &handles, &wrong_num, kLoopNum, t]() {
+      std::shared_ptr<OpKernelBin> thread_kernel = kernel;
+      for (size_t i = 0; i < kLoopNum; ++i) {
+        void *handle = nullptr;
+        if (kernel_store.RegisterTBEHandle("conv", thread_kernel, RT_DEV_BINARY_MAGIC_ELF, "", handle) != SUCCESS ||
+            (handles[t] != nullptr && handles[t] != handle)) {
+          wrong_num++;
+        }
+        handles[t] = handle;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(wrong_num.load(), 0);
+  for (auto handle : handles) {
+    EXPECT_EQ(handle, handles[0]);
+  }
+  EXPECT_EQ(GetRuntimeStubCounters().bin_register_count, 1);
+  ASSERT_EQ(kernel_store.binaries_.size(), 1);
+  EXPECT_EQ(kernel_store.binaries_.begin()->second.used, 1);
+  EXPECT_EQ(kernel_store.kernels_.find("conv")->second.used_num(), kThreadNum * kLoopNum);
+
+  std::map<std::string, uint32_t> names = {{"conv", kThreadNum * kLoopNum}};
+  kernel_store.EraseTBEHandle(names);
+  EXPECT_TRUE(kernel_store.kernels_.empty());
+  EXPECT_TRUE(kernel_store.binaries_.empty());
+  EXPECT_EQ(GetRuntimeStubCounters().bin_unregister_count, 1);
+}
+
+// concurrent lookups, as done by models loading in parallel, find the right handle and count every reference
+TEST_F(UtestTBEHandleStore, test_parallel_find_tbe_handle) {
+  TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
+  const size_t kKernelNum = 64;
+  const size_t kThreadNum = 4;
+  const size_t kLoopNum = 20000;
+  std::shared_ptr<OpKernelBin> tbe_kernel = std::shared_ptr<OpKernelBin>();
+  std::vector<std::string> names;
+  for (size_t i = 0; i < kKernelNum; ++i) {
+    names.emplace_back("tbe_kernel_" + std::to_string(i));
+    kernel_store.StoreTBEHandle(names.back(), reinterpret_cast<void *>(i + 1), tbe_kernel);
+  }
+
+  std::atomic<size_t> found_num(0);
+  std::atomic<size_t> wrong_num(0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([&kernel_store, &names, &found_num, &wrong_num, kKernelNum, kLoopNum, t]() {
+      size_t found = 0;
+      size_t wrong = 0;
+      for (size_t i = 0; i < kLoopNum; ++i) {
+        size_t index = (i + t) % kKernelNum;
+        void *handle = nullptr;
+        if (kernel_store.FindTBEHandle(names[index], handle)) {
+          kernel_store.ReferTBEHandle(names[index]);
+          found++;
+          wrong += (handle == reinterpret_cast<void *>(index + 1)) ? 0 : 1;
+        }
+      }
+      found_num += found;
+      wrong_num += wrong;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(found_num.load(), kThreadNum * kLoopNum);
+  EXPECT_EQ(wrong_num.load(), 0);
+  uint32_t used_num = 0;
+  for (const auto &name : names) {
+    used_num += kernel_store.kernels_.find(name)->second.used_num();
+  }
+  EXPECT_EQ(used_num, kKernelNum + kThreadNum * kLoopNum);
+}
 }  // namespace ge
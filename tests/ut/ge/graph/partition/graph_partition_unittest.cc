@@ -0,0 +1,338 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <queue>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#define protected public
+#define private public
+#include "graph/partition/graph_partition.h"
+#undef private
+#undef protected
+
+using namespace std;
+
+namespace ge {
+namespace {
+const char *const kAiCoreEngine = "AIcoreEngine";
+const char *const kAiCpuEngine = "aicpu_kernel";
+const char *const kHcclEngine = "ops_kernel_info_hccl";
+const char *const kDataEngine = "ENGINE_DEFAULT_DATA";
+const size_t kLargeNodeNum = 50000;
+}  // namespace
+
+class UtestGraphPartition : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+
+  struct ClusterDesc {
+    string engine;
+    string stream_label;
+    vector<size_t> parents;
+  };
+
+  // clusters as created by Initialize, indexes are in topological order
+  static void BuildClusters(GraphPartitioner &partitioner, const vector<ClusterDesc> &descs) {
+    for (size_t i = 0; i < descs.size(); ++i) {
+      auto cluster = std::make_shared<Cluster>(i, descs[i].engine, descs[i].stream_label);
+      cluster->nodes_.push_back(NodePtr());
+      for (auto parent : descs[i].parents) {
+        cluster->in_clu_.insert(parent);
+        partitioner.clusters_[parent]->out_clu_.insert(i);
+      }
+      partitioner.clusters_[i] = cluster;
+    }
+  }
+
+  static vector<size_t> GetMarks(GraphPartitioner &partitioner) {
+    vector<size_t> marks;
+    for (size_t i = 0; i < partitioner.clusters_.size(); ++i) {
+      marks.emplace_back(partitioner.GetMergedIndex(i));
+    }
+    return marks;
+  }
+
+  // merging with a depth first search per parent, as the reference of the order MarkClusters merges in. It is
+  // the baseline below with two changes: parents with the same output count are ordered by index instead of hash
+  // order, and the search follows merged indexes and skips the direct edge, so it never walks a stale cluster
+  static bool HasSecondPathByDfs(GraphPartitioner &partitioner, size_t src, size_t dst, size_t upper_bound) {
+    auto &clusters = partitioner.clusters_;
+    vector<size_t> temp_stack;
+    unordered_set<size_t> visited;
+    temp_stack.push_back(src);
+    while (!temp_stack.empty()) {
+      size_t cluster = temp_stack.back();
+      temp_stack.pop_back();
+      if (!visited.insert(cluster).second) {
+        continue;
+      }
+      for (auto out : clusters[cluster]->out_clu_) {
+        size_t out_index = partitioner.GetMergedIndex(out);
+        if ((out_index == cluster) || ((out_index == dst) && (cluster == src))) {
+          continue;
+        }
+        if (out_index == dst) {
+          return true;
+        }
+        if (out_index < upper_bound) {
+          temp_stack.push_back(out_index);
+        }
+      }
+    }
+    return false;
+  }
+
+  static void MarkClustersByDfs(GraphPartitioner &partitioner) {
+    auto &clusters = partitioner.clusters_;
+    size_t cluster_size = clusters.size();
+    for (size_t child_cluster = 0; child_cluster < cluster_size; child_cluster++) {
+      vector<size_t> ordered_cluster(clusters[child_cluster]->in_clu_.begin(), clusters[child_cluster]->in_clu_.end());
+      std::sort(ordered_cluster.begin(), ordered_cluster.end(), [&clusters](const size_t &left, const size_t &right) {
+        size_t left_size = clusters[left]->out_clu_.size();
+        size_t right_size = clusters[right]->out_clu_.size();
+        return (left_size < right_size) || ((left_size == right_size) && (left < right));
+      });
+      auto child_merged = child_cluster;
+      for (const auto &parent_cluster : ordered_cluster) {
+        if ((clusters[parent_cluster]->engine_name_ != clusters[child_merged]->engine_name_) ||
+            (clusters[parent_cluster]->stream_label_ != clusters[child_merged]->stream_label_)) {
+          continue;
+        }
+        if (!HasSecondPathByDfs(partitioner, parent_cluster, child_merged, child_cluster)) {
+          partitioner.MergeTwoClusters(parent_cluster, child_merged);
+        }
+      }
+    }
+  }
+
+  // MarkClusters as it was before ancestor bitsets, verbatim
+  static bool HasSecondPathBaseline(GraphPartitioner &partitioner, size_t src, size_t dst, size_t upper_bound) {
+    auto &clusters = partitioner.clusters_;
+    if (clusters.at(src)->out_clu_.empty() || clusters.at(dst)->in_clu_.empty()) {
+      return false;
+    }
+    vector<size_t> temp_stack;
+    unordered_set<size_t> visited;
+    temp_stack.push_back(src);
+    while (!temp_stack.empty()) {
+      size_t cluster = temp_stack.back();
+      temp_stack.pop_back();
+      ClusterPtr cur_cluster = clusters[cluster];
+      if (!visited.insert(cluster).second) {
+        continue;
+      }
+      for (auto out : cur_cluster->out_clu_) {
+        if (out == dst) {
+          return true;
+        }
+        if (out < upper_bound) {
+          temp_stack.push_back(out);
+        }
+      }
+    }
+    return false;
+  }
+
+  static void MarkClustersBaseline(GraphPartitioner &partitioner) {
+    auto &clusters = partitioner.clusters_;
+    size_t cluster_size = clusters.size();
+    for (size_t child_cluster = 0; child_cluster < cluster_size; child_cluster++) {
+      auto copy_parents_clusters = clusters[child_cluster]->in_clu_;
+      vector<size_t> ordered_cluster(copy_parents_clusters.begin(), copy_parents_clusters.end());
+      std::sort(ordered_cluster.begin(), ordered_cluster.end(), [&clusters](const size_t &left, const size_t &right) {
+        return clusters[left]->out_clu_.size() < clusters[right]->out_clu_.size();
+      });
+      auto child_merged = child_cluster;
+      for (const auto &parent_cluster : ordered_cluster) {
+        if ((clusters[parent_cluster]->engine_name_ != clusters[child_merged]->engine_name_) ||
+            (clusters[parent_cluster]->stream_label_ != clusters[child_merged]->stream_label_)) {
+          continue;
+        }
+        partitioner.RemoveEdge(parent_cluster, child_merged);
+        bool has_second_path = HasSecondPathBaseline(partitioner, parent_cluster, child_merged, child_cluster);
+        partitioner.InsertEdge(parent_cluster, child_merged);
+        if (!has_second_path) {
+          partitioner.MergeTwoClusters(parent_cluster, child_merged);
+        }
+      }
+    }
+  }
+
+  // every cluster holds one engine and stream label, and the graph of clusters has no cycle
+  static bool IsValidPartition(const vector<ClusterDesc> &descs, const vector<size_t> &marks) {
+    size_t node_num = descs.size();
+    vector<std::set<size_t>> cluster_outs(node_num);
+    vector<size_t> in_degrees(node_num, 0);
+    for (size_t i = 0; i < node_num; ++i) {
+      const auto &head = descs[marks[i]];
+      if ((descs[i].engine != head.engine) || (descs[i].stream_label != head.stream_label)) {
+        return false;
+      }
+      for (auto parent : descs[i].parents) {
+        if ((marks[parent] != marks[i]) && cluster_outs[marks[parent]].insert(marks[i]).second) {
+          in_degrees[marks[i]]++;
+        }
+      }
+    }
+    std::set<size_t> clusters(marks.begin(), marks.end());
+    std::queue<size_t> ready;
+    for (auto cluster : clusters) {
+      if (in_degrees[cluster] == 0) {
+        ready.push(cluster);
+      }
+    }
+    size_t sorted_num = 0;
+    while (!ready.empty()) {
+      size_t cluster = ready.front();
+      ready.pop();
+      sorted_num++;
+      for (auto out : cluster_outs[cluster]) {
+        if (--in_degrees[out] == 0) {
+          ready.push(out);
+        }
+      }
+    }
+    return sorted_num == clusters.size();
+  }
+
+  // layered graph with mixed engines, most inputs come from recent nodes and some from far away
+  static vector<ClusterDesc> CreateMixedEngineGraph(size_t node_num) {
+    std::mt19937 random_engine(2020);
+    vector<ClusterDesc> descs(node_num);
+    for (size_t i = 0; i < node_num; ++i) {
+      auto &desc = descs[i];
+      if (i % 500 == 0) {
+        desc.engine = kDataEngine;
+        continue;
+      }
+      uint32_t engine_dice = random_engine() % 100;
+      desc.engine = (engine_dice < 70) ? kAiCoreEngine : ((engine_dice < 95) ? kAiCpuEngine : kHcclEngine);
+      if (random_engine() % 50 == 0) {
+        desc.stream_label = "stream_label";
+      }
+      size_t window = std::min<size_t>(i, 32);
+      size_t parent_num = 1 + random_engine() % 3;
+      std::set<size_t> parents;
+      for (size_t j = 0; j < parent_num; ++j) {
+        parents.insert(i - 1 - random_engine() % window);
+      }
+      if (random_engine() % 20 == 0) {
+        parents.insert(random_engine() % i);
+      }
+      desc.parents.assign(parents.begin(), parents.end());
+    }
+    return descs;
+  }
+};
+
+TEST_F(UtestGraphPartition, second_path_prevents_merge) {
+  // 0(core) -> 1(cpu) -> 2(core), 0 -> 2, 2 -> 3(core)
+  vector<ClusterDesc> descs = {{kAiCoreEngine, "", {}},
+                               {kAiCpuEngine, "", {0}},
+                               {kAiCoreEngine, "", {0, 1}},
+                               {kAiCoreEngine, "", {2}}};
+  GraphPartitioner partitioner;
+  BuildClusters(partitioner, descs);
+  partitioner.MarkClusters();
+  vector<size_t> marks = GetMarks(partitioner);
+  EXPECT_EQ(marks, (vector<size_t>{0, 1, 2, 2}));
+  EXPECT_TRUE(partitioner.cluster_ancestors_.empty());
+}
+
+TEST_F(UtestGraphPartition, merged_cluster_passes_on_ancestors) {
+  // 0(core) -> 2(core), 1(cpu) -> 2, 0 -> 3(cpu), 3 -> 4(core), 1 -> 4
+  // after merging 0 and 2, 1 reaches 3 through the merged cluster, so 1 and 4 can not merge
+  vector<ClusterDesc> descs = {{kAiCoreEngine, "", {}},
+                               {kAiCpuEngine, "", {}},
+                               {kAiCoreEngine, "", {0, 1}},
+                               {kAiCpuEngine, "", {0}},
+                               {kAiCpuEngine, "", {1, 3}}};
+  GraphPartitioner partitioner;
+  BuildClusters(partitioner, descs);
+  GraphPartitioner reference;
+  BuildClusters(reference, descs);
+
+  partitioner.MarkClusters();
+  MarkClustersByDfs(reference);
+  vector<size_t> marks = GetMarks(partitioner);
+  EXPECT_EQ(marks, GetMarks(reference));
+  EXPECT_EQ(marks[2], 0);
+  EXPECT_NE(marks[4], marks[1]);
+  EXPECT_EQ(marks[4], 3);
+}
+
+TEST_F(UtestGraphPartition, stream_label_prevents_merge) {
+  vector<ClusterDesc> descs = {{kAiCoreEngine, "", {}}, {kAiCoreEngine, "label", {0}}, {kAiCoreEngine, "label", {1}}};
+  GraphPartitioner partitioner;
+  BuildClusters(partitioner, descs);
+  partitioner.MarkClusters();
+  EXPECT_EQ(GetMarks(partitioner), (vector<size_t>{0, 1, 1}));
+}
+
+TEST_F(UtestGraphPartition, merged_cluster_edge_is_not_second_path) {
+  // 0(core) -> 4(core) -> 10(core), 0 -> 1(cpu) -> 5(core), 2..9 are core and merge into cluster 2, 6 -> 10.
+  // after the merges the cluster of 2 keeps edges to its merged indexes, the baseline search walks them back into
+  // the cluster itself, takes its edge to 10 for a second path and leaves 10 alone
+  vector<ClusterDesc> descs = {{kAiCoreEngine, "", {}},     {kAiCpuEngine, "", {0}},     {kAiCoreEngine, "", {}},
+                               {kAiCoreEngine, "", {}},     {kAiCoreEngine, "", {0}},    {kAiCoreEngine, "", {1}},
+                               {kAiCoreEngine, "", {}},     {kAiCoreEngine, "", {5, 6}}, {kAiCoreEngine, "", {3, 7}},
+                               {kAiCoreEngine, "", {2, 8}}, {kAiCoreEngine, "", {4, 6}}};
+  GraphPartitioner partitioner;
+  BuildClusters(partitioner, descs);
+  GraphPartitioner baseline;
+  BuildClusters(baseline, descs);
+
+  partitioner.MarkClusters();
+  MarkClustersBaseline(baseline);
+  EXPECT_EQ(GetMarks(partitioner), (vector<size_t>{0, 1, 2, 2, 0, 2, 2, 2, 2, 2, 2}));
+  EXPECT_EQ(GetMarks(baseline), (vector<size_t>{0, 1, 2, 2, 0, 2, 2, 2, 2, 2, 10}));
+  EXPECT_TRUE(IsValidPartition(descs, GetMarks(partitioner)));
+}
+
+TEST_F(UtestGraphPartition, mark_clusters_50k_nodes) {
+  vector<ClusterDesc> descs = CreateMixedEngineGraph(kLargeNodeNum);
+  GraphPartitioner partitioner;
+  BuildClusters(partitioner, descs);
+  GraphPartitioner reference;
+  BuildClusters(reference, descs);
+  GraphPartitioner baseline;
+  BuildClusters(baseline, descs);
+
+  partitioner.MarkClusters();
+  MarkClustersByDfs(reference);
+  MarkClustersBaseline(baseline);
+
+  vector<size_t> marks = GetMarks(partitioner);
+  ASSERT_EQ(marks, GetMarks(reference));
+  EXPECT_TRUE(IsValidPartition(descs, marks));
+  // the baseline only differs by the merges it refused for stale edges and by hash order, it never has fewer clusters
+  vector<size_t> baseline_marks = GetMarks(baseline);
+  EXPECT_TRUE(IsValidPartition(descs, baseline_marks));
+  size_t cluster_num = std::set<size_t>(marks.begin(), marks.end()).size();
+  EXPECT_GT(cluster_num, 1);
+  EXPECT_LE(cluster_num, std::set<size_t>(baseline_marks.begin(), baseline_marks.end()).size());
+  EXPECT_TRUE(partitioner.cluster_ancestors_.empty());
+}
+}  // namespace ge
@@ -0,0 +1,181 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "graph/ge_tensor.h"
+#include "graph/op_desc.h"
+#include "runtime/rt.h"
+#include "tests/depends/runtime/src/runtime_stub.h"
+
+#define protected public
+#define private public
+#include "graph/passes/aicpu_constant_folding_pass.h"
+#undef protected
+#undef private
+
+namespace ge {
+namespace {
+const size_t kWeightSize = 1024;
+}  // namespace
+
+class UtestAicpuConstantFoldingPass : public testing::Test {
+ protected:
+  void SetUp() { ResetRuntimeStubCounters(); }
+
+  void TearDown() {}
+
+  static vector<ConstGeTensorPtr> CreateWeights(size_t num, size_t size) {
+    vector<ConstGeTensorPtr> weight_vec;
+    vector<uint8_t> data(size, 1);
+    for (size_t i = 0; i < num; ++i) {
+      GeTensorDesc tensor_desc(GeShape({static_cast<int64_t>(size)}), FORMAT_ND, DT_UINT8);
+      weight_vec.emplace_back(std::make_shared<GeTensor>(tensor_desc, data.data(), data.size()));
+    }
+    return weight_vec;
+  }
+
+  static OpDescPtr CreateOpDesc(size_t output_num) {
+    OpDescPtr op_desc = std::make_shared<OpDesc>("folding", "Stub");
+    for (size_t i = 0; i < output_num; ++i) {
+      op_desc->AddOutputDesc(GeTensorDesc(GeShape({1}), FORMAT_ND, DT_FLOAT));
+    }
+    return op_desc;
+  }
+
+  // launches a node the same way Run does once aicpu kernel store generates its tasks
+  static Status FoldOnDevice(AicpuConstantFoldingPass &pass, const vector<ConstGeTensorPtr> &weight_vec,
+                             const OpDescPtr &op_desc, vector<GeTensorPtr> &outputs) {
+    STR_FWK_OP_KERNEL run_task;
+    string task_info(64, 'r');
+    vector<uint64_t> output_addrs;
+    void *task_buf = nullptr;
+    Status ret =
+        pass.PackSingleOpRunTask(weight_vec, op_desc->GetOutputsSize(), task_info, run_task, output_addrs, task_buf);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+    ret = pass.KernelLaunch(task_buf);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+    vector<AicpuConstantFoldingPass::DataPtrInfo> data_vec;
+    ret = pass.GenerateDataPtrInfo(output_addrs, data_vec);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+    STR_FWK_OP_KERNEL copy_task;
+    string copy_task_info(32, 'c');
+    ret = pass.PackMemCopyTask(copy_task_info, data_vec, copy_task, task_buf);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+    ret = pass.KernelLaunch(task_buf);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+    return pass.GenerateGeTensor(op_desc, data_vec, outputs);
+  }
+};
+
+TEST_F(UtestAicpuConstantFoldingPass, pack_single_op_run_task) {
+  AicpuConstantFoldingPass pass;
+  vector<ConstGeTensorPtr> weight_vec = CreateWeights(3, 100);
+  STR_FWK_OP_KERNEL task;
+  string task_info(10, 'a');
+  vector<uint64_t> output_addrs;
+  void *task_buf = nullptr;
+  ASSERT_EQ(pass.PackSingleOpRunTask(weight_vec, 2, task_info, task, output_addrs, task_buf), SUCCESS);
+  EXPECT_EQ(GetRuntimeStubCounters().malloc_count, 1);
+  EXPECT_EQ(GetRuntimeStubCounters().memcpy_count, 1);
+  ASSERT_EQ(output_addrs.size(), 2);
+
+  // io addrs, workspace and task all point into the staging buffer
+  uint64_t base = pass.staging_buffer_.DeviceAddr(0);
+  uint64_t end = base + pass.staging_buffer_.GetSize();
+  auto in_range = [base, end](uint64_t addr) { return addr >= base && addr < end; };
+  EXPECT_TRUE(in_range(task.fwkKernelBase.fwk_kernel.inputOutputAddr));
+  EXPECT_TRUE(in_range(task.fwkKernelBase.fwk_kernel.workspaceBaseAddr));
+  EXPECT_TRUE(in_range(reinterpret_cast<uintptr_t>(task_buf)));
+  auto io_addrs = reinterpret_cast<const uint64_t *>(
+      pass.staging_buffer_.HostAddr(task.fwkKernelBase.fwk_kernel.inputOutputAddr - base));
+  for (size_t i = 0; i < weight_vec.size(); ++i) {
+    EXPECT_TRUE(in_range(io_addrs[i]));
+    EXPECT_EQ(*pass.staging_buffer_.HostAddr(io_addrs[i] - base), 1);
+  }
+  EXPECT_EQ(io_addrs[3], output_addrs[0]);
+  EXPECT_EQ(io_addrs[4], output_addrs[1]);
+}
+
+TEST_F(UtestAicpuConstantFoldingPass, copies_independent_of_input_num) {
+  OpDescPtr op_desc = CreateOpDesc(2);
+  uint64_t memcpy_count = 0;
+  for (size_t input_num : {1, 4, 16}) {
+    ResetRuntimeStubCounters();
+    AicpuConstantFoldingPass pass;
+    vector<GeTensorPtr> outputs;
+    ASSERT_EQ(FoldOnDevice(pass, CreateWeights(input_num, kWeightSize), op_desc, outputs), SUCCESS);
+    ASSERT_EQ(outputs.size(), 2);
+    EXPECT_EQ(GetRuntimeStubCounters().kernel_launch_ex_count, 2);
+    // one buffer for weights, maybe one more when memcopy task needs more room
+    EXPECT_LE(GetRuntimeStubCounters().malloc_count, 2);
+    if (memcpy_count == 0) {
+      memcpy_count = GetRuntimeStubCounters().memcpy_count;
+    }
+    EXPECT_EQ(GetRuntimeStubCounters().memcpy_count, memcpy_count);
+  }
+  // one copy to device per launch and one reading summaries back, outputs are empty in the stub
+  EXPECT_EQ(memcpy_count, 3);
+}
+
+TEST_F(UtestAicpuConstantFoldingPass, staging_buffer_reused_across_nodes) {
+  AicpuConstantFoldingPass pass;
+  OpDescPtr op_desc = CreateOpDesc(1);
+  vector<GeTensorPtr> outputs;
+  ASSERT_EQ(FoldOnDevice(pass, CreateWeights(4, kWeightSize), op_desc, outputs), SUCCESS);
+  uint64_t malloc_count = GetRuntimeStubCounters().malloc_count;
+
+  for (int i = 0; i < 10; ++i) {
+    outputs.clear();
+    ASSERT_EQ(FoldOnDevice(pass, CreateWeights(2, kWeightSize), op_desc, outputs), SUCCESS);
+  }
+  EXPECT_EQ(GetRuntimeStubCounters().malloc_count, malloc_count);
+  EXPECT_EQ(GetRuntimeStubCounters().free_count, 0);
+
+  // a bigger node grows the buffer once
+  ASSERT_EQ(FoldOnDevice(pass, CreateWeights(8, kWeightSize), op_desc, outputs), SUCCESS);
+  EXPECT_EQ(GetRuntimeStubCounters().malloc_count, malloc_count + 1);
+  EXPECT_EQ(GetRuntimeStubCounters().free_count, 1);
+}
+
+TEST_F(UtestAicpuConstantFoldingPass, pack_invalid_task) {
+  AicpuConstantFoldingPass pass;
+  STR_FWK_OP_KERNEL task;
+  vector<uint64_t> output_addrs;
+  void *task_buf = nullptr;
+  string task_info(10, 'a');
+  vector<ConstGeTensorPtr> no_weight;
+  EXPECT_NE(pass.PackSingleOpRunTask(no_weight, 1, task_info, task, output_addrs, task_buf), SUCCESS);
+  EXPECT_NE(pass.PackSingleOpRunTask(CreateWeights(1, 8), 0, task_info, task, output_addrs, task_buf), SUCCESS);
+  string no_task_info;
+  EXPECT_NE(pass.PackSingleOpRunTask(CreateWeights(1, 8), 1, no_task_info, task, output_addrs, task_buf), SUCCESS);
+
+  vector<AicpuConstantFoldingPass::DataPtrInfo> data_vec;
+  EXPECT_NE(pass.PackMemCopyTask(task_info, data_vec, task, task_buf), SUCCESS);
+  EXPECT_EQ(GetRuntimeStubCounters().memcpy_count, 0);
+}
+}  // namespace ge
@@ -0,0 +1,257 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "graph/passes/common_subexpression_elimination_pass.h"
+
+#include "common/types.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/passes/base_pass.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph_builder_utils.h"
+
+using namespace std;
+using namespace testing;
+
+namespace ge {
+class UtestGraphPassesCommonSubexpressionEliminationPass : public Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+
+  static NodePtr AddUnaryNode(ut::GraphBuilder &builder, const string &name, const string &type, NodePtr input) {
+    auto node = builder.AddNode(name, type, 1, 1);
+    builder.AddDataEdge(input, 0, node, 0);
+    return node;
+  }
+
+  static Status RunPass(ComputeGraphPtr &graph) {
+    CommonSubexpressionEliminationPass cse_pass;
+    NamesToPass names_to_passes;
+    names_to_passes.emplace_back("CommonSubexpressionEliminationPass", &cse_pass);
+    GEPass ge_passes(graph);
+    return ge_passes.Run(names_to_passes);
+  }
+
+  static NodePtr GetInDataNode(const ComputeGraphPtr &graph, const string &name, int index) {
+    auto node = graph->FindNode(name);
+    EXPECT_NE(node, nullptr);
+    auto peer_out_anchor = node->GetInDataAnchor(index)->GetPeerOutAnchor();
+    EXPECT_NE(peer_out_anchor, nullptr);
+    return peer_out_anchor->GetOwnerNode();
+  }
+};
+
+///
+///          data1
+///      /     |      \
+///   cast1  cast2   cast3(dst_type float16)
+///     |      |       |
+///   relu1  relu2   relu3
+///     |      |       |
+///    sqr1   sqr2    sqr3
+///       \   /        |
+///        add ----- netoutput
+///
+TEST_F(UtestGraphPassesCommonSubexpressionEliminationPass, nested_duplicate_chains) {
+  ut::GraphBuilder builder("g1");
+  auto data1 = builder.AddNode("data1", DATA, 1, 1);
+  vector<NodePtr> sqrs;
+  for (int i = 1; i <= 3; ++i) {
+    auto index = to_string(i);
+    auto cast = AddUnaryNode(builder, "cast" + index, CAST, data1);
+    (void)AttrUtils::SetInt(cast->GetOpDesc(), CAST_ATTR_DSTT, (i == 3) ? DT_FLOAT16 : DT_INT32);
+    auto relu = AddUnaryNode(builder, "relu" + index, RELU, cast);
+    sqrs.emplace_back(AddUnaryNode(builder, "sqr" + index, SQUARE, relu));
+  }
+  auto add = builder.AddNode("add", ADD, 2, 1);
+  builder.AddDataEdge(sqrs[0], 0, add, 0);
+  builder.AddDataEdge(sqrs[1], 0, add, 1);
+  auto netoutput = builder.AddNode("netoutput", NETOUTPUT, 2, 0);
+  builder.AddDataEdge(add, 0, netoutput, 0);
+  builder.AddDataEdge(sqrs[2], 0, netoutput, 1);
+  auto graph = builder.GetGraph();
+
+  EXPECT_EQ(RunPass(graph), SUCCESS);
+  EXPECT_EQ(graph->GetDirectNodesSize(), 9);
+  for (const auto &name : {"cast2", "relu2", "sqr2"}) {
+    EXPECT_EQ(graph->FindNode(name), nullptr);
+  }
+  for (const auto &name : {"cast1", "relu1", "sqr1", "cast3", "relu3", "sqr3"}) {
+    EXPECT_NE(graph->FindNode(name), nullptr);
+  }
+  EXPECT_EQ(GetInDataNode(graph, "add", 0)->GetName(), "sqr1");
+  EXPECT_EQ(GetInDataNode(graph, "add", 1)->GetName(), "sqr1");
+  EXPECT_EQ(GetInDataNode(graph, "netoutput", 1)->GetName(), "sqr3");
+  EXPECT_EQ(graph->FindNode("data1")->GetOutDataNodes().size(), 2);
+  EXPECT_EQ(graph->TopologicalSorting(), GRAPH_SUCCESS);
+}
+
+///
+///               data1
+///       /     /      \      \
+///  relu1<..noop   relu2  relu3 ..> netoutput
+///    |              |      |      /
+///   sqr1          sqr2   sqr3 ---
+///
+TEST_F(UtestGraphPassesCommonSubexpressionEliminationPass, control_edges) {
+  ut::GraphBuilder builder("g1");
+  auto data1 = builder.AddNode("data1", DATA, 1, 1);
+  auto noop = builder.AddNode("noop", NOOP, 0, 0);
+  auto relu1 = AddUnaryNode(builder, "relu1", RELU, data1);
+  builder.AddControlEdge(noop, relu1);
+  auto relu2 = AddUnaryNode(builder, "relu2", RELU, data1);
+  auto relu3 = AddUnaryNode(builder, "relu3", RELU, data1);
+  (void)AddUnaryNode(builder, "sqr1", SQUARE, relu1);
+  (void)AddUnaryNode(builder, "sqr2", SQUARE, relu2);
+  auto sqr3 = AddUnaryNode(builder, "sqr3", SQUARE, relu3);
+  auto netoutput = builder.AddNode("netoutput", NETOUTPUT, 1, 0);
+  builder.AddDataEdge(sqr3, 0, netoutput, 0);
+  builder.AddControlEdge(relu3, netoutput);
+  auto graph = builder.GetGraph();
+
+  EXPECT_EQ(RunPass(graph), SUCCESS);
+  // relu1 depends on noop, it is kept apart from the others
+  EXPECT_NE(graph->FindNode("relu1"), nullptr);
+  EXPECT_NE(graph->FindNode("sqr1"), nullptr);
+  EXPECT_EQ(graph->FindNode("relu1")->GetInControlNodes().size(), 1);
+  auto kept_relu = graph->FindNode("relu2");
+  ASSERT_NE(kept_relu, nullptr);
+  EXPECT_EQ(graph->FindNode("relu3"), nullptr);
+  EXPECT_EQ(graph->FindNode("sqr3"), nullptr);
+  EXPECT_EQ(GetInDataNode(graph, "netoutput", 0)->GetName(), "sqr2");
+  // the control edge of the merged node is moved to the kept one
+  ASSERT_EQ(kept_relu->GetOutControlNodes().size(), 1);
+  EXPECT_EQ(kept_relu->GetOutControlNodes().at(0)->GetName(), "netoutput");
+  EXPECT_EQ(graph->FindNode("netoutput")->GetInControlNodes().size(), 1);
+}
+
+TEST_F(UtestGraphPassesCommonSubexpressionEliminationPass, different_attrs_and_descs_kept_apart) {
+  ut::GraphBuilder builder("g1");
+  auto data1 = builder.AddNode("data1", DATA, 1, 1);
+  auto mul1 = AddUnaryNode(builder, "mul1", MUL, data1);
+  auto mul2 = AddUnaryNode(builder, "mul2", MUL, data1);
+  auto mul3 = AddUnaryNode(builder, "mul3", MUL, data1);
+  (void)AttrUtils::SetFloat(mul1->GetOpDesc(), "scale", 0.1f);
+  (void)AttrUtils::SetFloat(mul2->GetOpDesc(), "scale", 0.1f + 1e-8f);
+  (void)AttrUtils::SetFloat(mul3->GetOpDesc(), "scale", 0.1f);
+  mul3->GetOpDesc()->MutableOutputDesc(0)->SetDataType(DT_FLOAT16);
+  // the tensor attrs are not compared by value, such nodes are never merged
+  auto relu1 = AddUnaryNode(builder, "relu1", RELU, data1);
+  auto relu2 = AddUnaryNode(builder, "relu2", RELU, data1);
+  GeTensorDesc tensor_desc(GeShape({1}), FORMAT_ND, DT_FLOAT);
+  auto tensor = make_shared<GeTensor>(tensor_desc, vector<uint8_t>(sizeof(float)));
+  (void)AttrUtils::SetTensor(relu1->GetOpDesc(), "value", tensor);
+  (void)AttrUtils::SetTensor(relu2->GetOpDesc(), "value", tensor);
+  auto graph = builder.GetGraph();
+
+  EXPECT_EQ(RunPass(graph), SUCCESS);
+  EXPECT_EQ(graph->GetDirectNodesSize(), 6);
+}
+
+TEST_F(UtestGraphPassesCommonSubexpressionEliminationPass, stateful_ops_not_merged) {
+  ut::GraphBuilder builder("g1");
+  auto data1 = builder.AddNode("data1", DATA, 1, 1);
+  auto var1 = builder.AddNode("var1", VARIABLE, 0, 1);
+  for (const auto &type : {RANDOMUNIFORM, DROPOUTGENMASK, APPLYMOMENTUM, HCOMALLREDUCE, SWITCH, "Print",
+                           "ScatterNdUpdate", "SparseApplyAdagrad", "CountUpTo", "Save"}) {
+    (void)AddUnaryNode(builder, string(type) + "1", type, data1);
+    (void)AddUnaryNode(builder, string(type) + "2", type, data1);
+  }
+  for (int i = 1; i <= 2; ++i) {
+    auto assign = builder.AddNode("assign" + to_string(i), ASSIGN, 2, 1);
+    builder.AddDataEdge(var1, 0, assign, 0);
+    builder.AddDataEdge(data1, 0, assign, 1);
+    auto ref_relu = AddUnaryNode(builder, "ref_relu" + to_string(i), RELU, data1);
+    (void)AttrUtils::SetBool(ref_relu->GetOpDesc(), ATTR_NAME_REFERENCE, true);
+  }
+  auto graph = builder.GetGraph();
+  size_t node_num = graph->GetDirectNodesSize();
+
+  EXPECT_EQ(RunPass(graph), SUCCESS);
+  EXPECT_EQ(graph->GetDirectNodesSize(), node_num);
+}
+
+///
+///        var1   indices  updates
+///          \      |       /
+///       scatter_add1  scatter_add2  (var -> var)
+///
+TEST_F(UtestGraphPassesCommonSubexpressionEliminationPass, scatter_adds_not_merged) {
+  ut::GraphBuilder builder("g1");
+  auto var1 = builder.AddNode("var1", VARIABLE, 0, 1);
+  auto indices = builder.AddNode("indices", DATA, 1, 1);
+  auto updates = builder.AddNode("updates", DATA, 1, 1);
+  auto graph = builder.GetGraph();
+  GeTensorDesc tensor_desc(GeShape({4}), FORMAT_ND, DT_FLOAT);
+  for (int i = 1; i <= 2; ++i) {
+    auto op_desc = make_shared<OpDesc>("scatter_add" + to_string(i), "ScatterAdd");
+    op_desc->AddInputDesc("var", tensor_desc);
+    op_desc->AddInputDesc("indices", tensor_desc);
+    op_desc->AddInputDesc("updates", tensor_desc);
+    op_desc->AddOutputDesc("var", tensor_desc);
+    auto scatter_add = graph->AddNode(op_desc);
+    builder.AddDataEdge(var1, 0, scatter_add, 0);
+    builder.AddDataEdge(indices, 0, scatter_add, 1);
+    builder.AddDataEdge(updates, 0, scatter_add, 2);
+  }
+
+  EXPECT_EQ(RunPass(graph), SUCCESS);
+  EXPECT_NE(graph->FindNode("scatter_add1"), nullptr);
+  EXPECT_NE(graph->FindNode("scatter_add2"), nullptr);
+  EXPECT_EQ(graph->FindNode("var1")->GetOutDataNodes().size(), 2);
+}
+
+TEST_F(UtestGraphPassesCommonSubexpressionEliminationPass, ref_ops_found_by_names) {
+  ut::GraphBuilder builder("g1");
+  auto data1 = builder.AddNode("data1", DATA, 1, 1);
+  auto graph = builder.GetGraph();
+  GeTensorDesc tensor_desc(GeShape({4}), FORMAT_ND, DT_FLOAT);
+  for (int i = 1; i <= 2; ++i) {
+    // an unknown type, which writes its input x in place
+    auto op_desc = make_shared<OpDesc>("ref_op" + to_string(i), "StubRefOp");
+    op_desc->AddInputDesc("x", tensor_desc);
+    op_desc->AddOutputDesc("x", tensor_desc);
+    auto ref_op = graph->AddNode(op_desc);
+    builder.AddDataEdge(data1, 0, ref_op, 0);
+  }
+
+  EXPECT_EQ(RunPass(graph), SUCCESS);
+  EXPECT_EQ(graph->GetDirectNodesSize(), 3);
+}
+
+TEST_F(UtestGraphPassesCommonSubexpressionEliminationPass, dump_names_not_compared) {
+  ut::GraphBuilder builder("g1");
+  auto data1 = builder.AddNode("data1", DATA, 1, 1);
+  auto relu1 = AddUnaryNode(builder, "relu1", RELU, data1);
+  auto relu2 = AddUnaryNode(builder, "relu2", RELU, data1);
+  (void)AttrUtils::SetListStr(relu1->GetOpDesc(), ATTR_NAME_DATA_DUMP_ORIGIN_OP_NAMES, {"relu1"});
+  (void)AttrUtils::SetListStr(relu2->GetOpDesc(), ATTR_NAME_DATA_DUMP_ORIGIN_OP_NAMES, {"relu2"});
+  (void)AttrUtils::SetStr(relu1->GetOpDesc(), ATTR_NAME_DATA_DUMP_ORIGIN_NAME, "origin_relu1");
+  (void)AttrUtils::SetStr(relu2->GetOpDesc(), ATTR_NAME_DATA_DUMP_ORIGIN_NAME, "origin_relu2");
+  auto graph = builder.GetGraph();
+
+  EXPECT_EQ(RunPass(graph), SUCCESS);
+  EXPECT_EQ(graph->GetDirectNodesSize(), 2);
+  EXPECT_NE(graph->FindNode("relu1"), nullptr);
+}
+}  // namespace ge
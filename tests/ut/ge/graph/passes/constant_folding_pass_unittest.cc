@@ -22,8 +22,12 @@
 
 #include "common/types.h"
 #include "ge/common/ge/ge_util.h"
+#include "graph/debug/ge_attr_define.h"
 #include "graph/passes/base_pass.h"
 #include "graph/passes/dimension_compute_pass.h"
+#include "graph/passes/folding_result_cache.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/op_desc_utils.h"
 #include "graph_builder_utils.h"
 #include "inc/kernel.h"
 #include "inc/kernel_factory.h"
@@ -40,6 +44,7 @@ const char *WrongYes = "WrongYes";
 const char *WrongYes1 = "WrongYes1";
 const char *WrongYes2 = "WrongYes2";
 const char *WrongYes3 = "WrongYes3";
+const char *CountingAdd = "CountingAdd";
 
 class TestAddNKernel : public Kernel {
  public:
@@ -161,6 +166,27 @@ class TestWrongKernel3 : public Kernel {
 };
 REGISTER_KERNEL(WrongYes3, TestWrongKernel3);
 
+// adds uint8 inputs element by element and counts how many times it runs
+class TestCountingAddKernel : public Kernel {
+ public:
+  Status Compute(const ge::OpDescPtr op_desc_ptr, const std::vector<ge::ConstGeTensorPtr> &input,
+                 std::vector<ge::GeTensorPtr> &v_output) override {
+    compute_count++;
+    std::vector<uint8_t> data(input[0]->GetData().data(), input[0]->GetData().data() + input[0]->GetData().size());
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] += input[1]->GetData().data()[i];
+    }
+    auto output = std::make_shared<GeTensor>(input[0]->GetTensorDesc());
+    output->SetData(data);
+    v_output.push_back(output);
+    return SUCCESS;
+  }
+
+  static int compute_count;
+};
+int TestCountingAddKernel::compute_count = 0;
+REGISTER_KERNEL(CountingAdd, TestCountingAddKernel);
+
 class UtestGraphPassesConstantFoldingPass : public testing::Test {
  protected:
   UtestGraphPassesConstantFoldingPass() = default;
@@ -527,6 +553,44 @@ ComputeGraphPtr BuildWrongGraph6() {
   builder.AddDataEdge(op, 0, conv, 0);
   return builder.GetGraph();
 }
+
+NodePtr AddConstNode(ut::GraphBuilder &builder, const std::string &name, const std::vector<uint8_t> &data) {
+  auto node = builder.AddNode(name, CONSTANT, 0, 1, FORMAT_ND, DT_UINT8, {static_cast<int64_t>(data.size())});
+  GeTensorDesc tensor_desc(GeShape({static_cast<int64_t>(data.size())}), FORMAT_ND, DT_UINT8);
+  (void)AttrUtils::SetTensor(node->GetOpDesc(), ATTR_NAME_WEIGHTS, std::make_shared<GeTensor>(tensor_desc, data));
+  return node;
+}
+
+///           netoutput
+///        /      |      \
+///     add4    add3     add2
+///     /  \    /  \    |  \
+///  add1  c8  c5  c6  c3  c4
+///  /  \
+/// c1  c2
+/// add1, add2 and add3 fold the same constants, add4 has a different attr
+ComputeGraphPtr BuildDuplicatedConstGraph() {
+  auto builder = ut::GraphBuilder("test");
+  auto netoutput = builder.AddNode("netoutput", NETOUTPUT, 3, 0);
+  std::vector<NodePtr> adds;
+  for (int i = 0; i < 3; ++i) {
+    auto add = builder.AddNode("add" + std::to_string(i + 1), CountingAdd, 2, 1, FORMAT_ND, DT_UINT8, {3});
+    auto const1 = AddConstNode(builder, "const" + std::to_string(2 * i + 1), {1, 2, 3});
+    auto const2 = AddConstNode(builder, "const" + std::to_string(2 * i + 2), {4, 5, 6});
+    builder.AddDataEdge(const1, 0, add, 0);
+    builder.AddDataEdge(const2, 0, add, 1);
+    adds.push_back(add);
+  }
+  auto add4 = builder.AddNode("add4", CountingAdd, 2, 1, FORMAT_ND, DT_UINT8, {3});
+  (void)AttrUtils::SetInt(add4->GetOpDesc(), "mode", 1);
+  auto const8 = AddConstNode(builder, "const8", {4, 5, 6});
+  builder.AddDataEdge(adds[0], 0, add4, 0);
+  builder.AddDataEdge(const8, 0, add4, 1);
+  builder.AddDataEdge(add4, 0, netoutput, 0);
+  builder.AddDataEdge(adds[1], 0, netoutput, 1);
+  builder.AddDataEdge(adds[2], 0, netoutput, 2);
+  return builder.GetGraph();
+}
 }  // namespace
 
 TEST_F(UtestGraphPassesConstantFoldingPass, folding_addn) {
@@ -774,4 +838,84 @@ TEST_F(UtestGraphPassesConstantFoldingPass, unlikely6) {
     delete name_to_pass.second;
   }
 }
+
+TEST_F(UtestGraphPassesConstantFoldingPass, folding_cache_duplicated_consts) {
+  FoldingResultCache::Instance().Clear();
+  TestCountingAddKernel::compute_count = 0;
+  auto graph = BuildDuplicatedConstGraph();
+  NamesToPass names_to_pass;
+  ConstantFoldingPass constant_folding_pass;
+  names_to_pass.push_back({"Test", &constant_folding_pass});
+  GEPass pass(graph);
+  EXPECT_EQ(pass.Run(names_to_pass), SUCCESS);
+
+  // add1 computes, add2 and add3 hit, add4 differs by attr and computes
+  EXPECT_EQ(TestCountingAddKernel::compute_count, 2);
+  FoldingCacheStatistics statistics = FoldingResultCache::Instance().GetStatistics();
+  EXPECT_EQ(statistics.hit_count, 2);
+  EXPECT_EQ(statistics.saved_bytes, 6);
+
+  auto netoutput = graph->FindNode("netoutput");
+  ASSERT_NE(netoutput, nullptr);
+  std::vector<std::vector<uint8_t>> expect_data = {{9, 12, 15}, {5, 7, 9}, {5, 7, 9}};
+  auto in_nodes = netoutput->GetInDataNodes();
+  ASSERT_EQ(in_nodes.size(), 3);
+  for (size_t i = 0; i < in_nodes.size(); ++i) {
+    EXPECT_EQ(in_nodes.at(i)->GetType(), CONSTANT);
+    auto weights = OpDescUtils::MutableWeights(in_nodes.at(i));
+    ASSERT_EQ(weights.size(), 1);
+    std::vector<uint8_t> data(weights[0]->GetData().data(), weights[0]->GetData().data() + weights[0]->GetData().size());
+    EXPECT_EQ(data, expect_data[i]);
+  }
+
+  // the same graph compiled again is folded from cache only
+  auto graph2 = BuildDuplicatedConstGraph();
+  GEPass pass2(graph2);
+  EXPECT_EQ(pass2.Run(names_to_pass), SUCCESS);
+  EXPECT_EQ(TestCountingAddKernel::compute_count, 2);
+  EXPECT_EQ(FoldingResultCache::Instance().GetStatistics().hit_count, 6);
+  FoldingResultCache::Instance().Clear();
+}
+
+TEST_F(UtestGraphPassesConstantFoldingPass, folding_cache_key) {
+  FoldingResultCache &cache = FoldingResultCache::Instance();
+  cache.Clear();
+  auto op_desc = std::make_shared<OpDesc>("add", CountingAdd);
+  GeTensorDesc tensor_desc(GeShape({3}), FORMAT_ND, DT_UINT8);
+  op_desc->AddInputDesc(tensor_desc);
+  op_desc->AddOutputDesc(tensor_desc);
+  std::vector<ConstGeTensorPtr> inputs = {std::make_shared<GeTensor>(tensor_desc, std::vector<uint8_t>{1, 2, 3})};
+  std::string key = cache.GetFoldingKey(op_desc, inputs);
+  ASSERT_FALSE(key.empty());
+
+  // names do not matter, attrs and data do
+  auto renamed = std::make_shared<OpDesc>("other_add", CountingAdd);
+  renamed->AddInputDesc(tensor_desc);
+  renamed->AddOutputDesc(tensor_desc);
+  EXPECT_EQ(cache.GetFoldingKey(renamed, inputs), key);
+  (void)AttrUtils::SetListInt(renamed, "axes", std::vector<int64_t>{0});
+  EXPECT_NE(cache.GetFoldingKey(renamed, inputs), key);
+  std::vector<ConstGeTensorPtr> other_inputs = {
+      std::make_shared<GeTensor>(tensor_desc, std::vector<uint8_t>{1, 2, 4})};
+  EXPECT_NE(cache.GetFoldingKey(op_desc, other_inputs), key);
+
+  // attr not comparable, not cached
+  auto with_tensor = std::make_shared<OpDesc>("add", CountingAdd);
+  (void)AttrUtils::SetTensor(with_tensor, "value", std::make_shared<GeTensor>(tensor_desc));
+  EXPECT_TRUE(cache.GetFoldingKey(with_tensor, inputs).empty());
+
+  std::vector<GeTensorPtr> outputs = {std::make_shared<GeTensor>(tensor_desc, std::vector<uint8_t>{2, 4, 6})};
+  cache.Insert(key, inputs, outputs);
+  std::vector<GeTensorPtr> cached_outputs;
+  ASSERT_TRUE(cache.Find(key, inputs, cached_outputs));
+  EXPECT_EQ(cached_outputs[0], outputs[0]);
+  EXPECT_FALSE(cache.Find(key, other_inputs, cached_outputs));
+
+  // evicted when capacity shrinks
+  cache.SetCapacity(0);
+  EXPECT_FALSE(cache.Find(key, inputs, cached_outputs));
+  EXPECT_EQ(cache.GetStatistics().evict_count, 1);
+  cache.SetCapacity(64 * 1024 * 1024);
+  cache.Clear();
+}
 }  // namespace ge
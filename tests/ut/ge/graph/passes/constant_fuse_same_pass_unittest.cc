@@ -0,0 +1,189 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#define protected public
+#define private public
+#include "graph/passes/constant_fuse_same_pass.h"
+#undef protected
+#undef private
+
+#include "common/types.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph_builder_utils.h"
+
+using namespace std;
+using namespace testing;
+
+namespace ge {
+namespace {
+const int64_t kElementNum = 1024 * 1024;
+const size_t kWeightSize = kElementNum * sizeof(float);
+}  // namespace
+
+class UtestGraphPassesConstantFuseSamePass : public Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+
+  // const of float with the given dims, the content is made of the seed
+  static NodePtr AddConst(ut::GraphBuilder &builder, const string &name, const vector<int64_t> &dims, uint8_t seed,
+                          size_t size = kWeightSize) {
+    auto node = builder.AddNode(name, CONSTANT, 0, 1, FORMAT_ND, DT_FLOAT, dims);
+    vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i) {
+      data[i] = static_cast<uint8_t>(i * 31 + seed);
+    }
+    GeTensorDesc tensor_desc(GeShape(dims), FORMAT_ND, DT_FLOAT);
+    auto weight = make_shared<GeTensor>(tensor_desc, data);
+    EXPECT_TRUE(AttrUtils::SetTensor(node->GetOpDesc(), ATTR_NAME_WEIGHTS, weight));
+    return node;
+  }
+
+  static NodePtr AddRelu(ut::GraphBuilder &builder, const string &name, NodePtr input) {
+    auto node = builder.AddNode(name, RELU, 1, 1);
+    builder.AddDataEdge(input, 0, node, 0);
+    return node;
+  }
+
+  static void GetConsts(const ComputeGraphPtr &graph, size_t &const_num, size_t &weight_size) {
+    const_num = 0;
+    weight_size = 0;
+    for (const auto &node : graph->GetDirectNode()) {
+      if (node->GetType() != CONSTANT) {
+        continue;
+      }
+      ++const_num;
+      ConstGeTensorPtr weight;
+      if (AttrUtils::GetTensor(node->GetOpDesc(), ATTR_NAME_WEIGHTS, weight)) {
+        weight_size += weight->GetData().size();
+      }
+    }
+  }
+
+  ///
+  ///  const1  const2  const3  const4(other content)  const5(other shape)
+  ///    |       |   \   |        |                    |
+  ///  relu1  relu2    add       relu4               relu5
+  ///
+  static ComputeGraphPtr BuildGraph() {
+    ut::GraphBuilder builder("g1");
+    auto const1 = AddConst(builder, "const1", {kElementNum}, 1);
+    auto const2 = AddConst(builder, "const2", {kElementNum}, 1);
+    auto const3 = AddConst(builder, "const3", {kElementNum}, 1);
+    auto const4 = AddConst(builder, "const4", {kElementNum}, 2);
+    auto const5 = AddConst(builder, "const5", {1024, 1024}, 1);
+    (void)AddRelu(builder, "relu1", const1);
+    (void)AddRelu(builder, "relu2", const2);
+    auto add = builder.AddNode("add", ADD, 2, 1);
+    builder.AddDataEdge(const2, 0, add, 0);
+    builder.AddDataEdge(const3, 0, add, 1);
+    (void)AddRelu(builder, "relu4", const4);
+    (void)AddRelu(builder, "relu5", const5);
+    return builder.GetGraph();
+  }
+};
+
+TEST_F(UtestGraphPassesConstantFuseSamePass, dedup_4m_consts) {
+  auto graph = BuildGraph();
+  size_t const_num = 0;
+  size_t weight_size = 0;
+  GetConsts(graph, const_num, weight_size);
+  EXPECT_EQ(const_num, 5);
+  EXPECT_EQ(weight_size, 5 * kWeightSize);
+
+  ConstantFuseSamePass pass(true);
+  EXPECT_EQ(pass.Run(graph), SUCCESS);
+  GetConsts(graph, const_num, weight_size);
+  EXPECT_EQ(const_num, 3);
+  EXPECT_EQ(weight_size, 3 * kWeightSize);
+
+  auto const1 = graph->FindNode("const1");
+  ASSERT_NE(const1, nullptr);
+  EXPECT_EQ(graph->FindNode("const2"), nullptr);
+  EXPECT_EQ(graph->FindNode("const3"), nullptr);
+  EXPECT_NE(graph->FindNode("const4"), nullptr);
+  EXPECT_NE(graph->FindNode("const5"), nullptr);
+  EXPECT_EQ(const1->GetOutDataNodes().size(), 4);
+  auto add = graph->FindNode("add");
+  ASSERT_NE(add, nullptr);
+  EXPECT_EQ(add->GetInDataAnchor(0)->GetPeerOutAnchor()->GetOwnerNode(), const1);
+  EXPECT_EQ(add->GetInDataAnchor(1)->GetPeerOutAnchor()->GetOwnerNode(), const1);
+  EXPECT_EQ(graph->FindNode("relu2")->GetInDataNodes().at(0), const1);
+}
+
+TEST_F(UtestGraphPassesConstantFuseSamePass, only_one_element_consts_by_default) {
+  auto graph = BuildGraph();
+  ConstantFuseSamePass pass;
+  EXPECT_EQ(pass.Run(graph), SUCCESS);
+  size_t const_num = 0;
+  size_t weight_size = 0;
+  GetConsts(graph, const_num, weight_size);
+  EXPECT_EQ(const_num, 5);
+  EXPECT_EQ(weight_size, 5 * kWeightSize);
+}
+
+TEST_F(UtestGraphPassesConstantFuseSamePass, dedup_confirmed_by_content) {
+  ut::GraphBuilder builder("g1");
+  auto const1 = AddConst(builder, "const1", {4}, 1, 16);
+  auto const2 = AddConst(builder, "const2", {4}, 2, 16);
+  auto const3 = AddConst(builder, "const3", {4}, 1, 16);
+  (void)AddRelu(builder, "relu1", const1);
+  (void)AddRelu(builder, "relu2", const2);
+  (void)AddRelu(builder, "relu3", const3);
+  auto graph = builder.GetGraph();
+  ConstantFuseSamePass pass(true);
+  SameContentBuckets buckets;
+  for (const auto &name : {"const1", "const2", "const3"}) {
+    auto node = graph->FindNode(name);
+    ConstGeTensorPtr weight;
+    ASSERT_TRUE(AttrUtils::GetTensor(node->GetOpDesc(), ATTR_NAME_WEIGHTS, weight));
+    SameConstKey key;
+    key.data_size = static_cast<int>(weight->GetData().size());
+    key.data = weight->GetData().GetData();
+    key.data_type = DT_FLOAT;
+    key.format = FORMAT_ND;
+    key.shape = {4};
+    pass.AddSameContentNode(node, key, buckets);
+  }
+  ASSERT_EQ(buckets.size(), 2);
+
+  // both groups in one bucket, as if their contents had the same hash, the memcmp keeps them apart
+  SameContentBuckets collided_buckets;
+  for (const auto &bucket : buckets) {
+    for (const auto &consts : bucket.second) {
+      collided_buckets[0].emplace_back(consts);
+    }
+  }
+  ASSERT_EQ(collided_buckets[0].size(), 2);
+  auto &same_consts = (collided_buckets[0][0].nodes.size() == 2) ? collided_buckets[0][0] : collided_buckets[0][1];
+  ASSERT_EQ(same_consts.nodes.size(), 2);
+  EXPECT_EQ(same_consts.nodes[0], const1);
+  EXPECT_EQ(same_consts.nodes[1], const3);
+  EXPECT_EQ(pass.FuseSameContentNodes(graph, collided_buckets), SUCCESS);
+  EXPECT_NE(graph->FindNode("const1"), nullptr);
+  EXPECT_NE(graph->FindNode("const2"), nullptr);
+  EXPECT_EQ(graph->FindNode("const3"), nullptr);
+  EXPECT_EQ(graph->FindNode("relu3")->GetInDataNodes().at(0), const1);
+}
+}  // namespace ge
@@ -0,0 +1,242 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "common/types.h"
+#include "graph/common/bcast.h"
+#include "graph/ge_tensor.h"
+#include "graph/op_desc.h"
+#include "inc/kernel.h"
+#include "inc/kernel_factory.h"
+
+using namespace testing;
+using namespace ge;
+
+namespace {
+const int64_t kLargeElementNum = 1024 * 1024;
+// the timings depend on the machine, they are printed only in the benchmark runs which set it to 1
+const char *const kTimingEnv = "GE_BCAST_BENCHMARK_TIMING";
+
+template <typename T>
+ConstGeTensorPtr CreateTensor(const std::vector<int64_t> &dims, const std::vector<T> &data, DataType data_type) {
+  GeTensorDesc tensor_desc(GeShape(dims), FORMAT_ND, data_type);
+  return std::make_shared<GeTensor>(tensor_desc, reinterpret_cast<const uint8_t *>(data.data()),
+                                    data.size() * sizeof(T));
+}
+
+// the indexes materialising path used before BCastApply, as the reference
+template <typename InT, typename OutT>
+Status MaterialisedCompute(const std::vector<ConstGeTensorPtr> &input, std::vector<OutT> &v_output,
+                           const std::function<OutT(InT const &, InT const &)> &func) {
+  BCast bcast;
+  Status ret = bcast.GenerateBcastInfo(BCast::TransShapeToDimVec(input[0]->GetTensorDesc()),
+                                       BCast::TransShapeToDimVec(input[1]->GetTensorDesc()));
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  std::vector<int64_t> x_indexes;
+  std::vector<int64_t> y_indexes;
+  bcast.BCastIndexes(x_indexes, y_indexes);
+  auto x_data = reinterpret_cast<const InT *>(input[0]->GetData().data());
+  auto y_data = reinterpret_cast<const InT *>(input[1]->GetData().data());
+  for (size_t i = 0; i < x_indexes.size(); ++i) {
+    v_output.push_back(func(x_data[x_indexes[i]], y_data[y_indexes[i]]));
+  }
+  return SUCCESS;
+}
+
+std::vector<int32_t> CreateData(int64_t num, int32_t seed) {
+  std::vector<int32_t> data(static_cast<size_t>(num));
+  for (int64_t i = 0; i < num; ++i) {
+    data[i] = static_cast<int32_t>((i * 7 + seed) % 1000);
+  }
+  return data;
+}
+
+bool IsTimingEnabled() {
+  const char *timing = std::getenv(kTimingEnv);
+  return (timing != nullptr) && (std::string(timing) == "1");
+}
+
+int64_t CostUs(const std::chrono::steady_clock::time_point &start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+class UtestBCastCompute : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+
+  // checks lazy walking against the materialised indexes
+  void CheckSameAsMaterialised(const std::vector<int64_t> &x_dims, const std::vector<int64_t> &y_dims) {
+    int64_t x_num = 1;
+    int64_t y_num = 1;
+    for (auto dim : x_dims) {
+      x_num *= dim;
+    }
+    for (auto dim : y_dims) {
+      y_num *= dim;
+    }
+    std::vector<ConstGeTensorPtr> input = {CreateTensor(x_dims, CreateData(x_num, 1), DT_INT32),
+                                           CreateTensor(y_dims, CreateData(y_num, 3), DT_INT32)};
+    std::function<int32_t(int32_t const &, int32_t const &)> sub_func = [](int32_t const &a, int32_t const &b) {
+      return a * 1000 - b;
+    };
+
+    std::vector<int32_t> expect;
+    ASSERT_EQ(MaterialisedCompute<int32_t>(input, expect, sub_func), SUCCESS);
+    BCast bcast;
+    std::vector<int32_t> output;
+    ASSERT_EQ(bcast.BCastCompute<int32_t>(input, output, sub_func), SUCCESS);
+    EXPECT_EQ(output, expect);
+  }
+};
+
+TEST_F(UtestBCastCompute, same_as_materialised_indexes) {
+  CheckSameAsMaterialised({}, {});
+  CheckSameAsMaterialised({5}, {5});
+  CheckSameAsMaterialised({}, {2, 3});
+  CheckSameAsMaterialised({2, 3}, {1});
+  CheckSameAsMaterialised({2, 3, 4}, {3, 1});
+  CheckSameAsMaterialised({4, 1, 3}, {1, 5, 3});
+  CheckSameAsMaterialised({2, 1, 4, 1}, {1, 3, 1, 5});
+  CheckSameAsMaterialised({2, 3, 1, 4}, {2, 3, 5, 4});
+  CheckSameAsMaterialised({1, 1, 6}, {2, 3, 1});
+}
+
+TEST_F(UtestBCastCompute, empty_and_invalid_input) {
+  std::vector<int32_t> no_data;
+  std::vector<ConstGeTensorPtr> input = {CreateTensor({0, 3}, no_data, DT_INT32),
+                                         CreateTensor({3}, CreateData(3, 0), DT_INT32)};
+  BCast bcast;
+  std::vector<int32_t> output;
+  auto add_func = [](int32_t const &a, int32_t const &b) { return a + b; };
+  EXPECT_EQ(bcast.BCastCompute<int32_t>(input, output, add_func), SUCCESS);
+  EXPECT_TRUE(output.empty());
+
+  // data is less than the shape says
+  std::vector<ConstGeTensorPtr> short_input = {CreateTensor({4}, CreateData(2, 0), DT_INT32),
+                                               CreateTensor({4}, CreateData(4, 0), DT_INT32)};
+  BCast short_bcast;
+  EXPECT_EQ(short_bcast.BCastCompute<int32_t>(short_input, output, add_func), domi::PARAM_INVALID);
+
+  std::vector<ConstGeTensorPtr> mismatch_input = {CreateTensor({4}, CreateData(4, 0), DT_INT32),
+                                                  CreateTensor({3}, CreateData(3, 0), DT_INT32)};
+  BCast mismatch_bcast;
+  EXPECT_NE(mismatch_bcast.BCastCompute<int32_t>(mismatch_input, output, add_func), SUCCESS);
+}
+
+TEST_F(UtestBCastCompute, check_stops_at_failure) {
+  std::vector<ConstGeTensorPtr> input = {CreateTensor({2, 3}, std::vector<int32_t>{1, 2, 3, 4, 5, 6}, DT_INT32),
+                                         CreateTensor({3}, std::vector<int32_t>{1, 0, 1}, DT_INT32)};
+  int call_num = 0;
+  auto div_func = [&call_num](int32_t const &a, int32_t const &b, DataType &type, Status &ret) -> int32_t {
+    call_num++;
+    if (b == 0) {
+      ret = PARAM_INVALID;
+      return 0;
+    }
+    return a / b;
+  };
+  BCast bcast;
+  std::vector<int32_t> output;
+  EXPECT_EQ(bcast.BCastComputeCheck<int32_t>(input, output, div_func), PARAM_INVALID);
+  EXPECT_EQ(call_num, 2);
+}
+
+// folds 1M-element Add/Mul/Greater with broadcast and compares with the materialised indexes path,
+// the costs of both paths are printed if GE_BCAST_BENCHMARK_TIMING is 1
+TEST_F(UtestBCastCompute, fold_1m_elements_same_as_materialised) {
+  const int64_t kInner = 1024;
+  std::vector<ConstGeTensorPtr> same_shape = {
+      CreateTensor({kLargeElementNum}, CreateData(kLargeElementNum, 1), DT_INT32),
+      CreateTensor({kLargeElementNum}, CreateData(kLargeElementNum, 2), DT_INT32)};
+  std::vector<ConstGeTensorPtr> broadcast = {
+      CreateTensor({kLargeElementNum / kInner, kInner}, CreateData(kLargeElementNum, 1), DT_INT32),
+      CreateTensor({kInner}, CreateData(kInner, 2), DT_INT32)};
+
+  std::function<int32_t(int32_t const &, int32_t const &)> add_func = [](int32_t const &a, int32_t const &b) {
+    return a + b;
+  };
+  std::function<int32_t(int32_t const &, int32_t const &)> mul_func = [](int32_t const &a, int32_t const &b) {
+    return a * b;
+  };
+  std::function<uint8_t(int32_t const &, int32_t const &)> greater_func = [](int32_t const &a, int32_t const &b) {
+    return static_cast<uint8_t>(a > b);
+  };
+  auto add_lambda = [](int32_t const &a, int32_t const &b) { return a + b; };
+  auto mul_lambda = [](int32_t const &a, int32_t const &b) { return a * b; };
+  auto greater_lambda = [](int32_t const &a, int32_t const &b) { return static_cast<uint8_t>(a > b); };
+
+  bool timing = IsTimingEnabled();
+  for (const auto &input : {same_shape, broadcast}) {
+    std::vector<int32_t> add_expect;
+    std::vector<int32_t> mul_expect;
+    std::vector<uint8_t> greater_expect;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(MaterialisedCompute<int32_t>(input, add_expect, add_func), SUCCESS);
+    ASSERT_EQ(MaterialisedCompute<int32_t>(input, mul_expect, mul_func), SUCCESS);
+    ASSERT_EQ(MaterialisedCompute<int32_t>(input, greater_expect, greater_func), SUCCESS);
+    int64_t materialised_cost = CostUs(start);
+
+    std::vector<int32_t> add_output;
+    std::vector<int32_t> mul_output;
+    std::vector<uint8_t> greater_output;
+    start = std::chrono::steady_clock::now();
+    BCast add_bcast;
+    ASSERT_EQ(add_bcast.BCastCompute<int32_t>(input, add_output, add_lambda), SUCCESS);
+    BCast mul_bcast;
+    ASSERT_EQ(mul_bcast.BCastCompute<int32_t>(input, mul_output, mul_lambda), SUCCESS);
+    BCast greater_bcast;
+    ASSERT_EQ(greater_bcast.BCastCompute<int32_t>(input, greater_output, greater_lambda), SUCCESS);
+    int64_t lazy_cost = CostUs(start);
+
+    EXPECT_EQ(add_output, add_expect);
+    EXPECT_EQ(mul_output, mul_expect);
+    EXPECT_EQ(greater_output, greater_expect);
+    EXPECT_EQ(add_output.size(), kLargeElementNum);
+    if (timing) {
+      std::cout << "BCast Add/Mul/Greater of " << input[0]->GetTensorDesc().GetShape().ToString() << " and "
+                << input[1]->GetTensorDesc().GetShape().ToString() << ", materialised indexes: " << materialised_cost
+                << "us, lazy broadcast: " << lazy_cost << "us." << std::endl;
+    }
+  }
+
+  // whole add kernel
+  OpDescPtr op_desc = std::make_shared<OpDesc>("Add", ADD);
+  op_desc->AddOutputDesc(GeTensorDesc(GeShape({kLargeElementNum}), FORMAT_ND, DT_INT32));
+  std::shared_ptr<Kernel> kernel = KernelFactory::Instance().Create(ADD);
+  ASSERT_NE(kernel, nullptr);
+  std::vector<GeTensorPtr> v_output;
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(kernel->Compute(op_desc, same_shape, v_output), SUCCESS);
+  if (timing) {
+    std::cout << "Add kernel of " << kLargeElementNum << " elements: " << CostUs(start) << "us." << std::endl;
+  }
+  ASSERT_EQ(v_output.size(), 1);
+  ASSERT_EQ(v_output[0]->GetData().size(), kLargeElementNum * sizeof(int32_t));
+  std::vector<int32_t> add_expect;
+  ASSERT_EQ(MaterialisedCompute<int32_t>(same_shape, add_expect, add_func), SUCCESS);
+  auto add_output = reinterpret_cast<const int32_t *>(v_output[0]->GetData().data());
+  EXPECT_EQ(std::vector<int32_t>(add_output, add_output + kLargeElementNum), add_expect);
+}
@@ -0,0 +1,272 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "graph/passes/pass_profiler.h"
+
+#include "graph/passes/base_pass.h"
+#include "graph/utils/graph_utils.h"
+#include "graph_builder_utils.h"
+#include "inc/pass_manager.h"
+#include "nlohmann/json.hpp"
+
+namespace ge {
+namespace {
+// adds an Identity after the first Data
+class ProfileAddNodeGraphPass : public GraphPass {
+ public:
+  Status Run(ComputeGraphPtr graph) override {
+    auto data = graph->FindNode("data");
+    OpDescPtr op_desc = std::make_shared<OpDesc>("identity", "Identity");
+    op_desc->AddInputDesc(GeTensorDesc());
+    op_desc->AddOutputDesc(GeTensorDesc());
+    auto identity = graph->AddNode(op_desc);
+    return GraphUtils::AddEdge(data->GetOutDataAnchor(0), identity->GetInDataAnchor(0));
+  }
+};
+
+class ProfileNotChangedGraphPass : public GraphPass {
+ public:
+  Status Run(ComputeGraphPtr graph) override { return NOT_CHANGED; }
+};
+
+// deletes the Relu nodes
+class ProfileDeleteReluPass : public BaseNodePass {
+ public:
+  Status Run(NodePtr &node) override {
+    if (node->GetType() != "Relu") {
+      return SUCCESS;
+    }
+    return IsolateAndDeleteNode(node, {0});
+  }
+};
+
+class ProfileNothingPass : public BaseNodePass {
+ public:
+  Status Run(NodePtr &node) override { return SUCCESS; }
+};
+
+///
+///   netoutput
+///      |
+///    relu2
+///      |
+///    relu1
+///      |
+///    data
+///
+ComputeGraphPtr BuildReluGraph() {
+  ut::GraphBuilder builder("g1");
+  auto data = builder.AddNode("data", "Data", 1, 1);
+  auto relu1 = builder.AddNode("relu1", "Relu", 1, 1);
+  auto relu2 = builder.AddNode("relu2", "Relu", 1, 1);
+  auto netoutput = builder.AddNode("netoutput", "NetOutput", 1, 1);
+  builder.AddDataEdge(data, 0, relu1, 0);
+  builder.AddDataEdge(relu1, 0, relu2, 0);
+  builder.AddDataEdge(relu2, 0, netoutput, 0);
+  return builder.GetGraph();
+}
+
+const PassProfileStat *FindStat(const std::vector<PassProfileStat> &stats, const std::string &name) {
+  for (const auto &stat : stats) {
+    if (stat.name == name) {
+      return &stat;
+    }
+  }
+  return nullptr;
+}
+}  // namespace
+
+class UtestPassProfiler : public testing::Test {
+ protected:
+  void SetUp() { setenv("GE_PASS_PROFILING", "1", 1); }
+  void TearDown() { unsetenv("GE_PASS_PROFILING"); }
+};
+
+TEST_F(UtestPassProfiler, disabled_by_default) {
+  unsetenv("GE_PASS_PROFILING");
+  auto profiler = PassProfiler::CreateIfEnabled();
+  EXPECT_EQ(profiler, nullptr);
+  PassProfileScope scope(profiler);
+  EXPECT_EQ(PassProfiler::GetCurrent(), nullptr);
+
+  auto graph = BuildReluGraph();
+  ProfileNotChangedGraphPass pass;
+  std::vector<GraphPass *> passes = {&pass};
+  EXPECT_EQ(PassManager::Run(graph, passes), NOT_CHANGED);
+}
+
+TEST_F(UtestPassProfiler, graph_pass_stats) {
+  auto profiler = PassProfiler::CreateIfEnabled();
+  ASSERT_NE(profiler, nullptr);
+  {
+    PassProfileScope scope(profiler);
+    EXPECT_EQ(PassProfiler::GetCurrent(), profiler.get());
+    auto graph = BuildReluGraph();
+    ProfileAddNodeGraphPass add_pass;
+    ProfileNotChangedGraphPass not_changed_pass;
+    std::vector<GraphPass *> passes = {&add_pass, &not_changed_pass, &not_changed_pass};
+    EXPECT_EQ(PassManager::Run(graph, passes), SUCCESS);
+  }
+  EXPECT_EQ(PassProfiler::GetCurrent(), nullptr);
+
+  auto stats = profiler->GetStats();
+  ASSERT_EQ(stats.size(), 2);
+  // reported by class names in the order of the first runs
+  EXPECT_EQ(stats[0].name, "ge::(anonymous namespace)::ProfileAddNodeGraphPass");
+  EXPECT_FALSE(stats[0].is_node_pass);
+  EXPECT_EQ(stats[0].run_count, 1);
+  EXPECT_EQ(stats[0].nodes_visited, 4);
+  EXPECT_EQ(stats[0].change_count, 1);
+  EXPECT_EQ(stats[0].nodes_added, 1);
+  EXPECT_EQ(stats[0].nodes_deleted, 0);
+
+  EXPECT_EQ(stats[1].run_count, 2);
+  EXPECT_EQ(stats[1].nodes_visited, 10);
+  EXPECT_EQ(stats[1].change_count, 0);
+  EXPECT_EQ(stats[1].nodes_added, 0);
+}
+
+TEST_F(UtestPassProfiler, node_pass_stats) {
+  auto profiler = PassProfiler::CreateIfEnabled();
+  ASSERT_NE(profiler, nullptr);
+  auto graph = BuildReluGraph();
+  ProfileDeleteReluPass delete_pass;
+  ProfileNothingPass nothing_pass;
+  NamesToPass names_to_passes = {{"DeleteReluPass", &delete_pass}, {"NothingPass", &nothing_pass}};
+  {
+    PassProfileScope scope(profiler);
+    GEPass ge_passes(graph);
+    EXPECT_EQ(ge_passes.Run(names_to_passes), SUCCESS);
+  }
+  EXPECT_EQ(graph->GetDirectNodesSize(), 2);
+
+  auto stats = profiler->GetStats();
+  auto delete_stat = FindStat(stats, "DeleteReluPass");
+  ASSERT_NE(delete_stat, nullptr);
+  EXPECT_TRUE(delete_stat->is_node_pass);
+  EXPECT_EQ(delete_stat->nodes_deleted, 2);
+  EXPECT_EQ(delete_stat->nodes_added, 0);
+  EXPECT_EQ(delete_stat->change_count, 2);
+  // deleting a relu asks to re-pass itself, its input and its output
+  EXPECT_EQ(delete_stat->re_pass_triggers, 6);
+  // the four nodes in the first sweep, and data again in the re-pass sweep
+  EXPECT_EQ(delete_stat->run_count, 5);
+  EXPECT_EQ(delete_stat->nodes_visited, delete_stat->run_count);
+
+  auto nothing_stat = FindStat(stats, "NothingPass");
+  ASSERT_NE(nothing_stat, nullptr);
+  // the passes after the one deleting the node are skipped
+  EXPECT_EQ(nothing_stat->run_count, 3);
+  EXPECT_EQ(nothing_stat->change_count, 0);
+  EXPECT_EQ(nothing_stat->re_pass_triggers, 0);
+
+  EXPECT_EQ(profiler->GetGEPassRunCount(), 1);
+  EXPECT_EQ(profiler->GetGEPassSweepCount(), 2);
+}
+
+// the subgraphs are optimized on worker threads, each of them takes the profiler of the compile
+TEST_F(UtestPassProfiler, worker_thread_stats) {
+  auto profiler = PassProfiler::CreateIfEnabled();
+  ASSERT_NE(profiler, nullptr);
+  PassProfileScope scope(profiler);
+  const int thread_num = 4;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([profiler, i]() {
+      // thread local, a worker reports nothing until it takes the profiler
+      EXPECT_EQ(PassProfiler::GetCurrent(), nullptr);
+      PassProfileScope worker_scope((i % 2 == 0) ? profiler : nullptr);
+      auto graph = BuildReluGraph();
+      ProfileNotChangedGraphPass pass;
+      std::vector<GraphPass *> passes = {&pass};
+      EXPECT_EQ(PassManager::Run(graph, passes), NOT_CHANGED);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  auto stats = profiler->GetStats();
+  ASSERT_EQ(stats.size(), 1);
+  EXPECT_EQ(stats[0].name, "ge::(anonymous namespace)::ProfileNotChangedGraphPass");
+  EXPECT_EQ(stats[0].run_count, thread_num / 2);
+  EXPECT_EQ(stats[0].nodes_visited, 4 * thread_num / 2);
+}
+
+TEST_F(UtestPassProfiler, stage_stats) {
+  auto profiler = PassProfiler::CreateIfEnabled();
+  ASSERT_NE(profiler, nullptr);
+  for (int i = 0; i < 2; ++i) {
+    GE_TIMESTAMP_START(Unprofiled);
+    GE_TIMESTAMP_PROFILED_END(Unprofiled, "Stage1");
+  }
+  EXPECT_TRUE(profiler->GetStageStats().empty());
+
+  {
+    PassProfileScope scope(profiler);
+    for (int i = 0; i < 2; ++i) {
+      GE_TIMESTAMP_START(Stage1);
+      GE_TIMESTAMP_PROFILED_END(Stage1, "Stage1");
+    }
+    GE_TIMESTAMP_START(Stage2);
+    GE_TIMESTAMP_PROFILED_END(Stage2, "Stage2");
+  }
+  auto stages = profiler->GetStageStats();
+  ASSERT_EQ(stages.size(), 2);
+  EXPECT_EQ(stages[0].name, "Stage1");
+  EXPECT_EQ(stages[0].run_count, 2);
+  EXPECT_EQ(stages[1].name, "Stage2");
+  EXPECT_EQ(stages[1].run_count, 1);
+
+  auto report = nlohmann::json::parse(profiler->ToJson());
+  ASSERT_EQ(report["stages"].size(), 2);
+  EXPECT_EQ(report["stages"][0]["name"], "Stage1");
+  EXPECT_EQ(report["stages"][0]["run_count"], 2);
+}
+
+TEST_F(UtestPassProfiler, json_report) {
+  auto profiler = PassProfiler::CreateIfEnabled();
+  ASSERT_NE(profiler, nullptr);
+  profiler->AddNodePassRun("NodePass", 5, true, 1, 2, 3);
+  profiler->AddNodePassRun("NodePass", 5, false, 0, 0, 0);
+  profiler->AddGraphPassRun("GraphPass", 7, 10, false, 0, 0);
+  profiler->AddGEPassRun(2);
+
+  auto report = nlohmann::json::parse(profiler->ToJson());
+  EXPECT_EQ(report["ge_pass_run_count"], 1);
+  EXPECT_EQ(report["ge_pass_sweep_count"], 2);
+  ASSERT_EQ(report["passes"].size(), 2);
+  auto node_pass = report["passes"][0];
+  EXPECT_EQ(node_pass["name"], "NodePass");
+  EXPECT_EQ(node_pass["type"], "node");
+  EXPECT_EQ(node_pass["run_count"], 2);
+  EXPECT_EQ(node_pass["cost_us"], 10);
+  EXPECT_EQ(node_pass["nodes_visited"], 2);
+  EXPECT_EQ(node_pass["change_count"], 1);
+  EXPECT_EQ(node_pass["nodes_added"], 1);
+  EXPECT_EQ(node_pass["nodes_deleted"], 2);
+  EXPECT_EQ(node_pass["re_pass_triggers"], 3);
+  EXPECT_EQ(report["passes"][1]["type"], "graph");
+  EXPECT_EQ(report["passes"][1]["nodes_visited"], 10);
+}
+}  // namespace ge
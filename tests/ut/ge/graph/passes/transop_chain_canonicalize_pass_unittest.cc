@@ -0,0 +1,316 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#define protected public
+#define private public
+#include "graph/passes/transop_chain_canonicalize_pass.h"
+#undef protected
+#undef private
+
+#include "common/formats/format_transfers/datatype_transfer.h"
+#include "common/formats/format_transfers/format_transfer.h"
+#include "common/formats/format_transfers/format_transfer_transpose.h"
+#include "common/formats/formats.h"
+#include "common/types.h"
+#include "graph/compute_graph.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+
+using namespace std;
+using namespace testing;
+
+namespace ge {
+namespace {
+///
+/// Builds data -> trans ops -> netoutput, each op takes the output desc of the one before it.
+///
+class ChainBuilder {
+ public:
+  ChainBuilder(Format format, DataType data_type, const vector<int64_t> &dims)
+      : graph_(make_shared<ComputeGraph>("g1")), desc_(GeShape(dims), format, data_type) {
+    auto op_desc = make_shared<OpDesc>("data1", DATA);
+    op_desc->AddInputDesc(desc_);
+    op_desc->AddOutputDesc(desc_);
+    last_ = graph_->AddNode(op_desc);
+  }
+
+  NodePtr AddCast(const string &name, DataType data_type) {
+    GeTensorDesc output_desc = desc_;
+    output_desc.SetDataType(data_type);
+    auto node = AddOp(name, CAST, output_desc);
+    (void)AttrUtils::SetInt(node->GetOpDesc(), CAST_ATTR_SRCT, static_cast<int64_t>(desc_in_.GetDataType()));
+    (void)AttrUtils::SetInt(node->GetOpDesc(), CAST_ATTR_DSTT, static_cast<int64_t>(data_type));
+    return node;
+  }
+
+  NodePtr AddTransData(const string &name, Format format, const vector<int64_t> &dims) {
+    return AddOp(name, TRANSDATA, GeTensorDesc(GeShape(dims), format, desc_.GetDataType()));
+  }
+
+  // the output is labeled by the format, whatever the perm does to the axes
+  NodePtr AddTranspose(const string &name, const vector<int64_t> &perm, Format format) {
+    auto in_dims = desc_.GetShape().GetDims();
+    vector<int64_t> dims;
+    for (auto axis : perm) {
+      dims.emplace_back(in_dims[axis]);
+    }
+    auto node = AddOp(name, TRANSPOSE, GeTensorDesc(GeShape(dims), format, desc_.GetDataType()));
+    (void)AttrUtils::SetListInt(node->GetOpDesc(), "perm", perm);
+    return node;
+  }
+
+  ComputeGraphPtr Build(int consumer_num = 1) {
+    auto op_desc = make_shared<OpDesc>("netoutput", NETOUTPUT);
+    for (int i = 0; i < consumer_num; ++i) {
+      op_desc->AddInputDesc(desc_);
+    }
+    auto netoutput = graph_->AddNode(op_desc);
+    for (int i = 0; i < consumer_num; ++i) {
+      (void)GraphUtils::AddEdge(last_->GetOutDataAnchor(0), netoutput->GetInDataAnchor(i));
+    }
+    graph_->TopologicalSorting();
+    return graph_;
+  }
+
+ private:
+  NodePtr AddOp(const string &name, const string &type, const GeTensorDesc &output_desc) {
+    auto op_desc = make_shared<OpDesc>(name, type);
+    op_desc->AddInputDesc(desc_);
+    op_desc->AddOutputDesc(output_desc);
+    auto node = graph_->AddNode(op_desc);
+    (void)GraphUtils::AddEdge(last_->GetOutDataAnchor(0), node->GetInDataAnchor(0));
+    desc_in_ = desc_;
+    desc_ = output_desc;
+    last_ = node;
+    return node;
+  }
+
+  ComputeGraphPtr graph_;
+  GeTensorDesc desc_;
+  GeTensorDesc desc_in_;
+  NodePtr last_;
+};
+
+int64_t GetElementNum(const GeTensorDesc &desc) {
+  int64_t num = 1;
+  for (auto dim : desc.GetShape().GetDims()) {
+    num *= dim;
+  }
+  return num;
+}
+
+///
+/// Runs the trans ops from the data node to the netoutput on the host.
+///
+vector<uint8_t> RunOnHost(const ComputeGraphPtr &graph, const vector<uint8_t> &input) {
+  vector<uint8_t> data = input;
+  auto node = graph->FindNode("data1");
+  while (node->GetType() != NETOUTPUT) {
+    node = node->GetOutDataNodes().at(0);
+    if (node->GetType() == NETOUTPUT) {
+      break;
+    }
+    auto input_desc = node->GetOpDesc()->GetInputDesc(0);
+    auto output_desc = node->GetOpDesc()->GetOutputDesc(0);
+    formats::TransResult result;
+    if (node->GetType() == CAST) {
+      formats::CastArgs args = {data.data(), static_cast<size_t>(GetElementNum(input_desc)),
+                                input_desc.GetDataType(), output_desc.GetDataType()};
+      EXPECT_EQ(formats::TransDataType(args, result), SUCCESS);
+    } else if (node->GetType() == TRANSDATA) {
+      formats::TransArgs args = {data.data(), input_desc.GetFormat(), output_desc.GetFormat(),
+                                 input_desc.GetShape().GetDims(), output_desc.GetShape().GetDims(),
+                                 input_desc.GetDataType()};
+      EXPECT_EQ(formats::TransFormat(args, result), SUCCESS);
+    } else {
+      vector<int64_t> perm;
+      EXPECT_TRUE(AttrUtils::GetListInt(node->GetOpDesc(), "perm", perm));
+      EXPECT_EQ(formats::Transpose(data.data(), input_desc.GetShape().GetDims(), input_desc.GetDataType(), perm,
+                                   result),
+                SUCCESS);
+    }
+    if (result.data == nullptr) {
+      return {};
+    }
+    data.assign(result.data.get(), result.data.get() + result.length);
+  }
+  return data;
+}
+
+vector<uint8_t> MakeRandomInput(DataType data_type, int64_t num, uint32_t seed) {
+  mt19937 gen(seed);
+  uniform_real_distribution<float> dis(-10.0f, 10.0f);
+  vector<float> values;
+  for (int64_t i = 0; i < num; ++i) {
+    values.emplace_back(dis(gen));
+  }
+  auto begin = reinterpret_cast<uint8_t *>(values.data());
+  vector<uint8_t> data(begin, begin + values.size() * sizeof(float));
+  if (data_type == DT_FLOAT) {
+    return data;
+  }
+  formats::TransResult result;
+  formats::CastArgs args = {data.data(), static_cast<size_t>(num), DT_FLOAT, data_type};
+  EXPECT_EQ(formats::TransDataType(args, result), SUCCESS);
+  return vector<uint8_t>(result.data.get(), result.data.get() + result.length);
+}
+}  // namespace
+
+class UtestGraphPassesTransOpChainCanonicalizePass : public Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+
+  ///
+  /// Builds the chain twice, runs the pass on one of them and compares the outputs of both on random inputs.
+  ///
+  static ComputeGraphPtr CheckEquivalence(const function<ComputeGraphPtr()> &build_graph) {
+    auto origin_graph = build_graph();
+    auto graph = build_graph();
+    TransOpChainCanonicalizePass pass;
+    EXPECT_EQ(pass.Run(graph), SUCCESS);
+    EXPECT_EQ(graph->TopologicalSorting(), GRAPH_SUCCESS);
+
+    auto data_desc = graph->FindNode("data1")->GetOpDesc()->GetOutputDesc(0);
+    auto output_desc = origin_graph->FindNode("netoutput")->GetOpDesc()->GetInputDesc(0);
+    auto new_output_desc = graph->FindNode("netoutput")->GetInDataNodes().at(0)->GetOpDesc()->GetOutputDesc(0);
+    EXPECT_EQ(new_output_desc.GetFormat(), output_desc.GetFormat());
+    EXPECT_EQ(new_output_desc.GetDataType(), output_desc.GetDataType());
+    EXPECT_EQ(new_output_desc.GetShape().GetDims(), output_desc.GetShape().GetDims());
+    for (uint32_t seed = 1; seed <= 3; ++seed) {
+      auto input = MakeRandomInput(data_desc.GetDataType(), GetElementNum(data_desc), seed);
+      auto expect = RunOnHost(origin_graph, input);
+      auto actual = RunOnHost(graph, input);
+      EXPECT_FALSE(expect.empty());
+      EXPECT_EQ(expect.size(), actual.size());
+      EXPECT_TRUE(expect == actual);
+    }
+    return graph;
+  }
+};
+
+///
+/// data1(fp32, NCHW) -> cast1(fp16) -> transdata1(NC1HWC0) -> transdata2(NCHW) -> transpose1(NHWC)
+///                   -> cast2(fp32) -> netoutput
+/// the transdata pair cancels, while the fp16 rounding is kept
+///
+TEST_F(UtestGraphPassesTransOpChainCanonicalizePass, transdata_round_trip_with_lossy_cast) {
+  auto graph = CheckEquivalence([]() {
+    ChainBuilder builder(FORMAT_NCHW, DT_FLOAT, {2, 3, 4, 5});
+    builder.AddCast("cast1", DT_FLOAT16);
+    builder.AddTransData("transdata1", FORMAT_NC1HWC0, {2, 1, 4, 5, 16});
+    builder.AddTransData("transdata2", FORMAT_NCHW, {2, 3, 4, 5});
+    builder.AddTranspose("transpose1", {0, 2, 3, 1}, FORMAT_NHWC);
+    builder.AddCast("cast2", DT_FLOAT);
+    return builder.Build();
+  });
+  EXPECT_EQ(graph->GetDirectNodesSize(), 5);
+  EXPECT_EQ(graph->FindNode("transdata1"), nullptr);
+  EXPECT_EQ(graph->FindNode("transdata2"), nullptr);
+  auto transpose = graph->FindNode("transpose1");
+  ASSERT_NE(transpose, nullptr);
+  // the transpose moves the fp16 data between the casts
+  EXPECT_EQ(transpose->GetOpDesc()->GetInputDesc(0).GetDataType(), DT_FLOAT16);
+  EXPECT_EQ(transpose->GetInDataNodes().at(0)->GetName(), "cast1");
+  EXPECT_EQ(transpose->GetOutDataNodes().at(0)->GetName(), "cast2");
+}
+
+TEST_F(UtestGraphPassesTransOpChainCanonicalizePass, lossless_round_trip_removed) {
+  auto graph = CheckEquivalence([]() {
+    ChainBuilder builder(FORMAT_NCHW, DT_FLOAT16, {2, 3, 4, 5});
+    builder.AddCast("cast1", DT_FLOAT);
+    builder.AddTransData("transdata1", FORMAT_NC1HWC0, {2, 1, 4, 5, 16});
+    builder.AddTransData("transdata2", FORMAT_NCHW, {2, 3, 4, 5});
+    builder.AddCast("cast2", DT_FLOAT16);
+    return builder.Build();
+  });
+  EXPECT_EQ(graph->GetDirectNodesSize(), 2);
+  EXPECT_EQ(graph->FindNode("netoutput")->GetInDataNodes().at(0)->GetName(), "data1");
+}
+
+TEST_F(UtestGraphPassesTransOpChainCanonicalizePass, transposes_composed) {
+  auto graph = CheckEquivalence([]() {
+    ChainBuilder builder(FORMAT_NCHW, DT_FLOAT16, {2, 3, 4, 5});
+    builder.AddCast("cast1", DT_FLOAT);
+    builder.AddTranspose("transpose1", {0, 2, 3, 1}, FORMAT_NHWC);
+    builder.AddTranspose("transpose2", {1, 3, 0, 2}, FORMAT_NCHW);
+    builder.AddCast("cast2", DT_FLOAT16);
+    return builder.Build();
+  });
+  EXPECT_EQ(graph->GetDirectNodesSize(), 3);
+  auto transpose = graph->FindNode("transpose1");
+  ASSERT_NE(transpose, nullptr);
+  vector<int64_t> perm;
+  EXPECT_TRUE(AttrUtils::GetListInt(transpose->GetOpDesc(), "perm", perm));
+  EXPECT_EQ(perm, vector<int64_t>({2, 1, 0, 3}));
+  EXPECT_EQ(transpose->GetOpDesc()->GetOutputDesc(0).GetDataType(), DT_FLOAT16);
+}
+
+TEST_F(UtestGraphPassesTransOpChainCanonicalizePass, inverse_transposes_removed) {
+  auto graph = CheckEquivalence([]() {
+    ChainBuilder builder(FORMAT_NCHW, DT_FLOAT, {2, 3, 4, 5});
+    builder.AddTranspose("transpose1", {0, 2, 3, 1}, FORMAT_NHWC);
+    builder.AddTranspose("transpose2", {0, 3, 1, 2}, FORMAT_NCHW);
+    return builder.Build();
+  });
+  EXPECT_EQ(graph->GetDirectNodesSize(), 2);
+}
+
+TEST_F(UtestGraphPassesTransOpChainCanonicalizePass, minimal_chains_unchanged) {
+  ChainBuilder builder(FORMAT_NCHW, DT_FLOAT, {2, 3, 4, 5});
+  builder.AddCast("cast1", DT_FLOAT16);
+  builder.AddCast("cast2", DT_FLOAT);
+  auto graph = builder.Build();
+  TransOpChainCanonicalizePass pass;
+  EXPECT_EQ(pass.Run(graph), SUCCESS);
+  EXPECT_EQ(graph->GetDirectNodesSize(), 4);
+
+  // the output of transdata1 has two consumers, the chain stops there
+  ChainBuilder branch_builder(FORMAT_NCHW, DT_FLOAT, {2, 3, 4, 5});
+  branch_builder.AddTransData("transdata1", FORMAT_NC1HWC0, {2, 1, 4, 5, 16});
+  auto branch_graph = branch_builder.Build(2);
+  EXPECT_EQ(pass.Run(branch_graph), SUCCESS);
+  EXPECT_EQ(branch_graph->GetDirectNodesSize(), 3);
+}
+
+TEST_F(UtestGraphPassesTransOpChainCanonicalizePass, minimize_casts) {
+  using Types = vector<DataType>;
+  EXPECT_EQ(TransOpChainCanonicalizePass::MinimizeCasts({DT_FLOAT, DT_FLOAT16, DT_FLOAT}),
+            Types({DT_FLOAT, DT_FLOAT16, DT_FLOAT}));
+  EXPECT_EQ(TransOpChainCanonicalizePass::MinimizeCasts({DT_FLOAT16, DT_FLOAT, DT_FLOAT16}), Types({DT_FLOAT16}));
+  EXPECT_EQ(TransOpChainCanonicalizePass::MinimizeCasts({DT_INT8, DT_INT32, DT_FLOAT, DT_FLOAT16}),
+            Types({DT_INT8, DT_FLOAT16}));
+  EXPECT_EQ(TransOpChainCanonicalizePass::MinimizeCasts({DT_INT32, DT_FLOAT, DT_INT32}),
+            Types({DT_INT32, DT_FLOAT, DT_INT32}));
+  // float -> int8 may saturate where int16 -> int8 wraps, the float step is kept
+  EXPECT_EQ(TransOpChainCanonicalizePass::MinimizeCasts({DT_INT16, DT_FLOAT, DT_INT8}),
+            Types({DT_INT16, DT_FLOAT, DT_INT8}));
+  EXPECT_EQ(TransOpChainCanonicalizePass::MinimizeCasts({DT_FLOAT16, DT_FLOAT, DT_INT32}),
+            Types({DT_FLOAT16, DT_FLOAT, DT_INT32}));
+  // to a wider type or back to the source type the value is kept either way
+  EXPECT_EQ(TransOpChainCanonicalizePass::MinimizeCasts({DT_INT8, DT_INT16, DT_INT32}), Types({DT_INT8, DT_INT32}));
+  EXPECT_EQ(TransOpChainCanonicalizePass::MinimizeCasts({DT_INT8, DT_INT32, DT_INT8}), Types({DT_INT8}));
+}
+}  // namespace ge
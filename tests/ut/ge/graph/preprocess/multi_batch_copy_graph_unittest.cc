@@ -0,0 +1,397 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "framework/common/types.h"
+#include "ge/ge_api_types.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/detail/model_serialize_imp.h"
+#include "graph/ge_local_context.h"
+#include "proto/ge_ir.pb.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/tensor_utils.h"
+
+#define protected public
+#define private public
+#include "graph/build/memory/binary_block_mem_assigner.h"
+#include "graph/passes/multi_batch_pass.h"
+#include "graph/passes/switch_op_pass.h"
+#include "graph/preprocess/multi_batch_copy_graph.h"
+#undef private
+#undef protected
+
+using namespace std;
+
+namespace ge {
+namespace {
+const size_t kGearNum = 8;
+const size_t kBenchmarkGearNum = 16;
+const size_t kBenchmarkLayerNum = 200;
+const uint32_t kFeatureMapSize = 64 * 1024;
+const uint32_t kWeightSize = 256 * 1024;
+}  // namespace
+
+class UtestMultiBatchCopyGraph : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+
+  static NodePtr AddNode(const ComputeGraphPtr &graph, const string &name, const string &type, int in_num,
+                         int out_num, uint32_t out_size = kFeatureMapSize) {
+    auto op_desc = make_shared<OpDesc>(name, type);
+    GeTensorDesc tensor_desc(GeShape(vector<int64_t>{-1, 16, 32, 32}), FORMAT_NCHW, DT_FLOAT);
+    TensorUtils::SetSize(tensor_desc, out_size);
+    for (int i = 0; i < in_num; ++i) {
+      op_desc->AddInputDesc(tensor_desc);
+    }
+    for (int i = 0; i < out_num; ++i) {
+      op_desc->AddOutputDesc(tensor_desc);
+    }
+    return graph->AddNode(op_desc);
+  }
+
+  static NodePtr AddConst(const ComputeGraphPtr &graph, const string &name) {
+    auto node = AddNode(graph, name, CONSTANT, 0, 1, kWeightSize);
+    GeTensor weight(node->GetOpDesc()->GetOutputDesc(0), vector<uint8_t>(kWeightSize, 1));
+    EXPECT_TRUE(AttrUtils::SetTensor(node->GetOpDesc(), ATTR_NAME_WEIGHTS, weight));
+    return node;
+  }
+
+  static void AddEdge(const NodePtr &src, int src_index, const NodePtr &dst, int dst_index) {
+    EXPECT_EQ(GraphUtils::AddEdge(src->GetOutDataAnchor(src_index), dst->GetInDataAnchor(dst_index)), GRAPH_SUCCESS);
+  }
+
+  // data -> conv1(w1) -> relu -> conv2(w2) -> net_output, the relu also updates a variable read by the output
+  static ComputeGraphPtr CreateGraph() {
+    auto graph = make_shared<ComputeGraph>("multi_batch_graph");
+    auto data = AddNode(graph, "data", DATA, 1, 1);
+    auto w1 = AddConst(graph, "w1");
+    auto conv1 = AddNode(graph, "conv1", CONVOLUTION, 2, 1);
+    auto relu = AddNode(graph, "relu", RELU, 1, 1);
+    auto w2 = AddConst(graph, "w2");
+    auto conv2 = AddNode(graph, "conv2", CONVOLUTION, 2, 1);
+    auto var = AddNode(graph, "var", VARIABLE, 1, 1, kWeightSize);
+    auto net_output = AddNode(graph, "net_output", NETOUTPUT, 2, 0);
+    AddEdge(data, 0, conv1, 0);
+    AddEdge(w1, 0, conv1, 1);
+    AddEdge(conv1, 0, relu, 0);
+    AddEdge(relu, 0, conv2, 0);
+    AddEdge(w2, 0, conv2, 1);
+    AddEdge(relu, 0, var, 0);
+    AddEdge(conv2, 0, net_output, 0);
+    AddEdge(var, 0, net_output, 1);
+    graph->TopologicalSorting();
+    return graph;
+  }
+
+  /// data -> (conv(w) -> relu) * layer_num -> net_output, with a control edge between the layers. The data and the
+  /// weights of the odd layers also have control edges into the branch, which are shared by all batches
+  static ComputeGraphPtr CreateDeepGraph(size_t layer_num) {
+    auto graph = make_shared<ComputeGraph>("deep_graph");
+    auto data = AddNode(graph, "data", DATA, 1, 1);
+    auto prev = data;
+    NodePtr prev_relu;
+    for (size_t i = 0; i < layer_num; ++i) {
+      auto weight = AddConst(graph, "w" + to_string(i));
+      auto conv = AddNode(graph, "conv" + to_string(i), CONVOLUTION, 2, 1);
+      (void)AttrUtils::SetListInt(conv->GetOpDesc(), "strides", vector<int64_t>{1, 1, 1, 1});
+      auto relu = AddNode(graph, "relu" + to_string(i), RELU, 1, 1);
+      AddEdge(prev, 0, conv, 0);
+      AddEdge(weight, 0, conv, 1);
+      AddEdge(conv, 0, relu, 0);
+      if (prev_relu != nullptr) {
+        EXPECT_EQ(GraphUtils::AddEdge(prev_relu->GetOutControlAnchor(), relu->GetInControlAnchor()), GRAPH_SUCCESS);
+      }
+      if (i % 2 == 1) {
+        EXPECT_EQ(GraphUtils::AddEdge(weight->GetOutControlAnchor(), relu->GetInControlAnchor()), GRAPH_SUCCESS);
+        EXPECT_EQ(GraphUtils::AddEdge(data->GetOutControlAnchor(), conv->GetInControlAnchor()), GRAPH_SUCCESS);
+      }
+      prev = relu;
+      prev_relu = relu;
+    }
+    auto net_output = AddNode(graph, "net_output", NETOUTPUT, 1, 0);
+    AddEdge(prev, 0, net_output, 0);
+    graph->TopologicalSorting();
+    return graph;
+  }
+
+  static void AddControlEdge(const NodePtr &src, const NodePtr &dst) {
+    EXPECT_EQ(GraphUtils::AddEdge(src->GetOutControlAnchor(), dst->GetInControlAnchor()), GRAPH_SUCCESS);
+  }
+
+  /// data -> a -> b -> c -> d -> net_output, and a -> s. The control edges of b come from a and the weight shared by
+  /// the batches, the one of c from a only. s has no data output, so its merge is linked through a const, and s
+  /// controls d and the net_output
+  static ComputeGraphPtr CreateControlGraph() {
+    auto graph = make_shared<ComputeGraph>("control_graph");
+    auto data = AddNode(graph, "data", DATA, 1, 1);
+    auto weight = AddConst(graph, "w");
+    auto a = AddNode(graph, "a", RELU, 1, 1);
+    auto b = AddNode(graph, "b", RELU, 1, 1);
+    auto c = AddNode(graph, "c", RELU, 1, 1);
+    auto s = AddNode(graph, "s", NOOP, 1, 0);
+    auto d = AddNode(graph, "d", RELU, 1, 1);
+    auto net_output = AddNode(graph, "net_output", NETOUTPUT, 1, 0);
+    AddEdge(data, 0, a, 0);
+    AddEdge(a, 0, b, 0);
+    AddEdge(b, 0, c, 0);
+    AddEdge(a, 0, s, 0);
+    AddEdge(c, 0, d, 0);
+    AddEdge(d, 0, net_output, 0);
+    AddControlEdge(a, b);
+    AddControlEdge(weight, b);
+    AddControlEdge(a, c);
+    AddControlEdge(s, d);
+    AddControlEdge(s, net_output);
+    graph->TopologicalSorting();
+    return graph;
+  }
+
+  static Status CopyGraph(ComputeGraphPtr graph, size_t gear_num, bool parallel_copy, bool share_weights = false) {
+    multibatch::MultiBatchGraphCopyer copyer(graph);
+    for (size_t i = 0; i < gear_num; ++i) {
+      copyer.AddShape({static_cast<int64_t>(i + 1)});
+    }
+    copyer.SetParallelCopy(parallel_copy);
+    copyer.SetShareWeights(share_weights);
+    return copyer.CopyGraph();
+  }
+
+  // the passes of the graph manager which turn the merges and SwitchN into stream ops and label the batch branches
+  static ComputeGraphPtr CopyAndLabelGraph(bool share_weights) {
+    auto graph = CreateGraph();
+    EXPECT_EQ(CopyGraph(graph, kGearNum, false, share_weights), SUCCESS);
+    EXPECT_EQ(graph->TopologicalSorting(), GRAPH_SUCCESS);
+    SwitchOpPass switch_op_pass;
+    EXPECT_EQ(switch_op_pass.Run(graph), SUCCESS);
+    MultiBatchPass multi_batch_pass;
+    EXPECT_EQ(multi_batch_pass.Run(graph), SUCCESS);
+    EXPECT_EQ(graph->TopologicalSorting(), GRAPH_SUCCESS);
+    return graph;
+  }
+
+  // attrs are kept in proto maps, which are written in hash order unless the output is deterministic
+  static string SerializeGraph(const ComputeGraphPtr &graph) {
+    proto::GraphDef graph_def;
+    EXPECT_TRUE(ModelSerializeImp().SerializeGraph(graph, &graph_def));
+    string buffer;
+    {
+      google::protobuf::io::StringOutputStream string_stream(&buffer);
+      google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+      coded_stream.SetSerializationDeterministic(true);
+      EXPECT_TRUE(graph_def.SerializeToCodedStream(&coded_stream));
+    }
+    return buffer;
+  }
+
+  // the graph proto keeps the peers of the in anchors only, the order on the out anchors is compared here
+  static string GetOutPeers(const ComputeGraphPtr &graph) {
+    string out_peers;
+    for (const auto &node : graph->GetDirectNode()) {
+      out_peers += node->GetName() + ":";
+      for (const auto &out_anchor : node->GetAllOutDataAnchors()) {
+        for (const auto &peer_anchor : out_anchor->GetPeerInDataAnchors()) {
+          out_peers += " " + peer_anchor->GetOwnerNode()->GetName() + "(" + to_string(peer_anchor->GetIdx()) + ")";
+        }
+      }
+      for (const auto &peer_node : node->GetOutControlNodes()) {
+        out_peers += " " + peer_node->GetName() + "(-1)";
+      }
+      out_peers += "\n";
+    }
+    return out_peers;
+  }
+
+  static size_t CountNodes(const ComputeGraphPtr &graph, const string &type) {
+    size_t count = 0;
+    for (const auto &node : graph->GetDirectNode()) {
+      count += (node->GetType() == type) ? 1 : 0;
+    }
+    return count;
+  }
+
+  static uint32_t GetWeightBytes(const ComputeGraphPtr &graph) {
+    uint32_t weight_bytes = 0;
+    for (const auto &node : graph->GetDirectNode()) {
+      if ((node->GetType() != CONSTANT) && (node->GetType() != VARIABLE)) {
+        continue;
+      }
+      uint32_t size = 0;
+      (void)TensorUtils::GetSize(node->GetOpDesc()->GetOutputDesc(0), size);
+      weight_bytes += size;
+    }
+    return weight_bytes;
+  }
+
+  // feature map of the nodes inserted by the passes, like the merge outputs, gets the size of one feature map
+  static size_t GetPlannedMemory(const ComputeGraphPtr &graph) {
+    for (const auto &node : graph->GetDirectNode()) {
+      auto op_desc = node->GetOpDesc();
+      op_desc->SetStreamId(0);
+      for (size_t i = 0; i < op_desc->GetOutputsSize(); ++i) {
+        auto output_desc = op_desc->MutableOutputDesc(i);
+        uint32_t size = 0;
+        if ((TensorUtils::GetSize(*output_desc, size) != GRAPH_SUCCESS) || (size == 0)) {
+          TensorUtils::SetSize(*output_desc, kFeatureMapSize);
+        }
+      }
+    }
+    BinaryBlockMemAssigner mem_assigner(graph);
+    EXPECT_EQ(mem_assigner.Assign(), SUCCESS);
+    return mem_assigner.GetMemOffset();
+  }
+};
+
+TEST_F(UtestMultiBatchCopyGraph, weights_copied_8_gears) {
+  auto origin_graph = CreateGraph();
+  auto copyed_graph = CreateGraph();
+  ASSERT_EQ(CopyGraph(copyed_graph, kGearNum, false), SUCCESS);
+  EXPECT_EQ(copyed_graph->TopologicalSorting(), GRAPH_SUCCESS);
+
+  // conv1, relu and conv2 are copied for each gear, so is the variable written by relu, w1 and w2 are linked
+  EXPECT_EQ(CountNodes(copyed_graph, CONVOLUTION), 2 * kGearNum);
+  EXPECT_EQ(CountNodes(copyed_graph, RELU), kGearNum);
+  EXPECT_EQ(CountNodes(copyed_graph, VARIABLE), kGearNum);
+  EXPECT_EQ(CountNodes(copyed_graph, CONSTANT), CountNodes(origin_graph, CONSTANT));
+  EXPECT_EQ(GetWeightBytes(copyed_graph), GetWeightBytes(origin_graph) + (kGearNum - 1) * kWeightSize);
+  for (const auto &name : {"w1", "w2"}) {
+    auto weight = copyed_graph->FindNode(name);
+    ASSERT_NE(weight, nullptr);
+    EXPECT_EQ(weight->GetOutDataNodes().size(), kGearNum);
+  }
+
+  // the batch label is attached by MultiBatchPass later, not by the copyer
+  for (const auto &node : copyed_graph->GetDirectNode()) {
+    EXPECT_FALSE(node->GetOpDesc()->HasAttr(ATTR_NAME_BATCH_LABEL));
+  }
+}
+
+TEST_F(UtestMultiBatchCopyGraph, weights_shared_8_gears) {
+  auto origin_graph = CreateGraph();
+  auto copyed_graph = CopyAndLabelGraph(false);
+  auto shared_graph = CopyAndLabelGraph(true);
+
+  // the variable is kept out of the branches, the relu of each gear updates it through a merge
+  EXPECT_EQ(CountNodes(shared_graph, CONVOLUTION), 2 * kGearNum);
+  EXPECT_EQ(CountNodes(shared_graph, VARIABLE), 1);
+  EXPECT_LT(shared_graph->GetDirectNodesSize(), copyed_graph->GetDirectNodesSize());
+  EXPECT_EQ(GetWeightBytes(shared_graph), GetWeightBytes(origin_graph));
+  EXPECT_EQ(GetWeightBytes(copyed_graph) - GetWeightBytes(shared_graph), (kGearNum - 1) * kWeightSize);
+
+  size_t copyed_memory = GetPlannedMemory(copyed_graph);
+  GEThreadLocalContext saved_context = GetThreadLocalContext();
+  GetThreadLocalContext().SetSessionOption({{MULTI_BATCH_SHARE_WEIGHTS, "1"}});
+  size_t shared_memory = GetPlannedMemory(shared_graph);
+  GetThreadLocalContext() = saved_context;
+  EXPECT_LT(shared_memory, copyed_memory);
+
+  // only one gear runs, the outputs of the gears are planned on the same memory
+  for (const auto &name : {"conv1", "relu", "conv2"}) {
+    set<int64_t> offsets;
+    for (size_t i = 0; i < kGearNum; ++i) {
+      auto node = shared_graph->FindNode(string(name) + "_huawei_mbatch_batch_" + to_string(i));
+      ASSERT_NE(node, nullptr);
+      auto output_offsets = node->GetOpDesc()->GetOutputOffset();
+      ASSERT_EQ(output_offsets.size(), 1);
+      offsets.insert(output_offsets[0]);
+    }
+    EXPECT_EQ(offsets.size(), 1) << name;
+  }
+}
+
+TEST_F(UtestMultiBatchCopyGraph, parallel_copy_same_as_serial) {
+  {
+    auto graph = CreateGraph();
+    multibatch::MultiBatchGraphCopyer copyer(graph);
+    EXPECT_FALSE(copyer.parallel_copy_);
+    EXPECT_FALSE(copyer.share_weights_);
+  }
+  for (bool share_weights : {false, true}) {
+    auto serial_graph = CreateGraph();
+    auto parallel_graph = CreateGraph();
+    ASSERT_EQ(CopyGraph(serial_graph, kGearNum, false, share_weights), SUCCESS);
+    ASSERT_EQ(CopyGraph(parallel_graph, kGearNum, true, share_weights), SUCCESS);
+    string serial_buffer = SerializeGraph(serial_graph);
+    EXPECT_FALSE(serial_buffer.empty());
+    EXPECT_EQ(serial_buffer, SerializeGraph(parallel_graph));
+    EXPECT_EQ(GetOutPeers(serial_graph), GetOutPeers(parallel_graph));
+  }
+
+  auto serial_graph = CreateDeepGraph(10);
+  auto parallel_graph = CreateDeepGraph(10);
+  ASSERT_EQ(CopyGraph(serial_graph, kGearNum, false), SUCCESS);
+  ASSERT_EQ(CopyGraph(parallel_graph, kGearNum, true), SUCCESS);
+  EXPECT_EQ(SerializeGraph(serial_graph), SerializeGraph(parallel_graph));
+  EXPECT_EQ(GetOutPeers(serial_graph), GetOutPeers(parallel_graph));
+}
+
+TEST_F(UtestMultiBatchCopyGraph, parallel_copy_keeps_out_peer_order) {
+  auto serial_graph = CreateControlGraph();
+  auto parallel_graph = CreateControlGraph();
+  ASSERT_EQ(CopyGraph(serial_graph, kGearNum, false), SUCCESS);
+  ASSERT_EQ(CopyGraph(parallel_graph, kGearNum, true), SUCCESS);
+  EXPECT_EQ(SerializeGraph(serial_graph), SerializeGraph(parallel_graph));
+  EXPECT_EQ(GetOutPeers(serial_graph), GetOutPeers(parallel_graph));
+
+  // the copy of a controls the copies of b and c in the origin order, though only b is controlled by a shared node
+  auto batch_suffix = "_huawei_mbatch_batch_" + to_string(kGearNum - 1);
+  auto a = parallel_graph->FindNode("a" + batch_suffix);
+  ASSERT_NE(a, nullptr);
+  auto control_nodes = a->GetOutControlNodes();
+  ASSERT_EQ(control_nodes.size(), 2);
+  EXPECT_EQ(control_nodes.at(0)->GetName(), "b" + batch_suffix);
+  EXPECT_EQ(control_nodes.at(1)->GetName(), "c" + batch_suffix);
+
+  // the merge const of s is linked before d
+  auto s = parallel_graph->FindNode("s" + batch_suffix);
+  ASSERT_NE(s, nullptr);
+  control_nodes = s->GetOutControlNodes();
+  ASSERT_EQ(control_nodes.size(), 2);
+  EXPECT_EQ(control_nodes.at(0)->GetName(), "s" + batch_suffix + "_merge_const");
+  EXPECT_EQ(control_nodes.at(1)->GetName(), "d" + batch_suffix);
+}
+
+TEST_F(UtestMultiBatchCopyGraph, parallel_copy_16_gears) {
+  auto serial_graph = CreateDeepGraph(kBenchmarkLayerNum);
+  auto parallel_graph = CreateDeepGraph(kBenchmarkLayerNum);
+  ASSERT_EQ(CopyGraph(serial_graph, kBenchmarkGearNum, false), SUCCESS);
+  ASSERT_EQ(CopyGraph(parallel_graph, kBenchmarkGearNum, true), SUCCESS);
+
+  // data, shape data, SwitchN, the weights, conv and relu for each gear, the merge of the last relu and net_output
+  EXPECT_EQ(parallel_graph->GetDirectNodesSize(), kBenchmarkLayerNum * (2 * kBenchmarkGearNum + 1) + 5);
+  EXPECT_EQ(CountNodes(parallel_graph, CONVOLUTION), kBenchmarkLayerNum * kBenchmarkGearNum);
+  EXPECT_EQ(CountNodes(parallel_graph, RELU), kBenchmarkLayerNum * kBenchmarkGearNum);
+  EXPECT_EQ(SerializeGraph(serial_graph), SerializeGraph(parallel_graph));
+  EXPECT_EQ(GetOutPeers(serial_graph), GetOutPeers(parallel_graph));
+
+  // every copy of an odd relu gets the control edges from its weight and the relu before it, in the origin order
+  auto relu = parallel_graph->FindNode("relu1_huawei_mbatch_batch_" + to_string(kBenchmarkGearNum - 1));
+  ASSERT_NE(relu, nullptr);
+  auto control_nodes = relu->GetInControlNodes();
+  ASSERT_EQ(control_nodes.size(), 2);
+  EXPECT_EQ(control_nodes.at(0)->GetName(), "relu0_huawei_mbatch_batch_" + to_string(kBenchmarkGearNum - 1));
+  EXPECT_EQ(control_nodes.at(1)->GetName(), "w1");
+}
+}  // namespace ge
@@ -0,0 +1,277 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "aicpu/common/aicpu_task_struct.h"
+#include "external/graph/operator.h"
+#include "runtime/rt.h"
+#include "tests/depends/runtime/src/runtime_stub.h"
+
+#define protected public
+#define private public
+#include "single_op/single_op.h"
+#include "single_op/stream_resource.h"
+#undef private
+#undef protected
+
+using namespace std;
+using namespace testing;
+using namespace ge;
+
+namespace {
+const size_t kIoNum = 2;
+}  // namespace
+
+class UtestDynamicSingleOp : public testing::Test {
+ protected:
+  void SetUp() { ResetRuntimeStubCounters(); }
+
+  void TearDown() {}
+
+  // output dim 0 is twice of the input one, like an op whose output shape depends on the data
+  static OpDescPtr CreateOpDesc() {
+    auto op_desc = make_shared<OpDesc>("dynamic_op", "DynamicStub");
+    GeTensorDesc desc(GeShape(vector<int64_t>{1}));
+    op_desc->AddInputDesc("x", desc);
+    op_desc->AddOutputDesc("y", desc);
+    op_desc->AddInferFunc([](Operator &op) {
+      TensorDesc tensor_desc = op.GetInputDesc(0);
+      vector<int64_t> dims = tensor_desc.GetShape().GetDims();
+      dims[0] *= 2;
+      tensor_desc.SetShape(Shape(dims));
+      return op.UpdateOutputDesc("y", tensor_desc);
+    });
+    return op_desc;
+  }
+
+  static void InitOp(DynamicSingleOp &single_op) {
+    single_op.op_desc_ = CreateOpDesc();
+    single_op.num_inputs_ = 1;
+    single_op.num_outputs_ = 1;
+  }
+
+  static TbeOpTask *AddTbeTask(DynamicSingleOp &single_op, const vector<int64_t> &shape) {
+    auto *task = new TbeOpTask();
+    void *args = nullptr;
+    size_t arg_size = kIoNum * sizeof(void *);
+    EXPECT_EQ(rtMallocHost(&args, arg_size), RT_ERROR_NONE);
+    task->SetKernelArgs(args, arg_size, 1);
+    task->SetStubFunc("dynamic_stub", nullptr);
+    vector<GeTensorDesc> desc{GeTensorDesc(GeShape(shape))};
+    single_op.tbe_tasks_[DynamicSingleOp::GetShapeKey(desc)].reset(task);
+    return task;
+  }
+
+  static AiCpuTask *AddAiCpuTask(DynamicSingleOp &single_op, const vector<int64_t> &shape) {
+    auto *task = new AiCpuTask();
+    string args(sizeof(aicpu::AicpuParamHead) + kIoNum * sizeof(uint64_t) + 16, '\0');
+    EXPECT_EQ(task->Init("libcpu_kernels.so", "RunCpuKernel", args), SUCCESS);
+    single_op.aicpu_task_.reset(task);
+    vector<GeTensorDesc> desc{GeTensorDesc(GeShape(shape))};
+    single_op.aicpu_shape_key_ = DynamicSingleOp::GetShapeKey(desc);
+    return task;
+  }
+
+  static vector<GeTensorDesc> InputDesc(int64_t dim) { return {GeTensorDesc(GeShape(vector<int64_t>{dim}))}; }
+
+  uint8_t input_data_[1024] = {0};
+};
+
+TEST_F(UtestDynamicSingleOp, test_shape_key) {
+  vector<GeTensorDesc> desc{GeTensorDesc(GeShape(vector<int64_t>{3, 5})), GeTensorDesc(GeShape(vector<int64_t>{16}))};
+  ASSERT_EQ(DynamicSingleOp::GetShapeKey(desc), "3,5;16");
+  ASSERT_EQ(DynamicSingleOp::GetShapeKey(InputDesc(1)), "1");
+  ASSERT_NE(DynamicSingleOp::GetShapeKey(InputDesc(5)), DynamicSingleOp::GetShapeKey(InputDesc(8)));
+}
+
+TEST_F(UtestDynamicSingleOp, test_launch_tbe_kernel_of_shape) {
+  DynamicSingleOp single_op;
+  InitOp(single_op);
+  TbeOpTask *tbe_task = AddTbeTask(single_op, {8});
+  AddAiCpuTask(single_op, {8});
+
+  vector<DataBuffer> inputs{DataBuffer(input_data_, sizeof(input_data_), false)};
+  vector<GeTensorDesc> output_desc;
+  vector<DataBuffer> outputs;
+  ASSERT_EQ(single_op.ExecuteAsync(InputDesc(8), inputs, output_desc, outputs), SUCCESS);
+
+  ASSERT_EQ(output_desc.size(), 1);
+  ASSERT_EQ(output_desc[0].GetShape().GetDims(), vector<int64_t>{16});
+  ASSERT_EQ(outputs.size(), 1);
+  ASSERT_NE(outputs[0].data, nullptr);
+  ASSERT_GE(outputs[0].length, 16 * sizeof(float));
+  ASSERT_EQ(GetRuntimeStubCounters().kernel_launch_count, 1);
+  ASSERT_EQ(GetRuntimeStubCounters().cpu_kernel_launch_count, 0);
+
+  auto *args = reinterpret_cast<const uintptr_t *>(tbe_task->GetArgs());
+  ASSERT_EQ(args[0], reinterpret_cast<uintptr_t>(input_data_));
+  ASSERT_EQ(args[1], reinterpret_cast<uintptr_t>(outputs[0].data));
+}
+
+TEST_F(UtestDynamicSingleOp, test_static_tbe_kernel_not_reused_for_other_shape) {
+  DynamicSingleOp single_op;
+  InitOp(single_op);
+  AddTbeTask(single_op, {8});
+  AddAiCpuTask(single_op, {5});
+
+  // a smaller shape would have been in the same power of two bucket, the static kernel must not serve it
+  vector<DataBuffer> inputs{DataBuffer(input_data_, sizeof(input_data_), false)};
+  vector<GeTensorDesc> output_desc;
+  vector<DataBuffer> outputs;
+  ASSERT_EQ(single_op.ExecuteAsync(InputDesc(5), inputs, output_desc, outputs), SUCCESS);
+  ASSERT_EQ(output_desc[0].GetShape().GetDims(), vector<int64_t>{10});
+  ASSERT_EQ(GetRuntimeStubCounters().kernel_launch_count, 0);
+  ASSERT_EQ(GetRuntimeStubCounters().cpu_kernel_launch_count, 1);
+}
+
+TEST_F(UtestDynamicSingleOp, test_fall_back_to_aicpu) {
+  DynamicSingleOp single_op;
+  InitOp(single_op);
+  AddTbeTask(single_op, {8});
+  AddAiCpuTask(single_op, {100});
+
+  vector<DataBuffer> inputs{DataBuffer(input_data_, sizeof(input_data_), false)};
+  vector<GeTensorDesc> output_desc;
+  vector<DataBuffer> outputs;
+  ASSERT_EQ(single_op.ExecuteAsync(InputDesc(100), inputs, output_desc, outputs), SUCCESS);
+  ASSERT_EQ(output_desc[0].GetShape().GetDims(), vector<int64_t>{200});
+  ASSERT_EQ(GetRuntimeStubCounters().kernel_launch_count, 0);
+  ASSERT_EQ(GetRuntimeStubCounters().cpu_kernel_launch_count, 1);
+
+  // the op def in the aicpu args holds the shape it is built for, it can not serve another one
+  outputs.clear();
+  ASSERT_EQ(single_op.ExecuteAsync(InputDesc(50), inputs, output_desc, outputs), UNSUPPORTED);
+  ASSERT_EQ(GetRuntimeStubCounters().kernel_launch_count, 0);
+  ASSERT_EQ(GetRuntimeStubCounters().cpu_kernel_launch_count, 1);
+}
+
+TEST_F(UtestDynamicSingleOp, test_varying_output_shapes) {
+  DynamicSingleOp single_op;
+  InitOp(single_op);
+  AddTbeTask(single_op, {64});
+  AddTbeTask(single_op, {4});
+  AddTbeTask(single_op, {200});
+
+  vector<DataBuffer> inputs{DataBuffer(input_data_, sizeof(input_data_), false)};
+  vector<GeTensorDesc> output_desc;
+  vector<DataBuffer> outputs;
+  ASSERT_EQ(single_op.ExecuteAsync(InputDesc(64), inputs, output_desc, outputs), SUCCESS);
+  void *first_output = outputs[0].data;
+
+  // smaller output reuses the buffer of the op
+  outputs.clear();
+  ASSERT_EQ(single_op.ExecuteAsync(InputDesc(4), inputs, output_desc, outputs), SUCCESS);
+  ASSERT_EQ(output_desc[0].GetShape().GetDims(), vector<int64_t>{8});
+  ASSERT_EQ(outputs[0].data, first_output);
+
+  // bigger output needs a new buffer
+  outputs.clear();
+  ASSERT_EQ(single_op.ExecuteAsync(InputDesc(200), inputs, output_desc, outputs), SUCCESS);
+  ASSERT_EQ(output_desc[0].GetShape().GetDims(), vector<int64_t>{400});
+  ASSERT_GE(outputs[0].length, 400 * sizeof(float));
+  ASSERT_EQ(GetRuntimeStubCounters().kernel_launch_count, 3);
+}
+
+TEST_F(UtestDynamicSingleOp, test_use_given_output) {
+  DynamicSingleOp single_op;
+  InitOp(single_op);
+  AddAiCpuTask(single_op, {16});
+
+  uint8_t output_data[1024] = {0};
+  vector<DataBuffer> inputs{DataBuffer(input_data_, sizeof(input_data_), false)};
+  vector<DataBuffer> outputs{DataBuffer(output_data, sizeof(output_data), false)};
+  vector<GeTensorDesc> output_desc;
+  ASSERT_EQ(single_op.ExecuteAsync(InputDesc(16), inputs, output_desc, outputs), SUCCESS);
+  ASSERT_EQ(outputs[0].data, output_data);
+  ASSERT_TRUE(single_op.output_buffers_[0] == nullptr);
+}
+
+TEST_F(UtestDynamicSingleOp, test_given_output_too_small) {
+  DynamicSingleOp single_op;
+  InitOp(single_op);
+  AddAiCpuTask(single_op, {32});
+
+  // output of 64 floats does not fit in 128 bytes, the buffer of the caller is kept and nothing is launched
+  uint8_t output_data[128] = {0};
+  vector<DataBuffer> inputs{DataBuffer(input_data_, sizeof(input_data_), false)};
+  vector<DataBuffer> outputs{DataBuffer(output_data, sizeof(output_data), false)};
+  vector<GeTensorDesc> output_desc;
+  ASSERT_EQ(single_op.ExecuteAsync(InputDesc(32), inputs, output_desc, outputs), PARAM_INVALID);
+  ASSERT_EQ(outputs[0].data, output_data);
+  ASSERT_EQ(outputs[0].length, sizeof(output_data));
+  ASSERT_EQ(GetRuntimeStubCounters().cpu_kernel_launch_count, 0);
+
+  // the number of given outputs must match the op
+  vector<DataBuffer> two_outputs(2, DataBuffer(output_data, sizeof(output_data), false));
+  ASSERT_EQ(single_op.ExecuteAsync(InputDesc(32), inputs, output_desc, two_outputs), PARAM_INVALID);
+}
+
+TEST_F(UtestDynamicSingleOp, test_aicpu_args_rewrite_waits_for_launch) {
+  DynamicSingleOp single_op;
+  InitOp(single_op);
+  AiCpuTask *aicpu_task = AddAiCpuTask(single_op, {4});
+
+  vector<DataBuffer> inputs{DataBuffer(input_data_, sizeof(input_data_), false)};
+  vector<GeTensorDesc> output_desc;
+  vector<DataBuffer> outputs;
+  const int run_num = 3;
+  for (int i = 0; i < run_num; ++i) {
+    outputs.clear();
+    ASSERT_EQ(single_op.ExecuteAsync(InputDesc(4), inputs, output_desc, outputs), SUCCESS);
+  }
+  // the async copy reads the host args when the stream runs it, every rewrite after the first waits for it
+  ASSERT_EQ(GetRuntimeStubCounters().memcpy_count, 0);
+  ASSERT_EQ(GetRuntimeStubCounters().memcpy_async_count, run_num);
+  ASSERT_EQ(GetRuntimeStubCounters().memcpy_async_bytes, run_num * aicpu_task->arg_size_);
+  ASSERT_EQ(GetRuntimeStubCounters().stream_synchronize_count, run_num - 1);
+  ASSERT_EQ(GetRuntimeStubCounters().cpu_kernel_launch_count, run_num);
+
+  // the args of the last launch are not freed under it
+  single_op.aicpu_task_.reset();
+  ASSERT_EQ(GetRuntimeStubCounters().stream_synchronize_count, run_num);
+}
+
+TEST_F(UtestDynamicSingleOp, test_invalid_args) {
+  DynamicSingleOp single_op;
+  InitOp(single_op);
+  AddTbeTask(single_op, {8});
+
+  vector<DataBuffer> inputs{DataBuffer(input_data_, sizeof(input_data_), false)};
+  vector<GeTensorDesc> output_desc;
+  vector<DataBuffer> outputs;
+  vector<GeTensorDesc> no_desc;
+  ASSERT_EQ(single_op.ExecuteAsync(no_desc, inputs, output_desc, outputs), PARAM_INVALID);
+
+  // input buffer too small for the given shape
+  vector<DataBuffer> small_inputs{DataBuffer(input_data_, 4, false)};
+  ASSERT_EQ(single_op.ExecuteAsync(InputDesc(8), small_inputs, output_desc, outputs), PARAM_INVALID);
+
+  // no tbe kernel for the shape and no aicpu kernel
+  ASSERT_EQ(single_op.ExecuteAsync(InputDesc(100), inputs, output_desc, outputs), UNSUPPORTED);
+  ASSERT_EQ(GetRuntimeStubCounters().kernel_launch_count, 0);
+}
+
+TEST_F(UtestDynamicSingleOp, test_cache_dynamic_op) {
+  StreamResource res;
+  auto *op = new DynamicSingleOp();
+  string model_data = "model";
+  const void *key = model_data.c_str();
+  ASSERT_EQ(res.GetDynamicOperator(key), nullptr);
+  res.CacheDynamicOperator(key, op);
+  ASSERT_EQ(res.GetDynamicOperator(key), op);
+}